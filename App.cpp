@@ -1,5 +1,5 @@
 
-/** $VER: App.cpp (2024.04.04) P. Stuer **/
+/** $VER: App.cpp (2026.10.17) P. Stuer **/
 
 #include <CppCoreCheck/Warnings.h>
 
@@ -9,18 +9,38 @@
 
 #include "App.h"
 
-#include "Direct3D.h"
 #include "Direct2D.h"
 #include "DirectWrite.h"
+#include "WIC.h"
+#include "WICAnimation.h"
 
+#include "Frame.h"
+#include "ImageCache.h"
+#include "RasterAllocator.h"
+
+#include <algorithm>
 #include <chrono>
+#include <limits>
 
 #pragma hdrstop
 
+/// <summary>
+/// Gets the time of the animation and frame clock, in seconds. Uses the performance counter, like the frame statistics of DirectComposition.
+/// </summary>
+static double GetTime() noexcept
+{
+    LARGE_INTEGER Counter, Frequency;
+
+    ::QueryPerformanceCounter(&Counter);
+    ::QueryPerformanceFrequency(&Frequency);
+
+    return (double) Counter.QuadPart / (double) Frequency.QuadPart;
+}
+
 /// <summary>
 /// Initializes a new instance.
 /// </summary>
-App::App() : _hWnd(), _Number(1), _FilePath(), _Message()
+App::App() : _hWnd(), _Number(1), _FilePath(), _Message(), _FrameLatencyWaitable(), _CanPresent(), _ImageScale(1.f), _Animation([this]() { ::PostMessageW(_hWnd, WM_ANIMATIONFRAME, 0, 0); }), _ImageLoader([this]() { ::PostMessageW(_hWnd, WM_IMAGELOADED, 0, 0); }, nullptr, &ImageCache::GetDefault())
 {
 }
 
@@ -63,8 +83,15 @@ HRESULT App::Initialize()
         hr = _hWnd ? S_OK : E_FAIL;
     }
 
+    // The window has a single composition target. The child layer is a visual in its tree.
+    if (SUCCEEDED(hr))
+        hr = _DeviceManager.CreateTarget(_hWnd);
+
     if (SUCCEEDED(hr))
-        _Child.Initialize(_hWnd);
+        hr = _Child.Initialize(&_DeviceManager, _hWnd);
+
+    if (SUCCEEDED(hr))
+        UpdateFrameInterval();
 
     if (SUCCEEDED(hr))
     {
@@ -109,6 +136,15 @@ LRESULT CALLBACK App::WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
             case WM_SIZE:
                 return This->OnResize(LOWORD(lParam), HIWORD(lParam));
 
+            case WM_ENTERSIZEMOVE:
+                return This->OnEnterSizeMove();
+
+            case WM_EXITSIZEMOVE:
+                return This->OnExitSizeMove();
+
+            case WM_TIMER:
+                return This->OnTimer((UINT_PTR) wParam);
+
             case WM_PAINT:
             case WM_DISPLAYCHANGE:
             {
@@ -116,7 +152,7 @@ LRESULT CALLBACK App::WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 
                 ::BeginPaint(hWnd, &ps);
 
-                This->Render();
+                This->OnPaint();
 
                 ::EndPaint(hWnd, &ps);
 
@@ -129,6 +165,12 @@ LRESULT CALLBACK App::WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
             case WM_KEYDOWN:
                 return This->OnKeyDown(wParam);
 
+            case WM_IMAGELOADED:
+                return This->OnImageLoaded();
+
+            case WM_ANIMATIONFRAME:
+                return This->OnAnimationFrame();
+
             case WM_DESTROY:
             {
                 ::PostQuitMessage(0);
@@ -141,15 +183,36 @@ LRESULT CALLBACK App::WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
     return ::DefWindowProcW(hWnd, msg, wParam, lParam);
 }
 
+/// <summary>
+/// Handles the WM_PAINT message. The message loop renders the frame when the frame scheduler says so. The move/size loop of Windows runs its own
+/// message loop, so the frame is rendered right away while it runs.
+/// </summary>
+LRESULT App::OnPaint()
+{
+    if (_ResizeTracker.IsMoving())
+        Render();
+    else
+        _Scheduler.Invalidate();
+
+    return 0;
+}
+
 /// <summary>
 /// Handles the WM_SIZE message.
 /// </summary>
 LRESULT App::OnResize(UINT width, UINT height)
 {
+    // A minimized window has no client area. Nothing gets rendered until it is restored.
+    _Scheduler.SetOccluded((width == 0) || (height == 0), GetTime());
+
     if (_DC == nullptr)
         return 0;
 
-    _Bitmap.Release(); // Ensure that the bitmap gets rescaled.
+    // During a live resize keep the current bitmap and let the GPU stretch it. The bitmap gets rescaled once the size settles.
+    if (_ResizeTracker.Resize())
+        ::SetTimer(_hWnd, ResizeTimerId, ResizeTracker::SettleDelay, nullptr);
+    else
+        _Bitmap.reset(); // Ensure that the bitmap gets rescaled.
 
     ResizeSwapChain(width, height);
 
@@ -157,15 +220,131 @@ LRESULT App::OnResize(UINT width, UINT height)
 }
 
 /// <summary>
-/// Handles the WM_DROPFILES message.
+/// Handles the WM_ENTERSIZEMOVE message.
+/// </summary>
+LRESULT App::OnEnterSizeMove()
+{
+    UpdateFrameInterval(); // The window may have been moved to another monitor.
+
+    _ResizeTracker.BeginMove();
+
+    ScheduleAnimationFrame(); // Keeps the animation going with a window timer while the move/size loop runs.
+
+    return 0;
+}
+
+/// <summary>
+/// Handles the WM_EXITSIZEMOVE message.
+/// </summary>
+LRESULT App::OnExitSizeMove()
+{
+    if (_ResizeTracker.EndMove())
+        EndLiveResize();
+
+    return 0;
+}
+
+/// <summary>
+/// Handles the WM_TIMER message.
+/// </summary>
+LRESULT App::OnTimer(UINT_PTR timerId)
+{
+    if (timerId == AnimationTimerId)
+    {
+        ::KillTimer(_hWnd, AnimationTimerId);
+
+        return OnAnimationFrame();
+    }
+
+    if (timerId != ResizeTimerId)
+        return 1;
+
+    ::KillTimer(_hWnd, ResizeTimerId);
+
+    if (_ResizeTracker.Settle())
+        EndLiveResize();
+
+    return 0;
+}
+
+/// <summary>
+/// Handles the WM_DROPFILES message. The image is loaded in the background; the current image remains visible until the new one is ready.
 /// </summary>
 LRESULT App::OnDropFiles(HDROP hDrop)
 {
-    if (::DragQueryFileW(hDrop, 0, _FilePath, _countof(_FilePath)) != 0)
+    WCHAR FilePath[MAX_PATH] = { };
+
+    if (::DragQueryFileW(hDrop, 0, FilePath, _countof(FilePath)) != 0)
     {
-        DeleteBitmapSourceDependentResources();
+        ImageCache::GetDefault().Remove(FilePath); // The file may have changed since it was dropped the last time.
+
+        ::KillTimer(_hWnd, AnimationTimerId);
+
+        _Scheduler.CancelTick();
+
+        _Animation.Close();
+
+        RECT cr = { };
+
+        ::GetClientRect(_hWnd, &cr);
+
+        const std::wstring Path(FilePath);
+
+        const UINT MaxWidth  = (std::max)((UINT) cr.right,  1U);
+        const UINT MaxHeight = (std::max)((UINT) cr.bottom, 1U);
+
+        UINT ScreenWidth, ScreenHeight;
+
+        GetScreenSize(ScreenWidth, ScreenHeight);
+
+        // Runs on a worker thread.
+        auto Decoder = [this, Path, ScreenWidth, ScreenHeight](Raster & raster) -> HRESULT
+        {
+            HRESULT hr = WIC::InitializeThread();
+
+            // The file is opened once. Counting the frames parses the whole file so it happens here instead of on the UI thread.
+            CComPtr<IWICBitmapDecoder> FileDecoder;
+
+            if (SUCCEEDED(hr))
+                hr = _Direct2D.Load(Path.c_str(), &FileDecoder);
+
+            UINT FrameCount = 0;
+
+            if (SUCCEEDED(hr))
+                hr = FileDecoder->GetFrameCount(&FrameCount);
+
+            CComPtr<IWICBitmapFrameDecode> Frame;
 
-        ::InvalidateRect(_hWnd, nullptr, TRUE);
+            if (SUCCEEDED(hr))
+                hr = FileDecoder->GetFrame(0, &Frame);
+
+            // Let the decoder skip the detail that the fit to the screen discards. The cache then serves every window size, up to maximized, from this decode.
+            CComPtr<IWICBitmapSource> BitmapSource;
+
+            if (SUCCEEDED(hr))
+                hr = _WIC.GetReducedSource(Frame, ScreenWidth, ScreenHeight, &BitmapSource);
+
+            if (SUCCEEDED(hr))
+                hr = CreateScreenRaster(BitmapSource, ScreenWidth, ScreenHeight, raster);
+
+            // Play animated GIFs with the same decoder. The first frame is loaded like any other image and shows until the animation catches up.
+            if (SUCCEEDED(hr))
+            {
+                std::unique_ptr<AnimationSource> Animation;
+
+                if ((FrameCount < 2) || FAILED(WICAnimation::Create(FileDecoder, Animation)))
+                    Animation.reset();
+
+                std::lock_guard<std::mutex> Lock(_LoadedAnimationMutex);
+
+                _LoadedAnimationPath = Path;
+                _LoadedAnimation = std::move(Animation);
+            }
+
+            return hr;
+        };
+
+        _ImageLoader.Load(FilePath, Decoder, MaxWidth, MaxHeight);
     }
 
     ::DragFinish(hDrop);
@@ -173,6 +352,105 @@ LRESULT App::OnDropFiles(HDROP hDrop)
     return 0;
 }
 
+/// <summary>
+/// Handles the WM_IMAGELOADED message: swaps in the image that was loaded in the background and plays it if it is an animation.
+/// </summary>
+LRESULT App::OnImageLoaded()
+{
+    WCHAR FilePath[MAX_PATH] = { };
+    std::shared_ptr<const Raster> Image;
+
+    HRESULT hr = _ImageLoader.GetResult(FilePath, _countof(FilePath), Image);
+
+    if (hr == E_PENDING)
+        return 0; // The result has been superseded by a newer drop.
+
+    // Keep showing the current image if the new one could not be loaded.
+    if (FAILED(hr))
+        return 0;
+
+    CComPtr<ID2D1Bitmap> D2DBitmap;
+
+    // Direct2D uses a single-threaded factory so the upload to the GPU has to happen on this thread.
+    if (_DC != nullptr)
+    {
+        const PhaseTimer Timer(_Profiler, FramePhase::Bitmap);
+
+        hr = _Direct2D.CreateBitmap(*Image, _DC, &D2DBitmap);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        ::wcscpy_s(_FilePath, _countof(_FilePath), FilePath);
+
+        {
+            std::unique_ptr<AnimationSource> Animation;
+
+            {
+                std::lock_guard<std::mutex> Lock(_LoadedAnimationMutex);
+
+                if (_LoadedAnimationPath == FilePath)
+                {
+                    Animation = std::move(_LoadedAnimation);
+
+                    _LoadedAnimationPath.clear();
+                }
+            }
+
+            if (Animation != nullptr)
+                _Animation.Open(std::move(Animation));
+        }
+
+        DeleteBitmapSourceDependentResources();
+
+        // Creating the bitmap source only reads the header of the file. It is needed when the image has to be rescaled; the image cache makes sure the pixels do not get decoded again.
+        // An animation that is already playing keeps its current frame.
+        if (SUCCEEDED(CreateBitmapSource(&_BitmapSource)) && (D2DBitmap != nullptr) && (_Animation.GetFrame() == nullptr))
+        {
+            _Bitmap = std::make_unique<Direct2DBitmap>(D2DBitmap);
+
+            UINT ImageWidth = 0, ImageHeight = 0;
+
+            if (SUCCEEDED(_BitmapSource->GetSize(&ImageWidth, &ImageHeight)))
+                _ImageScale = (FLOAT) ImageWidth / (FLOAT) D2DBitmap->GetPixelSize().width;
+        }
+
+        ::InvalidateRect(_hWnd, nullptr, FALSE);
+    }
+
+    return 0;
+}
+
+/// <summary>
+/// Handles the WM_ANIMATIONFRAME message and the animation timer: shows the frame of the animation that is due and schedules the next one.
+/// </summary>
+LRESULT App::OnAnimationFrame()
+{
+    if (_Animation.Update(GetTime()))
+    {
+        const Raster * Frame = _Animation.GetFrame();
+
+        CComPtr<ID2D1Bitmap> D2DBitmap;
+
+        if ((Frame != nullptr) && (_DC != nullptr))
+        {
+            const PhaseTimer Timer(_Profiler, FramePhase::Bitmap);
+
+            if (SUCCEEDED(_Direct2D.CreateBitmap(*Frame, _DC, &D2DBitmap)))
+            {
+                _Bitmap = std::make_unique<Direct2DBitmap>(D2DBitmap);
+                _ImageScale = 1.f;
+
+                ::InvalidateRect(_hWnd, nullptr, FALSE);
+            }
+        }
+    }
+
+    ScheduleAnimationFrame();
+
+    return 0;
+}
+
 /// <summary>
 /// Handles the WM_KEYDOWN message.
 /// </summary>
@@ -186,6 +464,10 @@ LRESULT App::OnKeyDown(WPARAM wParam)
         case VK_ESCAPE:
             ::PostQuitMessage(0);
             break;
+
+        case 'P':
+            ExportProfile();
+            break;
     }
 
     return 0;
@@ -196,53 +478,101 @@ LRESULT App::OnKeyDown(WPARAM wParam)
 /// </summary>
 HRESULT App::Render()
 {
-    HRESULT hr = CreateDeviceDependentResources();
+    SynchronizeClock();
+
+    _Scheduler.BeginFrame(GetTime());
+
+    _Profiler.BeginFrame();
+    _DeviceManager.BeginFrame();
+
+    const auto Start = std::chrono::steady_clock::now();
+
+    HRESULT hr = S_OK;
 
-    if (SUCCEEDED(hr))
     {
-        D2D1_SIZE_F RenderTargetSize = _DC->GetSize();
+        const PhaseTimer Timer(_Profiler, FramePhase::Resources);
 
-        _DC->BeginDraw();
+        hr = CreateDeviceDependentResources();
+    }
 
-        _DC->SetTransform(D2D1::Matrix3x2F::Identity());
+    if (SUCCEEDED(hr))
+    {
+        const AppFrame Frame { _Background.get(), _Bitmap.get(), _TextFormat.get(), _Message, _ResizeTracker.IsLive() ? _ImageScale : 0.f };
 
-        if (_Bitmap)
+        const Region * DirtyRegion = nullptr;
+
+        // Determine which part of the back buffer differs from the previous frame.
         {
-            D2D1_SIZE_F Size = _Bitmap->GetSize();
+            const PhaseTimer Timer(_Profiler, FramePhase::Damage);
 
-            D2D1_RECT_F Rect = D2D1::RectF((RenderTargetSize.width - Size.width) / 2.f, (RenderTargetSize.height - Size.height) / 2.f, Size.width, Size.height);
+            RECT cr;
 
-            Rect.right += Rect.left;
-            Rect.bottom += Rect.top;
+            ::GetClientRect(_hWnd, &cr);
 
-            _DC->DrawBitmap(_Bitmap, Rect);
-        }
+            _DamageTracker.BeginFrame((UINT) (cr.right - cr.left), (UINT) (cr.bottom - cr.top), (FLOAT) ::GetDpiForWindow(_hWnd) / (FLOAT) USER_DEFAULT_SCREEN_DPI);
 
-        // Draw the spotlight.
-        {
-            const D2D1_POINT_2F Center = D2D1::Point2F(RenderTargetSize.width / 2.f, RenderTargetSize.height / 2.f);
-            const FLOAT Radius = ((std::min)(RenderTargetSize.width, RenderTargetSize.height) / 2.f) - 8.f;
-            const D2D1_ELLIPSE Ellipse = D2D1::Ellipse(Center, Radius, Radius);
+            Frame.AddElements(_DamageTracker, _Compositor.GetSize());
 
-            _SolidBrush->SetColor(D2D1::ColorF(.75f, .75f, 1, .25f));
-            _DC->FillEllipse(Ellipse, _SolidBrush);
+            DirtyRegion = &_DamageTracker.EndFrame();
         }
 
-        if (_Message[0])
+        if (!DirtyRegion->IsEmpty())
         {
-            _SolidBrush->SetColor(D2D1::ColorF(D2D1::ColorF::Black));
-            _DC->DrawText(_Message, (UINT) ::wcslen(_Message), _TextFormat, D2D1::RectF(0.f, 0.f, RenderTargetSize.width, RenderTargetSize.height), _SolidBrush);
+            {
+                const PhaseTimer Timer(_Profiler, FramePhase::Draw);
+
+                _Compositor.BeginDraw();
+
+                Frame.Render(_Compositor, *DirtyRegion);
+            }
+
+            {
+                const PhaseTimer Timer(_Profiler, FramePhase::Flush);
+
+                _Compositor.EndDraw();
+            }
+
+            // Present the dirty rectangles of the swap chain to the composition engine.
+            {
+                const PhaseTimer Timer(_Profiler, FramePhase::Present);
+
+                hr = _Compositor.Present(*DirtyRegion);
+
+                _CanPresent = false;
+            }
+
+            // Stop rendering until a test present shows that the window is visible again.
+            if (hr == DXGI_STATUS_OCCLUDED)
+                _Scheduler.SetOccluded(true, GetTime());
+
+            if (!SUCCEEDED(hr) && (hr != DXGI_STATUS_OCCLUDED))
+                DeleteDeviceDependentResources();
+
+            _ResizeTracker.AddFrame(std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count());
         }
+    }
 
-        _DC->EndDraw();
+    // Present the child layer and commit the changes to the visual tree of both layers at once.
+    if (SUCCEEDED(hr))
+    {
+        const PhaseTimer Timer(_Profiler, FramePhase::Compose);
 
-        // Present the swap chain to the composition engine.
-        hr = _SwapChain->Present(1, 0);
+        hr = _Child.Render();
 
         if (!SUCCEEDED(hr) && (hr != DXGI_STATUS_OCCLUDED))
-            DeleteDeviceDependentResources();
+            _Child.DeleteDeviceDependentResources();
+
+        HRESULT hc = _DeviceManager.EndFrame();
+
+        if (SUCCEEDED(hr))
+            hr = hc;
     }
 
+    RasterAllocator::GetDefault().MarkFrame();
+
+    _Profiler.EndFrame();
+    _Scheduler.EndFrame(GetTime());
+
     return hr;
 }
 
@@ -252,29 +582,11 @@ HRESULT App::Render()
 /// </summary>
 HRESULT App::CreateDeviceIndependentResources()
 {
-    HRESULT hr = _Direct3D.GetDXGIDevice(&_DXGIDevice);
-
-    // Create the Direct2D device that links back to the Direct3D device.
-    if (SUCCEEDED(hr))
-        hr = _Direct2D.Factory->CreateDevice(_DXGIDevice, &_D2DDevice);
-
-    // Create the DirectComposition device that links back to the Direct3D device.
-    if (SUCCEEDED(hr))
-        hr = ::DCompositionCreateDevice(_DXGIDevice, __uuidof(_CompositionDevice), (void **) &_CompositionDevice);
-
-    if (SUCCEEDED(hr))
-    {
-        static const WCHAR FontName[] = L"Verdana";
-        static const FLOAT FontSize = 24.f;
-
-        hr = _DirectWrite.Factory->CreateTextFormat(FontName, NULL, DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL, DWRITE_FONT_STRETCH_NORMAL, FontSize, L"", &_TextFormat);
-    }
+    // Create the devices shared by the main window and the child layer.
+    HRESULT hr = _DeviceManager.Initialize();
 
     if (SUCCEEDED(hr))
-    {
-        _TextFormat->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_CENTER);
-        _TextFormat->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_NEAR);
-    }
+        hr = _Compositor.CreateTextFormat(AppFrame::FontName, AppFrame::FontSize, TextAlignment::Center, ParagraphAlignment::Near, _TextFormat);
 
     return hr;
 }
@@ -295,95 +607,78 @@ HRESULT App::CreateDeviceDependentResources()
     HRESULT hr = (Width != 0) && (Height != 0) ? S_OK : DXGI_ERROR_INVALID_CALL;
 
     // Create the Direct2D device context that is the actual render target and exposes drawing commands.
+    // Set the DPI of the device context based on that of the target window.
     if (SUCCEEDED(hr) && (_DC == nullptr))
+        hr = _DeviceManager.CreateDeviceContext(::GetDpiForWindow(_hWnd), &_DC);
+
+    // Create the swap chain and make it the content of the root visual. The change is committed at the end of the frame.
+    if (SUCCEEDED(hr) && (_SwapChain == nullptr))
     {
-        hr = _D2DDevice->CreateDeviceContext(D2D1_DEVICE_CONTEXT_OPTIONS_NONE, &_DC);
+        hr = _DeviceManager.CreateSwapChain(Width, Height, &_SwapChain, SwapChainFlags);
 
-        // Set the DPI of the device context based on that of the target window.
+        // Queue at most one frame and let the message loop wait until the swap chain can take the next one, instead of blocking in Present.
         if (SUCCEEDED(hr))
         {
-            FLOAT DPI = (FLOAT) ::GetDpiForWindow(_hWnd);
+            CComPtr<IDXGISwapChain2> SwapChain;
 
-            _DC->SetDpi(DPI, DPI);
-        }
-    }
+            hr = _SwapChain->QueryInterface(&SwapChain);
 
-    // Create the swap chain.
-    if (SUCCEEDED(hr) && (_SwapChain == nullptr))
-    {
-        hr = _DXGI.CreateSwapChain(_DXGIDevice, Width, Height, &_SwapChain);
+            if (SUCCEEDED(hr))
+                hr = SwapChain->SetMaximumFrameLatency(1);
+
+            if (SUCCEEDED(hr))
+                _FrameLatencyWaitable = SwapChain->GetFrameLatencyWaitableObject();
+        }
 
         if (SUCCEEDED(hr))
             hr = CreateSwapChainBuffers(_DC, _SwapChain);
-    }
-
-    // Create the composition target.
-    if (SUCCEEDED(hr) && (_CompositionTarget == nullptr))
-    {
-        hr = _CompositionDevice->CreateTargetForHwnd(_hWnd, true, &_CompositionTarget);
-
-        if (SUCCEEDED(hr) && (_CompositionVisual == nullptr))
-            hr = _CompositionDevice->CreateVisual(&_CompositionVisual);
 
         if (SUCCEEDED(hr))
-            hr = _CompositionTarget->SetRoot(_CompositionVisual);
+            hr = _DeviceManager.SetContent(_DeviceManager.GetRoot(), _SwapChain);
     }
 
     if (SUCCEEDED(hr))
-        hr = _CompositionVisual->SetContent(_SwapChain);
+        hr = _Compositor.Attach(_DC, _SwapChain);
 
-    if (SUCCEEDED(hr))
-        hr = _CompositionDevice->Commit();
+    if (SUCCEEDED(hr) && (_Background == nullptr))
+    {
+        Raster GridPattern;
 
-    if (SUCCEEDED(hr) && (_BackgroundBrush == nullptr))
-        hr = CreatePatternBrush(_DC, &_BackgroundBrush);
+        hr = AppFrame::CreateGridPattern(GridPattern);
 
-    if (SUCCEEDED(hr) && (_SolidBrush == nullptr))
-        hr = _DC->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::Black), &_SolidBrush);
+        if (SUCCEEDED(hr))
+            hr = _Compositor.CreateBitmap(GridPattern, _Background);
+    }
 
     if (SUCCEEDED(hr) && (_BitmapSource == nullptr))
         hr = CreateBitmapSource(&_BitmapSource);
 
     if (SUCCEEDED(hr) && (_Bitmap == nullptr))
-        hr = CreateBitmap(_BitmapSource, _DC, Width, Height, &_Bitmap);
-
-    return hr;
-}
-
-/// <summary>
-/// Creates the pattern brush to paint the background.
-/// </summary>
-HRESULT App::CreatePatternBrush(ID2D1RenderTarget * renderTarget, ID2D1BitmapBrush ** bitmapBrush) const noexcept
-{
-    CComPtr<ID2D1BitmapRenderTarget> rt;
-
-    HRESULT hr = renderTarget->CreateCompatibleRenderTarget(D2D1::SizeF(10.0f, 10.0f), &rt);
-
-    CComPtr<ID2D1SolidColorBrush> GridBrush;
-
-    if (SUCCEEDED(hr))
-        hr = rt->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF(0.93f, 0.94f, 0.96f, 1.0f)), &GridBrush);
-
-    if (SUCCEEDED(hr))
     {
-        rt->BeginDraw();
+        const PhaseTimer Timer(_Profiler, FramePhase::Bitmap);
 
-        rt->FillRectangle(D2D1::RectF(0.0f, 0.0f, 10.0f, 1.0f), GridBrush);
-        rt->FillRectangle(D2D1::RectF(0.0f, 0.1f, 1.0f, 10.0f), GridBrush);
+        CComPtr<ID2D1Bitmap> D2DBitmap;
 
-        hr = rt->EndDraw();
-    }
+        const Raster * Frame = _Animation.GetFrame();
 
-    CComPtr<ID2D1Bitmap> GridBitmap;
+        // An animation shows its current frame at its own size; the GPU scales it.
+        if (Frame != nullptr)
+            hr = _Direct2D.CreateBitmap(*Frame, _DC, &D2DBitmap);
+        else
+            hr = CreateBitmap(_BitmapSource, _DC, Width, Height, &D2DBitmap);
 
-    if (SUCCEEDED(hr))
-        hr = rt->GetBitmap(&GridBitmap);
+        if (SUCCEEDED(hr))
+        {
+            _Bitmap = std::make_unique<Direct2DBitmap>(D2DBitmap);
 
-    if (SUCCEEDED(hr))
-    {
-        D2D1_BITMAP_BRUSH_PROPERTIES BrushProperties = D2D1::BitmapBrushProperties(D2D1_EXTEND_MODE_WRAP, D2D1_EXTEND_MODE_WRAP);
+            UINT ImageWidth = 0, ImageHeight = 0;
 
-        hr = rt->CreateBitmapBrush(GridBitmap, BrushProperties, bitmapBrush);
+            if (Frame != nullptr)
+                _ImageScale = 1.f;
+            else
+            if (SUCCEEDED(_BitmapSource->GetSize(&ImageWidth, &ImageHeight)))
+                _ImageScale = (FLOAT) ImageWidth / (FLOAT) D2DBitmap->GetPixelSize().width;
+        }
     }
 
     return hr;
@@ -394,14 +689,25 @@ HRESULT App::CreatePatternBrush(ID2D1RenderTarget * renderTarget, ID2D1BitmapBru
 /// </summary>
 HRESULT App::CreateBitmapSource(IWICBitmapSource ** bitmapSource) const noexcept
 {
-    if (_FilePath[0] != 0)
-        return _Direct2D.Load(_FilePath, bitmapSource);
+    WCHAR SourceName[MAX_PATH] = { };
 
-    WCHAR ResourceName[64] = { };
+    GetSourceName(SourceName, _countof(SourceName));
 
-    ::swprintf_s(ResourceName, _countof(ResourceName), L"Image%02d", _Number);
+    if (_FilePath[0] != 0)
+        return _Direct2D.Load(SourceName, bitmapSource);
 
-    return _Direct2D.Load(ResourceName, L"Image", bitmapSource);
+    return _Direct2D.Load(SourceName, L"Image", bitmapSource);
+}
+
+/// <summary>
+/// Gets the name of the bitmap source: the path of the dropped file or the name of the image resource.
+/// </summary>
+void App::GetSourceName(WCHAR * sourceName, size_t size) const noexcept
+{
+    if (_FilePath[0] != 0)
+        ::wcscpy_s(sourceName, size, _FilePath);
+    else
+        ::swprintf_s(sourceName, size, L"Image%02d", _Number);
 }
 
 /// <summary>
@@ -409,28 +715,78 @@ HRESULT App::CreateBitmapSource(IWICBitmapSource ** bitmapSource) const noexcept
 /// </summary>
 HRESULT App::CreateBitmap(IWICBitmapSource * bitmapSource, ID2D1RenderTarget * renderTarget, UINT maxWidth, UINT maxHeight, ID2D1Bitmap ** bitmap) const noexcept
 {
+    UINT ScreenWidth, ScreenHeight;
+
+    GetScreenSize(ScreenWidth, ScreenHeight);
+
+    // The decoder only produces the detail that survives the fit to the screen, e.g. JPEG at 1/2, 1/4 or 1/8 scale, like the background loader.
+    auto Loader = [bitmapSource, ScreenWidth, ScreenHeight](Raster & raster) -> HRESULT
+    {
+        CComPtr<IWICBitmapSource> ReducedSource;
+
+        HRESULT hr = _WIC.GetReducedSource(bitmapSource, ScreenWidth, ScreenHeight, &ReducedSource);
+
+        if (SUCCEEDED(hr))
+            hr = CreateScreenRaster(ReducedSource, ScreenWidth, ScreenHeight, raster);
+
+        return hr;
+    };
+
     UINT Width = 0, Height = 0;
 
     HRESULT hr = bitmapSource->GetSize(&Width, &Height);
 
-    CComPtr<IWICBitmapScaler> Scaler;
+    WCHAR SourceName[MAX_PATH] = { };
+
+    GetSourceName(SourceName, _countof(SourceName));
 
-    // Fit big images.
-    if (SUCCEEDED(hr) && ((Width > maxWidth) || (Height > maxHeight)))
-        hr = _Direct2D.CreateScaler(_BitmapSource, Width, Height, maxWidth, maxHeight, &Scaler);
+    std::shared_ptr<const Raster> Image;
 
+    // Fit big images. The cache only decodes the source if it has no image of the same size or larger.
     if (SUCCEEDED(hr))
-        hr = _Direct2D.CreateBitmap(Scaler ? Scaler : bitmapSource, renderTarget, bitmap);
+        hr = ImageCache::GetDefault().Fit(SourceName, maxWidth, maxHeight, Width, Height, Loader, Image);
+
+    if (SUCCEEDED(hr))
+        hr = _Direct2D.CreateBitmap(*Image, renderTarget, bitmap);
 
     return hr;
 }
 
+/// <summary>
+/// Decodes a bitmap source into a raster. Huge images are scaled to fit the screen while they are decoded instead of being decoded as a whole.
+/// </summary>
+HRESULT App::CreateScreenRaster(IWICBitmapSource * bitmapSource, UINT screenWidth, UINT screenHeight, Raster & raster) noexcept
+{
+    UINT Width = 0, Height = 0;
+
+    HRESULT hr = bitmapSource->GetSize(&Width, &Height);
+
+    if (SUCCEEDED(hr))
+    {
+        if ((uint64_t) Width * Height > StreamingThreshold)
+            hr = _WIC.CreateFitRaster(bitmapSource, screenWidth, screenHeight, raster);
+        else
+            hr = _WIC.CreateRaster(bitmapSource, raster);
+    }
+
+    return hr;
+}
+
+/// <summary>
+/// Gets the size of the virtual screen, the largest size the window can get. Images are decoded for this size so that resizing the window does not decode them again.
+/// </summary>
+void App::GetScreenSize(UINT & width, UINT & height) noexcept
+{
+    width  = (UINT) (std::max)(::GetSystemMetrics(SM_CXVIRTUALSCREEN), 1);
+    height = (UINT) (std::max)(::GetSystemMetrics(SM_CYVIRTUALSCREEN), 1);
+}
+
 /// <summary>
 /// Discards device-specific resources related to a bitmap source.
 /// </summary>
 void App::DeleteBitmapSourceDependentResources()
 {
-    _Bitmap.Release();
+    _Bitmap.reset();
     _BitmapSource.Release();
 }
 
@@ -441,8 +797,23 @@ void App::DeleteDeviceDependentResources()
 {
     DeleteBitmapSourceDependentResources();
 
-    _SolidBrush.Release();
-    _BackgroundBrush.Release();
+    _Background.reset();
+
+    _Compositor.Detach();
+
+    _DamageTracker.InvalidateAll();
+
+    // The layers share the device so they are lost together.
+    _Child.DeleteDeviceDependentResources();
+
+    if (_FrameLatencyWaitable != nullptr)
+    {
+        ::CloseHandle(_FrameLatencyWaitable);
+
+        _FrameLatencyWaitable = nullptr;
+    }
+
+    _CanPresent = false;
 
     _SwapChain.Release();
     _DC.Release();
@@ -459,7 +830,7 @@ void App::ResizeSwapChain(UINT width, UINT height) noexcept
     HRESULT hr = (width != 0) && (height != 0) ? S_OK : DXGI_ERROR_INVALID_CALL;
 
     if (SUCCEEDED(hr))
-        hr = _SwapChain->ResizeBuffers(0, width, height, DXGI_FORMAT_UNKNOWN, 0);
+        hr = _SwapChain->ResizeBuffers(0, width, height, DXGI_FORMAT_UNKNOWN, SwapChainFlags);
 
     if (SUCCEEDED(hr))
         CreateSwapChainBuffers(_DC, _SwapChain);
@@ -467,6 +838,201 @@ void App::ResizeSwapChain(UINT width, UINT height) noexcept
         DeleteDeviceDependentResources();
 }
 
+/// <summary>
+/// Ends a live resize: schedules the high-quality rescale of the bitmap. The frame times of the preview stay in the resize tracker until the next live resize.
+/// </summary>
+void App::EndLiveResize() noexcept
+{
+    _Bitmap.reset();
+
+    ::InvalidateRect(_hWnd, nullptr, FALSE);
+}
+
+/// <summary>
+/// Schedules the animation tick at the deadline of the current frame. There is no tick if the animation has ended or waits for a frame; the player posts WM_ANIMATIONFRAME when it arrives.
+/// </summary>
+void App::ScheduleAnimationFrame() noexcept
+{
+    const double Deadline = _Animation.GetDeadline();
+
+    _Scheduler.CancelTick();
+
+    if (Deadline == std::numeric_limits<double>::infinity())
+        return;
+
+    _Scheduler.ScheduleTick(Deadline);
+
+    // The move/size loop of Windows does not run the message loop of the app. A window timer keeps the animation going meanwhile.
+    if (_ResizeTracker.IsMoving())
+    {
+        // The deadlines are absolute, so a timer that fires late only shortens the next delay.
+        const UINT Milliseconds = (UINT) std::clamp(std::ceil((Deadline - GetTime()) * 1000.), (double) USER_TIMER_MINIMUM, 60000.);
+
+        ::SetTimer(_hWnd, AnimationTimerId, Milliseconds, nullptr);
+    }
+}
+
+/// <summary>
+/// Writes the counters of the last frame to Compositing.txt and the frame profile to Compositing.csv and Compositing.json in the temporary folder.
+/// A file that cannot be written does not keep the others from being written; the failures are reported once all files have been tried.
+/// </summary>
+HRESULT App::ExportProfile() noexcept
+{
+    WCHAR Directory[MAX_PATH] = { };
+
+    if (::GetTempPathW(_countof(Directory), Directory) == 0)
+        return HRESULT_FROM_WIN32(::GetLastError());
+
+    std::pair<const WCHAR *, std::string> Files[] = { { L"Compositing.txt", GetStatistics() }, { L"Compositing.csv", { } }, { L"Compositing.json", { } } };
+
+    // The counters of the last frame are always available; the phase timings only when the profiler is compiled in.
+    if (FAILED(_Profiler.Export(ProfileFormat::CSV, Files[1].second)) || FAILED(_Profiler.Export(ProfileFormat::JSON, Files[2].second)))
+    {
+        Files[1].second.clear();
+        Files[2].second.clear();
+    }
+
+    HRESULT Result = S_OK;
+
+    WCHAR Failures[512] = { };
+
+    for (const auto & [ FileName, Text ] : Files)
+    {
+        if (Text.empty())
+            continue;
+
+        WCHAR FilePath[MAX_PATH] = { };
+
+        ::swprintf_s(FilePath, _countof(FilePath), L"%s%s", Directory, FileName);
+
+        HRESULT hr = S_OK;
+
+        HANDLE hFile = ::CreateFileW(FilePath, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (hFile != INVALID_HANDLE_VALUE)
+        {
+            DWORD Written = 0;
+
+            if (!::WriteFile(hFile, Text.data(), (DWORD) Text.size(), &Written, nullptr) || (Written != (DWORD) Text.size()))
+                hr = HRESULT_FROM_WIN32(::GetLastError());
+
+            ::CloseHandle(hFile);
+        }
+        else
+            hr = HRESULT_FROM_WIN32(::GetLastError());
+
+        if (SUCCEEDED(hr))
+            continue;
+
+        if (SUCCEEDED(Result))
+            Result = hr;
+
+        const size_t Length = ::wcslen(Failures);
+
+        ::swprintf_s(Failures + Length, _countof(Failures) - Length, L"%s (0x%08X)\n", FilePath, (unsigned int) hr);
+    }
+
+    if (FAILED(Result))
+    {
+        WCHAR Text[640] = { };
+
+        ::swprintf_s(Text, _countof(Text), L"The profile could not be written to:\n\n%s", Failures);
+
+        ::MessageBoxW(_hWnd, Text, WindowTitle, MB_OK | MB_ICONWARNING);
+    }
+
+    return Result;
+}
+
+/// <summary>
+/// Gets the counters of the scheduler, the damage tracker, the devices, the text layouts, the raster allocator and the animation player, as of the last frame,
+/// and the frame times of the last live resize.
+/// </summary>
+std::string App::GetStatistics() const noexcept
+{
+    const DamageStatistics Damage = _DamageTracker.GetStatistics();
+    const DeviceStatistics Devices = _DeviceManager.GetStatistics();
+    const TextLayoutStatistics Layouts = _Compositor.GetTextLayoutStatistics();
+    const RasterAllocatorStatistics Rasters = RasterAllocator::GetDefault().GetStatistics();
+    const AnimationStatistics Animation = _Animation.GetStatistics();
+    const FrameSchedulerStatistics Scheduler = _Scheduler.GetStatistics();
+    const ResizeStatistics Resize = _ResizeTracker.GetStatistics();
+
+    char Text[2048];
+
+    ::sprintf_s(Text, _countof(Text),
+        "Frames: %llu, %llu missed (%.1f ms maximum), %llu invalidations, %llu ticks\n"
+        "Damage: %u rects, %.1f%% of the target, %llu frames, %llu skipped\n"
+        "Devices: %u, device contexts: %u, swap chains: %u, targets: %u, visuals: %u\n"
+        "Commits: %u (%llu in %llu frames)\n"
+        "Text layouts: %llu hits, %llu resizes, %llu relayouts, %llu misses\n"
+        "Rasters: %.1f MB live, %.1f MB pooled, %llu allocations\n"
+        "Animation: %u frames, %u of %u ahead (%s), %.1f MB, %llu dropped, %llu underruns\n"
+        "Resize: %u frames, %.1f ms average, %.1f ms maximum, %u over %.1f ms\n",
+        Scheduler.Frames, Scheduler.Missed, Scheduler.MaxLateness * 1e3, Scheduler.Invalidations, Scheduler.Ticks,
+        Damage.DirtyRects, Damage.FillRate * 100., Damage.Frames, Damage.SkippedFrames,
+        Devices.Devices, Devices.DeviceContexts, Devices.SwapChains, Devices.Targets, Devices.Visuals,
+        Devices.Commits, Devices.TotalCommits, Devices.Frames,
+        Layouts.Hits, Layouts.Resizes, Layouts.Relayouts, Layouts.Misses,
+        (double) Rasters.BytesLive / 1048576., (double) Rasters.BytesPooled / 1048576., Rasters.FrameAllocations,
+        Animation.FrameCount, Animation.DecodeAhead, Animation.Capacity, Animation.IsResident ? "resident" : "streaming", (double) Animation.MemoryUsage / 1048576.,
+        Animation.Dropped, Animation.Underruns,
+        Resize.Frames, Resize.Average * 1e3, Resize.Maximum * 1e3, Resize.Missed, Resize.Interval * 1e3);
+
+    return Text;
+}
+
+/// <summary>
+/// Sets the frame interval of the resize tracker to the refresh rate of the display of the window.
+/// </summary>
+void App::UpdateFrameInterval() noexcept
+{
+    HDC hDC = ::GetDC(_hWnd);
+
+    const int RefreshRate = ::GetDeviceCaps(hDC, VREFRESH);
+
+    ::ReleaseDC(_hWnd, hDC);
+
+    // 0 and 1 mean that the display uses its default rate.
+    if (RefreshRate > 1)
+    {
+        _ResizeTracker.SetFrameInterval(1. / (double) RefreshRate);
+        _Scheduler.SetFrameInterval(1. / (double) RefreshRate);
+    }
+}
+
+/// <summary>
+/// Aligns the vsync clock of the frame scheduler with the last frame and the rate of the composition engine.
+/// </summary>
+void App::SynchronizeClock() noexcept
+{
+    DCOMPOSITION_FRAME_STATISTICS Statistics = { };
+
+    if (FAILED(::DCompositionGetFrameStatistics(&Statistics)) || (Statistics.timeFrequency.QuadPart == 0))
+        return;
+
+    _Scheduler.Synchronize((double) Statistics.lastFrameTime.QuadPart / (double) Statistics.timeFrequency.QuadPart);
+
+    if ((Statistics.currentCompositionRate.Numerator != 0) && (Statistics.currentCompositionRate.Denominator != 0))
+        _Scheduler.SetFrameInterval((double) Statistics.currentCompositionRate.Denominator / (double) Statistics.currentCompositionRate.Numerator);
+}
+
+/// <summary>
+/// Tests whether the window is still occluded with a present that does not present anything. Schedules a complete frame when it is visible again.
+/// </summary>
+void App::TestOcclusion() noexcept
+{
+    if (::IsIconic(_hWnd))
+        return;
+
+    if ((_SwapChain != nullptr) && (_SwapChain->Present(0, DXGI_PRESENT_TEST) == DXGI_STATUS_OCCLUDED))
+        return;
+
+    _DamageTracker.InvalidateAll();
+
+    _Scheduler.SetOccluded(false, GetTime());
+}
+
 /// <summary>
 /// Creates the swap chain buffers.
 /// </summary>
@@ -495,9 +1061,75 @@ HRESULT App::CreateSwapChainBuffers(ID2D1DeviceContext * dc, IDXGISwapChain1 * s
             _DC->SetTarget(SurfaceBitmap);
     }
 
+    // New buffers have no previous frame to build on.
+    _DamageTracker.InvalidateAll();
+
     return hr;
 }
 
+/// <summary>
+/// Runs the message loop. Frames are rendered when the frame scheduler asks for one and the swap chain can take it; in between the loop sleeps
+/// until a message arrives, the swap chain signals or the scheduler needs it again. An idle or occluded window does not use the CPU.
+/// </summary>
+int App::Run() noexcept
+{
+    MSG Msg = { };
+
+    for (;;)
+    {
+        while (::PeekMessageW(&Msg, NULL, 0, 0, PM_REMOVE))
+        {
+            if (Msg.message == WM_QUIT)
+                return (int) Msg.wParam;
+
+            ::TranslateMessage(&Msg);
+            ::DispatchMessageW(&Msg);
+        }
+
+        const double Now = GetTime();
+
+        if (_Scheduler.TakeTick(Now))
+            OnAnimationFrame();
+
+        if (_Scheduler.TakeOcclusionTest(Now))
+            TestOcclusion();
+
+        HANDLE Handle = nullptr;
+
+        if (_Scheduler.IsFrameDue(Now))
+        {
+            // Render as soon as the swap chain can take the frame. Waiting here instead of in Present keeps the latency at one frame.
+            if (_CanPresent || (_FrameLatencyWaitable == nullptr) || (::WaitForSingleObjectEx(_FrameLatencyWaitable, 0, FALSE) == WAIT_OBJECT_0))
+            {
+                _CanPresent = true;
+
+                Render();
+
+                continue;
+            }
+
+            Handle = _FrameLatencyWaitable;
+        }
+
+        const double Wait = _Scheduler.GetWaitTime(Now);
+
+        DWORD Timeout = (Wait == std::numeric_limits<double>::infinity()) ? INFINITE : (DWORD) std::ceil(Wait * 1000.);
+
+        // Do not rely on the swap chain alone to wake up the loop, e.g. when the device gets removed.
+        if (Handle != nullptr)
+            Timeout = (std::min)(Timeout, (DWORD) 100);
+
+        const DWORD Result = ::MsgWaitForMultipleObjectsEx((Handle != nullptr) ? 1 : 0, &Handle, Timeout, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+
+        if ((Handle != nullptr) && (Result == WAIT_OBJECT_0))
+        {
+            _CanPresent = true;
+
+            Render();
+        }
+    }
+}
+
 /// <summary>
 /// Entry point
 /// </summary>
@@ -511,15 +1143,7 @@ int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int)
             App app;
 
             if (SUCCEEDED(app.Initialize()))
-            {
-                MSG Msg;
-
-                while (::GetMessageW(&Msg, NULL, 0, 0))
-                {
-                    ::TranslateMessage(&Msg);
-                    ::DispatchMessageW(&Msg);
-                }
-            }
+                app.Run();
         }
 
         ::CoUninitialize();
@@ -1,11 +1,19 @@
 
-/** $VER: App.h (2024.01.17) P. Stuer **/
+/** $VER: App.h (2026.10.17) P. Stuer **/
 
 #pragma once
 
 #include "framework.h"
 
+#include "Animation.h"
 #include "Child.h"
+#include "DamageTracker.h"
+#include "DeviceManager.h"
+#include "Direct2DCompositor.h"
+#include "FrameProfiler.h"
+#include "FrameScheduler.h"
+#include "ImageLoader.h"
+#include "ResizeTracker.h"
 
 class App
 {
@@ -14,14 +22,21 @@ public:
     ~App();
 
     HRESULT Initialize();
+    int Run() noexcept;
 
 private:
     static LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
 
     HRESULT Render();
 
+    LRESULT OnPaint();
     LRESULT OnResize(UINT width, UINT height);
+    LRESULT OnEnterSizeMove();
+    LRESULT OnExitSizeMove();
+    LRESULT OnTimer(UINT_PTR timerId);
     LRESULT OnDropFiles(HDROP hDrop);
+    LRESULT OnImageLoaded();
+    LRESULT OnAnimationFrame();
     LRESULT OnKeyDown(WPARAM wParam);
 
     HRESULT CreateDeviceIndependentResources();
@@ -30,12 +45,22 @@ private:
     void DeleteDeviceDependentResources();
 
     void ResizeSwapChain(UINT width, UINT height) noexcept;
+    void EndLiveResize() noexcept;
+    void UpdateFrameInterval() noexcept;
+    HRESULT ExportProfile() noexcept;
+    std::string GetStatistics() const noexcept;
+    void ScheduleAnimationFrame() noexcept;
+    void SynchronizeClock() noexcept;
+    void TestOcclusion() noexcept;
     HRESULT CreateSwapChainBuffers(ID2D1DeviceContext * dc, IDXGISwapChain1 * swapChain) noexcept;
 
-    HRESULT CreatePatternBrush(ID2D1RenderTarget * renderTarget, ID2D1BitmapBrush ** bitmapBrush) const noexcept;
     HRESULT CreateBitmapSource(IWICBitmapSource ** bitmapSource) const noexcept;
+    void GetSourceName(WCHAR * sourceName, size_t size) const noexcept;
     HRESULT CreateBitmap(IWICBitmapSource * bitmapSource, ID2D1RenderTarget * renderTarget, UINT maxWidth, UINT maxHeight, ID2D1Bitmap ** bitmap) const noexcept;
 
+    static HRESULT CreateScreenRaster(IWICBitmapSource * bitmapSource, UINT screenWidth, UINT screenHeight, Raster & raster) noexcept;
+    static void GetScreenSize(UINT & width, UINT & height) noexcept;
+
 private:
     HWND _hWnd;
 
@@ -43,24 +68,43 @@ private:
     WCHAR _FilePath[MAX_PATH];
     WCHAR _Message[256];
 
-    CComPtr<IDXGIDevice> _DXGIDevice;
-    CComPtr<ID2D1Device1> _D2DDevice;
-    CComPtr<IDCompositionDevice> _CompositionDevice;
+    DeviceManager _DeviceManager; // Shared with the child layer
 
-    CComPtr<IDWriteTextFormat> _TextFormat;
+    std::unique_ptr<TextFormat> _TextFormat;
 
     CComPtr<ID2D1DeviceContext> _DC;
     CComPtr<IDXGISwapChain1> _SwapChain;
+    HANDLE _FrameLatencyWaitable;   // Signalled when the swap chain can take another frame
+    bool _CanPresent;               // The waitable object was signalled for a frame that has not been presented yet.
 
-    CComPtr<IDCompositionTarget> _CompositionTarget;
-    CComPtr<IDCompositionVisual> _CompositionVisual;
+    Direct2DCompositor _Compositor;
 
-    CComPtr<ID2D1SolidColorBrush> _SolidBrush;
-    CComPtr<ID2D1BitmapBrush> _BackgroundBrush;
+    std::unique_ptr<Bitmap> _Background;
     CComPtr<IWICBitmapSource> _BitmapSource;
-    CComPtr<ID2D1Bitmap> _Bitmap;
+    std::unique_ptr<Bitmap> _Bitmap;
+    FLOAT _ImageScale; // Size of the image relative to the size of its bitmap. Limits the preview stretch during a live resize.
+
+    ResizeTracker _ResizeTracker;
+    DamageTracker _DamageTracker;
+    FrameProfiler _Profiler;
+    FrameScheduler _Scheduler;
+
+    Child _Child; // Declared after the device manager so that it gets destroyed first.
+
+    std::mutex _LoadedAnimationMutex;
+    std::wstring _LoadedAnimationPath;
+    std::unique_ptr<AnimationSource> _LoadedAnimation; // Opened by the loader of a dropped file; picked up by OnImageLoaded.
+
+    AnimationPlayer _Animation; // Declared after the bitmap members so that its worker has finished before they are destroyed.
+
+    ImageLoader _ImageLoader; // Declared last so that its stages have finished before the other members are destroyed.
 
-    Child _Child;
+    static const UINT WM_IMAGELOADED = WM_APP + 1;
+    static const UINT WM_ANIMATIONFRAME = WM_APP + 2;
+    static const UINT_PTR ResizeTimerId = 1;
+    static const UINT_PTR AnimationTimerId = 2;
+    static const UINT SwapChainFlags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+    static const uint64_t StreamingThreshold = 64 * 1024 * 1024; // Images with more pixels are scaled while they are decoded instead of being decoded as a whole.
 
     const WCHAR * ClassName = L"Compositing";
     const WCHAR * WindowTitle = L"Compositing";
@@ -0,0 +1,124 @@
+
+/** $VER: AnimationBenchmark.cpp (2026.10.17) P. Stuer **/
+
+#include "Benchmark.h"
+
+#include "Animation.h"
+
+#include <stdio.h>
+#include <thread>
+
+/// <summary>
+/// Stands in for the decoder of an animated GIF: a sprite that moves over a static first frame, with a mix of disposal methods.
+/// </summary>
+class SyntheticAnimation : public AnimationSource
+{
+public:
+    SyntheticAnimation(UINT width, UINT height, UINT frameCount) noexcept : _Width(width), _Height(height), _FrameCount(frameCount) { }
+
+    UINT GetWidth() const noexcept override { return _Width; }
+    UINT GetHeight() const noexcept override { return _Height; }
+
+    UINT GetFrameCount() const noexcept override { return _FrameCount; }
+    UINT GetLoopCount() const noexcept override { return 0; }
+
+    HRESULT ReadFrame(UINT index, AnimationFrame & frame, Raster & raster) noexcept override
+    {
+        const UINT Size = (index == 0) ? _Width : 64;
+
+        const int x = (index == 0) ? 0 : (int) ((index * 7) % (_Width - Size));
+        const int y = (index == 0) ? 0 : (int) ((index * 5) % (_Height - Size));
+
+        frame = { { x, y, x + (int) Size, y + (int) ((index == 0) ? _Height : Size) }, 40, (FrameDisposal) (index % 3), FrameBlend::Over };
+
+        HRESULT hr = raster.Initialize((UINT) frame.Rect.Width(), (UINT) frame.Rect.Height());
+
+        if (FAILED(hr))
+            return hr;
+
+        for (UINT j = 0; j < raster.Height(); ++j)
+        {
+            uint32_t * p = (uint32_t *) raster.Row(j);
+
+            for (UINT i = 0; i < raster.Width(); ++i)
+                p[i] = ((i ^ j ^ index) & 8) ? 0xFF000000u | (index * 0x030507u) : 0u; // Half of the sprite is transparent.
+        }
+
+        return S_OK;
+    }
+
+private:
+    UINT _Width;
+    UINT _Height;
+    UINT _FrameCount;
+};
+
+/// <summary>
+/// Measures compositing the frames of an animation, and playing 120 frames of a 640 x 360 animation through the player with the whole animation
+/// resident and streaming through a ring of 8 frames. The clock is simulated: it jumps to the deadline of the next frame as soon as a frame
+/// is shown, so the measurement shows how fast the worker keeps the ring filled.
+/// </summary>
+BENCHMARK(Animation)
+{
+    const UINT Width = 640, Height = 360, FrameCount = 120;
+
+    {
+        SyntheticAnimation Source(Width, Height, FrameCount);
+
+        AnimationCanvas Canvas;
+        Raster Pixels;
+
+        if (FAILED(Canvas.Initialize(Width, Height)))
+            return;
+
+        UINT Index = 0;
+
+        benchmark.Measure("Compose frame", (size_t) Width * Height * 4, [&]()
+        {
+            AnimationFrame Frame;
+
+            if (Index == 0)
+                Canvas.Reset();
+
+            if (SUCCEEDED(Source.ReadFrame(Index, Frame, Pixels)))
+                Canvas.Compose(Frame, Pixels);
+
+            Index = (Index + 1) % FrameCount;
+        });
+    }
+
+    for (const bool IsResident : { true, false })
+    {
+        const std::string Name = IsResident ? "resident" : "streaming";
+
+        AnimationPlayer Player(nullptr);
+        AnimationStatistics Statistics = { };
+
+        benchmark.Measure("Play 120 frames, " + Name, (size_t) Width * Height * 4 * FrameCount, [&]()
+        {
+            if (FAILED(Player.Open(std::make_unique<SyntheticAnimation>(Width, Height, FrameCount), AnimationPlayer::DefaultDecodeAhead, IsResident ? (size_t) 256 * 1024 * 1024 : (size_t) 16 * 1024 * 1024)))
+                return;
+
+            double Now = 0.;
+
+            while (Player.GetStatistics().Presented < FrameCount)
+            {
+                if (Player.Update(Now))
+                    Now = Player.GetDeadline();
+                else
+                    std::this_thread::yield();
+            }
+
+            Statistics = Player.GetStatistics();
+
+            Player.Close();
+        }, 5);
+
+        char Text[160];
+
+        ::snprintf(Text, sizeof(Text), "%u of %u frames held, %.1f MB, %llu underruns, %llu dropped", Statistics.Capacity, Statistics.FrameCount, (double) Statistics.MemoryUsage / 1048576.,
+            (unsigned long long) Statistics.Underruns, (unsigned long long) Statistics.Dropped);
+
+        benchmark.Comment("Memory, " + Name, Text);
+    }
+}
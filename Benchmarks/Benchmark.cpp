@@ -0,0 +1,208 @@
+
+/** $VER: Benchmark.cpp (2026.10.17) P. Stuer **/
+
+#include "Benchmark.h"
+
+#include "CPU.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <new>
+#include <thread>
+
+/// <summary>
+/// Runs the code the configured number of times, at most maxIterations, and records the best, median and mean time.
+/// In text mode it prints the best time and, if the number of bytes is known, the throughput.
+/// </summary>
+void Benchmark::Measure(const std::string & name, size_t bytes, const std::function<void()> & code, UINT maxIterations) noexcept
+{
+    if (!IsSelected(name))
+        return;
+
+    code(); // Warm up the caches and the branch predictors.
+
+    const UINT Iterations = (std::max)((std::min)(_Iterations, maxIterations), 1u);
+
+    std::vector<double> Times;
+
+    try
+    {
+        Times.reserve(Iterations);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return;
+    }
+
+    for (UINT i = 0; i < Iterations; ++i)
+    {
+        const auto Start = std::chrono::steady_clock::now();
+
+        code();
+
+        Times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count());
+    }
+
+    std::sort(Times.begin(), Times.end());
+
+    double Sum = 0.;
+
+    for (double t : Times)
+        Sum += t;
+
+    const double Best = Times[0];
+    const double Median = Times[Times.size() / 2];
+
+    try
+    {
+        _Results.push_back({ _Group, name, Iterations, bytes, Best, Median, Sum / (double) Iterations });
+    }
+    catch (const std::bad_alloc &)
+    {
+    }
+
+    if (_Format != BenchmarkFormat::Text)
+        return;
+
+    if (bytes == 0)
+    {
+        ::printf("%-48s %10.3f ms\n", name.c_str(), Best * 1e3);
+
+        return;
+    }
+
+    const double GBps = (Best > 0.) ? ((double) bytes / Best) / 1e9 : 0.;
+
+    ::printf("%-48s %10.3f ms %10.2f GB/s\n", name.c_str(), Best * 1e3, GBps);
+}
+
+/// <summary>
+/// Prints additional information about a benchmark, e.g. counters. Goes to stderr when the output is machine-readable.
+/// </summary>
+void Benchmark::Comment(const std::string & name, const std::string & text) noexcept
+{
+    if (!IsSelected(name))
+        return;
+
+    ::fprintf((_Format == BenchmarkFormat::Text) ? stdout : stderr, "%-48s %s\n", name.c_str(), text.c_str());
+}
+
+/// <summary>
+/// Registers a benchmark. Called by the BENCHMARK macro during static initialization.
+/// </summary>
+int Benchmark::Register(const char * name, Function function) noexcept
+{
+    GetEntries().push_back({ name, function });
+
+    return (int) GetEntries().size();
+}
+
+/// <summary>
+/// Runs the registered benchmarks. Usage: Benchmarks [--format=text|csv|json] [--iterations=n] [filter] [iterations]
+/// </summary>
+int Benchmark::Run(int argc, char * argv[]) noexcept
+{
+    const char * Filter = nullptr;
+    UINT Iterations = 10;
+    BenchmarkFormat Format = BenchmarkFormat::Text;
+
+    int Position = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char * Arg = argv[i];
+
+        if (::strcmp(Arg, "--format=text") == 0)
+            Format = BenchmarkFormat::Text;
+        else
+        if (::strcmp(Arg, "--format=csv") == 0)
+            Format = BenchmarkFormat::CSV;
+        else
+        if (::strcmp(Arg, "--format=json") == 0)
+            Format = BenchmarkFormat::JSON;
+        else
+        if (::strncmp(Arg, "--iterations=", 13) == 0)
+            Iterations = (UINT) (std::max)(1, ::atoi(Arg + 13));
+        else
+        if (::strncmp(Arg, "--", 2) == 0)
+        {
+            ::fprintf(stderr, "Usage: %s [--format=text|csv|json] [--iterations=n] [filter] [iterations]\n", argv[0]);
+
+            return 1;
+        }
+        else
+        if (Position++ == 0)
+            Filter = Arg;
+        else
+            Iterations = (UINT) (std::max)(1, ::atoi(Arg));
+    }
+
+    std::vector<BenchmarkResult> Results;
+
+    // The registration order depends on the link order.
+    std::sort(GetEntries().begin(), GetEntries().end(), [](const Entry & a, const Entry & b) { return ::strcmp(a.Name, b.Name) < 0; });
+
+    for (const auto & Entry : GetEntries())
+    {
+        // The filter selects either a complete benchmark or the measurements with a matching name.
+        const bool IsSelected = (Filter == nullptr) || (::strstr(Entry.Name, Filter) != nullptr);
+
+        Benchmark Context(Entry.Name, IsSelected ? nullptr : Filter, Iterations, Format, Results);
+
+        if (Format == BenchmarkFormat::Text)
+            ::printf("[%s]\n", Entry.Name);
+
+        Entry.Code(Context);
+    }
+
+    Print(Results, Format);
+
+    return 0;
+}
+
+/// <summary>
+/// Gets the registered benchmarks.
+/// </summary>
+std::vector<Benchmark::Entry> & Benchmark::GetEntries() noexcept
+{
+    static std::vector<Entry> Entries;
+
+    return Entries;
+}
+
+/// <summary>
+/// Prints the results in a machine-readable format. Times are in milliseconds, throughput in GB/s.
+/// </summary>
+void Benchmark::Print(const std::vector<BenchmarkResult> & results, BenchmarkFormat format) noexcept
+{
+    if (format == BenchmarkFormat::CSV)
+    {
+        ::printf("Benchmark,Measurement,Iterations,Bytes,Best,Median,Mean,Throughput\n");
+
+        for (const auto & r : results)
+        {
+            const double GBps = ((r.Bytes != 0) && (r.Best > 0.)) ? ((double) r.Bytes / r.Best) / 1e9 : 0.;
+
+            ::printf("%s,\"%s\",%u,%llu,%.6f,%.6f,%.6f,%.3f\n", r.Group.c_str(), r.Name.c_str(), r.Iterations, (unsigned long long) r.Bytes, r.Best * 1e3, r.Median * 1e3, r.Mean * 1e3, GBps);
+        }
+    }
+    else
+    if (format == BenchmarkFormat::JSON)
+    {
+        ::printf("{\n  \"machine\": { \"instructionSet\": \"%s\", \"threads\": %u },\n  \"results\": [\n", CPU::GetName(CPU::GetInstructionSet()), std::thread::hardware_concurrency());
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const auto & r = results[i];
+
+            const double GBps = ((r.Bytes != 0) && (r.Best > 0.)) ? ((double) r.Bytes / r.Best) / 1e9 : 0.;
+
+            ::printf("    { \"benchmark\": \"%s\", \"measurement\": \"%s\", \"iterations\": %u, \"bytes\": %llu, \"best\": %.6f, \"median\": %.6f, \"mean\": %.6f, \"throughput\": %.3f }%s\n",
+                r.Group.c_str(), r.Name.c_str(), r.Iterations, (unsigned long long) r.Bytes, r.Best * 1e3, r.Median * 1e3, r.Mean * 1e3, GBps, (i + 1 < results.size()) ? "," : "");
+        }
+
+        ::printf("  ]\n}\n");
+    }
+}
@@ -0,0 +1,80 @@
+
+/** $VER: Benchmark.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Identifies the output format of the benchmark runner.
+/// </summary>
+enum class BenchmarkFormat
+{
+    Text,       // A line per measurement, printed as soon as it is known
+    CSV,        // A line per measurement, printed when all benchmarks have run
+    JSON,       // The machine and all measurements, printed when all benchmarks have run
+};
+
+/// <summary>
+/// Contains the timing of a measurement, in seconds.
+/// </summary>
+struct BenchmarkResult
+{
+    std::string Group;      // Name of the benchmark
+    std::string Name;       // Name of the measurement
+    UINT Iterations;
+    size_t Bytes;           // Bytes processed by one iteration, 0 if not applicable
+    double Best;
+    double Median;
+    double Mean;
+};
+
+/// <summary>
+/// Runs a piece of code repeatedly and reports the best time and the throughput.
+/// </summary>
+class Benchmark
+{
+public:
+    typedef void (* Function)(Benchmark & benchmark);
+
+    Benchmark(const char * group, const char * filter, UINT iterations, BenchmarkFormat format, std::vector<BenchmarkResult> & results) : _Group(group), _Filter(filter), _Iterations(iterations), _Format(format), _Results(results) { }
+
+    void Measure(const std::string & name, size_t bytes, const std::function<void()> & code, UINT maxIterations = ~0u) noexcept;
+    void Comment(const std::string & name, const std::string & text) noexcept;
+
+    bool IsSelected(const std::string & name) const noexcept { return (_Filter == nullptr) || (name.find(_Filter) != std::string::npos); }
+
+    static int Register(const char * name, Function function) noexcept;
+    static int Run(int argc, char * argv[]) noexcept;
+
+private:
+    struct Entry
+    {
+        const char * Name;
+        Function Code;
+    };
+
+    static std::vector<Entry> & GetEntries() noexcept;
+
+    static void Print(const std::vector<BenchmarkResult> & results, BenchmarkFormat format) noexcept;
+
+private:
+    const char * _Group;
+    const char * _Filter;
+    UINT _Iterations;
+    BenchmarkFormat _Format;
+    std::vector<BenchmarkResult> & _Results;
+};
+
+/// <summary>
+/// Defines and registers a benchmark.
+/// </summary>
+#define BENCHMARK(name) \
+    static void Benchmark_##name(Benchmark & benchmark); \
+    static const int Benchmark_##name##_Registered = Benchmark::Register(#name, Benchmark_##name); \
+    static void Benchmark_##name(Benchmark & benchmark)
@@ -0,0 +1,84 @@
+
+/** $VER: DamageBenchmark.cpp (2026.10.17) P. Stuer **/
+
+#include "Benchmark.h"
+
+#include "HeadlessRenderer.h"
+#include "Raster.h"
+
+/// <summary>
+/// Fills a raster with a solid premultiplied color.
+/// </summary>
+static HRESULT CreateSolid(Raster & raster, UINT width, UINT height, uint32_t color) noexcept
+{
+    HRESULT hr = raster.Initialize(width, height);
+
+    if (SUCCEEDED(hr))
+    {
+        for (UINT y = 0; y < height; ++y)
+        {
+            uint32_t * p = (uint32_t *) raster.Row(y);
+
+            for (UINT x = 0; x < width; ++x)
+                p[x] = color;
+        }
+    }
+
+    return hr;
+}
+
+/// <summary>
+/// Measures a full redraw of a 1920 x 1080 headless frame versus a redraw of only the area damaged by swapping the image or the child image.
+/// Throughput is expressed in target bytes per second, so the partial redraws show the speed-up at equal work.
+/// </summary>
+BENCHMARK(Damage)
+{
+    const UINT Width = 1920, Height = 1080;
+
+    Raster Image1, Image2, Child1, Child2;
+
+    if (FAILED(CreateSolid(Image1, 800, 600, 0xFF2040C0)) || FAILED(CreateSolid(Image2, 600, 800, 0xFFC04020)) ||
+        FAILED(CreateSolid(Child1, 256, 256, 0x80008000)) || FAILED(CreateSolid(Child2, 256, 256, 0x80800000)))
+        return;
+
+    HeadlessRenderer Renderer;
+
+    if (FAILED(Renderer.Initialize(Width, Height)))
+        return;
+
+    Renderer.SetImage(Image1);
+    Renderer.SetChildImage(Child1);
+    Renderer.SetMessage(L"Damage benchmark");
+    Renderer.Render();
+
+    const size_t Bytes = (size_t) Width * Height * 4;
+
+    benchmark.Measure("Full redraw", Bytes, [&]()
+    {
+        Renderer.Invalidate();
+        Renderer.Render();
+    });
+
+    bool Toggle = false;
+
+    benchmark.Measure("Image swap", Bytes, [&]()
+    {
+        Toggle = !Toggle;
+
+        Renderer.SetImage(Toggle ? Image2 : Image1);
+        Renderer.Render();
+    });
+
+    benchmark.Measure("Child image swap", Bytes, [&]()
+    {
+        Toggle = !Toggle;
+
+        Renderer.SetChildImage(Toggle ? Child2 : Child1);
+        Renderer.Render();
+    });
+
+    benchmark.Measure("Unchanged frame", Bytes, [&]()
+    {
+        Renderer.Render();
+    });
+}
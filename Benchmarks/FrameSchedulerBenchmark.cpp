@@ -0,0 +1,134 @@
+
+/** $VER: FrameSchedulerBenchmark.cpp (2026.10.17) P. Stuer **/
+
+#include "Benchmark.h"
+
+#include "FrameScheduler.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+
+/// <summary>
+/// Contains the outcome of a simulated session.
+/// </summary>
+struct SessionResult
+{
+    uint64_t Frames;
+    uint64_t Wakeups;           // Times the message loop woke up
+    uint64_t Missed;
+    double MaxLatency;          // Longest time between an invalidation and the start of the frame that shows it, in seconds
+    double Busy;                // Fraction of the session spent rendering
+};
+
+/// <summary>
+/// Simulates 10 seconds of a window on a 60 Hz display with a simulated clock: 3 seconds idle, 2 seconds of input at 125 Hz (e.g. a mouse drag),
+/// 1 second idle and 4 seconds of a 24 fps animation. A frame takes 3 ms, every 50th frame 20 ms.
+/// </summary>
+static SessionResult Simulate(bool isScheduled) noexcept
+{
+    const double Duration = 10., Interval = 1. / 60., FrameRate = 24.;
+
+    std::vector<double> Inputs;
+
+    for (double t = 3.; t < 5.; t += 1. / 125.)
+        Inputs.push_back(t);
+
+    FrameScheduler Scheduler;
+
+    Scheduler.SetFrameInterval(Interval);
+    Scheduler.ScheduleTick(6.);
+
+    SessionResult Result = { };
+
+    double Now = 0.;
+    double Pending = -1.; // Time of the oldest invalidation that has not been shown yet
+    size_t i = 0;
+
+    while (Now < Duration)
+    {
+        ++Result.Wakeups;
+
+        for (; (i < Inputs.size()) && (Inputs[i] <= Now); ++i)
+        {
+            Scheduler.Invalidate();
+
+            if (Pending < 0.)
+                Pending = Inputs[i];
+        }
+
+        if (Scheduler.TakeTick(Now))
+        {
+            Scheduler.Invalidate();
+
+            if (Pending < 0.)
+                Pending = Now;
+
+            const double Next = 6. + std::floor((Now - 6.) * FrameRate + 1.) / FrameRate;
+
+            if (Next < Duration)
+                Scheduler.ScheduleTick(Next);
+        }
+
+        if (!isScheduled || Scheduler.IsFrameDue(Now))
+        {
+            Scheduler.BeginFrame(Now);
+
+            if (Pending >= 0.)
+                Result.MaxLatency = (std::max)(Result.MaxLatency, Now - Pending);
+
+            Pending = -1.;
+
+            const double Cost = ((Result.Frames % 50) == 49) ? .020 : .003;
+
+            Now += Cost;
+            Result.Busy += Cost;
+
+            Scheduler.EndFrame(Now);
+
+            ++Result.Frames;
+
+            if (isScheduled)
+                continue;
+        }
+
+        // Without a scheduler the loop only wakes up at vsync and picks up the input that arrived in between.
+        double Next = isScheduled ? Now + Scheduler.GetWaitTime(Now) : Scheduler.GetClock().GetNextVsync(Now);
+
+        if (isScheduled && (i < Inputs.size()))
+            Next = (std::min)(Next, Inputs[i]);
+
+        Now = (std::min)(Next, Duration);
+    }
+
+    Result.Missed = Scheduler.GetStatistics().Missed;
+    Result.Busy /= Duration;
+
+    return Result;
+}
+
+/// <summary>
+/// Compares rendering every vsync with the frame scheduler over a simulated session: frames rendered, wake-ups of the message loop,
+/// missed deadlines and the latency between a change and the frame that shows it.
+/// </summary>
+BENCHMARK(FrameScheduler)
+{
+    for (const bool IsScheduled : { false, true })
+    {
+        const std::string Name = IsScheduled ? "scheduled" : "every vsync";
+
+        SessionResult Result = { };
+
+        benchmark.Measure("Session 10 s, " + Name, 0, [&]()
+        {
+            Result = Simulate(IsScheduled);
+        });
+
+        char Text[192];
+
+        ::snprintf(Text, sizeof(Text), "%llu frames, %llu wake-ups, %llu missed, %.1f ms maximum latency, %.1f%% busy", (unsigned long long) Result.Frames, (unsigned long long) Result.Wakeups,
+            (unsigned long long) Result.Missed, Result.MaxLatency * 1e3, Result.Busy * 100.);
+
+        benchmark.Comment("Frames, " + Name, Text);
+    }
+}
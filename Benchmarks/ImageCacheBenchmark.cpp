@@ -0,0 +1,77 @@
+
+/** $VER: ImageCacheBenchmark.cpp (2026.10.17) P. Stuer **/
+
+#include "Benchmark.h"
+
+#include "ImageCache.h"
+
+#include <stdio.h>
+
+/// <summary>
+/// Simulates an interactive resize of a window showing a 12 MP image: 60 frames that shrink and grow the window and fit the image to it.
+/// Compares decoding and scaling every frame with going through the image cache.
+/// </summary>
+BENCHMARK(ImageCache)
+{
+    const UINT Width = 4000, Height = 3000;
+
+    // Stands in for the decoder: produces a 12 MP image.
+    const ImageCache::Loader Loader = [](Raster & raster)
+    {
+        HRESULT hr = raster.Initialize(Width, Height);
+
+        if (SUCCEEDED(hr))
+        {
+            for (UINT y = 0; y < Height; ++y)
+                ::memset(raster.Row(y), (int) (y & 0xFF), (size_t) Width * 4);
+        }
+
+        return hr;
+    };
+
+    // Window sizes during the drag.
+    std::vector<std::pair<UINT, UINT>> Sizes;
+
+    for (UINT i = 0; i < 60; ++i)
+    {
+        const UINT Step = (i < 30) ? i : 59 - i;
+
+        Sizes.push_back({ 1600 - Step * 16, 1000 - Step * 10 });
+    }
+
+    benchmark.Measure("Resize without cache (60 frames)", 0, [&]()
+    {
+        for (const auto & Size : Sizes)
+        {
+            Raster Decoded, Scaled;
+
+            if (SUCCEEDED(Loader(Decoded)))
+                Scaler::Fit(Decoded, Scaled, Size.first, Size.second);
+        }
+    });
+
+    ImageCache Cache;
+
+    benchmark.Measure("Resize with cache (60 frames)", 0, [&]()
+    {
+        Cache.Clear();
+        Cache.ResetStatistics();
+
+        for (const auto & Size : Sizes)
+        {
+            std::shared_ptr<const Raster> Image;
+
+            Cache.Fit(L"Image", Size.first, Size.second, Width, Height, Loader, Image);
+        }
+    });
+
+    const ImageCacheStatistics Statistics = Cache.GetStatistics();
+
+    char Text[128];
+
+    ::snprintf(Text, sizeof(Text), "%llu hits, %llu level hits, %llu misses, %llu evictions, %u images, %.1f MB",
+        (unsigned long long) Statistics.Hits, (unsigned long long) Statistics.LevelHits, (unsigned long long) Statistics.Misses, (unsigned long long) Statistics.Evictions,
+        Statistics.Count, (double) Statistics.Size / (1024. * 1024.));
+
+    benchmark.Comment("Cache statistics", Text);
+}
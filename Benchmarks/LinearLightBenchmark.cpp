@@ -0,0 +1,145 @@
+
+/** $VER: LinearLightBenchmark.cpp (2026.10.17) P. Stuer **/
+
+#include "Benchmark.h"
+
+#include "Blender.h"
+#include "LinearLight.h"
+#include "Raster.h"
+#include "Scaler.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+
+/// <summary>
+/// Measures the cost of working in linear light: the conversions of a 12 MP image with each instruction set, fitting it to 1920 x 1080 in sRGB and
+/// in linear light, and blending the translucent spotlight over a 1920 x 1080 target in both spaces.
+/// Also shows what it buys: the gray a black and white checkerboard averages to, and the result of 50% white over black.
+/// </summary>
+BENCHMARK(LinearLight)
+{
+    const UINT Width = 4000, Height = 3000;
+
+    Raster Src, Dst;
+
+    if (FAILED(Src.Initialize(Width, Height)))
+        return;
+
+    uint32_t Seed = 0x12345678;
+
+    for (UINT y = 0; y < Height; ++y)
+    {
+        uint32_t * p = (uint32_t *) Src.Row(y);
+
+        for (UINT x = 0; x < Width; ++x)
+        {
+            Seed = Seed * 1664525u + 1013904223u;
+
+            const uint32_t c = (x ^ y) & 0xFF;
+
+            p[x] = 0xFF000000u | ((c * 0x010101u) ^ ((Seed >> 24) & 0x0F));
+        }
+    }
+
+    {
+        std::vector<uint16_t> Linear((size_t) Width * 4);
+
+        const InstructionSet Saved = LinearLight::GetInstructionSet();
+
+        for (InstructionSet Set : { InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX2 })
+        {
+            if (Set > CPU::GetInstructionSet())
+                continue;
+
+            const LinearLight::DecodeFunction Decode = LinearLight::GetDecodeFunction(Set);
+            const LinearLight::EncodeFunction Encode = LinearLight::GetEncodeFunction(Set);
+
+            benchmark.Measure(std::string("Decode ") + CPU::GetName(Set), Src.Size(), [&]()
+            {
+                for (UINT y = 0; y < Height; ++y)
+                    Decode((const uint32_t *) Src.Row(y), Linear.data(), Width);
+            });
+
+            Decode((const uint32_t *) Src.Row(0), Linear.data(), Width);
+
+            benchmark.Measure(std::string("Encode ") + CPU::GetName(Set), Src.Size(), [&]()
+            {
+                for (UINT y = 0; y < Height; ++y)
+                    Encode(Linear.data(), (uint32_t *) Src.Row(y), Width);
+            });
+        }
+
+        LinearLight::SetInstructionSet(Saved);
+    }
+
+    // Throughput in source bytes per second, like the scaler benchmark.
+    for (ScaleFilter Filter : { ScaleFilter::Box, ScaleFilter::Lanczos3 })
+    {
+        const std::string Name = (Filter == ScaleFilter::Box) ? "Box" : "Lanczos3";
+
+        benchmark.Measure(Name + " fit, sRGB", Src.Size(), [&]()
+        {
+            Scaler::Fit(Src, Dst, 1920, 1080, Filter);
+        });
+
+        benchmark.Measure(Name + " fit, linear", Src.Size(), [&]()
+        {
+            Scaler::Fit(Src, Dst, 1920, 1080, Filter, nullptr, ColorSpace::Linear);
+        });
+    }
+
+    // The spotlight of the main window: a light blue at 25% opacity, over the opaque background.
+    {
+        const Color Spotlight = { .75f, .75f, 1.f, .25f };
+
+        Raster Target;
+
+        if (FAILED(Target.Initialize(1920, 1080)))
+            return;
+
+        for (const bool IsLinear : { false, true })
+        {
+            const Blender::FillFunction Fill = IsLinear ? LinearLight::GetFillFunction(LinearLight::GetInstructionSet()) : Blender::GetFillFunction(Blender::GetInstructionSet());
+
+            for (UINT y = 0; y < Target.Height(); ++y)
+                std::fill((uint32_t *) Target.Row(y), (uint32_t *) Target.Row(y) + Target.Width(), 0xFF404040u);
+
+            benchmark.Measure(IsLinear ? "Spotlight, linear" : "Spotlight, sRGB", Target.Size(), [&]()
+            {
+                for (UINT y = 0; y < Target.Height(); ++y)
+                    Fill(Spotlight.ToPBGRA(), (uint32_t *) Target.Row(y), Target.Width());
+            });
+        }
+    }
+
+    // Accuracy: a 1-pixel black and white checkerboard halved with the box filter, and white at 50% opacity over black.
+    {
+        Raster Checkerboard, Halved[2];
+
+        if (FAILED(Checkerboard.Initialize(64, 64)))
+            return;
+
+        for (UINT y = 0; y < 64; ++y)
+        {
+            uint32_t * p = (uint32_t *) Checkerboard.Row(y);
+
+            for (UINT x = 0; x < 64; ++x)
+                p[x] = ((x ^ y) & 1) ? 0xFFFFFFFFu : 0xFF000000u;
+        }
+
+        if (FAILED(Scaler::Scale(Checkerboard, Halved[0], 32, 32, ScaleFilter::Box)) || FAILED(Scaler::Scale(Checkerboard, Halved[1], 32, 32, ScaleFilter::Box, nullptr, ColorSpace::Linear)))
+            return;
+
+        uint32_t Blend[2] = { 0xFF000000u, 0xFF000000u };
+
+        Blender::GetFillFunction(Blender::GetInstructionSet())(0x80808080u, &Blend[0], 1);
+        LinearLight::GetFillFunction(LinearLight::GetInstructionSet())(0x80808080u, &Blend[1], 1);
+
+        char Text[160];
+
+        ::snprintf(Text, sizeof(Text), "Checkerboard halved: %u in sRGB, %u in linear light (188 is correct). 50%% white over black: %u, %u", (UINT) *Halved[0].Row(0), (UINT) *Halved[1].Row(0), Blend[0] & 0xFF, Blend[1] & 0xFF);
+
+        benchmark.Comment("Accuracy", Text);
+    }
+}
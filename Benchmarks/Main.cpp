@@ -0,0 +1,12 @@
+
+/** $VER: Main.cpp (2026.10.17) P. Stuer **/
+
+#include "Benchmark.h"
+
+/// <summary>
+/// Entry point of the benchmark runner.
+/// </summary>
+int main(int argc, char * argv[])
+{
+    return Benchmark::Run(argc, argv);
+}
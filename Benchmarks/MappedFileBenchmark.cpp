@@ -0,0 +1,143 @@
+
+/** $VER: MappedFileBenchmark.cpp (2026.10.17) P. Stuer **/
+
+#include "Benchmark.h"
+
+#include "MappedFile.h"
+
+#include <stdio.h>
+
+#include <filesystem>
+
+/// <summary>
+/// Adds up the 64-bit words of a block of memory. Stands in for a decoder that reads every byte of the file once.
+/// </summary>
+static uint64_t Consume(const BYTE * data, size_t size) noexcept
+{
+    uint64_t Sum = 0;
+
+    for (size_t i = 0; i + 8 <= size; i += 8)
+    {
+        uint64_t Word;
+
+        ::memcpy(&Word, data + i, 8);
+
+        Sum += Word;
+    }
+
+    return Sum;
+}
+
+/// <summary>
+/// Compares reading a file into a buffer with mapping it, for files the size of compressed 12 MP and 100 MP images and of an uncompressed 100 MP image.
+/// Measures the time until the first 64 kB are available to the decoder and the time to consume the complete file. The files are in the file cache,
+/// so the difference is the copy from the file cache into the buffer and the memory of the buffer itself.
+/// </summary>
+BENCHMARK(MappedFile)
+{
+    struct FileSize
+    {
+        const char * Name;
+        size_t Size;
+    };
+
+    const FileSize Sizes[] =
+    {
+        { "8 MB",    8 * 1024 * 1024 },
+        { "48 MB",  48 * 1024 * 1024 },
+        { "400 MB", 400 * 1024 * 1024 },
+    };
+
+    std::error_code ErrorCode;
+
+    const std::filesystem::path FilePath = std::filesystem::temp_directory_path(ErrorCode) / "MappedFileBenchmark.bin";
+
+    if (ErrorCode)
+        return;
+
+    std::vector<BYTE> Buffer;
+
+    for (const FileSize & s : Sizes)
+    {
+        const std::string Suffix = std::string(" ") + s.Name;
+
+        if (!benchmark.IsSelected("Read" + Suffix) && !benchmark.IsSelected("Map" + Suffix) && !benchmark.IsSelected("First 64 kB"))
+            continue;
+
+        // Write the file in chunks of 1 MB.
+        {
+            FILE * fp = ::fopen(FilePath.string().c_str(), "wb");
+
+            if (fp == nullptr)
+                return;
+
+            std::vector<BYTE> Chunk(1024 * 1024);
+
+            for (size_t i = 0; i < Chunk.size(); ++i)
+                Chunk[i] = (BYTE) (i * 2654435761u >> 24);
+
+            for (size_t Written = 0; Written < s.Size; Written += Chunk.size())
+                ::fwrite(Chunk.data(), 1, Chunk.size(), fp);
+
+            ::fclose(fp);
+        }
+
+        const std::wstring Path = FilePath.wstring();
+
+        volatile uint64_t Sum = 0;
+
+        benchmark.Measure("First 64 kB read" + Suffix, 0, [&]()
+        {
+            FILE * fp = ::fopen(FilePath.string().c_str(), "rb");
+
+            if (fp == nullptr)
+                return;
+
+            BYTE Head[65536];
+
+            const size_t Read = ::fread(Head, 1, sizeof(Head), fp);
+
+            Sum = Sum + Consume(Head, Read);
+
+            ::fclose(fp);
+        });
+
+        benchmark.Measure("First 64 kB mapped" + Suffix, 0, [&]()
+        {
+            MappedFile File;
+
+            if (SUCCEEDED(File.Open(Path.c_str())))
+                Sum = Sum + Consume(File.Data(), (std::min)(File.Size(), (size_t) 65536));
+        });
+
+        benchmark.Measure("Read" + Suffix, s.Size, [&]()
+        {
+            FILE * fp = ::fopen(FilePath.string().c_str(), "rb");
+
+            if (fp == nullptr)
+                return;
+
+            Buffer.resize(s.Size);
+            Buffer.shrink_to_fit(); // Like a loader that allocates a buffer per file.
+
+            const size_t Read = ::fread(Buffer.data(), 1, Buffer.size(), fp);
+
+            Sum = Sum + Consume(Buffer.data(), Read);
+
+            ::fclose(fp);
+
+            Buffer.clear();
+            Buffer.shrink_to_fit();
+        });
+
+        benchmark.Measure("Map" + Suffix, s.Size, [&]()
+        {
+            MappedFile File;
+
+            if (SUCCEEDED(File.Open(Path.c_str())))
+                Sum = Sum + Consume(File.Data(), File.Size());
+        });
+    }
+
+    std::filesystem::remove(FilePath, ErrorCode);
+}
@@ -0,0 +1,86 @@
+
+/** $VER: MipmapBenchmark.cpp (2026.10.17) P. Stuer **/
+
+#include "Benchmark.h"
+
+#include "Mipmap.h"
+#include "Raster.h"
+#include "Scaler.h"
+
+/// <summary>
+/// Measures building the mip chain of a 12 MP image with each instruction set, and fitting the image to a range of window sizes
+/// from the full image versus from the nearest larger level. Throughput is expressed in source bytes per second.
+/// </summary>
+BENCHMARK(Mipmap)
+{
+    const UINT Width = 4000, Height = 3000;
+
+    auto Src = std::make_shared<Raster>();
+
+    if (FAILED(Src->Initialize(Width, Height)))
+        return;
+
+    uint32_t Seed = 0x12345678;
+
+    for (UINT y = 0; y < Height; ++y)
+    {
+        uint32_t * p = (uint32_t *) Src->Row(y);
+
+        for (UINT x = 0; x < Width; ++x)
+        {
+            Seed = Seed * 1664525u + 1013904223u;
+
+            const uint32_t c = (x ^ y) & 0xFF;
+
+            p[x] = 0xFF000000u | ((c * 0x010101u) ^ ((Seed >> 24) & 0x0F));
+        }
+    }
+
+    const InstructionSet InstructionSets[] = { InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX2 };
+
+    const InstructionSet Saved = Mipmap::GetInstructionSet();
+
+    Mipmap Levels;
+
+    for (InstructionSet Set : InstructionSets)
+    {
+        if (Set > CPU::GetInstructionSet())
+            continue;
+
+        Mipmap::SetInstructionSet(Set);
+
+        benchmark.Measure(std::string("Build ") + CPU::GetName(Set), Src->Size(), [&]()
+        {
+            Levels.Build(Src);
+        });
+    }
+
+    Mipmap::SetInstructionSet(Saved);
+
+    Levels.Build(Src);
+
+    struct Size
+    {
+        UINT Width;
+        UINT Height;
+    };
+
+    const Size Sizes[] = { { 2560, 1440 }, { 1920, 1080 }, { 1280, 720 }, { 640, 480 } };
+
+    Raster Dst;
+
+    for (const auto & s : Sizes)
+    {
+        const std::string Name = std::to_string(s.Width) + " x " + std::to_string(s.Height);
+
+        benchmark.Measure("Fit " + Name + " from image", Src->Size(), [&]()
+        {
+            Scaler::Fit(*Src, Dst, s.Width, s.Height);
+        });
+
+        benchmark.Measure("Fit " + Name + " from level", Src->Size(), [&]()
+        {
+            Levels.Fit(Dst, s.Width, s.Height);
+        });
+    }
+}
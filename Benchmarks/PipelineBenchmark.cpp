@@ -0,0 +1,190 @@
+
+/** $VER: PipelineBenchmark.cpp (2026.10.17) P. Stuer **/
+
+#include "Benchmark.h"
+
+#include "Blender.h"
+#include "Mipmap.h"
+#include "PixelConverter.h"
+#include "Raster.h"
+#include "Scaler.h"
+
+#include <memory>
+
+/// <summary>
+/// Fills a raster with a gradient and some noise so that the pixel data is not trivially compressible or constant.
+/// </summary>
+static void FillImage(Raster & raster) noexcept
+{
+    const UINT BytesPerPixel = raster.BitsPerPixel() / 8;
+
+    uint32_t Seed = 0x12345678;
+
+    for (UINT y = 0; y < raster.Height(); ++y)
+    {
+        BYTE * p = raster.Row(y);
+
+        for (UINT x = 0; x < raster.Width(); ++x)
+        {
+            Seed = Seed * 1664525u + 1013904223u;
+
+            for (UINT i = 0; i < BytesPerPixel; ++i)
+                p[i] = (BYTE) ((x + y * (i + 1)) ^ (Seed >> (24 - i * 2)));
+
+            p += BytesPerPixel;
+        }
+    }
+}
+
+/// <summary>
+/// Measures the stages of the image pipeline, in isolation and end to end, from a decoded image to a frame: allocating the raster, converting
+/// the decoded pixels to premultiplied BGRA, building the mip chain, fitting the image to a 1920 x 1080 window and blending it onto the back buffer.
+/// The decoded image is either 24bpp BGR, as produced by JPEG, or 32bpp straight BGRA, as produced by PNG with alpha.
+/// Throughput is expressed in bytes of the premultiplied source image per second.
+/// </summary>
+BENCHMARK(Pipeline)
+{
+    struct ImageSize
+    {
+        const char * Name;
+        UINT Width;
+        UINT Height;
+    };
+
+    const ImageSize Sizes[] =
+    {
+        { "1 MP",    1152,  864 },
+        { "12 MP",   4000, 3000 },
+        { "48 MP",   8000, 6000 },
+        { "100 MP", 11552, 8664 },
+    };
+
+    struct ImageFormat
+    {
+        const char * Name;
+        PixelFormat Layout;
+    };
+
+    const ImageFormat Formats[] =
+    {
+        { "BGR24",  PixelFormat::BGR24 },
+        { "BGRA32", PixelFormat::BGRA32 },
+    };
+
+    const UINT WindowWidth = 1920, WindowHeight = 1080;
+
+    Raster BackBuffer;
+
+    if (FAILED(BackBuffer.Initialize(WindowWidth, WindowHeight)))
+        return;
+
+    for (const ImageSize & s : Sizes)
+    {
+        const size_t Bytes = (size_t) s.Width * s.Height * 4;
+
+        // Large images take long enough per iteration that a few iterations give a stable best time.
+        const UINT MaxIterations = (Bytes >= (size_t) 48000000 * 4) ? 3 : ~0u;
+
+        const std::string Suffix = std::string(" ") + s.Name;
+
+        benchmark.Measure("Allocate" + Suffix, Bytes, [&]()
+        {
+            Raster Image;
+
+            Image.Initialize(s.Width, s.Height);
+        }, MaxIterations);
+
+        for (const ImageFormat & f : Formats)
+        {
+            const std::string Name = std::string(" ") + f.Name + Suffix;
+
+            if (!benchmark.IsSelected("Convert" + Name) && !benchmark.IsSelected("End-to-end" + Name))
+                continue;
+
+            Raster Decoded;
+
+            if (FAILED(Decoded.Initialize(s.Width, s.Height, f.Layout)))
+                continue;
+
+            FillImage(Decoded);
+
+            {
+                Raster Image;
+
+                benchmark.Measure("Convert" + Name, Bytes, [&]()
+                {
+                    PixelConverter::Convert(Decoded, Image, PixelFormat::PBGRA32);
+                }, MaxIterations);
+            }
+
+            // Follows the image loader: convert the decoded pixels, build the mip chain, fit the nearest level to the window and show it.
+            benchmark.Measure("End-to-end" + Name, Bytes, [&]()
+            {
+                auto Image = std::make_shared<Raster>();
+
+                if (FAILED(PixelConverter::Convert(Decoded, *Image, PixelFormat::PBGRA32)))
+                    return;
+
+                Mipmap Levels;
+
+                if (FAILED(Levels.Build(Image)))
+                    return;
+
+                Raster Scaled;
+
+                if (FAILED(Levels.Fit(Scaled, WindowWidth, WindowHeight)))
+                    return;
+
+                Blender::Blend(Scaled, BackBuffer, (int) (WindowWidth - Scaled.Width()) / 2, (int) (WindowHeight - Scaled.Height()) / 2, BlendMode::SourceOver);
+            }, MaxIterations);
+        }
+
+        if (!benchmark.IsSelected("Mipmap" + Suffix) && !benchmark.IsSelected("Scale from image" + Suffix) && !benchmark.IsSelected("Scale from level" + Suffix) && !benchmark.IsSelected("Blend" + Suffix))
+            continue;
+
+        auto Image = std::make_shared<Raster>();
+
+        {
+            Raster Decoded;
+
+            if (FAILED(Decoded.Initialize(s.Width, s.Height, PixelFormat::BGRA32)))
+                continue;
+
+            FillImage(Decoded);
+
+            if (FAILED(PixelConverter::Convert(Decoded, *Image, PixelFormat::PBGRA32)))
+                continue;
+        }
+
+        Mipmap Levels;
+
+        benchmark.Measure("Mipmap" + Suffix, Bytes, [&]()
+        {
+            Levels.Build(Image);
+        }, MaxIterations);
+
+        if (FAILED(Levels.Build(Image)))
+            continue;
+
+        Raster Scaled;
+
+        benchmark.Measure("Scale from image" + Suffix, Bytes, [&]()
+        {
+            Scaler::Fit(*Image, Scaled, WindowWidth, WindowHeight);
+        }, MaxIterations);
+
+        benchmark.Measure("Scale from level" + Suffix, Bytes, [&]()
+        {
+            Levels.Fit(Scaled, WindowWidth, WindowHeight);
+        }, MaxIterations);
+
+        if (FAILED(Levels.Fit(Scaled, WindowWidth, WindowHeight)))
+            continue;
+
+        // Only the fitted image reaches the back buffer, so the cost of blending hardly depends on the size of the source.
+        benchmark.Measure("Blend" + Suffix, (size_t) Scaled.Width() * Scaled.Height() * 4, [&]()
+        {
+            Blender::Blend(Scaled, BackBuffer, (int) (WindowWidth - Scaled.Width()) / 2, (int) (WindowHeight - Scaled.Height()) / 2, BlendMode::SourceOver);
+        });
+    }
+}
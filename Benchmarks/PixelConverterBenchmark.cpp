@@ -0,0 +1,147 @@
+
+/** $VER: PixelConverterBenchmark.cpp (2026.10.17) P. Stuer **/
+
+#include "Benchmark.h"
+
+#include "PixelConverter.h"
+#include "Raster.h"
+
+/// <summary>
+/// Converts a row of pixels with a single loop that looks up the layout of both formats and branches on them for every pixel, the way a converter
+/// without per-format kernels works. The baseline of the specialized kernels.
+/// </summary>
+static void ConvertGeneric(const BYTE * src, PixelFormat srcFormat, BYTE * dst, PixelFormat dstFormat, UINT width) noexcept
+{
+    struct Layout
+    {
+        UINT Size;
+        int R, G, B, A;
+        bool IsPremultiplied;
+    };
+
+    const auto GetLayout = [](PixelFormat format) noexcept -> Layout
+    {
+        switch (format)
+        {
+            case PixelFormat::PBGRA32: return { 4, 2, 1, 0, 3, true };
+            case PixelFormat::BGRA32:  return { 4, 2, 1, 0, 3, false };
+            case PixelFormat::RGBA32:  return { 4, 0, 1, 2, 3, false };
+            case PixelFormat::BGR24:   return { 3, 2, 1, 0, -1, false };
+            case PixelFormat::RGB24:   return { 3, 0, 1, 2, -1, false };
+            default:                   return { };
+        }
+    };
+
+    for (UINT i = 0; i < width; ++i)
+    {
+        const Layout s = GetLayout(srcFormat);
+        const Layout d = GetLayout(dstFormat);
+
+        const BYTE * p = src + (size_t) i * s.Size;
+        BYTE * q = dst + (size_t) i * d.Size;
+
+        uint32_t c[3] = { p[s.R], p[s.G], p[s.B] };
+        const uint32_t a = (s.A >= 0) ? p[s.A] : 255u;
+
+        for (uint32_t & x : c)
+        {
+            if ((s.A >= 0) && !s.IsPremultiplied && (d.IsPremultiplied || (d.A < 0)))
+                x = (x * a + 127) / 255;
+            else
+            if (s.IsPremultiplied && (d.A >= 0) && !d.IsPremultiplied)
+                x = (a != 0) ? (std::min)((uint32_t) ((float) x * 255.f / (float) a + .5f), 255u) : 0;
+        }
+
+        q[d.R] = (BYTE) c[0];
+        q[d.G] = (BYTE) c[1];
+        q[d.B] = (BYTE) c[2];
+
+        if (d.A >= 0)
+            q[d.A] = (BYTE) a;
+    }
+}
+
+/// <summary>
+/// Measures the throughput of each pixel conversion on a 12 MP image: the generic converter and the specialized kernels with each instruction set.
+/// </summary>
+BENCHMARK(PixelConverter)
+{
+    const UINT Width = 4000, Height = 3000;
+
+    struct Conversion
+    {
+        const char * Name;
+        PixelFormat SrcFormat;
+        PixelFormat DstFormat;
+    };
+
+    const Conversion Conversions[] =
+    {
+        { "BGRA32->PBGRA32", PixelFormat::BGRA32,  PixelFormat::PBGRA32 },
+        { "RGBA32->PBGRA32", PixelFormat::RGBA32,  PixelFormat::PBGRA32 },
+        { "BGR24->PBGRA32",  PixelFormat::BGR24,   PixelFormat::PBGRA32 },
+        { "RGB24->PBGRA32",  PixelFormat::RGB24,   PixelFormat::PBGRA32 },
+        { "PBGRA32->BGRA32", PixelFormat::PBGRA32, PixelFormat::BGRA32 },
+        { "PBGRA32->RGBA32", PixelFormat::PBGRA32, PixelFormat::RGBA32 },
+        { "BGRA32->RGBA32",  PixelFormat::BGRA32,  PixelFormat::RGBA32 },
+        { "PBGRA32->BGR24",  PixelFormat::PBGRA32, PixelFormat::BGR24 },
+    };
+
+    const InstructionSet InstructionSets[] = { InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX2 };
+
+    const InstructionSet Saved = PixelConverter::GetInstructionSet();
+
+    for (const auto & c : Conversions)
+    {
+        Raster Src, Dst;
+
+        if (FAILED(Src.Initialize(Width, Height, c.SrcFormat)) || FAILED(Dst.Initialize(Width, Height, c.DstFormat)))
+            return;
+
+        // Semi-transparent noise so that the opaque fast paths don't kick in.
+        uint32_t Seed = 0x12345678;
+
+        for (UINT y = 0; y < Height; ++y)
+        {
+            BYTE * p = Src.Row(y);
+
+            for (UINT x = 0; x < Width * (Src.BitsPerPixel() / 8); ++x)
+            {
+                Seed = Seed * 1664525u + 1013904223u;
+                p[x] = (BYTE) (Seed >> 24);
+            }
+
+            if (c.SrcFormat == PixelFormat::PBGRA32)
+            {
+                for (UINT x = 0; x < Width; ++x, p += 4)
+                    for (int i = 0; i < 3; ++i)
+                        p[i] = (BYTE) (std::min)(p[i], p[3]);
+            }
+        }
+
+        benchmark.Measure(std::string(c.Name) + " Generic", (size_t) Src.Size() + Dst.Size(), [&]()
+        {
+            for (UINT y = 0; y < Height; ++y)
+                ConvertGeneric(Src.Row(y), c.SrcFormat, Dst.Row(y), c.DstFormat, Width);
+        });
+
+        for (InstructionSet Set : InstructionSets)
+        {
+            if (Set > CPU::GetInstructionSet())
+                continue;
+
+            // Conversions without SIMD kernels only have a scalar kernel.
+            if ((Set != InstructionSet::Scalar) && (PixelConverter::GetRowFunction(c.SrcFormat, c.DstFormat, Set) == PixelConverter::GetRowFunction(c.SrcFormat, c.DstFormat, InstructionSet::Scalar)))
+                continue;
+
+            PixelConverter::SetInstructionSet(Set);
+
+            benchmark.Measure(std::string(c.Name) + " " + CPU::GetName(Set), (size_t) Src.Size() + Dst.Size(), [&]()
+            {
+                PixelConverter::Convert(Src.Data(), Src.Stride(), c.SrcFormat, Dst.Data(), Dst.Stride(), c.DstFormat, Width, Height);
+            });
+        }
+    }
+
+    PixelConverter::SetInstructionSet(Saved);
+}
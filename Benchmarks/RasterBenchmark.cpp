@@ -0,0 +1,78 @@
+
+/** $VER: RasterBenchmark.cpp (2026.10.17) P. Stuer **/
+
+#include "Benchmark.h"
+
+#include "Raster.h"
+#include "RasterAllocator.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+/// <summary>
+/// Measures the allocation of rasters during a simulated live resize: every frame the window grows by a few pixels and a new back buffer is created
+/// and swapped with the previous one, which is released. Compares the heap (a pool without budget) with the pooled allocator.
+/// </summary>
+BENCHMARK(Raster)
+{
+    const UINT Width = 1920, Height = 1080;
+
+    RasterAllocator & Allocator = RasterAllocator::GetDefault();
+
+    const size_t PoolBudget = Allocator.GetStatistics().PoolBudget;
+
+    for (const bool IsPooled : { false, true })
+    {
+        Allocator.SetPoolBudget(IsPooled ? PoolBudget : 0);
+
+        Raster BackBuffer;
+        UINT Step = 0;
+
+        const RasterAllocatorStatistics Before = Allocator.GetStatistics();
+
+        benchmark.Measure(IsPooled ? "Resize, pooled" : "Resize, heap", (size_t) Width * Height * 4, [&]()
+        {
+            Step = (Step + 3) % 64;
+
+            Raster Next;
+
+            if (FAILED(Next.Initialize(Width - 64 + Step, Height - 64 + Step)))
+                return;
+
+            BackBuffer = std::move(Next);
+        });
+
+        const RasterAllocatorStatistics After = Allocator.GetStatistics();
+
+        const unsigned long long Allocations = (unsigned long long) (After.Allocations - Before.Allocations);
+        const unsigned long long PoolHits = (unsigned long long) (After.PoolHits - Before.PoolHits);
+
+        char Text[128];
+
+        ::snprintf(Text, sizeof(Text), "%llu allocations, %.1f%% from the pool, %.1f MB pooled", Allocations, (Allocations != 0) ? (double) PoolHits * 100. / (double) Allocations : 0., (double) After.BytesPooled / 1048576.);
+
+        benchmark.Comment(IsPooled ? "Allocator, pooled" : "Allocator, heap", Text);
+    }
+
+    Allocator.SetPoolBudget(PoolBudget);
+
+    // A view copies a sub-rectangle without touching the rest of the raster, e.g. the dirty rectangles of a frame.
+    {
+        Raster Src, Dst;
+
+        if (FAILED(Src.Initialize(Width, Height)) || FAILED(Dst.Initialize(Width, Height)))
+            return;
+
+        const RectI Rect = { 256, 128, 256 + 512, 128 + 384 };
+
+        benchmark.Measure("Copy view 512 x 384", (size_t) Rect.Width() * Rect.Height() * 4, [&]()
+        {
+            const ConstRasterView s = Src.GetView(Rect);
+            const RasterView d = Dst.GetView(Rect);
+
+            for (UINT y = 0; y < s.Height(); ++y)
+                ::memcpy(d.Row(y), s.Row(y), (size_t) s.Width() * 4);
+        });
+    }
+}
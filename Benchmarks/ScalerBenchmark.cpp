@@ -0,0 +1,142 @@
+
+/** $VER: ScalerBenchmark.cpp (2026.10.17) P. Stuer **/
+
+#include "Benchmark.h"
+
+#include "Scaler.h"
+#include "Raster.h"
+#include "ThreadPool.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/// <summary>
+/// Measures the throughput of each filter and instruction set, and the scaling with the number of threads, when fitting a 12 MP image to 1920 x 1080,
+/// and the streaming scaler on the same image and on a 20,000 x 20,000 image that is generated in strips. Throughput is expressed in source bytes per second.
+/// </summary>
+BENCHMARK(Scaler)
+{
+    const UINT Width = 4000, Height = 3000;
+
+    Raster Src, Dst;
+
+    if (FAILED(Src.Initialize(Width, Height)))
+        return;
+
+    uint32_t Seed = 0x12345678;
+
+    for (UINT y = 0; y < Height; ++y)
+    {
+        uint32_t * p = (uint32_t *) Src.Row(y);
+
+        for (UINT x = 0; x < Width; ++x)
+        {
+            Seed = Seed * 1664525u + 1013904223u;
+
+            const uint32_t c = (x ^ y) & 0xFF;
+
+            p[x] = 0xFF000000u | ((c * 0x010101u) ^ ((Seed >> 24) & 0x0F));
+        }
+    }
+
+    struct Filter
+    {
+        const char * Name;
+        ScaleFilter Filter;
+    };
+
+    const Filter Filters[] =
+    {
+        { "Box",        ScaleFilter::Box },
+        { "CatmullRom", ScaleFilter::CatmullRom },
+        { "Lanczos3",   ScaleFilter::Lanczos3 },
+    };
+
+    const InstructionSet InstructionSets[] = { InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX2 };
+
+    const InstructionSet Saved = Scaler::GetInstructionSet();
+
+    for (const auto & f : Filters)
+    {
+        for (InstructionSet Set : InstructionSets)
+        {
+            if (Set > CPU::GetInstructionSet())
+                continue;
+
+            Scaler::SetInstructionSet(Set);
+
+            benchmark.Measure(std::string(f.Name) + " " + CPU::GetName(Set), Src.Size(), [&]()
+            {
+                Scaler::Fit(Src, Dst, 1920, 1080, f.Filter);
+            });
+        }
+    }
+
+    Scaler::SetInstructionSet(Saved);
+
+    const UINT MaxThreads = (std::max)(std::thread::hardware_concurrency(), 1u);
+
+    for (UINT Threads = 1; Threads <= MaxThreads; Threads *= 2)
+    {
+        ThreadPool Pool(Threads);
+
+        benchmark.Measure("Lanczos3 " + std::to_string(Threads) + " thread(s)", Src.Size(), [&]()
+        {
+            Scaler::Fit(Src, Dst, 1920, 1080, ScaleFilter::Lanczos3, &Pool);
+        });
+    }
+
+    // The streaming scaler box-filters to the level the mip chain would select before resampling, so it does about the work of building the
+    // mip chain and scaling from it, without holding either.
+    {
+        benchmark.Measure("Streaming Lanczos3", Src.Size(), [&]()
+        {
+            StreamingScaler::Fit(Width, Height, [&](UINT y, UINT count, BYTE * data, UINT stride) -> HRESULT
+            {
+                for (UINT i = 0; i < count; ++i)
+                    ::memcpy(data + (size_t) i * stride, Src.Row(y + i), (size_t) Width * 4);
+
+                return S_OK;
+            }, Dst, 1920, 1080);
+        });
+    }
+
+    {
+        const UINT HugeWidth = 20000, HugeHeight = 20000;
+
+        // Stands in for a decoder that produces the image strip by strip.
+        const StreamingScaler::RowReader Reader = [](UINT y, UINT count, BYTE * data, UINT stride) -> HRESULT
+        {
+            for (UINT i = 0; i < count; ++i)
+            {
+                uint32_t * p = (uint32_t *) (data + (size_t) i * stride);
+
+                for (UINT x = 0; x < HugeWidth; ++x)
+                    p[x] = 0xFF000000u | (((x ^ (y + i)) & 0xFF) * 0x010101u);
+            }
+
+            return S_OK;
+        };
+
+        benchmark.Measure("Streaming 20000 x 20000", (size_t) HugeWidth * HugeHeight * 4, [&]()
+        {
+            StreamingScaler::Fit(HugeWidth, HugeHeight, Reader, Dst, 1920, 1080);
+        }, 3);
+
+        StreamingScaler Scaler;
+
+        UINT FitWidth, FitHeight;
+
+        Scaler::GetFitSize(HugeWidth, HugeHeight, 1920, 1080, FitWidth, FitHeight);
+
+        if (SUCCEEDED(Scaler.Initialize(HugeWidth, HugeHeight, FitWidth, FitHeight)))
+        {
+            char Text[128];
+
+            ::snprintf(Text, sizeof(Text), "%.1f MB for a %u x %u result, plus a %.1f MB strip, instead of %.1f MB for the decoded image",
+                (double) Scaler.GetSize() / 1048576., FitWidth, FitHeight, (double) HugeWidth * 4 * StreamingScaler::StripRows / 1048576., (double) HugeWidth * HugeHeight * 4 / 1048576.);
+
+            benchmark.Comment("Streaming memory", Text);
+        }
+    }
+}
@@ -0,0 +1,115 @@
+
+/** $VER: VisualTreeBenchmark.cpp (2026.10.17) P. Stuer **/
+
+#include "Benchmark.h"
+
+#include "VisualTree.h"
+
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Measures the retained visual tree on a 1920 x 1080 headless target with thousands of overlapping visuals: redrawing the content of every visual
+/// each frame, as immediate-mode drawing does, versus blending the cached layers, and the partial frames caused by changing a few visuals.
+/// </summary>
+BENCHMARK(VisualTree)
+{
+    const UINT Width = 1920, Height = 1080;
+    const UINT Size = 40;
+
+    const size_t Bytes = (size_t) Width * Height * 4;
+
+    for (const UINT Count : { 1000u, 5000u })
+    {
+        const std::string Prefix = std::to_string(Count) + " visuals, ";
+
+        SoftwareCompositor Target;
+
+        if (FAILED(Target.Initialize(Width, Height)))
+            return;
+
+        VisualTree Tree;
+
+        Tree.SetBackground({ 1.f, 1.f, 1.f, 1.f });
+
+        std::vector<Visual *> Visuals;
+
+        const UINT Columns = (UINT) std::ceil(std::sqrt((double) Count * Width / Height));
+        const UINT Rows = (Count + Columns - 1) / Columns;
+
+        for (UINT i = 0; i < Count; ++i)
+        {
+            Visual * v = nullptr;
+
+            if (FAILED(Tree.GetRoot()->CreateChild(&v)))
+                return;
+
+            const Color Fill = { (FLOAT) (i % 7) / 6.f, (FLOAT) (i % 5) / 4.f, (FLOAT) (i % 3) / 2.f, .75f };
+
+            v->SetContent(Size, Size, [Fill](Compositor & compositor)
+            {
+                compositor.Clear({ 0.f, 0.f, 0.f, .25f });
+                compositor.FillEllipse({ Size / 2.f, Size / 2.f }, Size / 2.f - 2.f, Size / 2.f - 2.f, Fill);
+            });
+
+            v->SetOffset((FLOAT) (i % Columns) * (FLOAT) (Width - Size) / (FLOAT) (Columns - 1), (FLOAT) (i / Columns) * (FLOAT) (Height - Size) / (FLOAT) (std::max)(Rows - 1, 1u));
+
+            Visuals.push_back(v);
+        }
+
+        if (FAILED(Tree.Render(Target)))
+            return;
+
+        {
+            const VisualStatistics Statistics = Tree.GetStatistics();
+
+            benchmark.Comment(Prefix + "cache", std::to_string(Statistics.Visuals) + " visuals, " + std::to_string(Statistics.CachedBytes / 1024) + " kB of cached rasters");
+        }
+
+        benchmark.Measure(Prefix + "redraw content", Bytes, [&]()
+        {
+            for (Visual * v : Visuals)
+                v->InvalidateContent();
+
+            Tree.InvalidateAll();
+            Tree.Render(Target);
+        });
+
+        benchmark.Measure(Prefix + "compose cached", Bytes, [&]()
+        {
+            Tree.InvalidateAll();
+            Tree.Render(Target);
+        });
+
+        bool Toggle = false;
+
+        benchmark.Measure(Prefix + "move 1", Bytes, [&]()
+        {
+            Toggle = !Toggle;
+
+            Visuals[Count / 2]->SetOffset(Toggle ? 100.f : 200.f, 100.f);
+            Tree.Render(Target);
+        });
+
+        benchmark.Measure(Prefix + "fade 1%", Bytes, [&]()
+        {
+            Toggle = !Toggle;
+
+            for (UINT i = 0; i < Count; i += 100)
+                Visuals[i]->SetOpacity(Toggle ? .5f : 1.f);
+
+            Tree.Render(Target);
+        });
+
+        {
+            const VisualStatistics Statistics = Tree.GetStatistics();
+
+            benchmark.Comment(Prefix + "fade 1%", std::to_string(Statistics.Composed) + " layers composed, " + std::to_string(Tree.GetDamage().GetRects().size()) + " damaged rectangles");
+        }
+
+        benchmark.Measure(Prefix + "unchanged", Bytes, [&]()
+        {
+            Tree.Render(Target);
+        });
+    }
+}
@@ -0,0 +1,234 @@
+
+/** $VER: DecodeBenchmark.cpp (2026.10.17) P. Stuer **/
+
+#include <CppCoreCheck/Warnings.h>
+
+#pragma warning(disable: 4100 4625 4626 4710 4711 5045 ALL_CPPCORECHECK_WARNINGS)
+
+#include "framework.h"
+
+#include "Benchmark.h"
+
+#include "Direct2D.h"
+#include "Direct3D.h"
+#include "WIC.h"
+
+#include "Mipmap.h"
+#include "Raster.h"
+
+/// <summary>
+/// Writes a synthetic image of the specified size to a file with a WIC encoder.
+/// </summary>
+static HRESULT WriteImage(const WCHAR * filePath, const GUID & containerFormat, WICPixelFormatGUID pixelFormat, UINT width, UINT height) noexcept
+{
+    const UINT BytesPerPixel = (pixelFormat == GUID_WICPixelFormat24bppBGR) ? 3 : 4;
+
+    Raster Image;
+
+    HRESULT hr = Image.Initialize(width, height, (BytesPerPixel == 3) ? PixelFormat::BGR24 : PixelFormat::BGRA32);
+
+    if (FAILED(hr))
+        return hr;
+
+    for (UINT y = 0; y < height; ++y)
+    {
+        BYTE * p = Image.Row(y);
+
+        for (UINT x = 0; x < width; ++x, p += BytesPerPixel)
+        {
+            p[0] = (BYTE) x;
+            p[1] = (BYTE) y;
+            p[2] = (BYTE) (x ^ y);
+
+            if (BytesPerPixel == 4)
+                p[3] = (BYTE) (128 + (x & 127));
+        }
+    }
+
+    CComPtr<IWICStream> Stream;
+
+    hr = _WIC.Factory->CreateStream(&Stream);
+
+    if (SUCCEEDED(hr))
+        hr = Stream->InitializeFromFilename(filePath, GENERIC_WRITE);
+
+    CComPtr<IWICBitmapEncoder> Encoder;
+
+    if (SUCCEEDED(hr))
+        hr = _WIC.Factory->CreateEncoder(containerFormat, nullptr, &Encoder);
+
+    if (SUCCEEDED(hr))
+        hr = Encoder->Initialize(Stream, WICBitmapEncoderNoCache);
+
+    CComPtr<IWICBitmapFrameEncode> Frame;
+    CComPtr<IPropertyBag2> Properties;
+
+    if (SUCCEEDED(hr))
+        hr = Encoder->CreateNewFrame(&Frame, &Properties);
+
+    if (SUCCEEDED(hr))
+        hr = Frame->Initialize(Properties);
+
+    if (SUCCEEDED(hr))
+        hr = Frame->SetSize(width, height);
+
+    if (SUCCEEDED(hr))
+        hr = Frame->SetPixelFormat(&pixelFormat);
+
+    if (SUCCEEDED(hr))
+        hr = Frame->WritePixels(height, Image.Stride(), (UINT) Image.Size(), Image.Data());
+
+    if (SUCCEEDED(hr))
+        hr = Frame->Commit();
+
+    if (SUCCEEDED(hr))
+        hr = Encoder->Commit();
+
+    return hr;
+}
+
+/// <summary>
+/// Measures the Windows stages of the image pipeline for JPEG and PNG files of 1, 12, 48 and 100 MP: opening the file (Direct2D::Load), decoding it
+/// into a premultiplied BGRA raster (WIC::CreateRaster) and uploading the raster to the GPU (Direct2D::CreateBitmap); and the complete path of a dropped file,
+/// from the file to a bitmap that fits a 1920 x 1080 window, with a full and a reduced decode (JPEG only, PNG has no scaling decoder). Throughput is expressed in bytes of the premultiplied image per second.
+/// </summary>
+BENCHMARK(Decode)
+{
+    struct ImageSize
+    {
+        const char * Name;
+        UINT Width;
+        UINT Height;
+    };
+
+    const ImageSize Sizes[] =
+    {
+        { "1 MP",    1152,  864 },
+        { "12 MP",   4000, 3000 },
+        { "48 MP",   8000, 6000 },
+        { "100 MP", 11552, 8664 },
+    };
+
+    struct ImageFormat
+    {
+        const char * Name;
+        const WCHAR * FileName;
+        GUID Container;
+        WICPixelFormatGUID Layout;
+    };
+
+    const ImageFormat Formats[] =
+    {
+        { "JPEG", L"Benchmark.jpg", GUID_ContainerFormatJpeg, GUID_WICPixelFormat24bppBGR },
+        { "PNG",  L"Benchmark.png", GUID_ContainerFormatPng,  GUID_WICPixelFormat32bppBGRA },
+    };
+
+    const UINT WindowWidth = 1920, WindowHeight = 1080;
+
+    CComPtr<IDXGIDevice> DXGIDevice;
+    CComPtr<ID2D1Device1> D2DDevice;
+    CComPtr<ID2D1DeviceContext> DC;
+
+    HRESULT hr = _Direct3D.GetDXGIDevice(&DXGIDevice);
+
+    if (SUCCEEDED(hr))
+        hr = _Direct2D.Factory->CreateDevice(DXGIDevice, &D2DDevice);
+
+    if (SUCCEEDED(hr))
+        hr = D2DDevice->CreateDeviceContext(D2D1_DEVICE_CONTEXT_OPTIONS_NONE, &DC);
+
+    WCHAR Directory[MAX_PATH] = { };
+
+    if (FAILED(hr) || (::GetTempPathW(_countof(Directory), Directory) == 0))
+        return;
+
+    for (const ImageSize & s : Sizes)
+    {
+        const size_t Bytes = (size_t) s.Width * s.Height * 4;
+
+        const UINT MaxIterations = (Bytes >= (size_t) 48000000 * 4) ? 3 : ~0u;
+
+        for (const ImageFormat & f : Formats)
+        {
+            const std::string Name = std::string(" ") + f.Name + " " + s.Name;
+
+            if (!benchmark.IsSelected("Load" + Name) && !benchmark.IsSelected("Decode" + Name) && !benchmark.IsSelected("CreateBitmap" + Name) && !benchmark.IsSelected("End-to-end" + Name) && !benchmark.IsSelected("Reduced decode" + Name))
+                continue;
+
+            WCHAR FilePath[MAX_PATH] = { };
+
+            ::swprintf_s(FilePath, _countof(FilePath), L"%s%s", Directory, f.FileName);
+
+            if (FAILED(WriteImage(FilePath, f.Container, f.Layout, s.Width, s.Height)))
+                continue;
+
+            benchmark.Measure("Load" + Name, Bytes, [&]()
+            {
+                CComPtr<IWICBitmapSource> Source;
+
+                _Direct2D.Load(FilePath, &Source);
+            }, MaxIterations);
+
+            Raster Image;
+
+            benchmark.Measure("Decode" + Name, Bytes, [&]()
+            {
+                CComPtr<IWICBitmapSource> Source;
+
+                if (SUCCEEDED(_Direct2D.Load(FilePath, &Source)))
+                    _WIC.CreateRaster(Source, Image);
+            }, MaxIterations);
+
+            benchmark.Measure("CreateBitmap" + Name, Bytes, [&]()
+            {
+                CComPtr<ID2D1Bitmap> Bitmap;
+
+                _Direct2D.CreateBitmap(Image, DC, &Bitmap);
+            }, MaxIterations);
+
+            // Follows a dropped file: decode, build the mip chain, fit the nearest level to the window and upload it.
+            benchmark.Measure("End-to-end" + Name, Bytes, [&]()
+            {
+                CComPtr<IWICBitmapSource> Source;
+
+                auto Decoded = std::make_shared<Raster>();
+
+                if (FAILED(_Direct2D.Load(FilePath, &Source)) || FAILED(_WIC.CreateRaster(Source, *Decoded)))
+                    return;
+
+                Mipmap Levels;
+                Raster Scaled;
+
+                if (FAILED(Levels.Build(Decoded)) || FAILED(Levels.Fit(Scaled, WindowWidth, WindowHeight)))
+                    return;
+
+                CComPtr<ID2D1Bitmap> Bitmap;
+
+                _Direct2D.CreateBitmap(Scaled, DC, &Bitmap);
+            }, MaxIterations);
+
+            // Same as above, but the decoder skips the detail that the fit to the window discards: JPEG decodes at 1/2, 1/4 or 1/8 of its size.
+            benchmark.Measure("Reduced decode" + Name, Bytes, [&]()
+            {
+                CComPtr<IWICBitmapSource> Source;
+
+                auto Decoded = std::make_shared<Raster>();
+
+                if (FAILED(_Direct2D.Load(FilePath, WindowWidth, WindowHeight, &Source)) || FAILED(_WIC.CreateRaster(Source, *Decoded)))
+                    return;
+
+                Mipmap Levels;
+                Raster Scaled;
+
+                if (FAILED(Levels.Build(Decoded)) || FAILED(Levels.Fit(Scaled, WindowWidth, WindowHeight)))
+                    return;
+
+                CComPtr<ID2D1Bitmap> Bitmap;
+
+                _Direct2D.CreateBitmap(Scaled, DC, &Bitmap);
+            }, MaxIterations);
+
+            ::DeleteFileW(FilePath);
+        }
+    }
+}
@@ -1,5 +1,5 @@
 
-/** $VER: Child.cpp (2024.04.04) P. Stuer **/
+/** $VER: Child.cpp (2026.10.17) P. Stuer **/
 
 #include <CppCoreCheck/Warnings.h>
 
@@ -9,16 +9,19 @@
 
 #include "Child.h"
 
-#include "Direct3D.h"
 #include "Direct2D.h"
 #include "DirectWrite.h"
+#include "WIC.h"
+
+#include "Frame.h"
+#include "ImageCache.h"
 
 #pragma hdrstop
 
 /// <summary>
 /// Initializes a new instance.
 /// </summary>
-Child::Child() : _hWnd(), _Number(2)
+Child::Child() : _hParent(), _DeviceManager(), _Number(2), _IsDirty(true)
 {
 }
 
@@ -28,233 +31,117 @@ Child::Child() : _hWnd(), _Number(2)
 Child::~Child()
 {
     DeleteDeviceDependentResources();
+
+    if ((_DeviceManager != nullptr) && (_CompositionVisual != nullptr))
+        _DeviceManager->RemoveVisual(_CompositionVisual);
 }
 
 /// <summary>
-/// Initializes this instance.
+/// Initializes this instance: adds the visual of the layer to the visual tree of the parent window.
 /// </summary>
-HRESULT Child::Initialize(HWND hParent)
+HRESULT Child::Initialize(DeviceManager * deviceManager, HWND hParent)
 {
-    const DWORD Style = WS_CHILDWINDOW;
-    const DWORD ExStyle = WS_EX_NOREDIRECTIONBITMAP; // Disable the creation of the opaque redirection surface.
+    _DeviceManager = deviceManager;
+    _hParent = hParent;
 
-    HRESULT hr = CreateDeviceIndependentResources();
+    HRESULT hr = _DeviceManager->CreateVisual(&_CompositionVisual);
 
+    // Visual offsets are in pixels.
     if (SUCCEEDED(hr))
     {
-        WNDCLASSEX wcex = { sizeof(WNDCLASSEX) };
-
-        wcex.lpszClassName = ClassName;
-        wcex.style = CS_HREDRAW | CS_VREDRAW;
-        wcex.lpfnWndProc = Child::WndProc;
-        wcex.hInstance = THIS_HINSTANCE;
-        wcex.hCursor = ::LoadCursorW(NULL, IDC_ARROW);
-        wcex.cbWndExtra = sizeof(LONG_PTR);
+        const UINT DPI = ::GetDpiForWindow(_hParent);
 
-        ::RegisterClassExW(&wcex);
-
-        _hWnd = ::CreateWindowExW(ExStyle, ClassName, nullptr, Style, 0, 0, 0, 0, hParent, NULL, THIS_HINSTANCE, this);
-
-        hr = _hWnd ? S_OK : E_FAIL;
+        hr = _DeviceManager->SetOffset(_CompositionVisual, (FLOAT) ToDPI(ChildFrame::Left, DPI), (FLOAT) ToDPI(ChildFrame::Top, DPI));
     }
 
     if (SUCCEEDED(hr))
-    {
-        RECT wr = { 0, 0, 144, 144 };
-
-        ::AdjustWindowRectEx(&wr, Style, FALSE, ExStyle);
-
-        UINT DPI = ::GetDpiForWindow(_hWnd);
-
-        ::MoveWindow(_hWnd, ToDPI(16, DPI), ToDPI(16, DPI), ToDPI(wr.right, DPI), ToDPI(wr.bottom, DPI), TRUE);
-
-        ::ShowWindow(_hWnd, SW_SHOWNORMAL);
-        ::UpdateWindow(_hWnd);
-    }
+        hr = _DeviceManager->AddVisual(_CompositionVisual);
 
     return hr;
 }
 
 /// <summary>
-/// Windows procedure
-/// </summary>
-LRESULT CALLBACK Child::WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
-{
-    if (msg == WM_CREATE)
-    {
-        LPCREATESTRUCT pcs = (LPCREATESTRUCT) lParam;
-        Child * This = (Child *) pcs->lpCreateParams;
-
-        ::SetWindowLongPtrW(hWnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(This));
-
-        ::DragAcceptFiles(hWnd, TRUE);
-
-        return 1;
-    }
- 
-    Child * This = (Child *)(::GetWindowLongPtrW(hWnd, GWLP_USERDATA));
-
-    if (This != nullptr)
-    {
-        switch (msg)
-        {
-            case WM_SIZE:
-                return This->OnResize(LOWORD(lParam), HIWORD(lParam));
-
-            case WM_PAINT:
-            case WM_DISPLAYCHANGE:
-            {
-                PAINTSTRUCT ps;
-
-                ::BeginPaint(hWnd, &ps);
-
-                This->Render();
-
-                ::EndPaint(hWnd, &ps);
-
-                return 0;
-            }
-        }
-    }
-
-    return ::DefWindowProcW(hWnd, msg, wParam, lParam);
-}
-
-/// <summary>
-/// Handles the WM_SIZE message.
-/// </summary>
-LRESULT Child::OnResize(UINT width, UINT height)
-{
-    if (_DC == nullptr)
-        return 0;
-
-    _Bitmap.Release(); // Ensure that the bitmap gets rescaled.
-
-    ResizeSwapChain(width, height);
-
-    return 0;
-}
-
-/// <summary>
-/// Renders a frame.
+/// Renders a frame. The content of the layer does not change so the swap chain is only drawn and presented after it has been (re)created.
+/// The caller commits the visual tree.
 /// </summary>
 HRESULT Child::Render()
 {
     HRESULT hr = CreateDeviceDependentResources();
 
-    if (SUCCEEDED(hr))
+    if (SUCCEEDED(hr) && _IsDirty)
     {
-        D2D1_SIZE_F RenderTargetSize = _DC->GetSize();
-
-        _DC->BeginDraw();
-
-        _DC->Clear(D2D1::ColorF(0, 0.f));
+        _Compositor.BeginDraw();
 
-        if (_Bitmap)
-        {
-            D2D1_SIZE_F Size = _Bitmap->GetSize();
+        ChildFrame { _Bitmap.get() }.Render(_Compositor);
 
-            D2D1_RECT_F Rect = D2D1::RectF((RenderTargetSize.width - Size.width) / 2.f, (RenderTargetSize.height - Size.height) / 2.f, Size.width, Size.height);
+        _Compositor.EndDraw();
 
-            Rect.right += Rect.left;
-            Rect.bottom += Rect.top;
+        // Present the swap chain to the composition engine. An occluded present is a success code but shows nothing; present again once the window is visible.
+        hr = _Compositor.Present();
 
-            _DC->DrawBitmap(_Bitmap, Rect);
-        }
-
-        _DC->EndDraw();
-
-        // Present the swap chain to the composition engine.
-        hr = _SwapChain->Present(1, 0);
-
-        if (!SUCCEEDED(hr) && (hr != DXGI_STATUS_OCCLUDED))
+        if (hr == S_OK)
+            _IsDirty = false;
+        else
+        if (FAILED(hr))
             DeleteDeviceDependentResources();
     }
 
     return hr;
 }
 
-/// <summary>
-/// Create resources which are not bound to any device. Their lifetime effectively extends for the duration of the app. These resources include the Direct2D,
-/// DirectWrite, and WIC factories; and a DirectWrite Text Format object (used for identifying particular font characteristics) and a Direct2D geometry.
-/// </summary>
-HRESULT Child::CreateDeviceIndependentResources()
-{
-    HRESULT hr = _Direct3D.GetDXGIDevice(&_DXGIDevice);
-
-    // Create the Direct2D device that links back to the Direct3D device.
-    if (SUCCEEDED(hr))
-        hr = _Direct2D.Factory->CreateDevice(_DXGIDevice, &_D2DDevice);
-
-    // Create the DirectComposition device that links back to the Direct3D device.
-    if (SUCCEEDED(hr))
-        hr = ::DCompositionCreateDevice(_DXGIDevice, __uuidof(_CompositionDevice), (void **) &_CompositionDevice);
-
-    return hr;
-}
-
 /// <summary>
 /// Creates resources which are bound to a particular Direct3D device. It's all centralized here, in case the resources
 /// need to be recreated in case of Direct3D device loss (eg. display change, remoting, removal of video card, etc).
 /// </summary>
 HRESULT Child::CreateDeviceDependentResources()
 {
-    RECT cr = { };
+    const UINT DPI = ::GetDpiForWindow(_hParent);
 
-    ::GetClientRect(_hWnd, &cr);
+    const UINT Width  = (UINT) ToDPI((int) ChildFrame::Width,  DPI);
+    const UINT Height = (UINT) ToDPI((int) ChildFrame::Height, DPI);
 
-    UINT Width  = (UINT) (cr.right  - cr.left);
-    UINT Height = (UINT) (cr.bottom - cr.top);
-
-    HRESULT hr = (Width != 0) && (Height != 0) ? S_OK : DXGI_ERROR_INVALID_CALL;
+    HRESULT hr = S_OK;
 
     // Create the Direct2D device context that is the actual render target and exposes drawing commands.
     if (SUCCEEDED(hr) && (_DC == nullptr))
     {
-        hr = _D2DDevice->CreateDeviceContext(D2D1_DEVICE_CONTEXT_OPTIONS_NONE, &_DC);
+        hr = _DeviceManager->CreateDeviceContext(DPI, &_DC);
 
-        // Set the DPI of the device context based on that of the target window.
         if (SUCCEEDED(hr))
-        {
-            FLOAT DPI = (FLOAT) ::GetDpiForWindow(_hWnd);
-
-            _DC->SetDpi(DPI, DPI);
             _DC->SetTransform(D2D1::Matrix3x2F::Identity());
-        }
     }
 
-    // Create the swap chain.
+    // Create the swap chain and make it the content of the visual.
     if (SUCCEEDED(hr) && (_SwapChain == nullptr))
     {
-        hr = _DXGI.CreateSwapChain(_DXGIDevice, Width, Height, &_SwapChain);
+        hr = _DeviceManager->CreateSwapChain(Width, Height, &_SwapChain);
 
         if (SUCCEEDED(hr))
             hr = CreateSwapChainBuffers(_DC, _SwapChain);
-    }
-
-    // Create the composition target.
-    if (SUCCEEDED(hr) && (_CompositionTarget == nullptr))
-    {
-        hr = _CompositionDevice->CreateTargetForHwnd(_hWnd, true, &_CompositionTarget);
-
-        if (SUCCEEDED(hr) && (_CompositionVisual == nullptr))
-            hr = _CompositionDevice->CreateVisual(&_CompositionVisual);
 
         if (SUCCEEDED(hr))
-            hr = _CompositionTarget->SetRoot(_CompositionVisual);
-    }
+            hr = _DeviceManager->SetContent(_CompositionVisual, _SwapChain);
 
-    if (SUCCEEDED(hr))
-        hr = _CompositionVisual->SetContent(_SwapChain);
+        if (SUCCEEDED(hr))
+            hr = _Compositor.Attach(_DC, _SwapChain);
 
-    if (SUCCEEDED(hr))
-        hr = _CompositionDevice->Commit();
+        _IsDirty = true;
+    }
 
     if (SUCCEEDED(hr) && (_BitmapSource == nullptr))
         hr = CreateBitmapSource(&_BitmapSource);
 
     if (SUCCEEDED(hr) && (_Bitmap == nullptr))
-        hr = CreateBitmap(_BitmapSource, _DC, Width, Height, &_Bitmap);
+    {
+        CComPtr<ID2D1Bitmap> D2DBitmap;
+
+        hr = CreateBitmap(_BitmapSource, _DC, Width, Height, &D2DBitmap);
+
+        if (SUCCEEDED(hr))
+            _Bitmap = std::make_unique<Direct2DBitmap>(D2DBitmap);
+
+        _IsDirty = true;
+    }
 
     return hr;
 }
@@ -264,11 +151,19 @@ HRESULT Child::CreateDeviceDependentResources()
 /// </summary>
 HRESULT Child::CreateBitmapSource(IWICBitmapSource ** bitmapSource) const noexcept
 {
-    WCHAR ResourceName[64] = { };
+    WCHAR SourceName[MAX_PATH] = { };
 
-    ::swprintf_s(ResourceName, _countof(ResourceName), L"Image%02d", _Number);
+    GetSourceName(SourceName, _countof(SourceName));
 
-    return _Direct2D.Load(ResourceName, L"Image", bitmapSource);
+    return _Direct2D.Load(SourceName, L"Image", bitmapSource);
+}
+
+/// <summary>
+/// Gets the name of the bitmap source: the name of the image resource.
+/// </summary>
+void Child::GetSourceName(WCHAR * sourceName, size_t size) const noexcept
+{
+    ::swprintf_s(sourceName, size, L"Image%02d", _Number);
 }
 
 /// <summary>
@@ -280,14 +175,18 @@ HRESULT Child::CreateBitmap(IWICBitmapSource * bitmapSource, ID2D1RenderTarget *
 
     HRESULT hr = bitmapSource->GetSize(&Width, &Height);
 
-    CComPtr<IWICBitmapScaler> Scaler;
+    WCHAR SourceName[MAX_PATH] = { };
+
+    GetSourceName(SourceName, _countof(SourceName));
 
-    // Fit big images.
-    if (SUCCEEDED(hr) && ((Width > maxWidth) || (Height > maxHeight)))
-        hr = _Direct2D.CreateScaler(_BitmapSource, Width, Height, maxWidth, maxHeight, &Scaler);
+    std::shared_ptr<const Raster> Image;
 
+    // Fit big images. The cache only decodes the source if it has no image of the same size or larger.
     if (SUCCEEDED(hr))
-        hr = _Direct2D.CreateBitmap(Scaler ? Scaler : bitmapSource, renderTarget, bitmap);
+        hr = ImageCache::GetDefault().Fit(SourceName, maxWidth, maxHeight, Width, Height, [bitmapSource](Raster & raster) { return _WIC.CreateRaster(bitmapSource, raster); }, Image);
+
+    if (SUCCEEDED(hr))
+        hr = _Direct2D.CreateBitmap(*Image, renderTarget, bitmap);
 
     return hr;
 }
@@ -297,7 +196,7 @@ HRESULT Child::CreateBitmap(IWICBitmapSource * bitmapSource, ID2D1RenderTarget *
 /// </summary>
 void Child::DeleteBitmapSourceDependentResources()
 {
-    _Bitmap.Release();
+    _Bitmap.reset();
     _BitmapSource.Release();
 }
 
@@ -308,27 +207,14 @@ void Child::DeleteDeviceDependentResources()
 {
     DeleteBitmapSourceDependentResources();
 
-    _SwapChain.Release();
-    _DC.Release();
-}
-
-/// <summary>
-/// Resizes the swap chain buffers.
-/// </summary>
-void Child::ResizeSwapChain(UINT width, UINT height) noexcept
-{
-    // Release the reference to the swap chain before resizing its buffers.
-    _DC->SetTarget(nullptr);
+    _Compositor.Detach();
 
-    HRESULT hr = (width != 0) && (height != 0) ? S_OK : DXGI_ERROR_INVALID_CALL;
+    // The visual keeps a reference to the swap chain until it gets new content.
+    if (_CompositionVisual != nullptr)
+        _DeviceManager->SetContent(_CompositionVisual, nullptr);
 
-    if (SUCCEEDED(hr))
-        hr = _SwapChain->ResizeBuffers(0, width, height, DXGI_FORMAT_UNKNOWN, 0);
-
-    if (SUCCEEDED(hr))
-        CreateSwapChainBuffers(_DC, _SwapChain);
-    else
-        DeleteDeviceDependentResources();
+    _SwapChain.Release();
+    _DC.Release();
 }
 
 /// <summary>
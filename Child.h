@@ -1,54 +1,52 @@
 
-/** $VER: Child.h (2024.01.28) P. Stuer **/
+/** $VER: Child.h (2026.10.17) P. Stuer **/
 
 #pragma once
 
 #include "framework.h"
 
+#include "DeviceManager.h"
+#include "Direct2DCompositor.h"
+
+/// <summary>
+/// Implements the child layer: a transparent visual on top of the main window, with its own swap chain and offset. It shares the devices and the visual tree of the main window.
+/// </summary>
 class Child
 {
 public:
     Child();
     ~Child();
 
-    HRESULT Initialize(HWND hParent);
-
-private:
-    static LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
+    HRESULT Initialize(DeviceManager * deviceManager, HWND hParent);
 
     HRESULT Render();
 
-    LRESULT OnResize(UINT width, UINT height);
+    void DeleteDeviceDependentResources();
 
-    HRESULT CreateDeviceIndependentResources();
+private:
     HRESULT CreateDeviceDependentResources();
     void DeleteBitmapSourceDependentResources();
-    void DeleteDeviceDependentResources();
 
-    void ResizeSwapChain(UINT width, UINT height) noexcept;
     HRESULT CreateSwapChainBuffers(ID2D1DeviceContext * dc, IDXGISwapChain1 * swapChain) noexcept;
 
     HRESULT CreateBitmapSource(IWICBitmapSource ** bitmapSource) const noexcept;
+    void GetSourceName(WCHAR * sourceName, size_t size) const noexcept;
     HRESULT CreateBitmap(IWICBitmapSource * bitmapSource, ID2D1RenderTarget * renderTarget, UINT maxWidth, UINT maxHeight, ID2D1Bitmap ** bitmap) const noexcept;
 
 private:
-    HWND _hWnd;
+    HWND _hParent;
+    DeviceManager * _DeviceManager;
 
     uint32_t _Number;
-
-    CComPtr<IDXGIDevice> _DXGIDevice;
-    CComPtr<ID2D1Device1> _D2DDevice;
-    CComPtr<IDCompositionDevice> _CompositionDevice;
+    bool _IsDirty; // True if the content of the swap chain has to be redrawn.
 
     CComPtr<ID2D1DeviceContext> _DC;
     CComPtr<IDXGISwapChain1> _SwapChain;
 
-    CComPtr<IDCompositionTarget> _CompositionTarget;
     CComPtr<IDCompositionVisual> _CompositionVisual;
 
-    CComPtr<ID2D1SolidColorBrush> _SolidBrush;
-    CComPtr<IWICBitmapSource> _BitmapSource;
-    CComPtr<ID2D1Bitmap> _Bitmap;
+    Direct2DCompositor _Compositor;
 
-    const WCHAR * ClassName = L"Compositing.Child";
+    CComPtr<IWICBitmapSource> _BitmapSource;
+    std::unique_ptr<Bitmap> _Bitmap;
 };
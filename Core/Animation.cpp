@@ -0,0 +1,481 @@
+
+/** $VER: Animation.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "Animation.h"
+#include "Blender.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <limits>
+#include <new>
+#include <string.h>
+
+/// <summary>
+/// Initializes the canvas with a transparent image of the specified size.
+/// </summary>
+HRESULT AnimationCanvas::Initialize(UINT width, UINT height) noexcept
+{
+    _Saved.Reset();
+    _HasPrevious = false;
+
+    return _Canvas.Initialize(width, height);
+}
+
+/// <summary>
+/// Clears the canvas to transparent black before the first frame of a loop is drawn.
+/// </summary>
+void AnimationCanvas::Reset() noexcept
+{
+    _Canvas.Clear();
+
+    _HasPrevious = false;
+}
+
+/// <summary>
+/// Disposes the previous frame and draws the specified frame on the canvas.
+/// </summary>
+HRESULT AnimationCanvas::Compose(const AnimationFrame & frame, const Raster & raster) noexcept
+{
+    if (_Canvas.IsEmpty())
+        return E_FAIL;
+
+    HRESULT hr = S_OK;
+
+    if (_HasPrevious && !_Previous.Rect.IsEmpty())
+    {
+        const RectI & r = _Previous.Rect;
+
+        if (_Previous.Disposal == FrameDisposal::Background)
+        {
+            const RasterView Area = _Canvas.GetView(r);
+
+            for (UINT y = 0; y < Area.Height(); ++y)
+                ::memset(Area.Row(y), 0, (size_t) Area.Width() * 4);
+        }
+        else
+        if ((_Previous.Disposal == FrameDisposal::Previous) && !_Saved.IsEmpty())
+            hr = Blender::Blend(_Saved, _Canvas, r.left, r.top, BlendMode::Copy);
+    }
+
+    const RectI Rect = Clip(frame.Rect);
+
+    // Keep the content under the frame if it has to be restored before the next frame.
+    if (SUCCEEDED(hr) && (frame.Disposal == FrameDisposal::Previous) && !Rect.IsEmpty())
+    {
+        hr = _Saved.Initialize((UINT) Rect.Width(), (UINT) Rect.Height());
+
+        if (SUCCEEDED(hr))
+        {
+            const ConstRasterView Area = _Canvas.GetView(Rect);
+
+            for (UINT y = 0; y < Area.Height(); ++y)
+                ::memcpy(_Saved.Row(y), Area.Row(y), (size_t) Area.Width() * 4);
+        }
+    }
+
+    if (SUCCEEDED(hr) && !Rect.IsEmpty())
+        hr = Blender::Blend(raster, _Canvas, frame.Rect.left, frame.Rect.top, (frame.Blend == FrameBlend::Source) ? BlendMode::Copy : BlendMode::SourceOver);
+
+    if (FAILED(hr))
+        return hr;
+
+    _Previous = frame;
+    _Previous.Rect = Rect;
+    _HasPrevious = true;
+
+    return S_OK;
+}
+
+/// <summary>
+/// Clips a rectangle to the canvas.
+/// </summary>
+RectI AnimationCanvas::Clip(const RectI & rect) const noexcept
+{
+    const RectI Rect = { (std::max)(rect.left, 0), (std::max)(rect.top, 0), (std::min)(rect.right, (int) _Canvas.Width()), (std::min)(rect.bottom, (int) _Canvas.Height()) };
+
+    return Rect.IsEmpty() ? RectI() : Rect;
+}
+
+/// <summary>
+/// Initializes a new instance. The callback is invoked on a worker thread when the frame that the player waits for is ready; it should only notify the UI thread.
+/// </summary>
+AnimationPlayer::AnimationPlayer(Callback onFrameReady, ThreadPool * threadPool) noexcept :
+    _OnFrameReady(std::move(onFrameReady)),
+    _ThreadPool((threadPool != nullptr) ? *threadPool : ThreadPool::GetDefault()),
+    _IsOpen(false),
+    _IsResident(false),
+    _IsDecoding(false),
+    _IsClosing(false),
+    _IsStarved(false),
+    _Status(S_OK),
+    _FrameCount(0),
+    _Sequences(0),
+    _Decoded(0),
+    _Shown(0),
+    _Deadline(0.),
+    _MemoryUsage(0),
+    _TotalDecoded(0),
+    _Presented(0),
+    _Dropped(0),
+    _Underruns(0)
+{
+}
+
+/// <summary>
+/// Stops the playback and waits for the worker to finish.
+/// </summary>
+AnimationPlayer::~AnimationPlayer()
+{
+    Close();
+}
+
+/// <summary>
+/// Starts playing an animation. Keeps up to decodeAhead composited frames ahead of the current one, or all frames if they fit the budget.
+/// The first frame is shown by the first call to Update after it is ready.
+/// </summary>
+HRESULT AnimationPlayer::Open(std::unique_ptr<AnimationSource> source, UINT decodeAhead, size_t budget) noexcept
+{
+    Close();
+
+    if ((source == nullptr) || (source->GetWidth() == 0) || (source->GetHeight() == 0) || (source->GetFrameCount() == 0))
+        return E_INVALIDARG;
+
+    const UINT FrameCount = source->GetFrameCount();
+    const size_t FrameSize = (size_t) Raster::GetStride(source->GetWidth(), 32) * source->GetHeight();
+
+    // The ring needs room for the current frame and at least one frame ahead.
+    const UINT Capacity = (UINT) (std::max)((std::min)(budget / FrameSize, (size_t) decodeAhead + 1), (size_t) 2);
+
+    const bool IsResident = ((size_t) FrameCount * FrameSize <= budget) || (FrameCount <= Capacity);
+
+    HRESULT hr = _Canvas.Initialize(source->GetWidth(), source->GetHeight());
+
+    if (FAILED(hr))
+        return hr;
+
+    try
+    {
+        _Slots = std::vector<Slot>(IsResident ? FrameCount : Capacity);
+    }
+    catch (const std::bad_alloc &)
+    {
+        _Canvas = AnimationCanvas();
+
+        return E_OUTOFMEMORY;
+    }
+
+    _Source = std::move(source);
+
+    {
+        std::lock_guard<std::mutex> Lock(_Mutex);
+
+        _IsOpen = true;
+        _IsResident = IsResident;
+        _IsDecoding = true;
+        _IsStarved = false;
+        _Status = S_OK;
+
+        _FrameCount = FrameCount;
+        _Sequences = ((_Source->GetLoopCount() != 0) || (FrameCount == 1)) ? (uint64_t) FrameCount * (std::max)(_Source->GetLoopCount(), 1U) : UINT64_MAX;
+        _Decoded = 0;
+        _Shown = 0;
+        _Deadline = 0.;
+        _MemoryUsage = _Canvas.GetMemoryUsage();
+
+        _TotalDecoded = _Presented = _Dropped = _Underruns = 0;
+    }
+
+    hr = _ThreadPool.Submit([this]() { Decode(); });
+
+    if (FAILED(hr))
+    {
+        {
+            std::lock_guard<std::mutex> Lock(_Mutex);
+
+            _IsDecoding = false;
+        }
+
+        Close();
+    }
+
+    return hr;
+}
+
+/// <summary>
+/// Stops the playback, waits for the worker to finish the frame it is decoding and releases the frames.
+/// </summary>
+void AnimationPlayer::Close() noexcept
+{
+    {
+        std::unique_lock<std::mutex> Lock(_Mutex);
+
+        _IsClosing = true;
+
+        _Idle.wait(Lock, [this]() { return !_IsDecoding; });
+
+        _IsOpen = false;
+        _IsClosing = false;
+        _FrameCount = 0;
+        _Decoded = _Shown = 0;
+        _MemoryUsage = 0;
+    }
+
+    _Slots.clear();
+    _Pixels.Reset();
+    _Canvas = AnimationCanvas();
+    _Source.reset();
+}
+
+/// <summary>
+/// Returns true if an animation is playing or paused at its last frame.
+/// </summary>
+bool AnimationPlayer::IsOpen() const noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    return _IsOpen;
+}
+
+/// <summary>
+/// Advances the playback to the specified time, in seconds on a monotonic clock. Returns true if the current frame changed.
+/// Frames whose deadline passed while the next one was already due are skipped; if the next frame is not ready yet, the current one stays and the timeline restarts when it arrives.
+/// </summary>
+bool AnimationPlayer::Update(double now) noexcept
+{
+    bool IsChanged = false;
+    bool Resume = false;
+
+    {
+        std::lock_guard<std::mutex> Lock(_Mutex);
+
+        if (!_IsOpen)
+            return false;
+
+        if (_Shown == 0)
+        {
+            if (!IsReady(0))
+                return false;
+
+            _Shown = 1;
+            _Deadline = now + GetSlot(0).Delay / 1000.;
+
+            ++_Presented;
+
+            IsChanged = true;
+        }
+
+        UINT Advances = 0;
+
+        while ((now >= _Deadline) && (_Shown < _Sequences))
+        {
+            if (!IsReady(_Shown))
+            {
+                if (!_IsStarved)
+                    ++_Underruns;
+
+                _IsStarved = true;
+
+                break;
+            }
+
+            if (_IsStarved)
+            {
+                _Deadline = now;
+                _IsStarved = false;
+            }
+
+            _Deadline += GetSlot(_Shown).Delay / 1000.;
+
+            ++_Shown;
+            ++Advances;
+        }
+
+        if (Advances != 0)
+        {
+            ++_Presented;
+
+            _Dropped += Advances - 1;
+
+            IsChanged = true;
+        }
+
+        // Showing a frame frees a slot in the ring.
+        if (!_IsDecoding && !_IsClosing && SUCCEEDED(_Status) && CanDecode())
+        {
+            _IsDecoding = true;
+
+            Resume = true;
+        }
+    }
+
+    if (Resume && FAILED(_ThreadPool.Submit([this]() { Decode(); })))
+        Decode();
+
+    return IsChanged;
+}
+
+/// <summary>
+/// Gets the current frame, or nullptr if the first frame has not been shown yet. The frame remains valid until the next call to Update or Close.
+/// </summary>
+const Raster * AnimationPlayer::GetFrame() const noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    if (!_IsOpen || (_Shown == 0))
+        return nullptr;
+
+    return &GetSlot(_Shown - 1).Image;
+}
+
+/// <summary>
+/// Gets the time at which the current frame makes way for the next one, in seconds. Returns infinity if the animation has ended, or if the player
+/// waits for a frame and the callback will signal its arrival.
+/// </summary>
+double AnimationPlayer::GetDeadline() const noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    if (!_IsOpen || (_Shown == 0) || _IsStarved || (_Shown >= _Sequences) || (FAILED(_Status) && !IsReady(_Shown)))
+        return std::numeric_limits<double>::infinity();
+
+    return _Deadline;
+}
+
+/// <summary>
+/// Gets the outcome of the decoding: S_OK, or the error that stopped it.
+/// </summary>
+HRESULT AnimationPlayer::GetStatus() const noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    return _Status;
+}
+
+/// <summary>
+/// Gets the state of the playback.
+/// </summary>
+AnimationStatistics AnimationPlayer::GetStatistics() const noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    AnimationStatistics Statistics = { };
+
+    Statistics.FrameCount = _FrameCount;
+    Statistics.Capacity = (UINT) _Slots.size();
+    Statistics.IsResident = _IsResident;
+    Statistics.MemoryUsage = _MemoryUsage;
+
+    if (_IsResident && (_Decoded == _FrameCount))
+        Statistics.DecodeAhead = _FrameCount - ((_Shown != 0) ? 1 : 0);
+    else
+        Statistics.DecodeAhead = (UINT) ((_Decoded > _Shown) ? _Decoded - _Shown : 0);
+
+    Statistics.Decoded = _TotalDecoded;
+    Statistics.Presented = _Presented;
+    Statistics.Dropped = _Dropped;
+    Statistics.Underruns = _Underruns;
+
+    return Statistics;
+}
+
+/// <summary>
+/// Reads and composites frames until the ring is full, the animation has been decoded or the player gets closed. Runs on the thread pool.
+/// </summary>
+void AnimationPlayer::Decode() noexcept
+{
+    for (;;)
+    {
+        uint64_t Sequence;
+
+        {
+            std::lock_guard<std::mutex> Lock(_Mutex);
+
+            if (_IsClosing || FAILED(_Status) || !CanDecode())
+            {
+                _IsDecoding = false;
+                _Idle.notify_all();
+
+                return;
+            }
+
+            Sequence = _Decoded;
+        }
+
+        // Only this thread touches the source, the canvas and the slots that have not been decoded yet.
+        const UINT Index = (UINT) (Sequence % _FrameCount);
+
+        if (Index == 0)
+            _Canvas.Reset();
+
+        AnimationFrame Frame = { };
+
+        HRESULT hr = _Source->ReadFrame(Index, Frame, _Pixels);
+
+        if (SUCCEEDED(hr))
+            hr = _Canvas.Compose(Frame, _Pixels);
+
+        Slot & s = GetSlot(Sequence);
+
+        if (SUCCEEDED(hr))
+            hr = s.Image.CopyFrom(_Canvas.GetRaster());
+
+        s.Delay = (Frame.Delay > 10) ? Frame.Delay : DefaultDelay;
+
+        size_t MemoryUsage = _Canvas.GetMemoryUsage() + _Pixels.Size();
+
+        for (const Slot & Item : _Slots)
+            MemoryUsage += Item.Image.Size();
+
+        bool Notify;
+
+        {
+            std::lock_guard<std::mutex> Lock(_Mutex);
+
+            if (SUCCEEDED(hr))
+            {
+                ++_Decoded;
+                ++_TotalDecoded;
+            }
+            else
+                _Status = hr;
+
+            _MemoryUsage = MemoryUsage;
+
+            // Wake up the UI thread if it is waiting for this frame or if it will never come.
+            Notify = ((_Shown == 0) || _IsStarved) && (IsReady(_Shown) || FAILED(hr));
+        }
+
+        if (Notify && _OnFrameReady)
+            _OnFrameReady();
+    }
+}
+
+/// <summary>
+/// Returns true if the next frame can be decoded: it is part of the animation and its slot is not in use.
+/// </summary>
+bool AnimationPlayer::CanDecode() const noexcept
+{
+    if (_IsResident)
+        return _Decoded < _FrameCount;
+
+    if (_Decoded >= _Sequences)
+        return false;
+
+    // The slot of the current frame is in use until the next frame is shown.
+    const uint64_t Current = (_Shown != 0) ? _Shown - 1 : 0;
+
+    return _Decoded < Current + _Slots.size();
+}
+
+/// <summary>
+/// Returns true if the frame with the specified sequence number has been composited.
+/// </summary>
+bool AnimationPlayer::IsReady(uint64_t sequence) const noexcept
+{
+    if (_IsResident)
+        return (sequence % _FrameCount) < _Decoded;
+
+    return sequence < _Decoded;
+}
@@ -0,0 +1,193 @@
+
+/** $VER: Animation.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+#include "Raster.h"
+#include "Types.h"
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class ThreadPool;
+
+/// <summary>
+/// Identifies what happens to the area of a frame before the next frame is drawn.
+/// </summary>
+enum class FrameDisposal
+{
+    None,           // Leave the frame in place (GIF 0 and 1, APNG_DISPOSE_OP_NONE)
+    Background,     // Clear the area of the frame to transparent black (GIF 2, APNG_DISPOSE_OP_BACKGROUND)
+    Previous,       // Restore the area of the frame to what it was before the frame was drawn (GIF 3, APNG_DISPOSE_OP_PREVIOUS)
+};
+
+/// <summary>
+/// Identifies how a frame is combined with the canvas.
+/// </summary>
+enum class FrameBlend
+{
+    Source,         // Replace the pixels of the canvas (APNG_BLEND_OP_SOURCE)
+    Over,           // Draw the frame over the canvas (GIF, APNG_BLEND_OP_OVER)
+};
+
+/// <summary>
+/// Describes a frame of an animation.
+/// </summary>
+struct AnimationFrame
+{
+    RectI Rect;                 // Area of the canvas covered by the frame
+    UINT Delay;                 // Display time, in milliseconds
+    FrameDisposal Disposal;
+    FrameBlend Blend;
+};
+
+/// <summary>
+/// Provides the frames of an animation, e.g. an animated GIF. The frames are read in order, one at a time, on a worker thread.
+/// </summary>
+class AnimationSource
+{
+public:
+    virtual ~AnimationSource() { }
+
+    virtual UINT GetWidth() const noexcept = 0;
+    virtual UINT GetHeight() const noexcept = 0;
+
+    virtual UINT GetFrameCount() const noexcept = 0;
+    virtual UINT GetLoopCount() const noexcept = 0;  // Number of times the animation plays; 0 plays it forever.
+
+    /// <summary>
+    /// Reads a frame into a premultiplied BGRA raster the size of the area of the frame.
+    /// </summary>
+    virtual HRESULT ReadFrame(UINT index, AnimationFrame & frame, Raster & raster) noexcept = 0;
+};
+
+/// <summary>
+/// Composites the frames of an animation into complete images by applying the blend and disposal rules of every frame.
+/// </summary>
+class AnimationCanvas
+{
+public:
+    AnimationCanvas() noexcept : _Previous(), _HasPrevious() { }
+
+    HRESULT Initialize(UINT width, UINT height) noexcept;
+    void Reset() noexcept;
+
+    HRESULT Compose(const AnimationFrame & frame, const Raster & raster) noexcept;
+
+    const Raster & GetRaster() const noexcept { return _Canvas; }
+
+    size_t GetMemoryUsage() const noexcept { return (size_t) _Canvas.Size() + _Saved.Size(); }
+
+private:
+    RectI Clip(const RectI & rect) const noexcept;
+
+private:
+    Raster _Canvas;
+    Raster _Saved;              // Area of the previous frame before it was drawn, if it gets disposed to the previous content.
+
+    AnimationFrame _Previous;   // Clipped to the canvas
+    bool _HasPrevious;
+};
+
+/// <summary>
+/// Contains the state of the playback of an animation.
+/// </summary>
+struct AnimationStatistics
+{
+    UINT FrameCount;            // Frames in the animation
+    UINT Capacity;              // Composited frames that can be held at once
+    UINT DecodeAhead;           // Composited frames waiting to be presented
+    bool IsResident;            // True if all frames fit and get decoded only once; otherwise the animation streams through a ring.
+    size_t MemoryUsage;         // Bytes held by the composited frames, the canvas and the frame being read
+
+    uint64_t Decoded;           // Frames read and composited
+    uint64_t Presented;         // Frames shown
+    uint64_t Dropped;           // Frames skipped to catch up with the clock
+    uint64_t Underruns;         // Deadlines at which the next frame was not ready yet
+};
+
+/// <summary>
+/// Plays an animation. A worker reads and composites the frames ahead of time into a bounded ring of complete images; the UI thread picks them up
+/// at their deadlines. The deadlines are derived from the start of the playback and the frame delays, not from the moment a frame was shown,
+/// so late timer events do not accumulate into drift. Animations that fit the memory budget are decoded once and loop from memory; longer ones stream.
+/// </summary>
+class AnimationPlayer
+{
+public:
+    typedef std::function<void()> Callback;
+
+    static constexpr UINT DefaultDecodeAhead = 8;
+    static constexpr size_t DefaultBudget = 64 * 1024 * 1024;
+    static constexpr UINT DefaultDelay = 100;   // Display time, in milliseconds, of frames with a delay of 10 ms or less, like browsers do.
+
+    AnimationPlayer(Callback onFrameReady, ThreadPool * threadPool = nullptr) noexcept;
+    ~AnimationPlayer();
+
+    AnimationPlayer(const AnimationPlayer &) = delete;
+    AnimationPlayer & operator=(const AnimationPlayer &) = delete;
+
+    HRESULT Open(std::unique_ptr<AnimationSource> source, UINT decodeAhead = DefaultDecodeAhead, size_t budget = DefaultBudget) noexcept;
+    void Close() noexcept;
+
+    bool IsOpen() const noexcept;
+
+    bool Update(double now) noexcept;
+
+    const Raster * GetFrame() const noexcept;
+    double GetDeadline() const noexcept;
+    HRESULT GetStatus() const noexcept;
+
+    AnimationStatistics GetStatistics() const noexcept;
+
+private:
+    struct Slot
+    {
+        Raster Image;
+        UINT Delay;             // In milliseconds
+    };
+
+    void Decode() noexcept;
+
+    bool CanDecode() const noexcept;
+    bool IsReady(uint64_t sequence) const noexcept;
+
+    Slot & GetSlot(uint64_t sequence) noexcept { return _Slots[(size_t) (sequence % _Slots.size())]; }
+    const Slot & GetSlot(uint64_t sequence) const noexcept { return _Slots[(size_t) (sequence % _Slots.size())]; }
+
+private:
+    Callback _OnFrameReady;
+    ThreadPool & _ThreadPool;
+
+    // Owned by the worker while it is decoding.
+    std::unique_ptr<AnimationSource> _Source;
+    AnimationCanvas _Canvas;
+    Raster _Pixels;
+
+    std::vector<Slot> _Slots;   // Resident: one per frame. Streaming: a ring indexed by sequence number.
+
+    mutable std::mutex _Mutex;
+    std::condition_variable _Idle;
+
+    bool _IsOpen;
+    bool _IsResident;
+    bool _IsDecoding;
+    bool _IsClosing;
+    bool _IsStarved;
+    HRESULT _Status;
+
+    UINT _FrameCount;
+    uint64_t _Sequences;        // Frames to show before the animation ends, counting every loop. UINT64_MAX plays forever.
+    uint64_t _Decoded;          // Sequence number of the next frame to decode
+    uint64_t _Shown;            // Frames shown; the current frame has sequence number _Shown - 1.
+    double _Deadline;           // Time at which the current frame makes way for the next one, in seconds
+    size_t _MemoryUsage;
+
+    uint64_t _TotalDecoded;
+    uint64_t _Presented;
+    uint64_t _Dropped;
+    uint64_t _Underruns;
+};
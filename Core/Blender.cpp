@@ -0,0 +1,645 @@
+
+/** $VER: Blender.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "Blender.h"
+#include "Raster.h"
+
+#include <atomic>
+
+/*
+    Each operator is a struct with a scalar, an SSE2 and an AVX2 implementation that all produce the same results: every product
+    is divided by 255 and rounded to nearest. The span templates take care of loading, storing and the alignment required by the
+    non-temporal stores.
+*/
+
+static std::atomic<InstructionSet> _InstructionSet(CPU::GetInstructionSet());
+
+/// <summary>
+/// Divides by 255 and rounds to nearest. Exact for x in [0, 255 * 255].
+/// </summary>
+static inline uint32_t Div255(uint32_t x) noexcept
+{
+    x += 128;
+
+    return (x + (x >> 8)) >> 8;
+}
+
+/// <summary>
+/// Multiplies all channels of a premultiplied pixel with a value (0 - 255).
+/// </summary>
+static inline uint32_t Scale(uint32_t pixel, uint32_t value) noexcept
+{
+    uint32_t rb = (pixel & 0x00FF00FF) * value + 0x00800080;
+    uint32_t ag = ((pixel >> 8) & 0x00FF00FF) * value + 0x00800080;
+
+    rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+    ag = (ag + ((ag >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+
+    return rb | ag;
+}
+
+#ifdef CORE_X86
+
+/// <summary>
+/// Divides 8 16-bit values by 255 and rounds to nearest.
+/// </summary>
+static inline __m128i Div255_SSE2(__m128i x) noexcept
+{
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+/// <summary>
+/// Copies the alpha of 2 pixels stored as 16-bit values to all their channels.
+/// </summary>
+static inline __m128i BroadcastAlpha_SSE2(__m128i p) noexcept
+{
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(p, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+/// <summary>
+/// Divides 16 16-bit values by 255 and rounds to nearest.
+/// </summary>
+TARGET_AVX2 static inline __m256i Div255_AVX2(__m256i x) noexcept
+{
+    x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+
+    return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+/// <summary>
+/// Copies the alpha of 4 pixels stored as 16-bit values to all their channels.
+/// </summary>
+TARGET_AVX2 static inline __m256i BroadcastAlpha_AVX2(__m256i p) noexcept
+{
+    const __m256i Shuffle = _mm256_setr_epi8(6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15, 6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15);
+
+    return _mm256_shuffle_epi8(p, Shuffle);
+}
+
+#endif
+
+/// <summary>
+/// Implements the Clear operator.
+/// </summary>
+struct ClearOperator
+{
+    static const bool ReadsSource = false;
+    static const bool ReadsDestination = false;
+
+    static uint32_t Scalar(uint32_t, uint32_t) noexcept { return 0; }
+
+#ifdef CORE_X86
+    static __m128i SSE2(__m128i, __m128i) noexcept { return _mm_setzero_si128(); }
+    TARGET_AVX2 static __m256i AVX2(__m256i, __m256i) noexcept { return _mm256_setzero_si256(); }
+#endif
+};
+
+/// <summary>
+/// Implements the Copy operator.
+/// </summary>
+struct CopyOperator
+{
+    static const bool ReadsSource = true;
+    static const bool ReadsDestination = false;
+
+    static uint32_t Scalar(uint32_t s, uint32_t) noexcept { return s; }
+
+#ifdef CORE_X86
+    static __m128i SSE2(__m128i s, __m128i) noexcept { return s; }
+    TARGET_AVX2 static __m256i AVX2(__m256i s, __m256i) noexcept { return s; }
+#endif
+};
+
+/// <summary>
+/// Implements the Source Over operator.
+/// </summary>
+struct SourceOverOperator
+{
+    static const bool ReadsSource = true;
+    static const bool ReadsDestination = true;
+
+    static uint32_t Scalar(uint32_t s, uint32_t d) noexcept
+    {
+        const uint32_t Alpha = s >> 24;
+
+        if (Alpha == 255)
+            return s;
+
+        if (s == 0)
+            return d;
+
+        return s + Scale(d, 255 - Alpha);
+    }
+
+#ifdef CORE_X86
+    static __m128i SSE2(__m128i s, __m128i d) noexcept
+    {
+        const __m128i AlphaMask = _mm_set1_epi32((int) 0xFF000000);
+
+        const __m128i Alpha = _mm_and_si128(s, AlphaMask);
+
+        // All sources opaque?
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(Alpha, AlphaMask)) == 0xFFFF)
+            return s;
+
+        // All sources transparent?
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(s, _mm_setzero_si128())) == 0xFFFF)
+            return d;
+
+        const __m128i Zero = _mm_setzero_si128();
+        const __m128i InvAlpha = _mm_xor_si128(s, _mm_set1_epi8((char) 0xFF)); // 255 - Sa in the alpha bytes
+
+        const __m128i Lo = Div255_SSE2(_mm_mullo_epi16(_mm_unpacklo_epi8(d, Zero), BroadcastAlpha_SSE2(_mm_unpacklo_epi8(InvAlpha, Zero))));
+        const __m128i Hi = Div255_SSE2(_mm_mullo_epi16(_mm_unpackhi_epi8(d, Zero), BroadcastAlpha_SSE2(_mm_unpackhi_epi8(InvAlpha, Zero))));
+
+        return _mm_adds_epu8(s, _mm_packus_epi16(Lo, Hi));
+    }
+
+    TARGET_AVX2 static __m256i AVX2(__m256i s, __m256i d) noexcept
+    {
+        const __m256i AlphaMask = _mm256_set1_epi32((int) 0xFF000000);
+
+        const __m256i Alpha = _mm256_and_si256(s, AlphaMask);
+
+        if ((uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi32(Alpha, AlphaMask)) == 0xFFFFFFFFu)
+            return s;
+
+        if (_mm256_testz_si256(s, s))
+            return d;
+
+        const __m256i Zero = _mm256_setzero_si256();
+        const __m256i InvAlpha = _mm256_xor_si256(s, _mm256_set1_epi8((char) 0xFF));
+
+        const __m256i Lo = Div255_AVX2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, Zero), BroadcastAlpha_AVX2(_mm256_unpacklo_epi8(InvAlpha, Zero))));
+        const __m256i Hi = Div255_AVX2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, Zero), BroadcastAlpha_AVX2(_mm256_unpackhi_epi8(InvAlpha, Zero))));
+
+        return _mm256_adds_epu8(s, _mm256_packus_epi16(Lo, Hi));
+    }
+#endif
+};
+
+/// <summary>
+/// Implements the Plus operator.
+/// </summary>
+struct PlusOperator
+{
+    static const bool ReadsSource = true;
+    static const bool ReadsDestination = true;
+
+    static uint32_t Scalar(uint32_t s, uint32_t d) noexcept
+    {
+        uint32_t Result = 0;
+
+        for (int Shift = 0; Shift < 32; Shift += 8)
+            Result |= (std::min)(((s >> Shift) & 0xFF) + ((d >> Shift) & 0xFF), 255u) << Shift;
+
+        return Result;
+    }
+
+#ifdef CORE_X86
+    static __m128i SSE2(__m128i s, __m128i d) noexcept { return _mm_adds_epu8(s, d); }
+    TARGET_AVX2 static __m256i AVX2(__m256i s, __m256i d) noexcept { return _mm256_adds_epu8(s, d); }
+#endif
+};
+
+/// <summary>
+/// Implements the Multiply operator.
+/// </summary>
+struct MultiplyOperator
+{
+    static const bool ReadsSource = true;
+    static const bool ReadsDestination = true;
+
+    static uint32_t Scalar(uint32_t s, uint32_t d) noexcept
+    {
+        const uint32_t InvSa = 255 - (s >> 24);
+        const uint32_t InvDa = 255 - (d >> 24);
+
+        uint32_t Result = 0;
+
+        for (int Shift = 0; Shift < 32; Shift += 8)
+        {
+            const uint32_t sc = (s >> Shift) & 0xFF;
+            const uint32_t dc = (d >> Shift) & 0xFF;
+
+            Result |= (std::min)(Div255(sc * dc) + Div255(sc * InvDa) + Div255(dc * InvSa), 255u) << Shift;
+        }
+
+        return Result;
+    }
+
+#ifdef CORE_X86
+    /// <summary>
+    /// Multiplies 2 pixels stored as 16-bit values.
+    /// </summary>
+    static __m128i Multiply2_SSE2(__m128i s, __m128i d) noexcept
+    {
+        const __m128i Max = _mm_set1_epi16(255);
+
+        const __m128i InvSa = _mm_sub_epi16(Max, BroadcastAlpha_SSE2(s));
+        const __m128i InvDa = _mm_sub_epi16(Max, BroadcastAlpha_SSE2(d));
+
+        return _mm_add_epi16(_mm_add_epi16(Div255_SSE2(_mm_mullo_epi16(s, d)), Div255_SSE2(_mm_mullo_epi16(s, InvDa))), Div255_SSE2(_mm_mullo_epi16(d, InvSa)));
+    }
+
+    static __m128i SSE2(__m128i s, __m128i d) noexcept
+    {
+        const __m128i Zero = _mm_setzero_si128();
+
+        const __m128i Lo = Multiply2_SSE2(_mm_unpacklo_epi8(s, Zero), _mm_unpacklo_epi8(d, Zero));
+        const __m128i Hi = Multiply2_SSE2(_mm_unpackhi_epi8(s, Zero), _mm_unpackhi_epi8(d, Zero));
+
+        return _mm_packus_epi16(Lo, Hi);
+    }
+
+    /// <summary>
+    /// Multiplies 4 pixels stored as 16-bit values.
+    /// </summary>
+    TARGET_AVX2 static __m256i Multiply4_AVX2(__m256i s, __m256i d) noexcept
+    {
+        const __m256i Max = _mm256_set1_epi16(255);
+
+        const __m256i InvSa = _mm256_sub_epi16(Max, BroadcastAlpha_AVX2(s));
+        const __m256i InvDa = _mm256_sub_epi16(Max, BroadcastAlpha_AVX2(d));
+
+        return _mm256_add_epi16(_mm256_add_epi16(Div255_AVX2(_mm256_mullo_epi16(s, d)), Div255_AVX2(_mm256_mullo_epi16(s, InvDa))), Div255_AVX2(_mm256_mullo_epi16(d, InvSa)));
+    }
+
+    TARGET_AVX2 static __m256i AVX2(__m256i s, __m256i d) noexcept
+    {
+        const __m256i Zero = _mm256_setzero_si256();
+
+        const __m256i Lo = Multiply4_AVX2(_mm256_unpacklo_epi8(s, Zero), _mm256_unpacklo_epi8(d, Zero));
+        const __m256i Hi = Multiply4_AVX2(_mm256_unpackhi_epi8(s, Zero), _mm256_unpackhi_epi8(d, Zero));
+
+        return _mm256_packus_epi16(Lo, Hi);
+    }
+#endif
+};
+
+/// <summary>
+/// Blends a span of pixels one at a time.
+/// </summary>
+template<class Operator>
+static void Span_Scalar(const uint32_t * src, uint32_t * dst, UINT count) noexcept
+{
+    for (UINT i = 0; i < count; ++i)
+        dst[i] = Operator::Scalar(Operator::ReadsSource ? src[i] : 0, Operator::ReadsDestination ? dst[i] : 0);
+}
+
+#ifdef CORE_X86
+
+/// <summary>
+/// Blends a span of pixels 4 at a time. Streaming spans are written with non-temporal stores once the destination is 16-byte aligned.
+/// </summary>
+template<class Operator, bool Streaming>
+static void Span_SSE2(const uint32_t * src, uint32_t * dst, UINT count) noexcept
+{
+    UINT i = 0;
+
+    if (Streaming)
+    {
+        i = (std::min)(count, (UINT) (((16 - ((uintptr_t) dst & 15)) & 15) / 4));
+
+        Span_Scalar<Operator>(src, dst, i);
+    }
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i s = Operator::ReadsSource ? _mm_loadu_si128((const __m128i *) (src + i)) : _mm_setzero_si128();
+        const __m128i d = Operator::ReadsDestination ? _mm_loadu_si128((const __m128i *) (dst + i)) : _mm_setzero_si128();
+
+        if (Streaming)
+            _mm_stream_si128((__m128i *) (dst + i), Operator::SSE2(s, d));
+        else
+            _mm_storeu_si128((__m128i *) (dst + i), Operator::SSE2(s, d));
+    }
+
+    Span_Scalar<Operator>(src + i, dst + i, count - i);
+}
+
+/// <summary>
+/// Blends a span of pixels 8 at a time. Streaming spans are written with non-temporal stores once the destination is 32-byte aligned.
+/// </summary>
+template<class Operator, bool Streaming>
+TARGET_AVX2 static void Span_AVX2(const uint32_t * src, uint32_t * dst, UINT count) noexcept
+{
+    UINT i = 0;
+
+    if (Streaming)
+    {
+        i = (std::min)(count, (UINT) (((32 - ((uintptr_t) dst & 31)) & 31) / 4));
+
+        Span_Scalar<Operator>(src, dst, i);
+    }
+
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256i s = Operator::ReadsSource ? _mm256_loadu_si256((const __m256i *) (src + i)) : _mm256_setzero_si256();
+        const __m256i d = Operator::ReadsDestination ? _mm256_loadu_si256((const __m256i *) (dst + i)) : _mm256_setzero_si256();
+
+        if (Streaming)
+            _mm256_stream_si256((__m256i *) (dst + i), Operator::AVX2(s, d));
+        else
+            _mm256_storeu_si256((__m256i *) (dst + i), Operator::AVX2(s, d));
+    }
+
+    Span_Scalar<Operator>(src + i, dst + i, count - i);
+}
+
+#endif
+
+/// <summary>
+/// Blends a solid premultiplied color over a span of pixels one at a time.
+/// </summary>
+static void Fill_Scalar(uint32_t color, uint32_t * dst, UINT count) noexcept
+{
+    if ((color >> 24) == 255)
+        std::fill(dst, dst + count, color);
+    else
+    if (color != 0)
+    {
+        for (UINT i = 0; i < count; ++i)
+            dst[i] = color + Scale(dst[i], 255 - (color >> 24));
+    }
+}
+
+#ifdef CORE_X86
+
+/// <summary>
+/// Blends a solid premultiplied color over a span of pixels 4 at a time. The inverse alpha of the color is the same for every pixel.
+/// </summary>
+static void Fill_SSE2(uint32_t color, uint32_t * dst, UINT count) noexcept
+{
+    if (((color >> 24) == 255) || (color == 0))
+    {
+        Fill_Scalar(color, dst, count);
+
+        return;
+    }
+
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i Color = _mm_set1_epi32((int) color);
+    const __m128i InvAlpha = _mm_set1_epi16((short) (255 - (color >> 24)));
+
+    UINT i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+
+        const __m128i Lo = Div255_SSE2(_mm_mullo_epi16(_mm_unpacklo_epi8(d, Zero), InvAlpha));
+        const __m128i Hi = Div255_SSE2(_mm_mullo_epi16(_mm_unpackhi_epi8(d, Zero), InvAlpha));
+
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_adds_epu8(Color, _mm_packus_epi16(Lo, Hi)));
+    }
+
+    Fill_Scalar(color, dst + i, count - i);
+}
+
+/// <summary>
+/// Blends a solid premultiplied color over a span of pixels 8 at a time. Opaque colors are stored without reading the destination.
+/// </summary>
+TARGET_AVX2 static void Fill_AVX2(uint32_t color, uint32_t * dst, UINT count) noexcept
+{
+    if (color == 0)
+        return;
+
+    const __m256i Color = _mm256_set1_epi32((int) color);
+
+    UINT i = 0;
+
+    if ((color >> 24) == 255)
+    {
+        for (; i + 8 <= count; i += 8)
+            _mm256_storeu_si256((__m256i *) (dst + i), Color);
+    }
+    else
+    {
+        const __m256i Zero = _mm256_setzero_si256();
+        const __m256i InvAlpha = _mm256_set1_epi16((short) (255 - (color >> 24)));
+
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256i d = _mm256_loadu_si256((const __m256i *) (dst + i));
+
+            const __m256i Lo = Div255_AVX2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, Zero), InvAlpha));
+            const __m256i Hi = Div255_AVX2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, Zero), InvAlpha));
+
+            _mm256_storeu_si256((__m256i *) (dst + i), _mm256_adds_epu8(Color, _mm256_packus_epi16(Lo, Hi)));
+        }
+    }
+
+    Fill_Scalar(color, dst + i, count - i);
+}
+
+#endif
+
+/// <summary>
+/// Interpolates 2 spans of premultiplied pixels one at a time. The weight of the second span is 0 - 256.
+/// </summary>
+static void Lerp_Scalar(const uint32_t * a, const uint32_t * b, uint32_t * dst, UINT count, UINT weight) noexcept
+{
+    const uint32_t w0 = 256 - weight;
+
+    for (UINT i = 0; i < count; ++i)
+    {
+        const uint32_t rb = (((a[i] & 0x00FF00FF) * w0 + (b[i] & 0x00FF00FF) * weight + 0x00800080) >> 8) & 0x00FF00FF;
+        const uint32_t ag = (((a[i] >> 8) & 0x00FF00FF) * w0 + ((b[i] >> 8) & 0x00FF00FF) * weight + 0x00800080) & 0xFF00FF00;
+
+        dst[i] = rb | ag;
+    }
+}
+
+#ifdef CORE_X86
+
+/// <summary>
+/// Interpolates 2 spans of premultiplied pixels 4 at a time. The weighted sum of a channel never exceeds 16 bits.
+/// </summary>
+static void Lerp_SSE2(const uint32_t * a, const uint32_t * b, uint32_t * dst, UINT count, UINT weight) noexcept
+{
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i W0 = _mm_set1_epi16((short) (256 - weight));
+    const __m128i W1 = _mm_set1_epi16((short) weight);
+    const __m128i Half = _mm_set1_epi16(0x80);
+
+    UINT i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i p = _mm_loadu_si128((const __m128i *) (a + i));
+        const __m128i q = _mm_loadu_si128((const __m128i *) (b + i));
+
+        const __m128i Lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(p, Zero), W0), _mm_mullo_epi16(_mm_unpacklo_epi8(q, Zero), W1)), Half), 8);
+        const __m128i Hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(p, Zero), W0), _mm_mullo_epi16(_mm_unpackhi_epi8(q, Zero), W1)), Half), 8);
+
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_packus_epi16(Lo, Hi));
+    }
+
+    Lerp_Scalar(a + i, b + i, dst + i, count - i, weight);
+}
+
+/// <summary>
+/// Interpolates 2 spans of premultiplied pixels 8 at a time.
+/// </summary>
+TARGET_AVX2 static void Lerp_AVX2(const uint32_t * a, const uint32_t * b, uint32_t * dst, UINT count, UINT weight) noexcept
+{
+    const __m256i Zero = _mm256_setzero_si256();
+    const __m256i W0 = _mm256_set1_epi16((short) (256 - weight));
+    const __m256i W1 = _mm256_set1_epi16((short) weight);
+    const __m256i Half = _mm256_set1_epi16(0x80);
+
+    UINT i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256i p = _mm256_loadu_si256((const __m256i *) (a + i));
+        const __m256i q = _mm256_loadu_si256((const __m256i *) (b + i));
+
+        const __m256i Lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(p, Zero), W0), _mm256_mullo_epi16(_mm256_unpacklo_epi8(q, Zero), W1)), Half), 8);
+        const __m256i Hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(p, Zero), W0), _mm256_mullo_epi16(_mm256_unpackhi_epi8(q, Zero), W1)), Half), 8);
+
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_packus_epi16(Lo, Hi));
+    }
+
+    Lerp_Scalar(a + i, b + i, dst + i, count - i, weight);
+}
+
+#endif
+
+/// <summary>
+/// Gets the span function of an operator for the specified instruction set.
+/// </summary>
+template<class Operator>
+static Blender::SpanFunction SelectSpanFunction(InstructionSet instructionSet, bool streaming) noexcept
+{
+#ifdef CORE_X86
+    if ((instructionSet >= InstructionSet::AVX2) && CPU::HasAVX2())
+        return streaming ? Span_AVX2<Operator, true> : Span_AVX2<Operator, false>;
+
+    if ((instructionSet >= InstructionSet::SSE2) && CPU::HasSSE2())
+        return streaming ? Span_SSE2<Operator, true> : Span_SSE2<Operator, false>;
+#else
+    (void) instructionSet;
+    (void) streaming;
+#endif
+
+    return Span_Scalar<Operator>;
+}
+
+/// <summary>
+/// Gets the function that blends a span of pixels using the specified instruction set.
+/// </summary>
+Blender::SpanFunction Blender::GetSpanFunction(BlendMode mode, InstructionSet instructionSet, bool streaming) noexcept
+{
+    switch (mode)
+    {
+        case BlendMode::Clear:      return SelectSpanFunction<ClearOperator>(instructionSet, streaming);
+        case BlendMode::Copy:       return SelectSpanFunction<CopyOperator>(instructionSet, streaming);
+        case BlendMode::SourceOver: return SelectSpanFunction<SourceOverOperator>(instructionSet, streaming);
+        case BlendMode::Plus:       return SelectSpanFunction<PlusOperator>(instructionSet, streaming);
+        case BlendMode::Multiply:   return SelectSpanFunction<MultiplyOperator>(instructionSet, streaming);
+
+        default:                    return nullptr;
+    }
+}
+
+/// <summary>
+/// Gets the function that blends a solid premultiplied color over a span of pixels (Source Over) using the specified instruction set.
+/// </summary>
+Blender::FillFunction Blender::GetFillFunction(InstructionSet instructionSet) noexcept
+{
+#ifdef CORE_X86
+    if ((instructionSet >= InstructionSet::AVX2) && CPU::HasAVX2())
+        return Fill_AVX2;
+
+    if ((instructionSet >= InstructionSet::SSE2) && CPU::HasSSE2())
+        return Fill_SSE2;
+#else
+    (void) instructionSet;
+#endif
+
+    return Fill_Scalar;
+}
+
+/// <summary>
+/// Gets the function that interpolates 2 spans of premultiplied pixels using the specified instruction set.
+/// </summary>
+Blender::LerpFunction Blender::GetLerpFunction(InstructionSet instructionSet) noexcept
+{
+#ifdef CORE_X86
+    if ((instructionSet >= InstructionSet::AVX2) && CPU::HasAVX2())
+        return Lerp_AVX2;
+
+    if ((instructionSet >= InstructionSet::SSE2) && CPU::HasSSE2())
+        return Lerp_SSE2;
+#else
+    (void) instructionSet;
+#endif
+
+    return Lerp_Scalar;
+}
+
+/// <summary>
+/// Blends a premultiplied BGRA raster into another one at the specified offset. The source is clipped to the destination.
+/// </summary>
+HRESULT Blender::Blend(const Raster & src, Raster & dst, int x, int y, BlendMode mode) noexcept
+{
+    return Blend(src, dst, x, y, { 0, 0, (int) dst.Width(), (int) dst.Height() }, mode);
+}
+
+/// <summary>
+/// Blends a premultiplied BGRA raster into another one at the specified offset. Only the destination pixels inside the clip rectangle are changed.
+/// </summary>
+HRESULT Blender::Blend(const Raster & src, Raster & dst, int x, int y, const RectI & clip, BlendMode mode) noexcept
+{
+    if ((src.Format() != PixelFormat::PBGRA32) || (dst.Format() != PixelFormat::PBGRA32))
+        return E_INVALIDARG;
+
+    const int Left   = (std::max)({ x, clip.left, 0 });
+    const int Top    = (std::max)({ y, clip.top, 0 });
+    const int Right  = (std::min)({ x + (int) src.Width(),  clip.right,  (int) dst.Width() });
+    const int Bottom = (std::min)({ y + (int) src.Height(), clip.bottom, (int) dst.Height() });
+
+    if ((Left >= Right) || (Top >= Bottom))
+        return S_FALSE;
+
+    const UINT Width = (UINT) (Right - Left);
+
+    const bool Streaming = (size_t) Width * (size_t) (Bottom - Top) * 4 > StreamingThreshold;
+
+    const SpanFunction Function = GetSpanFunction(mode, GetInstructionSet(), Streaming);
+
+    if (Function == nullptr)
+        return E_INVALIDARG;
+
+    for (int j = Top; j < Bottom; ++j)
+        Function((const uint32_t *) src.Row((UINT) (j - y)) + (Left - x), (uint32_t *) dst.Row((UINT) j) + Left, Width);
+
+#ifdef CORE_X86
+    if (Streaming)
+        _mm_sfence(); // Make the non-temporal stores visible to other threads.
+#endif
+
+    return S_OK;
+}
+
+/// <summary>
+/// Gets the instruction set used by the blends.
+/// </summary>
+InstructionSet Blender::GetInstructionSet() noexcept
+{
+    return _InstructionSet;
+}
+
+/// <summary>
+/// Limits the instruction set used by the blends, e.g. to compare the kernels. The CPU capabilities are never exceeded.
+/// </summary>
+void Blender::SetInstructionSet(InstructionSet instructionSet) noexcept
+{
+    _InstructionSet = (std::min)(instructionSet, CPU::GetInstructionSet());
+}
@@ -0,0 +1,48 @@
+
+/** $VER: Blender.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+#include "CPU.h"
+#include "Types.h"
+
+class Raster;
+
+/// <summary>
+/// Identifies a Porter-Duff compositing operator. All operators work on premultiplied pixels.
+/// </summary>
+enum class BlendMode
+{
+    Clear,          // Result = 0
+    Copy,           // Result = S
+    SourceOver,     // Result = S + D * (1 - Sa)
+    Plus,           // Result = min(S + D, 1)
+    Multiply,       // Result = S * D + S * (1 - Da) + D * (1 - Sa)
+};
+
+/// <summary>
+/// Blends premultiplied BGRA pixels. Uses AVX2 or SSE2 kernels when the CPU supports them and falls back to scalar code otherwise.
+/// </summary>
+class Blender
+{
+public:
+    typedef void (* SpanFunction)(const uint32_t * src, uint32_t * dst, UINT count);
+    typedef void (* FillFunction)(uint32_t color, uint32_t * dst, UINT count);
+    typedef void (* LerpFunction)(const uint32_t * a, const uint32_t * b, uint32_t * dst, UINT count, UINT weight);
+
+    static HRESULT Blend(const Raster & src, Raster & dst, int x, int y, BlendMode mode) noexcept;
+    static HRESULT Blend(const Raster & src, Raster & dst, int x, int y, const RectI & clip, BlendMode mode) noexcept;
+
+    static InstructionSet GetInstructionSet() noexcept;
+    static void SetInstructionSet(InstructionSet instructionSet) noexcept;
+
+    static SpanFunction GetSpanFunction(BlendMode mode, InstructionSet instructionSet, bool streaming) noexcept;
+    static FillFunction GetFillFunction(InstructionSet instructionSet) noexcept;
+    static LerpFunction GetLerpFunction(InstructionSet instructionSet) noexcept;
+
+    /// <summary>
+    /// Blends that write more bytes than this bypass the caches with non-temporal stores. Chosen to exceed a typical L2 cache.
+    /// </summary>
+    static const size_t StreamingThreshold = 4 * 1024 * 1024;
+};
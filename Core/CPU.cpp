@@ -0,0 +1,116 @@
+
+/** $VER: CPU.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "CPU.h"
+
+#if defined(CORE_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(CORE_X86)
+#include <cpuid.h>
+#endif
+
+#ifdef CORE_X86
+
+/// <summary>
+/// Executes the CPUID instruction.
+/// </summary>
+static void GetCPUID(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) noexcept
+{
+#ifdef _MSC_VER
+    int Regs[4];
+
+    ::__cpuidex(Regs, (int) leaf, (int) subleaf);
+
+    for (int i = 0; i < 4; ++i)
+        regs[i] = (uint32_t) Regs[i];
+#else
+    regs[0] = regs[1] = regs[2] = regs[3] = 0;
+
+    ::__get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+}
+
+/// <summary>
+/// Returns true if the operating system saves the YMM registers on a context switch.
+/// </summary>
+static bool IsAVXStateEnabled() noexcept
+{
+#ifdef _MSC_VER
+    return (::_xgetbv(0) & 0x06) == 0x06;
+#else
+    uint32_t Lo, Hi;
+
+    __asm__ ("xgetbv" : "=a" (Lo), "=d" (Hi) : "c" (0));
+
+    return (Lo & 0x06) == 0x06;
+#endif
+}
+
+/// <summary>
+/// Determines the best instruction set supported by the CPU and the operating system.
+/// </summary>
+static InstructionSet DetectInstructionSet() noexcept
+{
+    uint32_t Regs[4];
+
+    GetCPUID(0, 0, Regs);
+
+    const uint32_t MaxLeaf = Regs[0];
+
+    if (MaxLeaf < 1)
+        return InstructionSet::Scalar;
+
+    GetCPUID(1, 0, Regs);
+
+    const bool HasSSE2    = (Regs[3] & (1u << 26)) != 0;
+    const bool HasOSXSAVE = (Regs[2] & (1u << 27)) != 0;
+    const bool HasAVX     = (Regs[2] & (1u << 28)) != 0;
+
+    if (!HasSSE2)
+        return InstructionSet::Scalar;
+
+    if ((MaxLeaf < 7) || !HasOSXSAVE || !HasAVX || !IsAVXStateEnabled())
+        return InstructionSet::SSE2;
+
+    GetCPUID(7, 0, Regs);
+
+    const bool HasAVX2 = (Regs[1] & (1u << 5)) != 0;
+
+    return HasAVX2 ? InstructionSet::AVX2 : InstructionSet::SSE2;
+}
+
+#endif
+
+/// <summary>
+/// Gets the best instruction set supported by the CPU. The result is determined once.
+/// </summary>
+InstructionSet CPU::GetInstructionSet() noexcept
+{
+#ifdef CORE_X86
+    static const InstructionSet Best = DetectInstructionSet();
+
+    return Best;
+#else
+    return InstructionSet::Scalar;
+#endif
+}
+
+/// <summary>
+/// Gets the name of an instruction set.
+/// </summary>
+const char * CPU::GetName(InstructionSet instructionSet) noexcept
+{
+    switch (instructionSet)
+    {
+        case InstructionSet::AVX2:
+            return "AVX2";
+
+        case InstructionSet::SSE2:
+            return "SSE2";
+
+        default:
+            return "Scalar";
+    }
+}
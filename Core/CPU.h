@@ -0,0 +1,45 @@
+
+/** $VER: CPU.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CORE_X86 1
+#include <immintrin.h>
+#endif
+
+/*
+    Functions that use AVX2 intrinsics are compiled for AVX2 on a per-function basis so that the rest of the code keeps running on any x86 CPU.
+    They may only be called after checking CPU::HasAVX2().
+*/
+#if defined(CORE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+/// <summary>
+/// Identifies a SIMD instruction set. The order matters: a higher value implies support for the lower ones.
+/// </summary>
+enum class InstructionSet
+{
+    Scalar,
+    SSE2,
+    AVX2,
+};
+
+/// <summary>
+/// Detects the capabilities of the CPU at run-time.
+/// </summary>
+class CPU
+{
+public:
+    static InstructionSet GetInstructionSet() noexcept;
+
+    static bool HasSSE2() noexcept { return GetInstructionSet() >= InstructionSet::SSE2; }
+    static bool HasAVX2() noexcept { return GetInstructionSet() >= InstructionSet::AVX2; }
+
+    static const char * GetName(InstructionSet instructionSet) noexcept;
+};
@@ -0,0 +1,87 @@
+
+/** $VER: Compositor.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+#include "Types.h"
+
+#include <atomic>
+
+class Raster;
+class Region;
+
+/// <summary>
+/// Represents a bitmap owned by a compositor back-end.
+/// </summary>
+class Bitmap
+{
+public:
+    Bitmap() noexcept : _Id(++_LastId) { }
+    virtual ~Bitmap() { }
+
+    virtual SizeF GetSize() const noexcept = 0;
+
+    /// <summary>
+    /// Gets an id that is unique for the lifetime of the process. Unlike the address of a bitmap it is never reused, so it identifies the content of the bitmap.
+    /// </summary>
+    uint64_t GetId() const noexcept { return _Id; }
+
+private:
+    uint64_t _Id;
+
+    static inline std::atomic<uint64_t> _LastId;
+};
+
+enum class TextAlignment
+{
+    Leading,
+    Trailing,
+    Center,
+};
+
+enum class ParagraphAlignment
+{
+    Near,
+    Far,
+    Center,
+};
+
+/// <summary>
+/// Represents the font characteristics of text, owned by a compositor back-end.
+/// </summary>
+class TextFormat
+{
+public:
+    virtual ~TextFormat() { }
+};
+
+/// <summary>
+/// Represents a back-end neutral drawing surface that gets presented to the screen or kept in memory.
+/// Drawing coordinates are in DIPs; clip rectangles and dirty regions are in pixels so that they line up with the back buffer.
+/// </summary>
+class Compositor
+{
+public:
+    virtual ~Compositor() { }
+
+    virtual SizeF GetSize() const noexcept = 0;
+
+    virtual HRESULT CreateBitmap(const Raster & raster, std::unique_ptr<Bitmap> & bitmap) noexcept = 0;
+    virtual HRESULT CreateTextFormat(const WCHAR * fontName, FLOAT fontSize, TextAlignment textAlignment, ParagraphAlignment paragraphAlignment, std::unique_ptr<TextFormat> & textFormat) noexcept = 0;
+
+    virtual void BeginDraw() noexcept = 0;
+    virtual HRESULT EndDraw() noexcept = 0;
+
+    virtual void PushClip(const RectI & rect) noexcept = 0;
+    virtual void PopClip() noexcept = 0;
+
+    virtual void Clear(const Color & color) noexcept = 0;
+    virtual void FillRectangle(const RectF & rect, const Bitmap * pattern) noexcept = 0;
+    virtual void DrawBitmap(const Bitmap * bitmap, const RectF & rect) noexcept = 0;
+    virtual void FillEllipse(const PointF & center, FLOAT radiusX, FLOAT radiusY, const Color & color) noexcept = 0;
+    virtual void DrawString(const WCHAR * text, UINT length, const TextFormat * textFormat, const RectF & rect, const Color & color) noexcept = 0;
+
+    virtual HRESULT Present() noexcept = 0;
+    virtual HRESULT Present(const Region & dirtyRegion) noexcept = 0;
+};
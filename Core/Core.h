@@ -0,0 +1,99 @@
+
+/** $VER: Core.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+/*
+    Portable counterpart of framework.h. Everything in the Core folder only depends on this header and the C++ standard library
+    so that it can be built, profiled and benchmarked without the Windows SDK.
+*/
+
+#ifdef _MSC_VER
+#pragma warning(disable: 4100 4625 4626 4710 4711 5045)
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <wchar.h>
+
+#include <cmath>
+#include <algorithm>
+#include <memory>
+
+/*
+    Windows SDK types and HRESULT codes used by the portable code. The definitions are token-identical to the ones in the SDK
+    so that Core headers can be included before or after windows.h.
+*/
+
+#ifdef _WIN32
+typedef long HRESULT;
+#else
+typedef int32_t HRESULT;
+#endif
+
+typedef unsigned int UINT;
+typedef unsigned char BYTE;
+typedef float FLOAT;
+typedef wchar_t WCHAR;
+
+#ifndef _HRESULT_TYPEDEF_
+#define _HRESULT_TYPEDEF_(_sc) ((HRESULT)_sc)
+#endif
+
+#ifndef S_OK
+#define S_OK ((HRESULT)0L)
+#endif
+
+#ifndef S_FALSE
+#define S_FALSE ((HRESULT)1L)
+#endif
+
+#ifndef E_NOTIMPL
+#define E_NOTIMPL _HRESULT_TYPEDEF_(0x80004001L)
+#endif
+
+#ifndef E_ABORT
+#define E_ABORT _HRESULT_TYPEDEF_(0x80004004L)
+#endif
+
+#ifndef E_FAIL
+#define E_FAIL _HRESULT_TYPEDEF_(0x80004005L)
+#endif
+
+#ifndef E_PENDING
+#define E_PENDING _HRESULT_TYPEDEF_(0x8000000AL)
+#endif
+
+#ifndef E_OUTOFMEMORY
+#define E_OUTOFMEMORY _HRESULT_TYPEDEF_(0x8007000EL)
+#endif
+
+#ifndef E_ACCESSDENIED
+#define E_ACCESSDENIED _HRESULT_TYPEDEF_(0x80070005L)
+#endif
+
+#ifndef STG_E_FILENOTFOUND
+#define STG_E_FILENOTFOUND _HRESULT_TYPEDEF_(0x80030002L)
+#endif
+
+#ifndef E_INVALIDARG
+#define E_INVALIDARG _HRESULT_TYPEDEF_(0x80070057L)
+#endif
+
+#ifndef SUCCEEDED
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#endif
+
+#ifndef FAILED
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
+#endif
+
+#ifndef _countof
+#define _countof(a) (sizeof(a) / sizeof((a)[0]))
+#endif
+
+#ifndef Assert
+#include <assert.h>
+#define Assert(b) assert(b)
+#endif
@@ -0,0 +1,172 @@
+
+/** $VER: DamageTracker.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "DamageTracker.h"
+
+#include <cmath>
+#include <new>
+
+/// <summary>
+/// Initializes a new instance. The first frame is always redrawn completely.
+/// </summary>
+DamageTracker::DamageTracker() noexcept : _Width(), _Height(), _Scale(1.f), _IsInvalid(true), _Frames(), _SkippedFrames(), _TotalDirtyPixels(), _TotalTargetPixels()
+{
+}
+
+/// <summary>
+/// Starts collecting the elements of a frame. The size of the target is in pixels; the scale converts the bounds of the elements from DIPs to pixels.
+/// </summary>
+void DamageTracker::BeginFrame(UINT width, UINT height, FLOAT scale) noexcept
+{
+    if ((width != _Width) || (height != _Height) || (scale != _Scale))
+        _IsInvalid = true;
+
+    _Width = width;
+    _Height = height;
+    _Scale = scale;
+
+    _Current.clear();
+}
+
+/// <summary>
+/// Adds an element of the frame. The bounds are grown to whole pixels plus 1 pixel for anti-aliasing.
+/// </summary>
+void DamageTracker::Add(UINT id, const RectF & bounds, uint64_t content) noexcept
+{
+    const RectI Bounds =
+    {
+        (int) std::floor(bounds.left   * _Scale) - 1,
+        (int) std::floor(bounds.top    * _Scale) - 1,
+        (int) std::ceil (bounds.right  * _Scale) + 1,
+        (int) std::ceil (bounds.bottom * _Scale) + 1,
+    };
+
+    try
+    {
+        _Current.push_back({ id, Bounds, content });
+    }
+    catch (const std::bad_alloc &)
+    {
+        _IsInvalid = true; // The element can not be compared with the next frame.
+    }
+}
+
+/// <summary>
+/// Finishes the frame and gets the area that has to be redrawn. The area is empty if nothing changed since the previous frame.
+/// </summary>
+const Region & DamageTracker::EndFrame() noexcept
+{
+    const RectI Target = { 0, 0, (int) _Width, (int) _Height };
+
+    _Damage.Clear();
+
+    if (_IsInvalid)
+        _Damage.Union(Target);
+    else
+    {
+        _Damage.Union(_Invalid);
+
+        for (const Element & e : _Current)
+        {
+            const Element * Previous = nullptr;
+
+            for (const Element & p : _Previous)
+            {
+                if (p.Id == e.Id)
+                {
+                    Previous = &p;
+                    break;
+                }
+            }
+
+            if (Previous == nullptr)
+                _Damage.Union(e.Bounds);
+            else
+            if ((Previous->Content != e.Content) || !IsEqual(Previous->Bounds, e.Bounds))
+            {
+                _Damage.Union(Previous->Bounds);
+                _Damage.Union(e.Bounds);
+            }
+        }
+
+        for (const Element & p : _Previous)
+        {
+            bool IsRemoved = true;
+
+            for (const Element & e : _Current)
+            {
+                if (e.Id == p.Id)
+                {
+                    IsRemoved = false;
+                    break;
+                }
+            }
+
+            if (IsRemoved)
+                _Damage.Union(p.Bounds);
+        }
+
+        _Damage.Intersect(Target);
+        _Damage.Simplify(MaxRects);
+    }
+
+    _IsInvalid = false;
+    _Invalid.Clear();
+
+    _Previous.swap(_Current);
+
+    const uint64_t DirtyPixels = _Damage.GetArea();
+
+    if (DirtyPixels != 0)
+        ++_Frames;
+    else
+        ++_SkippedFrames;
+
+    _TotalDirtyPixels += DirtyPixels;
+    _TotalTargetPixels += (uint64_t) _Width * _Height;
+
+    return _Damage;
+}
+
+/// <summary>
+/// Marks an area, in pixels, that has to be redrawn in the next frame.
+/// </summary>
+void DamageTracker::Invalidate(const RectI & rect) noexcept
+{
+    _Invalid.Union(rect);
+}
+
+/// <summary>
+/// Marks the complete target to be redrawn in the next frame, e.g. because the contents of the back buffers were lost.
+/// </summary>
+void DamageTracker::InvalidateAll() noexcept
+{
+    _IsInvalid = true;
+}
+
+/// <summary>
+/// Gets the counters of the tracker.
+/// </summary>
+DamageStatistics DamageTracker::GetStatistics() const noexcept
+{
+    const uint64_t DirtyPixels = _Damage.GetArea();
+    const uint64_t TargetPixels = (uint64_t) _Width * _Height;
+
+    return
+    {
+        _Frames, _SkippedFrames,
+        (UINT) _Damage.GetRects().size(), DirtyPixels, TargetPixels, (TargetPixels != 0) ? (double) DirtyPixels / (double) TargetPixels : 0.,
+        _TotalDirtyPixels, _TotalTargetPixels
+    };
+}
+
+/// <summary>
+/// Resets the counters.
+/// </summary>
+void DamageTracker::ResetStatistics() noexcept
+{
+    _Frames = _SkippedFrames = 0;
+    _TotalDirtyPixels = _TotalTargetPixels = 0;
+}
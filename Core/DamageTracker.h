@@ -0,0 +1,80 @@
+
+/** $VER: DamageTracker.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+#include "Region.h"
+#include "Types.h"
+
+#include <vector>
+
+/// <summary>
+/// Contains the counters of a damage tracker.
+/// </summary>
+struct DamageStatistics
+{
+    uint64_t Frames;            // Frames that had to be (partially) redrawn
+    uint64_t SkippedFrames;     // Frames without damage
+
+    UINT DirtyRects;            // Rectangles redrawn in the last frame
+    uint64_t DirtyPixels;       // Pixels redrawn in the last frame
+    uint64_t TargetPixels;      // Pixels of the target in the last frame
+    double FillRate;            // Fraction of the target redrawn in the last frame
+
+    uint64_t TotalDirtyPixels;  // Pixels redrawn in all frames
+    uint64_t TotalTargetPixels; // Pixels a full redraw of all frames would have filled
+};
+
+/// <summary>
+/// Determines the damaged area of a frame by comparing the elements of the frame with those of the previous frame.
+/// Every element reports an id, its bounds and a key that changes when its content changes. An element that appears, disappears, moves or changes
+/// damages its old and its new bounds. Changes that are not described by the elements, e.g. lost back buffers, are reported with Invalidate.
+/// </summary>
+class DamageTracker
+{
+public:
+    static const UINT MaxRects = 8; // The damage is simplified to at most this number of rectangles.
+
+    DamageTracker() noexcept;
+
+    void BeginFrame(UINT width, UINT height, FLOAT scale = 1.f) noexcept;
+    void Add(UINT id, const RectF & bounds, uint64_t content) noexcept;
+    const Region & EndFrame() noexcept;
+
+    void Invalidate(const RectI & rect) noexcept;
+    void InvalidateAll() noexcept;
+
+    const Region & GetDamage() const noexcept { return _Damage; }
+
+    DamageStatistics GetStatistics() const noexcept;
+    void ResetStatistics() noexcept;
+
+private:
+    struct Element
+    {
+        UINT Id;
+        RectI Bounds;
+        uint64_t Content;
+    };
+
+    static bool IsEqual(const RectI & a, const RectI & b) noexcept { return (a.left == b.left) && (a.top == b.top) && (a.right == b.right) && (a.bottom == b.bottom); }
+
+private:
+    UINT _Width;
+    UINT _Height;
+    FLOAT _Scale;               // Pixels per DIP
+
+    bool _IsInvalid;            // The next frame has to be redrawn completely.
+    Region _Invalid;            // Area that has to be redrawn in the next frame, in addition to the damage caused by the elements.
+
+    std::vector<Element> _Previous;
+    std::vector<Element> _Current;
+
+    Region _Damage;
+
+    uint64_t _Frames;
+    uint64_t _SkippedFrames;
+    uint64_t _TotalDirtyPixels;
+    uint64_t _TotalTargetPixels;
+};
@@ -0,0 +1,42 @@
+
+/** $VER: Font.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+
+/// <summary>
+/// Represents the built-in 5 x 7 bitmap font used by the software compositor. All metrics are expressed in pixels for the specified font size.
+/// </summary>
+class Font
+{
+public:
+    Font(FLOAT fontSize) noexcept : _FontSize(fontSize), _Unit(fontSize / 10.f) { }
+
+    FLOAT FontSize() const noexcept { return _FontSize; }
+
+    /// <summary>
+    /// Gets the size of one cell of the glyph grid.
+    /// </summary>
+    FLOAT Unit() const noexcept { return _Unit; }
+
+    FLOAT Advance() const noexcept { return _Unit * (FLOAT) CellWidth; }
+    FLOAT LineHeight() const noexcept { return _Unit * (FLOAT) LineCells; }
+    FLOAT GlyphTop() const noexcept { return _Unit * (FLOAT) TopCells; }
+
+    FLOAT Measure(const WCHAR *, UINT length) const noexcept { return Advance() * (FLOAT) length; }
+
+    static const BYTE * GetGlyph(WCHAR c) noexcept;
+
+public:
+    static const UINT GlyphWidth = 5;   // Columns in a glyph; bit 4 of a row is the leftmost column.
+    static const UINT GlyphHeight = 7;  // Rows in a glyph.
+
+    static const UINT CellWidth = 6;    // Glyph width plus one column of spacing.
+    static const UINT LineCells = 12;   // Line height, roughly the ascent + descent + line gap of Verdana.
+    static const UINT TopCells = 2;     // Space between the top of the line and the top of a glyph.
+
+private:
+    FLOAT _FontSize;
+    FLOAT _Unit;
+};
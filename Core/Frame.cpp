@@ -0,0 +1,177 @@
+
+/** $VER: Frame.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "Frame.h"
+#include "DamageTracker.h"
+
+#include <algorithm>
+
+const WCHAR AppFrame::FontName[] = L"Verdana";
+const FLOAT AppFrame::FontSize = 24.f;
+
+/// <summary>
+/// Gets the rectangle that centers a bitmap in the render target.
+/// </summary>
+static RectF GetCenteredRect(const SizeF & renderTargetSize, const SizeF & size) noexcept
+{
+    RectF Rect = { (renderTargetSize.width - size.width) / 2.f, (renderTargetSize.height - size.height) / 2.f, size.width, size.height };
+
+    Rect.right += Rect.left;
+    Rect.bottom += Rect.top;
+
+    return Rect;
+}
+
+/// <summary>
+/// Identifies the elements of the main window for damage tracking.
+/// </summary>
+enum AppElement : UINT
+{
+    BackgroundElement,
+    ImageElement,
+    SpotlightElement,
+    MessageElement,
+};
+
+/// <summary>
+/// Renders the main window: the background grid, the image, the spotlight and the message.
+/// </summary>
+void AppFrame::Render(Compositor & compositor) const noexcept
+{
+    const SizeF RenderTargetSize = compositor.GetSize();
+
+    compositor.Clear({ 0.f, 0.f, 0.f, 0.f });
+
+    if (Background)
+        compositor.FillRectangle({ 0.f, 0.f, RenderTargetSize.width, RenderTargetSize.height }, Background);
+
+    if (Image)
+        compositor.DrawBitmap(Image, GetImageRect(RenderTargetSize));
+
+    // Draw the spotlight.
+    {
+        const RectF Rect = GetSpotlightRect(RenderTargetSize);
+
+        compositor.FillEllipse({ (Rect.left + Rect.right) / 2.f, (Rect.top + Rect.bottom) / 2.f }, Rect.Width() / 2.f, Rect.Height() / 2.f, { .75f, .75f, 1.f, .25f });
+    }
+
+    if (Message && Message[0])
+        compositor.DrawString(Message, (UINT) ::wcslen(Message), Format, { 0.f, 0.f, RenderTargetSize.width, RenderTargetSize.height }, { 0.f, 0.f, 0.f, 1.f });
+}
+
+/// <summary>
+/// Renders the parts of the main window inside a region, in pixels. Returns without drawing anything if the region is empty.
+/// </summary>
+void AppFrame::Render(Compositor & compositor, const Region & region) const noexcept
+{
+    for (const RectI & Rect : region.GetRects())
+    {
+        compositor.PushClip(Rect);
+
+        Render(compositor);
+
+        compositor.PopClip();
+    }
+}
+
+/// <summary>
+/// Reports the bounds and the content of the elements of the main window to a damage tracker.
+/// </summary>
+void AppFrame::AddElements(DamageTracker & damageTracker, const SizeF & renderTargetSize) const noexcept
+{
+    const RectF Bounds = { 0.f, 0.f, renderTargetSize.width, renderTargetSize.height };
+
+    if (Background)
+        damageTracker.Add(BackgroundElement, Bounds, Background->GetId());
+
+    if (Image)
+        damageTracker.Add(ImageElement, GetImageRect(renderTargetSize), Image->GetId());
+
+    damageTracker.Add(SpotlightElement, GetSpotlightRect(renderTargetSize), 0);
+
+    // The extent of the text depends on the back-end so the complete layout rectangle is used.
+    if (Message && Message[0])
+        damageTracker.Add(MessageElement, Bounds, GetHash(Message));
+}
+
+/// <summary>
+/// Gets the rectangle of the image: centered and, while previewing, stretched to fit.
+/// </summary>
+RectF AppFrame::GetImageRect(const SizeF & renderTargetSize) const noexcept
+{
+    SizeF Size = Image->GetSize();
+
+    if ((PreviewScale > 0.f) && (Size.width > 0.f) && (Size.height > 0.f))
+    {
+        const FLOAT Scale = (std::min)({ renderTargetSize.width / Size.width, renderTargetSize.height / Size.height, PreviewScale });
+
+        Size = { Size.width * Scale, Size.height * Scale };
+    }
+
+    return GetCenteredRect(renderTargetSize, Size);
+}
+
+/// <summary>
+/// Gets the bounding rectangle of the spotlight.
+/// </summary>
+RectF AppFrame::GetSpotlightRect(const SizeF & renderTargetSize) noexcept
+{
+    const PointF Center = { renderTargetSize.width / 2.f, renderTargetSize.height / 2.f };
+    const FLOAT Radius = (std::max)(((std::min)(renderTargetSize.width, renderTargetSize.height) / 2.f) - 8.f, 0.f);
+
+    return { Center.x - Radius, Center.y - Radius, Center.x + Radius, Center.y + Radius };
+}
+
+/// <summary>
+/// Gets the FNV-1a hash of a string.
+/// </summary>
+uint64_t AppFrame::GetHash(const WCHAR * text) noexcept
+{
+    uint64_t Hash = 14695981039346656037ull;
+
+    for (; *text != 0; ++text)
+    {
+        Hash ^= (uint64_t) *text;
+        Hash *= 1099511628211ull;
+    }
+
+    return Hash;
+}
+
+/// <summary>
+/// Creates the 10 x 10 pattern that gets tiled to paint the background grid.
+/// </summary>
+HRESULT AppFrame::CreateGridPattern(Raster & raster) noexcept
+{
+    HRESULT hr = raster.Initialize(10, 10, PixelFormat::PBGRA32);
+
+    if (SUCCEEDED(hr))
+    {
+        const uint32_t GridColor = Color { 0.93f, 0.94f, 0.96f, 1.0f }.ToPBGRA();
+
+        uint32_t * Row = (uint32_t *) raster.Row(0);
+
+        for (UINT x = 0; x < raster.Width(); ++x)
+            Row[x] = GridColor;
+
+        for (UINT y = 1; y < raster.Height(); ++y)
+            ((uint32_t *) raster.Row(y))[0] = GridColor;
+    }
+
+    return hr;
+}
+
+/// <summary>
+/// Renders the child layer: a transparent layer with a centered image.
+/// </summary>
+void ChildFrame::Render(Compositor & compositor) const noexcept
+{
+    const SizeF RenderTargetSize = compositor.GetSize();
+
+    compositor.Clear({ 0.f, 0.f, 0.f, 0.f });
+
+    if (Image)
+        compositor.DrawBitmap(Image, GetCenteredRect(RenderTargetSize, Image->GetSize()));
+}
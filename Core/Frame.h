@@ -0,0 +1,53 @@
+
+/** $VER: Frame.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+#include "Compositor.h"
+#include "Raster.h"
+#include "Region.h"
+
+class DamageTracker;
+
+/// <summary>
+/// Describes the content of the main window. The same frame is rendered by every compositor back-end.
+/// </summary>
+struct AppFrame
+{
+    const Bitmap * Background;  // Tiled grid pattern
+    const Bitmap * Image;       // Centered image
+    const TextFormat * Format;
+    const WCHAR * Message;
+    FLOAT PreviewScale;         // If not 0, the image is stretched to fit the render target, up to this factor. Used while the window is being resized.
+
+    void Render(Compositor & compositor) const noexcept;
+    void Render(Compositor & compositor, const Region & region) const noexcept;
+    void AddElements(DamageTracker & damageTracker, const SizeF & renderTargetSize) const noexcept;
+
+    static HRESULT CreateGridPattern(Raster & raster) noexcept;
+
+    static const WCHAR FontName[];
+    static const FLOAT FontSize;
+
+private:
+    RectF GetImageRect(const SizeF & renderTargetSize) const noexcept;
+
+    static RectF GetSpotlightRect(const SizeF & renderTargetSize) noexcept;
+    static uint64_t GetHash(const WCHAR * text) noexcept;
+};
+
+/// <summary>
+/// Describes the content of the child layer, a transparent visual on top of the main window.
+/// </summary>
+struct ChildFrame
+{
+    const Bitmap * Image;       // Centered image
+
+    void Render(Compositor & compositor) const noexcept;
+
+    static const int Left = 16;
+    static const int Top = 16;
+    static const UINT Width = 144;
+    static const UINT Height = 144;
+};
@@ -0,0 +1,282 @@
+
+/** $VER: FrameProfiler.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "FrameProfiler.h"
+
+#if CORE_PROFILING
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <new>
+
+/// <summary>
+/// Initializes a new instance.
+/// </summary>
+FrameProfiler::FrameProfiler() noexcept : _Epoch(Clock::now()), _FrameStart(_Epoch), _Phases(), _Head()
+{
+    for (Slot & s : _Slots)
+    {
+        s.Sequence.store(0, std::memory_order_relaxed);
+        s.Start.store(0, std::memory_order_relaxed);
+        s.Total.store(0, std::memory_order_relaxed);
+
+        for (auto & Phase : s.Phases)
+            Phase.store(0, std::memory_order_relaxed);
+    }
+}
+
+/// <summary>
+/// Starts a frame.
+/// </summary>
+void FrameProfiler::BeginFrame() noexcept
+{
+    _FrameStart = Clock::now();
+}
+
+/// <summary>
+/// Ends the frame and publishes it in the ring, overwriting the oldest frame if the ring is full.
+/// </summary>
+void FrameProfiler::EndFrame() noexcept
+{
+    const Clock::time_point Now = Clock::now();
+
+    const uint64_t Frame = _Head.load(std::memory_order_relaxed);
+
+    Slot & s = _Slots[Frame % Capacity];
+
+    s.Sequence.store(2 * Frame + 1, std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_release); // The odd sequence becomes visible before any of the new fields.
+
+    s.Start.store((_FrameStart - _Epoch).count(), std::memory_order_relaxed);
+    s.Total.store((Now - _FrameStart).count(), std::memory_order_relaxed);
+
+    for (size_t i = 0; i < _countof(_Phases); ++i)
+    {
+        s.Phases[i].store(_Phases[i], std::memory_order_relaxed);
+
+        _Phases[i] = 0;
+    }
+
+    s.Sequence.store(2 * Frame + 2, std::memory_order_release);
+
+    _Head.store(Frame + 1, std::memory_order_release);
+}
+
+/// <summary>
+/// Gets a snapshot of the frames in the ring, oldest first. Frames that are overwritten while they are being copied are left out.
+/// </summary>
+HRESULT FrameProfiler::GetFrames(std::vector<FrameRecord> & frames) const noexcept
+{
+    const uint64_t Head = _Head.load(std::memory_order_acquire);
+    const uint64_t Tail = (Head > Capacity) ? Head - Capacity : 0;
+
+    const double Period = (double) Clock::period::num / (double) Clock::period::den;
+
+    try
+    {
+        frames.clear();
+        frames.reserve((size_t) (Head - Tail));
+
+        for (uint64_t Frame = Tail; Frame < Head; ++Frame)
+        {
+            const Slot & s = _Slots[Frame % Capacity];
+
+            const uint64_t Sequence = s.Sequence.load(std::memory_order_acquire);
+
+            if (Sequence != 2 * Frame + 2)
+                continue;
+
+            FrameRecord Record = { Frame, (double) s.Start.load(std::memory_order_relaxed) * Period, (double) s.Total.load(std::memory_order_relaxed) * Period, { } };
+
+            for (size_t i = 0; i < _countof(Record.Phases); ++i)
+                Record.Phases[i] = (double) s.Phases[i].load(std::memory_order_relaxed) * Period;
+
+            std::atomic_thread_fence(std::memory_order_acquire); // The fields are read before the sequence is checked again.
+
+            if (s.Sequence.load(std::memory_order_relaxed) != Sequence)
+                continue;
+
+            frames.push_back(Record);
+        }
+    }
+    catch (const std::bad_alloc &)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    return S_OK;
+}
+
+/// <summary>
+/// Gets the distribution of the duration of a phase over the frames in the ring. FramePhase::Count summarizes the duration of the complete frames.
+/// </summary>
+HRESULT FrameProfiler::GetSummary(FramePhase phase, PhaseSummary & summary) const noexcept
+{
+    std::vector<FrameRecord> Frames;
+
+    HRESULT hr = GetFrames(Frames);
+
+    if (SUCCEEDED(hr))
+        hr = GetSummary(Frames, phase, summary);
+
+    return hr;
+}
+
+/// <summary>
+/// Exports the frames in the ring as CSV or JSON.
+/// </summary>
+HRESULT FrameProfiler::Export(ProfileFormat format, std::string & text) const noexcept
+{
+    std::vector<FrameRecord> Frames;
+
+    HRESULT hr = GetFrames(Frames);
+
+    if (FAILED(hr))
+        return hr;
+
+    const size_t PhaseCount = (size_t) FramePhase::Count;
+
+    char Line[128];
+
+    try
+    {
+        text.clear();
+
+        if (format == ProfileFormat::CSV)
+        {
+            text += "Frame,Start,Total";
+
+            for (size_t i = 0; i < PhaseCount; ++i)
+                (text += ',') += GetName((FramePhase) i);
+
+            text += '\n';
+
+            for (const FrameRecord & r : Frames)
+            {
+                ::snprintf(Line, sizeof(Line), "%llu,%.3f,%.3f", (unsigned long long) r.Frame, r.Start * 1e3, r.Total * 1e3);
+
+                text += Line;
+
+                for (size_t i = 0; i < PhaseCount; ++i)
+                {
+                    ::snprintf(Line, sizeof(Line), ",%.3f", r.Phases[i] * 1e3);
+
+                    text += Line;
+                }
+
+                text += '\n';
+            }
+        }
+        else
+        {
+            text += "{\n  \"frames\": [\n";
+
+            for (size_t j = 0; j < Frames.size(); ++j)
+            {
+                const FrameRecord & r = Frames[j];
+
+                ::snprintf(Line, sizeof(Line), "    { \"frame\": %llu, \"start\": %.3f, \"total\": %.3f", (unsigned long long) r.Frame, r.Start * 1e3, r.Total * 1e3);
+
+                text += Line;
+
+                for (size_t i = 0; i < PhaseCount; ++i)
+                {
+                    ::snprintf(Line, sizeof(Line), ", \"%s\": %.3f", GetName((FramePhase) i), r.Phases[i] * 1e3);
+
+                    text += Line;
+                }
+
+                text += (j + 1 < Frames.size()) ? " },\n" : " }\n";
+            }
+
+            text += "  ],\n  \"summary\": {\n";
+
+            for (size_t i = 0; i <= PhaseCount; ++i)
+            {
+                PhaseSummary Summary;
+
+                hr = GetSummary(Frames, (FramePhase) i, Summary);
+
+                if (FAILED(hr))
+                    return hr;
+
+                ::snprintf(Line, sizeof(Line), "    \"%s\": { \"count\": %llu, \"mean\": %.3f, \"p50\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"max\": %.3f }%s\n",
+                    (i < PhaseCount) ? GetName((FramePhase) i) : "Total", (unsigned long long) Summary.Count,
+                    Summary.Mean * 1e3, Summary.P50 * 1e3, Summary.P95 * 1e3, Summary.P99 * 1e3, Summary.Maximum * 1e3, (i < PhaseCount) ? "," : "");
+
+                text += Line;
+            }
+
+            text += "  }\n}\n";
+        }
+    }
+    catch (const std::bad_alloc &)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    return S_OK;
+}
+
+/// <summary>
+/// Gets the name of a phase.
+/// </summary>
+const char * FrameProfiler::GetName(FramePhase phase) noexcept
+{
+    static const char * const Names[] = { "Resources", "Bitmap", "Damage", "Draw", "Flush", "Compose", "Present" };
+
+    static_assert(_countof(Names) == (size_t) FramePhase::Count, "Every phase needs a name.");
+
+    return ((size_t) phase < _countof(Names)) ? Names[(size_t) phase] : "Total";
+}
+
+/// <summary>
+/// Gets the distribution of the duration of a phase over a set of frames. The percentiles use the nearest rank.
+/// </summary>
+HRESULT FrameProfiler::GetSummary(const std::vector<FrameRecord> & frames, FramePhase phase, PhaseSummary & summary) noexcept
+{
+    summary = { };
+
+    if (frames.empty())
+        return S_OK;
+
+    std::vector<double> Durations;
+
+    try
+    {
+        Durations.reserve(frames.size());
+
+        for (const FrameRecord & r : frames)
+            Durations.push_back((phase < FramePhase::Count) ? r.Phases[(size_t) phase] : r.Total);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    std::sort(Durations.begin(), Durations.end());
+
+    const size_t n = Durations.size();
+
+    double Sum = 0.;
+
+    for (double d : Durations)
+        Sum += d;
+
+    auto Percentile = [&Durations, n](size_t p) { return Durations[(std::max)((n * p + 99) / 100, (size_t) 1) - 1]; };
+
+    summary.Count   = n;
+    summary.Mean    = Sum / (double) n;
+    summary.P50     = Percentile(50);
+    summary.P95     = Percentile(95);
+    summary.P99     = Percentile(99);
+    summary.Maximum = Durations[n - 1];
+
+    return S_OK;
+}
+
+#endif
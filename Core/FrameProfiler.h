@@ -0,0 +1,184 @@
+
+/** $VER: FrameProfiler.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/*
+    CORE_PROFILING selects the frame profiler at compile time. It defaults to on in debug builds and to off in release builds. When it is off
+    FrameProfiler and PhaseTimer are empty classes with inline no-op members, so the instrumented code compiles to nothing.
+*/
+
+#ifndef CORE_PROFILING
+#ifdef NDEBUG
+#define CORE_PROFILING 0
+#else
+#define CORE_PROFILING 1
+#endif
+#endif
+
+/// <summary>
+/// Identifies a phase of a frame.
+/// </summary>
+enum class FramePhase : UINT
+{
+    Resources,  // Creating device dependent resources. Includes Bitmap if the bitmap gets created during the frame.
+    Bitmap,     // Decoding, scaling and uploading the bitmap
+    Damage,     // Determining the dirty region
+    Draw,       // Issuing the draw commands
+    Flush,      // Executing the draw commands (EndDraw)
+    Compose,    // Layering the child on top of the main window and committing the visual tree
+    Present,    // Presenting the frame
+
+    Count
+};
+
+/// <summary>
+/// Contains the duration of every phase of a frame, in seconds.
+/// </summary>
+struct FrameRecord
+{
+    uint64_t Frame;         // Sequence number, starting at 0
+    double Start;           // Start of the frame, relative to the creation of the profiler
+    double Total;           // Duration of the complete frame
+    double Phases[(size_t) FramePhase::Count];
+};
+
+/// <summary>
+/// Contains the distribution of the duration of a phase, in seconds.
+/// </summary>
+struct PhaseSummary
+{
+    uint64_t Count;         // Frames in the summary
+    double Mean;
+    double P50;
+    double P95;
+    double P99;
+    double Maximum;
+};
+
+/// <summary>
+/// Identifies the format of an exported profile.
+/// </summary>
+enum class ProfileFormat
+{
+    CSV,                    // One line per frame, durations in milliseconds
+    JSON,                   // The frames and the summary of every phase, durations in milliseconds
+};
+
+#if CORE_PROFILING
+
+/// <summary>
+/// Records the duration of the phases of the last frames in a fixed-size ring. Frames and phases are recorded by a single thread, the render thread;
+/// any thread can take a snapshot of the ring without blocking it. Phases that are timed between frames are attributed to the next frame.
+/// </summary>
+class FrameProfiler
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    static constexpr UINT Capacity = 1024; // Number of frames kept in the ring
+
+    FrameProfiler() noexcept;
+
+    FrameProfiler(const FrameProfiler &) = delete;
+    FrameProfiler & operator=(const FrameProfiler &) = delete;
+
+    void BeginFrame() noexcept;
+    void EndFrame() noexcept;
+
+    void AddPhase(FramePhase phase, Clock::duration duration) noexcept { _Phases[(size_t) phase] += duration.count(); }
+
+    uint64_t GetFrameCount() const noexcept { return _Head.load(std::memory_order_acquire); }
+
+    HRESULT GetFrames(std::vector<FrameRecord> & frames) const noexcept;
+    HRESULT GetSummary(FramePhase phase, PhaseSummary & summary) const noexcept;
+
+    HRESULT Export(ProfileFormat format, std::string & text) const noexcept;
+
+    static const char * GetName(FramePhase phase) noexcept;
+
+private:
+    static HRESULT GetSummary(const std::vector<FrameRecord> & frames, FramePhase phase, PhaseSummary & summary) noexcept;
+
+private:
+    /// <summary>
+    /// Contains a frame in the ring. The sequence is odd while the slot is being written, and 2 * (frame + 1) once frame has been written completely.
+    /// Every field is atomic so that a reader that races with the writer gets a torn record that it can detect, rather than undefined behavior.
+    /// </summary>
+    struct Slot
+    {
+        std::atomic<uint64_t> Sequence;
+        std::atomic<Clock::rep> Start;
+        std::atomic<Clock::rep> Total;
+        std::atomic<Clock::rep> Phases[(size_t) FramePhase::Count];
+    };
+
+    Clock::time_point _Epoch;
+    Clock::time_point _FrameStart;
+    Clock::rep _Phases[(size_t) FramePhase::Count]; // Accumulates the phases of the current frame. Only used by the render thread.
+
+    std::atomic<uint64_t> _Head;    // Number of frames written
+    Slot _Slots[Capacity];
+};
+
+/// <summary>
+/// Adds the time between its construction and its destruction to a phase of the current frame.
+/// </summary>
+class PhaseTimer
+{
+public:
+    PhaseTimer(FrameProfiler & profiler, FramePhase phase) noexcept : _Profiler(profiler), _Phase(phase), _Start(FrameProfiler::Clock::now()) { }
+
+    ~PhaseTimer() noexcept { _Profiler.AddPhase(_Phase, FrameProfiler::Clock::now() - _Start); }
+
+    PhaseTimer(const PhaseTimer &) = delete;
+    PhaseTimer & operator=(const PhaseTimer &) = delete;
+
+private:
+    FrameProfiler & _Profiler;
+    FramePhase _Phase;
+    FrameProfiler::Clock::time_point _Start;
+};
+
+#else
+
+/// <summary>
+/// Stands in for the frame profiler when profiling is disabled.
+/// </summary>
+class FrameProfiler
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    void BeginFrame() noexcept { }
+    void EndFrame() noexcept { }
+
+    void AddPhase(FramePhase, Clock::duration) noexcept { }
+
+    uint64_t GetFrameCount() const noexcept { return 0; }
+
+    HRESULT GetFrames(std::vector<FrameRecord> &) const noexcept { return E_NOTIMPL; }
+    HRESULT GetSummary(FramePhase, PhaseSummary &) const noexcept { return E_NOTIMPL; }
+
+    HRESULT Export(ProfileFormat, std::string &) const noexcept { return E_NOTIMPL; }
+
+    static const char * GetName(FramePhase) noexcept { return ""; }
+};
+
+/// <summary>
+/// Stands in for the phase timer when profiling is disabled.
+/// </summary>
+class PhaseTimer
+{
+public:
+    PhaseTimer(FrameProfiler &, FramePhase) noexcept { }
+};
+
+#endif
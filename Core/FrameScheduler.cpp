@@ -0,0 +1,160 @@
+
+/** $VER: FrameScheduler.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "FrameScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/// <summary>
+/// Sets the time between two vsyncs. Ignores intervals that are not positive.
+/// </summary>
+void VsyncClock::SetInterval(double seconds) noexcept
+{
+    if (seconds > 0.)
+        _Interval = seconds;
+}
+
+/// <summary>
+/// Gets the time of the first vsync after the specified time.
+/// </summary>
+double VsyncClock::GetNextVsync(double time) const noexcept
+{
+    return _Phase + (std::floor((time - _Phase) / _Interval) + 1.) * _Interval;
+}
+
+/// <summary>
+/// Initializes a new instance. The frame interval defaults to 60 Hz.
+/// </summary>
+FrameScheduler::FrameScheduler() noexcept :
+    _IsInvalid(false),
+    _IsOccluded(false),
+    _Tick(std::numeric_limits<double>::infinity()),
+    _NextFrame(-std::numeric_limits<double>::infinity()),
+    _Deadline(0.),
+    _NextOcclusionTest(0.),
+    _Statistics()
+{
+}
+
+/// <summary>
+/// Requests a frame because the content changed. Requests before the frame starts are merged into one frame.
+/// </summary>
+void FrameScheduler::Invalidate() noexcept
+{
+    _IsInvalid = true;
+
+    ++_Statistics.Invalidations;
+}
+
+/// <summary>
+/// Requests an animation tick at the specified time. An earlier pending tick takes precedence.
+/// </summary>
+void FrameScheduler::ScheduleTick(double time) noexcept
+{
+    _Tick = (std::min)(_Tick, time);
+}
+
+/// <summary>
+/// Cancels the pending animation tick, if any.
+/// </summary>
+void FrameScheduler::CancelTick() noexcept
+{
+    _Tick = std::numeric_limits<double>::infinity();
+}
+
+/// <summary>
+/// Returns true, once, if the pending animation tick is due. Ticks are held back while the window is occluded; the animation catches up when it shows again.
+/// </summary>
+bool FrameScheduler::TakeTick(double now) noexcept
+{
+    if (_IsOccluded || (now < _Tick))
+        return false;
+
+    _Tick = std::numeric_limits<double>::infinity();
+
+    ++_Statistics.Ticks;
+
+    return true;
+}
+
+/// <summary>
+/// Signals that the window became occluded, e.g. because a present returned DXGI_STATUS_OCCLUDED or the window got minimized, or visible again.
+/// A window that becomes visible again is redrawn.
+/// </summary>
+void FrameScheduler::SetOccluded(bool isOccluded, double now) noexcept
+{
+    if (isOccluded && !_IsOccluded)
+        _NextOcclusionTest = now + OcclusionTestInterval;
+    else
+    if (!isOccluded && _IsOccluded)
+        Invalidate();
+
+    _IsOccluded = isOccluded;
+}
+
+/// <summary>
+/// Returns true if the window is occluded and it is time to test whether it still is. Schedules the next test.
+/// </summary>
+bool FrameScheduler::TakeOcclusionTest(double now) noexcept
+{
+    if (!_IsOccluded || (now < _NextOcclusionTest))
+        return false;
+
+    _NextOcclusionTest = now + OcclusionTestInterval;
+
+    ++_Statistics.OcclusionTests;
+
+    return true;
+}
+
+/// <summary>
+/// Returns true if a frame should be rendered now.
+/// </summary>
+bool FrameScheduler::IsFrameDue(double now) const noexcept
+{
+    return _IsInvalid && !_IsOccluded && (now >= _NextFrame);
+}
+
+/// <summary>
+/// Gets the time until the scheduler needs the caller again: for a frame that waits for the next vsync, an animation tick or an occlusion test.
+/// A frame that is already due is not included; the caller renders it or waits until the swap chain can take it. Returns infinity if there is nothing to do.
+/// </summary>
+double FrameScheduler::GetWaitTime(double now) const noexcept
+{
+    double Time = _IsOccluded ? _NextOcclusionTest : _Tick;
+
+    if (!_IsOccluded && _IsInvalid && (now < _NextFrame))
+        Time = (std::min)(Time, _NextFrame);
+
+    return (std::max)(Time - now, 0.);
+}
+
+/// <summary>
+/// Signals the start of a frame. The frame has to be presented before the next vsync to show without delay.
+/// </summary>
+void FrameScheduler::BeginFrame(double now) noexcept
+{
+    _IsInvalid = false;
+
+    _Deadline = _Clock.GetNextVsync(now);
+    _NextFrame = _Deadline;
+}
+
+/// <summary>
+/// Signals the end of a frame and records whether it missed its deadline.
+/// </summary>
+void FrameScheduler::EndFrame(double now) noexcept
+{
+    ++_Statistics.Frames;
+
+    if (now > _Deadline)
+    {
+        ++_Statistics.Missed;
+
+        _Statistics.MaxLateness = (std::max)(_Statistics.MaxLateness, now - _Deadline);
+    }
+}
@@ -0,0 +1,88 @@
+
+/** $VER: FrameScheduler.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+
+/// <summary>
+/// Simulates the vertical blank of a display: a vsync every interval, in phase with the last vsync that was observed.
+/// </summary>
+class VsyncClock
+{
+public:
+    VsyncClock() noexcept : _Interval(1. / 60.), _Phase(0.) { }
+
+    void SetInterval(double seconds) noexcept;
+    double GetInterval() const noexcept { return _Interval; }
+
+    void Synchronize(double vsync) noexcept { _Phase = vsync; }
+
+    double GetNextVsync(double time) const noexcept;
+
+private:
+    double _Interval;           // In seconds
+    double _Phase;              // Time of an observed vsync, in seconds
+};
+
+/// <summary>
+/// Contains the counters of the frame scheduler.
+/// </summary>
+struct FrameSchedulerStatistics
+{
+    uint64_t Frames;            // Frames rendered
+    uint64_t Missed;            // Frames that finished after the vsync that followed their start
+    uint64_t Invalidations;     // Requests for a frame, including those merged into a frame that was already pending
+    uint64_t Ticks;             // Animation ticks served
+    uint64_t OcclusionTests;    // Test presents while occluded
+    double MaxLateness;         // Longest overrun of a deadline, in seconds
+};
+
+/// <summary>
+/// Decides when to render. A frame is rendered when the content was invalidated, at most once per vsync so that the latency stays at one frame;
+/// animations request ticks at their deadlines. Nothing happens while the window is idle and no frames are rendered while it is occluded, except for
+/// an occasional test of the occlusion. All times are in seconds on a monotonic clock.
+/// </summary>
+class FrameScheduler
+{
+public:
+    static constexpr double OcclusionTestInterval = .25;
+
+    FrameScheduler() noexcept;
+
+    void SetFrameInterval(double seconds) noexcept { _Clock.SetInterval(seconds); }
+    void Synchronize(double vsync) noexcept { _Clock.Synchronize(vsync); }
+
+    const VsyncClock & GetClock() const noexcept { return _Clock; }
+
+    void Invalidate() noexcept;
+
+    void ScheduleTick(double time) noexcept;
+    void CancelTick() noexcept;
+    bool TakeTick(double now) noexcept;
+
+    void SetOccluded(bool isOccluded, double now) noexcept;
+    bool IsOccluded() const noexcept { return _IsOccluded; }
+    bool TakeOcclusionTest(double now) noexcept;
+
+    bool IsFrameDue(double now) const noexcept;
+    double GetWaitTime(double now) const noexcept;
+
+    void BeginFrame(double now) noexcept;
+    void EndFrame(double now) noexcept;
+
+    FrameSchedulerStatistics GetStatistics() const noexcept { return _Statistics; }
+
+private:
+    VsyncClock _Clock;
+
+    bool _IsInvalid;
+    bool _IsOccluded;
+
+    double _Tick;               // Time of the pending animation tick; infinity if there is none
+    double _NextFrame;          // Earliest start of the next frame: the vsync after the start of the previous one
+    double _Deadline;           // Vsync by which the frame in progress should have been presented
+    double _NextOcclusionTest;
+
+    FrameSchedulerStatistics _Statistics;
+};
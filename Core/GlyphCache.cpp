@@ -0,0 +1,362 @@
+
+/** $VER: GlyphCache.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "GlyphCache.h"
+
+#include <new>
+#include <string.h>
+
+/// <summary>
+/// Gets the location of the coverage bitmap of a glyph, rasterizing it into the atlas if it is not cached yet.
+/// The phases position the origin of the glyph at a fraction (phase / SubpixelPositions) of the top-left pixel of the bitmap.
+/// </summary>
+HRESULT GlyphCache::GetGlyph(const Font & font, WCHAR c, UINT phaseX, UINT phaseY, CachedGlyph & glyph) noexcept
+{
+    if ((phaseX >= SubpixelPositions) || (phaseY >= SubpixelPositions))
+        return E_INVALIDARG;
+
+    ++_Clock;
+
+    const uint64_t Key = GetKey(font, c, phaseX, phaseY);
+
+    auto Entry = _Glyphs.find(Key);
+
+    if (Entry != _Glyphs.end())
+    {
+        glyph = Entry->second;
+
+        if (glyph.Width != 0)
+            _Pages[glyph.Page].LastUsed = _Clock;
+
+        ++_Hits;
+
+        return S_OK;
+    }
+
+    ++_Misses;
+
+    UINT Width = 0, Height = 0;
+
+    if (c != L' ')
+        GetSize(font, phaseX, phaseY, Width, Height);
+
+    glyph = { };
+
+    if (Width != 0)
+    {
+        HRESULT hr = Allocate(Width, Height, glyph);
+
+        if (FAILED(hr))
+            return hr;
+
+        Rasterize(font, c, phaseX, phaseY, _Pages[glyph.Page].Pixels.data() + (size_t) glyph.Y * _PageSize + glyph.X, _PageSize, Width, Height);
+    }
+
+    try
+    {
+        _Glyphs.insert({ Key, glyph });
+    }
+    catch (const std::bad_alloc &)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    return S_OK;
+}
+
+/// <summary>
+/// Removes all glyphs and pages.
+/// </summary>
+void GlyphCache::Clear() noexcept
+{
+    _Glyphs.clear();
+    _Pages.clear();
+}
+
+/// <summary>
+/// Gets the counters of the cache.
+/// </summary>
+GlyphCacheStatistics GlyphCache::GetStatistics() const noexcept
+{
+    GlyphCacheStatistics Statistics = { };
+
+    Statistics.Hits = _Hits;
+    Statistics.Misses = _Misses;
+    Statistics.Evictions = _Evictions;
+
+    Statistics.Glyphs = (UINT) _Glyphs.size();
+    Statistics.Pages = (UINT) _Pages.size();
+
+    size_t Area = 0;
+
+    for (const Page & p : _Pages)
+        Area += p.Area;
+
+    if (!_Pages.empty())
+        Statistics.Occupancy = (FLOAT) ((double) Area / ((double) _PageSize * _PageSize * _Pages.size()));
+
+    if (_Hits + _Misses != 0)
+        Statistics.HitRate = (FLOAT) ((double) _Hits / (double) (_Hits + _Misses));
+
+    return Statistics;
+}
+
+/// <summary>
+/// Resets the hit, miss and eviction counters.
+/// </summary>
+void GlyphCache::ResetStatistics() noexcept
+{
+    _Hits = 0;
+    _Misses = 0;
+    _Evictions = 0;
+}
+
+/// <summary>
+/// Gets the key of a glyph: the font size, the character and the phases.
+/// </summary>
+uint64_t GlyphCache::GetKey(const Font & font, WCHAR c, UINT phaseX, UINT phaseY) noexcept
+{
+    const FLOAT FontSize = font.FontSize();
+
+    uint32_t Bits;
+
+    ::memcpy(&Bits, &FontSize, sizeof(Bits));
+
+    return ((uint64_t) Bits << 32) | ((uint64_t) c << 8) | ((uint64_t) phaseY << 4) | phaseX;
+}
+
+/// <summary>
+/// Allocates an area for a glyph in the first page that has room. Adds a page or clears the least recently used page if none has.
+/// </summary>
+HRESULT GlyphCache::Allocate(UINT width, UINT height, CachedGlyph & glyph) noexcept
+{
+    if ((width > _PageSize) || (height > _PageSize) || (_MaxPages == 0))
+        return E_INVALIDARG;
+
+    bool IsAllocated = false;
+
+    for (UINT i = 0; (i < (UINT) _Pages.size()) && !IsAllocated; ++i)
+    {
+        if (Allocate(_Pages[i], width, height, glyph.X, glyph.Y))
+        {
+            glyph.Page = i;
+            IsAllocated = true;
+        }
+    }
+
+    if (!IsAllocated)
+    {
+        if (_Pages.size() < _MaxPages)
+        {
+            HRESULT hr = AddPage();
+
+            if (FAILED(hr))
+                return hr;
+
+            glyph.Page = (UINT) _Pages.size() - 1;
+        }
+        else
+        {
+            glyph.Page = 0;
+
+            for (UINT i = 1; i < (UINT) _Pages.size(); ++i)
+            {
+                if (_Pages[i].LastUsed < _Pages[glyph.Page].LastUsed)
+                    glyph.Page = i;
+            }
+
+            EvictPage(glyph.Page);
+        }
+
+        // An empty page always has room for a glyph that is not larger than the page.
+        Allocate(_Pages[glyph.Page], width, height, glyph.X, glyph.Y);
+    }
+
+    glyph.Width = width;
+    glyph.Height = height;
+
+    Page & p = _Pages[glyph.Page];
+
+    p.LastUsed = _Clock;
+    p.Area += (size_t) width * height;
+
+    return S_OK;
+}
+
+/// <summary>
+/// Allocates an area in a page with the bottom-left skyline heuristic: the position with the lowest top edge wins, the leftmost one on a tie.
+/// </summary>
+bool GlyphCache::Allocate(Page & page, UINT width, UINT height, UINT & x, UINT & y) const noexcept
+{
+    std::vector<Segment> & Skyline = page.Skyline;
+
+    size_t BestIndex = Skyline.size();
+    UINT BestY = _PageSize;
+
+    for (size_t i = 0; i < Skyline.size(); ++i)
+    {
+        if (Skyline[i].X + width > _PageSize)
+            break;
+
+        // The glyph rests on the highest segment it spans.
+        UINT Top = 0;
+        UINT Remaining = width;
+
+        for (size_t j = i; Remaining != 0; ++j)
+        {
+            Top = (std::max)(Top, Skyline[j].Y);
+
+            Remaining -= (std::min)(Remaining, Skyline[j].Width);
+        }
+
+        if ((Top + height <= _PageSize) && (Top < BestY))
+        {
+            BestIndex = i;
+            BestY = Top;
+        }
+    }
+
+    if (BestIndex == Skyline.size())
+        return false;
+
+    x = Skyline[BestIndex].X;
+    y = BestY;
+
+    // The segments below the glyph are replaced by a segment at its bottom edge. The skyline never has more segments than the page is wide.
+    const UINT Right = x + width;
+
+    Skyline.insert(Skyline.begin() + (ptrdiff_t) BestIndex, { x, y + height, width });
+
+    size_t i = BestIndex + 1;
+
+    while ((i < Skyline.size()) && (Skyline[i].X < Right))
+    {
+        const UINT Overlap = Right - Skyline[i].X;
+
+        if (Overlap >= Skyline[i].Width)
+        {
+            Skyline.erase(Skyline.begin() + (ptrdiff_t) i);
+        }
+        else
+        {
+            Skyline[i].X += Overlap;
+            Skyline[i].Width -= Overlap;
+
+            break;
+        }
+    }
+
+    for (i = 1; i < Skyline.size(); )
+    {
+        if (Skyline[i - 1].Y == Skyline[i].Y)
+        {
+            Skyline[i - 1].Width += Skyline[i].Width;
+            Skyline.erase(Skyline.begin() + (ptrdiff_t) i);
+        }
+        else
+            ++i;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Adds an empty page to the atlas.
+/// </summary>
+HRESULT GlyphCache::AddPage() noexcept
+{
+    try
+    {
+        Page p;
+
+        p.Pixels.resize((size_t) _PageSize * _PageSize);
+        p.Skyline.reserve((size_t) _PageSize + 1);
+        p.Skyline.push_back({ 0, 0, _PageSize });
+        p.LastUsed = _Clock;
+        p.Area = 0;
+
+        _Pages.push_back(std::move(p));
+    }
+    catch (const std::bad_alloc &)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    return S_OK;
+}
+
+/// <summary>
+/// Removes all glyphs of a page and empties it.
+/// </summary>
+void GlyphCache::EvictPage(UINT index) noexcept
+{
+    for (auto Entry = _Glyphs.begin(); Entry != _Glyphs.end(); )
+    {
+        if ((Entry->second.Width != 0) && (Entry->second.Page == index))
+            Entry = _Glyphs.erase(Entry);
+        else
+            ++Entry;
+    }
+
+    Page & p = _Pages[index];
+
+    p.Skyline.clear();
+    p.Skyline.push_back({ 0, 0, _PageSize }); // Does not allocate: the capacity was reserved.
+    p.Area = 0;
+
+    ++_Evictions;
+}
+
+/// <summary>
+/// Gets the size of the bitmap of a glyph at the specified phase.
+/// </summary>
+void GlyphCache::GetSize(const Font & font, UINT phaseX, UINT phaseY, UINT & width, UINT & height) noexcept
+{
+    const FLOAT x = (FLOAT) phaseX / (FLOAT) SubpixelPositions;
+    const FLOAT y = (FLOAT) phaseY / (FLOAT) SubpixelPositions;
+
+    width  = (UINT) std::ceil(x + font.Unit() * (FLOAT) Font::GlyphWidth);
+    height = (UINT) std::ceil(y + font.Unit() * (FLOAT) Font::GlyphHeight);
+}
+
+/// <summary>
+/// Rasterizes a glyph into a coverage bitmap. The coverage of each pixel is determined by 4 x 4 supersampling of the glyph cells.
+/// </summary>
+void GlyphCache::Rasterize(const Font & font, WCHAR c, UINT phaseX, UINT phaseY, BYTE * coverage, size_t stride, UINT width, UINT height) noexcept
+{
+    const BYTE * Glyph = Font::GetGlyph(c);
+
+    const FLOAT Unit = font.Unit();
+    const FLOAT x = (FLOAT) phaseX / (FLOAT) SubpixelPositions;
+    const FLOAT y = (FLOAT) phaseY / (FLOAT) SubpixelPositions;
+
+    for (UINT py = 0; py < height; ++py)
+    {
+        BYTE * d = coverage + (size_t) py * stride;
+
+        for (UINT px = 0; px < width; ++px)
+        {
+            uint32_t Count = 0;
+
+            for (int sy = 0; sy < 4; ++sy)
+            {
+                const int Row = (int) std::floor(((FLOAT) py + ((FLOAT) sy + .5f) / 4.f - y) / Unit);
+
+                if ((Row < 0) || (Row >= (int) Font::GlyphHeight))
+                    continue;
+
+                for (int sx = 0; sx < 4; ++sx)
+                {
+                    const int Column = (int) std::floor(((FLOAT) px + ((FLOAT) sx + .5f) / 4.f - x) / Unit);
+
+                    if ((Column >= 0) && (Column < (int) Font::GlyphWidth) && (Glyph[Row] & (0x10 >> Column)))
+                        ++Count;
+                }
+            }
+
+            d[px] = (BYTE) (Count * 255 / 16);
+        }
+    }
+}
@@ -0,0 +1,110 @@
+
+/** $VER: GlyphCache.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+#include "Font.h"
+
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// Contains the counters of a glyph cache.
+/// </summary>
+struct GlyphCacheStatistics
+{
+    uint64_t Hits;          // Lookups served by the atlas
+    uint64_t Misses;        // Lookups that required rasterizing the glyph
+    uint64_t Evictions;     // Pages cleared to make room for new glyphs
+
+    UINT Glyphs;            // Glyphs in the atlas
+    UINT Pages;             // Pages in use
+    FLOAT Occupancy;        // Fraction of the area of the pages covered by glyphs
+    FLOAT HitRate;          // Hits / (Hits + Misses)
+};
+
+/// <summary>
+/// Describes the location of a rasterized glyph in the atlas. The bitmap contains 8-bit coverage values.
+/// </summary>
+struct CachedGlyph
+{
+    UINT Page;
+    UINT X;                 // Position in the page
+    UINT Y;
+    UINT Width;             // Size of the bitmap, 0 for glyphs without pixels
+    UINT Height;
+};
+
+/// <summary>
+/// Caches the glyphs of the built-in font, rasterized once per font size, character and subpixel position, in an atlas of coverage pages.
+/// Glyphs are packed with a skyline packer. When the atlas is full the least recently used page is cleared.
+/// </summary>
+class GlyphCache
+{
+public:
+    static const UINT SubpixelPositions = 4;    // Horizontal and vertical glyph positions per pixel
+    static const UINT DefaultPageSize = 256;
+    static const UINT DefaultMaxPages = 4;
+
+    GlyphCache(UINT pageSize = DefaultPageSize, UINT maxPages = DefaultMaxPages) noexcept : _PageSize(pageSize), _MaxPages(maxPages), _Clock(), _Hits(), _Misses(), _Evictions() { }
+
+    HRESULT GetGlyph(const Font & font, WCHAR c, UINT phaseX, UINT phaseY, CachedGlyph & glyph) noexcept;
+
+    /// <summary>
+    /// Gets the coverage of a row of a glyph.
+    /// </summary>
+    const BYTE * GetRow(const CachedGlyph & glyph, UINT y) const noexcept { return _Pages[glyph.Page].Pixels.data() + (size_t) (glyph.Y + y) * _PageSize + glyph.X; }
+
+    /// <summary>
+    /// Gets the distance between the rows of a glyph, in bytes.
+    /// </summary>
+    UINT GetStride() const noexcept { return _PageSize; }
+
+    void Clear() noexcept;
+
+    GlyphCacheStatistics GetStatistics() const noexcept;
+    void ResetStatistics() noexcept;
+
+    static void GetSize(const Font & font, UINT phaseX, UINT phaseY, UINT & width, UINT & height) noexcept;
+    static void Rasterize(const Font & font, WCHAR c, UINT phaseX, UINT phaseY, BYTE * coverage, size_t stride, UINT width, UINT height) noexcept;
+
+private:
+    /// <summary>
+    /// Represents a horizontal segment of the skyline: the area above Y is used, the area below is free.
+    /// </summary>
+    struct Segment
+    {
+        UINT X;
+        UINT Y;
+        UINT Width;
+    };
+
+    struct Page
+    {
+        std::vector<BYTE> Pixels;
+        std::vector<Segment> Skyline;   // Sorted by X, covering the width of the page
+        uint64_t LastUsed;              // Value of the clock when a glyph of the page was last used
+        size_t Area;                    // Pixels covered by glyphs
+    };
+
+    static uint64_t GetKey(const Font & font, WCHAR c, UINT phaseX, UINT phaseY) noexcept;
+
+    HRESULT Allocate(UINT width, UINT height, CachedGlyph & glyph) noexcept;
+    bool Allocate(Page & page, UINT width, UINT height, UINT & x, UINT & y) const noexcept;
+    HRESULT AddPage() noexcept;
+    void EvictPage(UINT index) noexcept;
+
+private:
+    UINT _PageSize;
+    UINT _MaxPages;
+
+    std::unordered_map<uint64_t, CachedGlyph> _Glyphs;
+    std::vector<Page> _Pages;
+
+    uint64_t _Clock;                    // Incremented on every lookup
+
+    uint64_t _Hits;
+    uint64_t _Misses;
+    uint64_t _Evictions;
+};
@@ -0,0 +1,160 @@
+
+/** $VER: HeadlessRenderer.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "HeadlessRenderer.h"
+
+/// <summary>
+/// Initializes this instance with a main window of the specified client size.
+/// </summary>
+HRESULT HeadlessRenderer::Initialize(UINT width, UINT height) noexcept
+{
+    HRESULT hr = _App.Initialize(width, height);
+
+    _App.SetFrontBuffer(&_FrontBuffer);
+
+    if (SUCCEEDED(hr))
+        hr = _Child.Initialize(ChildFrame::Width, ChildFrame::Height);
+
+    Raster GridPattern;
+
+    if (SUCCEEDED(hr))
+        hr = AppFrame::CreateGridPattern(GridPattern);
+
+    if (SUCCEEDED(hr))
+        hr = _App.CreateBitmap(GridPattern, _Background);
+
+    if (SUCCEEDED(hr))
+        hr = _App.CreateTextFormat(AppFrame::FontName, AppFrame::FontSize, TextAlignment::Center, ParagraphAlignment::Near, _TextFormat);
+
+    return hr;
+}
+
+/// <summary>
+/// Sets the image of the main window.
+/// </summary>
+HRESULT HeadlessRenderer::SetImage(const Raster & raster) noexcept
+{
+    return _App.CreateBitmap(raster, _Image);
+}
+
+/// <summary>
+/// Sets the image of the child window.
+/// </summary>
+HRESULT HeadlessRenderer::SetChildImage(const Raster & raster) noexcept
+{
+    return _Child.CreateBitmap(raster, _ChildImage);
+}
+
+/// <summary>
+/// Sets the message of the main window.
+/// </summary>
+void HeadlessRenderer::SetMessage(const WCHAR * message) noexcept
+{
+    ::wcsncpy(_Message, (message != nullptr) ? message : L"", _countof(_Message) - 1);
+
+    _Message[_countof(_Message) - 1] = 0;
+}
+
+/// <summary>
+/// Sets the space in which the translucent elements are blended. The next frame is redrawn completely.
+/// </summary>
+void HeadlessRenderer::SetColorSpace(ColorSpace colorSpace) noexcept
+{
+    _App.SetColorSpace(colorSpace);
+    _Child.SetColorSpace(colorSpace);
+
+    _DamageTracker.InvalidateAll();
+}
+
+/// <summary>
+/// Renders a frame. Returns S_FALSE if nothing changed since the previous frame.
+/// </summary>
+HRESULT HeadlessRenderer::Render() noexcept
+{
+    _Profiler.BeginFrame();
+
+    HRESULT hr = RenderFrame();
+
+    RasterAllocator::GetDefault().MarkFrame();
+
+    _Profiler.EndFrame();
+
+    return hr;
+}
+
+/// <summary>
+/// Renders the phases of a frame.
+/// </summary>
+HRESULT HeadlessRenderer::RenderFrame() noexcept
+{
+    const AppFrame Frame = { _Background.get(), _Image.get(), _TextFormat.get(), _Message, 0.f };
+
+    const Region * DirtyRegion = nullptr;
+
+    {
+        const PhaseTimer Timer(_Profiler, FramePhase::Damage);
+
+        _DamageTracker.BeginFrame(_App.GetTarget().Width(), _App.GetTarget().Height());
+
+        Frame.AddElements(_DamageTracker, _App.GetSize());
+
+        _DamageTracker.Add(ChildElement, { (FLOAT) ChildFrame::Left, (FLOAT) ChildFrame::Top, (FLOAT) (ChildFrame::Left + ChildFrame::Width), (FLOAT) (ChildFrame::Top + ChildFrame::Height) }, _ChildImage ? _ChildImage->GetId() : 0);
+
+        DirtyRegion = &_DamageTracker.EndFrame();
+    }
+
+    if (DirtyRegion->IsEmpty())
+        return S_FALSE;
+
+    HRESULT hr = S_OK;
+
+    {
+        const PhaseTimer Timer(_Profiler, FramePhase::Draw);
+
+        _App.BeginDraw();
+
+        Frame.Render(_App, *DirtyRegion);
+
+        hr = _App.EndDraw();
+
+        if (SUCCEEDED(hr))
+        {
+            _Child.BeginDraw();
+
+            ChildFrame { _ChildImage.get() }.Render(_Child);
+
+            hr = _Child.EndDraw();
+        }
+
+        if (SUCCEEDED(hr))
+            hr = _Child.Present();
+    }
+
+    // Layer the child on top of the main window. The child may only be blended into the pixels that have just been redrawn.
+    {
+        const PhaseTimer Timer(_Profiler, FramePhase::Compose);
+
+        for (const RectI & Rect : DirtyRegion->GetRects())
+        {
+            if (!SUCCEEDED(hr))
+                break;
+
+            _App.PushClip(Rect);
+
+            hr = _App.Compose(_Child.GetTarget(), ChildFrame::Left, ChildFrame::Top);
+
+            _App.PopClip();
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        const PhaseTimer Timer(_Profiler, FramePhase::Present);
+
+        hr = _App.Present(*DirtyRegion);
+    }
+
+    return hr;
+}
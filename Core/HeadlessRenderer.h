@@ -0,0 +1,61 @@
+
+/** $VER: HeadlessRenderer.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+#include "SoftwareCompositor.h"
+#include "Frame.h"
+#include "DamageTracker.h"
+#include "FrameProfiler.h"
+
+/// <summary>
+/// Renders the main window and the child window with the software compositor and layers the child on top of the main window,
+/// like the Windows Composition Engine does. Used to profile and regression-test the rendering without a desktop.
+/// Only the damaged area of a frame is redrawn and presented to the front buffer.
+/// </summary>
+class HeadlessRenderer
+{
+public:
+    HeadlessRenderer() : _Message() { }
+
+    HRESULT Initialize(UINT width, UINT height) noexcept;
+
+    HRESULT SetImage(const Raster & raster) noexcept;
+    HRESULT SetChildImage(const Raster & raster) noexcept;
+    void SetMessage(const WCHAR * message) noexcept;
+    void SetColorSpace(ColorSpace colorSpace) noexcept;
+
+    HRESULT Render() noexcept;
+    void Invalidate() noexcept { _DamageTracker.InvalidateAll(); }
+
+    const Raster & GetTarget() const noexcept { return _App.GetTarget(); }
+    const Raster & GetFrontBuffer() const noexcept { return _FrontBuffer; }
+
+    DamageStatistics GetDamageStatistics() const noexcept { return _DamageTracker.GetStatistics(); }
+    GlyphCacheStatistics GetGlyphCacheStatistics() const noexcept { return _App.GetGlyphCache().GetStatistics(); }
+    TextLayoutStatistics GetTextLayoutStatistics() const noexcept { return _App.GetTextLayoutCache().GetStatistics(); }
+    RasterAllocatorStatistics GetRasterStatistics() const noexcept { return RasterAllocator::GetDefault().GetStatistics(); }
+    const FrameProfiler & GetProfiler() const noexcept { return _Profiler; }
+
+private:
+    HRESULT RenderFrame() noexcept;
+
+private:
+    SoftwareCompositor _App;
+    SoftwareCompositor _Child;
+
+    std::unique_ptr<Bitmap> _Background;
+    std::unique_ptr<Bitmap> _Image;
+    std::unique_ptr<Bitmap> _ChildImage;
+    std::unique_ptr<TextFormat> _TextFormat;
+
+    WCHAR _Message[256];
+
+    DamageTracker _DamageTracker;
+    Raster _FrontBuffer;
+
+    FrameProfiler _Profiler;
+
+    static const UINT ChildElement = 0x100; // Id of the child layer in the damage tracker. The ids below are used by the main window frame.
+};
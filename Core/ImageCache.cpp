@@ -0,0 +1,344 @@
+
+/** $VER: ImageCache.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "ImageCache.h"
+
+#include <new>
+
+/// <summary>
+/// Gets an image of the specified size, from the cache if possible. Decodes the source with the loader on a miss.
+/// The decoding and the scaling happen outside the lock so other threads can use the cache in the meantime.
+/// </summary>
+HRESULT ImageCache::Get(const WCHAR * source, UINT width, UINT height, const Loader & loader, std::shared_ptr<const Raster> & raster, ScaleFilter filter) noexcept
+{
+    std::shared_ptr<const Raster> Level;
+
+    {
+        std::lock_guard<std::mutex> Lock(_Mutex);
+
+        auto Entry = FindEntry(source, width, height);
+
+        if (Entry != _Entries.end())
+        {
+            _Entries.splice(_Entries.begin(), _Entries, Entry);
+
+            ++_Hits;
+
+            raster = Entry->Image;
+
+            return S_OK;
+        }
+
+        auto LevelEntry = FindLevel(source, width, height);
+
+        if (LevelEntry != _Entries.end())
+        {
+            _Entries.splice(_Entries.begin(), _Entries, LevelEntry);
+
+            ++_LevelHits;
+
+            Level = LevelEntry->Image;
+        }
+        else
+            ++_Misses;
+    }
+
+    HRESULT hr = S_OK;
+
+    if (Level == nullptr)
+    {
+        std::shared_ptr<Raster> Decoded;
+
+        try
+        {
+            Decoded = std::make_shared<Raster>();
+        }
+        catch (const std::bad_alloc &)
+        {
+            return E_OUTOFMEMORY;
+        }
+
+        hr = loader(*Decoded);
+
+        if (!SUCCEEDED(hr))
+            return hr;
+
+        if ((Decoded->Width() == width) && (Decoded->Height() == height))
+        {
+            InsertEntry(source, Decoded);
+
+            raster = Decoded;
+
+            return S_OK;
+        }
+
+        // Keep the mip chain of the decoded image as levels for other sizes.
+        Mipmap Levels;
+
+        hr = Levels.Build(Decoded);
+
+        if (SUCCEEDED(hr))
+        {
+            Insert(source, Levels);
+
+            Level = Levels.GetLevel(Levels.SelectLevel(width, height));
+        }
+        else
+        {
+            InsertEntry(source, Decoded);
+
+            Level = Decoded;
+        }
+
+        if ((Level->Width() == width) && (Level->Height() == height))
+        {
+            raster = Level;
+
+            return S_OK;
+        }
+    }
+
+    std::shared_ptr<Raster> Scaled;
+
+    try
+    {
+        Scaled = std::make_shared<Raster>();
+    }
+    catch (const std::bad_alloc &)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    hr = Scaler::Scale(*Level, *Scaled, width, height, filter);
+
+    if (SUCCEEDED(hr))
+    {
+        InsertEntry(source, Scaled);
+
+        raster = Scaled;
+    }
+
+    return hr;
+}
+
+/// <summary>
+/// Gets an image scaled down to fit the specified size, preserving its aspect ratio. The size of the source must be known up front, e.g. from the decoder.
+/// </summary>
+HRESULT ImageCache::Fit(const WCHAR * source, UINT maxWidth, UINT maxHeight, UINT srcWidth, UINT srcHeight, const Loader & loader, std::shared_ptr<const Raster> & raster, ScaleFilter filter) noexcept
+{
+    UINT Width, Height;
+
+    Scaler::GetFitSize(srcWidth, srcHeight, maxWidth, maxHeight, Width, Height);
+
+    return Get(source, Width, Height, loader, raster, filter);
+}
+
+/// <summary>
+/// Finds the image of the specified source and size. Does not update the statistics.
+/// </summary>
+std::shared_ptr<const Raster> ImageCache::Find(const WCHAR * source, UINT width, UINT height) noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    auto Entry = FindEntry(source, width, height);
+
+    if (Entry == _Entries.end())
+        return nullptr;
+
+    _Entries.splice(_Entries.begin(), _Entries, Entry);
+
+    return Entry->Image;
+}
+
+/// <summary>
+/// Adds an image to the cache, replacing the image of the same source and size. Returns S_FALSE if the image does not fit in the budget.
+/// </summary>
+HRESULT ImageCache::Insert(const WCHAR * source, const std::shared_ptr<const Raster> & raster) noexcept
+{
+    if ((raster == nullptr) || raster->IsEmpty())
+        return E_INVALIDARG;
+
+    return InsertEntry(source, raster);
+}
+
+/// <summary>
+/// Adds all levels of a mip chain to the cache. The levels are shared, not copied. The smallest levels end up as the most recently used ones.
+/// </summary>
+HRESULT ImageCache::Insert(const WCHAR * source, const Mipmap & mipmap) noexcept
+{
+    if (mipmap.GetLevelCount() == 0)
+        return E_INVALIDARG;
+
+    HRESULT Result = S_OK;
+
+    for (UINT i = 0; i < mipmap.GetLevelCount(); ++i)
+    {
+        HRESULT hr = InsertEntry(source, mipmap.GetLevel(i));
+
+        if (FAILED(hr))
+            return hr;
+
+        if (hr != S_OK)
+            Result = hr;
+    }
+
+    return Result;
+}
+
+/// <summary>
+/// Removes all images of a source, e.g. because the file changed.
+/// </summary>
+void ImageCache::Remove(const WCHAR * source) noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    for (auto Entry = _Entries.begin(); Entry != _Entries.end();)
+    {
+        if (Entry->Source == source)
+        {
+            _Size -= Entry->Image->Size();
+
+            Entry = _Entries.erase(Entry);
+        }
+        else
+            ++Entry;
+    }
+}
+
+/// <summary>
+/// Removes all images.
+/// </summary>
+void ImageCache::Clear() noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    _Entries.clear();
+    _Size = 0;
+}
+
+/// <summary>
+/// Sets the maximum number of bytes used by the cached images. Discards the least recently used images if necessary.
+/// </summary>
+void ImageCache::SetBudget(size_t budget) noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    _Budget = budget;
+
+    Trim();
+}
+
+/// <summary>
+/// Gets the counters of the cache.
+/// </summary>
+ImageCacheStatistics ImageCache::GetStatistics() const noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    return { _Hits, _LevelHits, _Misses, _Evictions, _Size, _Budget, (UINT) _Entries.size() };
+}
+
+/// <summary>
+/// Resets the hit, miss and eviction counters.
+/// </summary>
+void ImageCache::ResetStatistics() noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    _Hits = _LevelHits = _Misses = _Evictions = 0;
+}
+
+/// <summary>
+/// Gets the cache shared by the application.
+/// </summary>
+ImageCache & ImageCache::GetDefault() noexcept
+{
+    static ImageCache Default;
+
+    return Default;
+}
+
+/// <summary>
+/// Finds the entry of the specified source and size. The caller must hold the lock.
+/// </summary>
+std::list<ImageCache::Entry>::iterator ImageCache::FindEntry(const WCHAR * source, UINT width, UINT height) noexcept
+{
+    for (auto Entry = _Entries.begin(); Entry != _Entries.end(); ++Entry)
+    {
+        if ((Entry->Image->Width() == width) && (Entry->Image->Height() == height) && (Entry->Source == source))
+            return Entry;
+    }
+
+    return _Entries.end();
+}
+
+/// <summary>
+/// Finds the smallest entry of the specified source that is at least as large as the specified size. The caller must hold the lock.
+/// </summary>
+std::list<ImageCache::Entry>::iterator ImageCache::FindLevel(const WCHAR * source, UINT width, UINT height) noexcept
+{
+    auto Level = _Entries.end();
+
+    for (auto Entry = _Entries.begin(); Entry != _Entries.end(); ++Entry)
+    {
+        if ((Entry->Image->Width() < width) || (Entry->Image->Height() < height) || (Entry->Source != source))
+            continue;
+
+        if ((Level == _Entries.end()) || (Entry->Image->Size() < Level->Image->Size()))
+            Level = Entry;
+    }
+
+    return Level;
+}
+
+/// <summary>
+/// Adds an image to the front of the cache and trims the cache to its budget.
+/// </summary>
+HRESULT ImageCache::InsertEntry(const WCHAR * source, const std::shared_ptr<const Raster> & raster) noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    if (raster->Size() > _Budget)
+        return S_FALSE;
+
+    auto Existing = FindEntry(source, raster->Width(), raster->Height());
+
+    if (Existing != _Entries.end())
+    {
+        _Size -= Existing->Image->Size();
+
+        _Entries.erase(Existing);
+    }
+
+    try
+    {
+        _Entries.push_front({ source, raster });
+    }
+    catch (const std::bad_alloc &)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    _Size += raster->Size();
+
+    Trim();
+
+    return S_OK;
+}
+
+/// <summary>
+/// Discards the least recently used images until the cache fits in its budget. The caller must hold the lock.
+/// </summary>
+void ImageCache::Trim() noexcept
+{
+    while ((_Size > _Budget) && !_Entries.empty())
+    {
+        _Size -= _Entries.back().Image->Size();
+
+        _Entries.pop_back();
+
+        ++_Evictions;
+    }
+}
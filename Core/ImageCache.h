@@ -0,0 +1,86 @@
+
+/** $VER: ImageCache.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+#include "Mipmap.h"
+#include "Raster.h"
+#include "Scaler.h"
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+
+/// <summary>
+/// Contains the counters of an image cache.
+/// </summary>
+struct ImageCacheStatistics
+{
+    uint64_t Hits;          // Requests served by an entry of the requested size
+    uint64_t LevelHits;     // Requests served by scaling down a larger entry of the same source
+    uint64_t Misses;        // Requests that required decoding the source
+    uint64_t Evictions;     // Entries removed to stay within the budget
+
+    size_t Size;            // Bytes used by the cached rasters
+    size_t Budget;          // Maximum number of bytes used by the cached rasters
+    UINT Count;             // Number of cached rasters
+};
+
+/// <summary>
+/// Caches decoded and scaled images in system memory, keyed by source and size, and discards the least recently used images when the cache exceeds its budget.
+/// Requests for a size that is not cached are served by scaling down the smallest cached image of the same source that is large enough.
+/// Decoded images are stored as a mip chain so that such a level is never more than twice the requested size.
+/// </summary>
+class ImageCache
+{
+public:
+    typedef std::function<HRESULT(Raster & raster)> Loader;
+
+    static const size_t DefaultBudget = 256 * 1024 * 1024;
+
+    ImageCache(size_t budget = DefaultBudget) noexcept : _Budget(budget), _Size(), _Hits(), _LevelHits(), _Misses(), _Evictions() { }
+
+    HRESULT Get(const WCHAR * source, UINT width, UINT height, const Loader & loader, std::shared_ptr<const Raster> & raster, ScaleFilter filter = ScaleFilter::Lanczos3) noexcept;
+    HRESULT Fit(const WCHAR * source, UINT maxWidth, UINT maxHeight, UINT srcWidth, UINT srcHeight, const Loader & loader, std::shared_ptr<const Raster> & raster, ScaleFilter filter = ScaleFilter::Lanczos3) noexcept;
+
+    std::shared_ptr<const Raster> Find(const WCHAR * source, UINT width, UINT height) noexcept;
+    HRESULT Insert(const WCHAR * source, const std::shared_ptr<const Raster> & raster) noexcept;
+    HRESULT Insert(const WCHAR * source, const Mipmap & mipmap) noexcept;
+
+    void Remove(const WCHAR * source) noexcept;
+    void Clear() noexcept;
+
+    void SetBudget(size_t budget) noexcept;
+    ImageCacheStatistics GetStatistics() const noexcept;
+    void ResetStatistics() noexcept;
+
+    static ImageCache & GetDefault() noexcept;
+
+private:
+    struct Entry
+    {
+        std::wstring Source;
+        std::shared_ptr<const Raster> Image;
+    };
+
+    std::list<Entry>::iterator FindEntry(const WCHAR * source, UINT width, UINT height) noexcept;
+    std::list<Entry>::iterator FindLevel(const WCHAR * source, UINT width, UINT height) noexcept;
+
+    HRESULT InsertEntry(const WCHAR * source, const std::shared_ptr<const Raster> & raster) noexcept;
+    void Trim() noexcept;
+
+private:
+    mutable std::mutex _Mutex;
+
+    std::list<Entry> _Entries; // Most recently used first. Caches hold a few dozen images at most so a linear search is fine.
+
+    size_t _Budget;
+    size_t _Size;
+
+    uint64_t _Hits;
+    uint64_t _LevelHits;
+    uint64_t _Misses;
+    uint64_t _Evictions;
+};
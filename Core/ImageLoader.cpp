@@ -0,0 +1,266 @@
+
+/** $VER: ImageLoader.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "ImageLoader.h"
+#include "ImageCache.h"
+#include "Mipmap.h"
+#include "Scaler.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cwchar>
+#include <new>
+
+/// <summary>
+/// Initializes a new instance. The callback is invoked on a worker thread when a result is ready; it should only notify the UI thread.
+/// </summary>
+ImageLoader::ImageLoader(Callback onCompleted, ThreadPool * threadPool, ImageCache * imageCache) noexcept :
+    _OnCompleted(std::move(onCompleted)),
+    _ThreadPool((threadPool != nullptr) ? *threadPool : ThreadPool::GetDefault()),
+    _ImageCache(imageCache),
+    _Generation(0),
+    _ActiveStages(0),
+    _HasResult(false),
+    _Result(S_OK)
+{
+}
+
+/// <summary>
+/// Cancels the current load and waits for its stages to finish.
+/// </summary>
+ImageLoader::~ImageLoader()
+{
+    Cancel();
+
+    std::unique_lock<std::mutex> Lock(_Mutex);
+
+    _Idle.wait(Lock, [this]() { return _ActiveStages == 0; });
+}
+
+/// <summary>
+/// Starts loading an image that is scaled down to fit the specified size. Supersedes the load in progress and any result that has not been picked up yet.
+/// </summary>
+HRESULT ImageLoader::Load(const WCHAR * source, const Decoder & decoder, UINT maxWidth, UINT maxHeight) noexcept
+{
+    if ((source == nullptr) || (maxWidth == 0) || (maxHeight == 0))
+        return E_INVALIDARG;
+
+    std::shared_ptr<Request> NewRequest;
+
+    try
+    {
+        NewRequest = std::make_shared<Request>(Request { ++_Generation, source, decoder, maxWidth, maxHeight });
+    }
+    catch (const std::bad_alloc &)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    {
+        std::lock_guard<std::mutex> Lock(_Mutex);
+
+        _HasResult = false;
+        _ResultRaster.reset();
+    }
+
+    BeginStage();
+
+    HRESULT hr = _ThreadPool.Submit([this, NewRequest]() { Decode(NewRequest); });
+
+    if (FAILED(hr))
+        EndStage();
+
+    return hr;
+}
+
+/// <summary>
+/// Cancels the load in progress, if any, and discards the result that has not been picked up yet.
+/// </summary>
+void ImageLoader::Cancel() noexcept
+{
+    ++_Generation;
+
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    _HasResult = false;
+    _ResultRaster.reset();
+}
+
+/// <summary>
+/// Gets the result of the last load. Returns E_PENDING if there is none (yet), otherwise the outcome of the load. A result can only be taken once.
+/// </summary>
+HRESULT ImageLoader::GetResult(WCHAR * source, size_t size, std::shared_ptr<const Raster> & raster) noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    if (!_HasResult)
+        return E_PENDING;
+
+    if ((source != nullptr) && (size != 0))
+    {
+        const size_t Length = (std::min)(_ResultSource.size(), size - 1);
+
+        ::wmemcpy(source, _ResultSource.c_str(), Length);
+
+        source[Length] = L'\0';
+    }
+
+    raster = std::move(_ResultRaster);
+
+    _HasResult = false;
+
+    return _Result;
+}
+
+/// <summary>
+/// Returns true if a load is in progress.
+/// </summary>
+bool ImageLoader::IsBusy() const noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    return _ActiveStages != 0;
+}
+
+/// <summary>
+/// Decode stage: decodes the source, builds its mip chain and hands the nearest larger level to the scale stage.
+/// </summary>
+void ImageLoader::Decode(const std::shared_ptr<Request> & request) noexcept
+{
+    if (!IsCancelled(*request))
+    {
+        std::shared_ptr<Raster> Decoded;
+
+        HRESULT hr = S_OK;
+
+        try
+        {
+            Decoded = std::make_shared<Raster>();
+        }
+        catch (const std::bad_alloc &)
+        {
+            hr = E_OUTOFMEMORY;
+        }
+
+        if (SUCCEEDED(hr))
+            hr = request->Decode(*Decoded);
+
+        // Build the mip chain so that the scale stage, and later resizes served by the cache, start from the nearest larger level.
+        Mipmap Levels;
+
+        if (SUCCEEDED(hr) && !IsCancelled(*request))
+            hr = Levels.Build(Decoded, &_ThreadPool);
+
+        if (FAILED(hr))
+            Complete(request, hr, nullptr);
+        else
+        if (!IsCancelled(*request))
+        {
+            if (_ImageCache != nullptr)
+                _ImageCache->Insert(request->Source.c_str(), Levels);
+
+            UINT Width, Height;
+
+            Scaler::GetFitSize(Decoded->Width(), Decoded->Height(), request->MaxWidth, request->MaxHeight, Width, Height);
+
+            std::shared_ptr<const Raster> Level = Levels.GetLevel(Levels.SelectLevel(Width, Height));
+
+            // Run the scale stage as a separate task so that the decode stage of a newer request does not have to wait for it.
+            BeginStage();
+
+            if (FAILED(_ThreadPool.Submit([this, request, Level, Width, Height]() { Scale(request, Level, Width, Height); })))
+                Scale(request, Level, Width, Height);
+        }
+    }
+
+    EndStage();
+}
+
+/// <summary>
+/// Scale stage: scales a level of the decoded image to the size that fits the requested size.
+/// </summary>
+void ImageLoader::Scale(const std::shared_ptr<Request> & request, const std::shared_ptr<const Raster> & level, UINT width, UINT height) noexcept
+{
+    if (!IsCancelled(*request))
+    {
+        std::shared_ptr<Raster> Scaled;
+
+        HRESULT hr = S_OK;
+
+        if ((width == level->Width()) && (height == level->Height()))
+            Complete(request, S_OK, level);
+        else
+        {
+            try
+            {
+                Scaled = std::make_shared<Raster>();
+            }
+            catch (const std::bad_alloc &)
+            {
+                hr = E_OUTOFMEMORY;
+            }
+
+            if (SUCCEEDED(hr))
+                hr = Scaler::Scale(*level, *Scaled, width, height, ScaleFilter::Lanczos3, &_ThreadPool);
+
+            if (SUCCEEDED(hr) && (_ImageCache != nullptr))
+                _ImageCache->Insert(request->Source.c_str(), Scaled);
+
+            Complete(request, hr, Scaled);
+        }
+    }
+
+    EndStage();
+}
+
+/// <summary>
+/// Publishes the result of a request, unless it has been cancelled, and notifies the owner.
+/// </summary>
+void ImageLoader::Complete(const std::shared_ptr<Request> & request, HRESULT hr, const std::shared_ptr<const Raster> & raster) noexcept
+{
+    {
+        std::lock_guard<std::mutex> Lock(_Mutex);
+
+        if (IsCancelled(*request))
+            return;
+
+        try
+        {
+            _ResultSource = request->Source;
+        }
+        catch (const std::bad_alloc &)
+        {
+            hr = E_OUTOFMEMORY;
+        }
+
+        _Result = hr;
+        _ResultRaster = SUCCEEDED(hr) ? raster : nullptr;
+        _HasResult = true;
+    }
+
+    if (_OnCompleted)
+        _OnCompleted();
+}
+
+/// <summary>
+/// Registers a stage that is queued or running.
+/// </summary>
+void ImageLoader::BeginStage() noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    ++_ActiveStages;
+}
+
+/// <summary>
+/// Unregisters a stage and wakes up the destructor when the last one finishes.
+/// </summary>
+void ImageLoader::EndStage() noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    if (--_ActiveStages == 0)
+        _Idle.notify_all();
+}
@@ -0,0 +1,75 @@
+
+/** $VER: ImageLoader.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+#include "Raster.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+
+class ThreadPool;
+class ImageCache;
+
+/// <summary>
+/// Loads images in the background: a decode stage, which also builds the mip chain, and a scale stage run on a thread pool and the result is picked up by the UI thread.
+/// Starting a new load cancels the previous one; the stages of a cancelled load stop at the next stage boundary and never produce a result.
+/// </summary>
+class ImageLoader
+{
+public:
+    typedef std::function<HRESULT(Raster & raster)> Decoder;
+    typedef std::function<void()> Callback;
+
+    ImageLoader(Callback onCompleted, ThreadPool * threadPool = nullptr, ImageCache * imageCache = nullptr) noexcept;
+    ~ImageLoader();
+
+    ImageLoader(const ImageLoader &) = delete;
+    ImageLoader & operator=(const ImageLoader &) = delete;
+
+    HRESULT Load(const WCHAR * source, const Decoder & decoder, UINT maxWidth, UINT maxHeight) noexcept;
+    void Cancel() noexcept;
+
+    HRESULT GetResult(WCHAR * source, size_t size, std::shared_ptr<const Raster> & raster) noexcept;
+
+    bool IsBusy() const noexcept;
+
+private:
+    struct Request
+    {
+        uint64_t Generation;
+        std::wstring Source;
+        Decoder Decode;
+        UINT MaxWidth;
+        UINT MaxHeight;
+    };
+
+    void Decode(const std::shared_ptr<Request> & request) noexcept;
+    void Scale(const std::shared_ptr<Request> & request, const std::shared_ptr<const Raster> & level, UINT width, UINT height) noexcept;
+    void Complete(const std::shared_ptr<Request> & request, HRESULT hr, const std::shared_ptr<const Raster> & raster) noexcept;
+
+    bool IsCancelled(const Request & request) const noexcept { return request.Generation != _Generation; }
+
+    void BeginStage() noexcept;
+    void EndStage() noexcept;
+
+private:
+    Callback _OnCompleted;
+    ThreadPool & _ThreadPool;
+    ImageCache * _ImageCache;
+
+    std::atomic<uint64_t> _Generation;
+
+    mutable std::mutex _Mutex;
+    std::condition_variable _Idle;
+    UINT _ActiveStages;
+
+    bool _HasResult;
+    HRESULT _Result;
+    std::wstring _ResultSource;
+    std::shared_ptr<const Raster> _ResultRaster;
+};
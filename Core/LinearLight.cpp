@@ -0,0 +1,752 @@
+
+/** $VER: LinearLight.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "LinearLight.h"
+
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <new>
+
+/*
+    Both conversions evaluate polynomials in 16-bit fixed point, with a linear segment near black, so that the vector kernels compute exactly
+    the values of the tables of the scalar code. Decoding evaluates a quartic in the 8-bit value scaled to 16 bits. Encoding evaluates one in
+    1 minus the square root of the linear value. All its coefficients but the constant one are negative, so every step of the evaluation, and
+    the encoding, is monotonic. The square root is computed in single precision, which IEEE 754 rounds correctly, so the table and the kernels
+    truncate it to the same value. Every 8-bit value survives a round trip. The scalar code decodes opaque pixels with 3 lookups in tables of
+    complete linear pixels, one per channel, that are combined with ORs. AVX2 encodes with gathers from the table, which are faster than the
+    square roots; the table is padded because the gathers read 4 bytes at a time and mask off the rest.
+
+    Blends multiply by the inverse alpha of the color scaled to 16 bits, with rounding, so that an opaque destination stays exactly opaque.
+*/
+
+static std::atomic<InstructionSet> _InstructionSet(CPU::GetInstructionSet());
+
+static const uint32_t LinearEnd = 2699;                                                 // The end of the linear segment of the decoding (8-bit value 10.5)
+static const uint32_t K0 = 69, K1 = 1867, K2 = 36695, K3 = 34470, K4 = 7566;            // The coefficients of the decoding, highest degree last
+
+static const uint32_t LinearLimit = 103;                                                // The end of the linear segment of the encoding
+static const uint32_t E0 = 32748, E1 = 29573, E2 = 401, E4 = 3843;                      // The coefficients of the encoding, with the cubic one 0
+
+/// <summary>
+/// Converts an 8-bit sRGB value, scaled to 16 bits, to a 15-bit linear value. Every product keeps its top 16 bits, like a vector multiply.
+/// </summary>
+static inline uint32_t Expand(uint32_t x) noexcept
+{
+    if (x < LinearEnd)
+        return ((x + 13) * 2536) >> 16;
+
+    uint32_t y = K3 - ((K4 * x) >> 16);
+
+    y = ((y * x) >> 16) + K2;
+    y = ((y * x) >> 16) + K1;
+    y = ((y * x) >> 16) + K0;
+
+    return (y + 1) >> 1;
+}
+
+/// <summary>
+/// Gets the square root of a 15-bit linear value as a 16-bit fraction, truncated, like the vector kernels.
+/// </summary>
+static inline uint32_t Root(uint32_t value) noexcept
+{
+    return (uint32_t) std::sqrt((float) value * 131072.f);
+}
+
+/// <summary>
+/// Converts a 15-bit linear value to an 8-bit sRGB value. Every product keeps its top 16 bits, like a vector multiply.
+/// </summary>
+static inline uint32_t Compress(uint32_t value) noexcept
+{
+    if (value < LinearLimit)
+        return (((value * 13180) >> 16) + 1) >> 1;
+
+    const uint32_t s = 65535 - Root(value);
+
+    uint32_t q = (E4 * s) >> 16;
+
+    q = ((q * s) >> 16) + E2;
+    q = ((q * s) >> 16) + E1;
+
+    return (E0 - ((q * s) >> 16)) >> 7;
+}
+
+/// <summary>
+/// Contains the conversion tables.
+/// </summary>
+static const struct Tables
+{
+    uint16_t ToLinear[256];
+    BYTE ToSRGB[LinearLight::One + 1 + 3];
+    uint64_t ToLinearPixel[3][256];     // An opaque pixel with only the B, G or R channel set
+
+    Tables() noexcept : ToLinear(), ToSRGB(), ToLinearPixel()
+    {
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            ToLinear[i] = (uint16_t) Expand(i * 257);
+
+            ToLinearPixel[0][i] = (uint64_t) ToLinear[i] | ((uint64_t) LinearLight::One << 48);
+            ToLinearPixel[1][i] = (uint64_t) ToLinear[i] << 16;
+            ToLinearPixel[2][i] = (uint64_t) ToLinear[i] << 32;
+        }
+
+        for (uint32_t i = 0; i <= LinearLight::One; ++i)
+            ToSRGB[i] = (BYTE) Compress(i);
+    }
+} _Tables;
+
+/// <summary>
+/// Contains the blended gray levels of the last color that filled a long span on this thread. The spans of a shape share their color.
+/// </summary>
+static thread_local struct FillTable
+{
+    uint32_t Color;                     // 0 if the table is empty
+    uint32_t Candidate;                 // The color of the last long span that had no table. It gets one on its next long span.
+    uint32_t Red[256];                  // The A and R channels of the gray levels
+    std::unique_ptr<uint16_t[]> Pairs;  // The B and G channels of every combination of the gray levels, plus padding for the gathers
+} _FillTable;
+
+/// <summary>
+/// Converts an 8-bit sRGB value to a 15-bit linear value.
+/// </summary>
+uint32_t LinearLight::ToLinear(uint32_t value) noexcept
+{
+    return _Tables.ToLinear[value & 0xFF];
+}
+
+/// <summary>
+/// Converts a 15-bit linear value to an 8-bit sRGB value.
+/// </summary>
+uint32_t LinearLight::ToSRGB(uint32_t value) noexcept
+{
+    return _Tables.ToSRGB[(std::min)(value, One)];
+}
+
+/// <summary>
+/// Converts a premultiplied sRGB pixel to a premultiplied linear pixel. The color of a translucent pixel is unpremultiplied before it is decoded.
+/// </summary>
+void LinearLight::Decode(uint32_t pixel, uint16_t * dst) noexcept
+{
+    const uint32_t a = pixel >> 24;
+
+    if (a == 255)
+    {
+        const uint64_t Pixel = _Tables.ToLinearPixel[0][pixel & 0xFF] | _Tables.ToLinearPixel[1][(pixel >> 8) & 0xFF] | _Tables.ToLinearPixel[2][(pixel >> 16) & 0xFF];
+
+        ::memcpy(dst, &Pixel, sizeof(Pixel));
+    }
+    else
+    if (a == 0)
+    {
+        dst[0] = dst[1] = dst[2] = dst[3] = 0;
+    }
+    else
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            const uint32_t c = (std::min)((((pixel >> (i * 8)) & 0xFF) * 255 + a / 2) / a, 255u);
+
+            dst[i] = (uint16_t) ((_Tables.ToLinear[c] * a + 127) / 255);
+        }
+
+        dst[3] = (uint16_t) ((a * One + 127) / 255);
+    }
+}
+
+/// <summary>
+/// Converts a premultiplied linear pixel to a premultiplied sRGB pixel. The color of a translucent pixel is unpremultiplied before it is encoded.
+/// </summary>
+uint32_t LinearLight::Encode(const uint16_t * src) noexcept
+{
+    const uint32_t A = (std::min)((uint32_t) src[3], One);
+
+    if (A == One)
+        return ToSRGB(src[0]) | (ToSRGB(src[1]) << 8) | (ToSRGB(src[2]) << 16) | 0xFF000000u;
+
+    const uint32_t a = (A * 255 + One / 2) / One;
+
+    if (a == 0)
+        return 0;
+
+    uint32_t Pixel = a << 24;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        const uint32_t c = ToSRGB((src[i] * One + A / 2) / A);
+
+        Pixel |= ((c * a + 127) / 255) << (i * 8);
+    }
+
+    return Pixel;
+}
+
+// Scalar
+
+/// <summary>
+/// Decodes a span of pixels one at a time.
+/// </summary>
+static void Decode_Scalar(const uint32_t * src, uint16_t * dst, UINT count) noexcept
+{
+    for (UINT i = 0; i < count; ++i)
+        LinearLight::Decode(src[i], dst + (size_t) i * 4);
+}
+
+/// <summary>
+/// Encodes a span of pixels one at a time.
+/// </summary>
+static void Encode_Scalar(const uint16_t * src, uint32_t * dst, UINT count) noexcept
+{
+    for (UINT i = 0; i < count; ++i)
+        dst[i] = LinearLight::Encode(src + (size_t) i * 4);
+}
+
+/// <summary>
+/// Gets the inverse alpha of a linear color, scaled to 16 bits. Colors that are not transparent have an alpha of at least 128, so it fits.
+/// </summary>
+static inline uint32_t GetInverseAlpha(const uint16_t * color) noexcept
+{
+    return (std::min)(((LinearLight::One - color[3]) * 65536 + LinearLight::One / 2) / LinearLight::One, 65535u);
+}
+
+/// <summary>
+/// Blends a premultiplied linear color over a span of linear pixels one at a time.
+/// </summary>
+static void BlendOver_Scalar(const uint16_t * color, uint16_t * dst, UINT count) noexcept
+{
+    const uint32_t InvAlpha = GetInverseAlpha(color);
+
+    for (UINT i = 0; i < count * 4; ++i)
+        dst[i] = (uint16_t) (color[i & 3] + ((dst[i] * InvAlpha + 32768) >> 16));
+}
+
+/// <summary>
+/// Looks up opaque pixels in a table of blended gray levels one at a time, the B and G channels together. Returns the number of pixels done:
+/// it stops at the first pixel that is not opaque.
+/// </summary>
+static UINT Lookup_Scalar(const FillTable & table, uint32_t * dst, UINT count) noexcept
+{
+    const uint16_t * Pairs = table.Pairs.get();
+
+    for (UINT i = 0; i < count; ++i)
+    {
+        const uint32_t p = dst[i];
+
+        if ((p >> 24) != 255)
+            return i;
+
+        dst[i] = Pairs[p & 0xFFFF] | table.Red[(p >> 16) & 0xFF];
+    }
+
+    return count;
+}
+
+#ifdef CORE_X86
+
+/// <summary>
+/// Converts 8 8-bit sRGB values, scaled to 16 bits, to 15-bit linear values like Expand().
+/// </summary>
+static inline __m128i Expand_SSE2(__m128i x) noexcept
+{
+    const __m128i Linear = _mm_mulhi_epu16(_mm_add_epi16(x, _mm_set1_epi16(13)), _mm_set1_epi16(2536));
+
+    __m128i y = _mm_sub_epi16(_mm_set1_epi16((short) K3), _mm_mulhi_epu16(x, _mm_set1_epi16((short) K4)));
+
+    y = _mm_add_epi16(_mm_mulhi_epu16(y, x), _mm_set1_epi16((short) K2));
+    y = _mm_add_epi16(_mm_mulhi_epu16(y, x), _mm_set1_epi16((short) K1));
+    y = _mm_add_epi16(_mm_mulhi_epu16(y, x), _mm_set1_epi16((short) K0));
+
+    const __m128i IsLinear = _mm_cmpeq_epi16(_mm_subs_epu16(x, _mm_set1_epi16(LinearEnd - 1)), _mm_setzero_si128());
+
+    // The linear segment lies below the curve, so removing the curve from the lanes of the segment selects with one instruction less.
+    return _mm_max_epi16(Linear, _mm_subs_epu16(_mm_avg_epu16(y, _mm_setzero_si128()), IsLinear));
+}
+
+/// <summary>
+/// Converts 8 15-bit linear values to 8-bit sRGB values, in 16-bit lanes, like Compress().
+/// </summary>
+static inline __m128i Compress_SSE2(__m128i l) noexcept
+{
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128 Scale = _mm_set1_ps(131072.f);
+    const __m128i Bias = _mm_set1_epi32(32768);
+
+    // The roots are biased to fit the signed pack; the complement undoes the bias.
+    const __m128i r0 = _mm_sub_epi32(_mm_cvttps_epi32(_mm_sqrt_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(l, Zero)), Scale))), Bias);
+    const __m128i r1 = _mm_sub_epi32(_mm_cvttps_epi32(_mm_sqrt_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(l, Zero)), Scale))), Bias);
+
+    const __m128i s = _mm_xor_si128(_mm_packs_epi32(r0, r1), _mm_set1_epi16(0x7FFF));
+
+    __m128i q = _mm_mulhi_epu16(_mm_set1_epi16((short) E4), s);
+
+    q = _mm_add_epi16(_mm_mulhi_epu16(q, s), _mm_set1_epi16((short) E2));
+    q = _mm_add_epi16(_mm_mulhi_epu16(q, s), _mm_set1_epi16((short) E1));
+
+    const __m128i Curve = _mm_srli_epi16(_mm_sub_epi16(_mm_set1_epi16((short) E0), _mm_mulhi_epu16(q, s)), 7);
+    const __m128i Linear = _mm_avg_epu16(_mm_mulhi_epu16(l, _mm_set1_epi16(13180)), Zero);
+
+    const __m128i IsLinear = _mm_cmplt_epi16(l, _mm_set1_epi16(LinearLimit));
+
+    return _mm_or_si128(_mm_and_si128(IsLinear, Linear), _mm_andnot_si128(IsLinear, Curve));
+}
+
+/// <summary>
+/// Decodes a span of pixels 4 at a time. Groups of opaque pixels evaluate the polynomial on every channel, alpha included; other groups use scalar code.
+/// </summary>
+static void Decode_SSE2(const uint32_t * src, uint16_t * dst, UINT count) noexcept
+{
+    const __m128i AlphaMask = _mm_set1_epi32((int) 0xFF000000);
+
+    UINT i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i p = _mm_loadu_si128((const __m128i *) (src + i));
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(p, AlphaMask), AlphaMask)) != 0xFFFF)
+        {
+            Decode_Scalar(src + i, dst + (size_t) i * 4, 4);
+
+            continue;
+        }
+
+        // Unpacking a byte with itself scales it to 16 bits. 255 decodes to One, so the alpha of an opaque pixel needs no special case.
+        _mm_storeu_si128((__m128i *) (dst + (size_t) i * 4),     Expand_SSE2(_mm_unpacklo_epi8(p, p)));
+        _mm_storeu_si128((__m128i *) (dst + (size_t) i * 4 + 8), Expand_SSE2(_mm_unpackhi_epi8(p, p)));
+    }
+
+    Decode_Scalar(src + i, dst + (size_t) i * 4, count - i);
+}
+
+/// <summary>
+/// Encodes a span of pixels 4 at a time. Groups of opaque pixels evaluate the polynomial on every channel, alpha included; other groups use scalar code.
+/// </summary>
+static void Encode_SSE2(const uint16_t * src, uint32_t * dst, UINT count) noexcept
+{
+    const __m128i AlphaMask = _mm_set1_epi64x((long long) 0xFFFF000000000000ull);
+    const __m128i AlphaOne = _mm_set1_epi64x((long long) ((uint64_t) LinearLight::One << 48));
+    const __m128i One = _mm_set1_epi16((short) LinearLight::One);
+
+    UINT i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i p0 = _mm_loadu_si128((const __m128i *) (src + (size_t) i * 4));       // Pixels 0 and 1
+        __m128i p1 = _mm_loadu_si128((const __m128i *) (src + (size_t) i * 4 + 8));   // Pixels 2 and 3
+
+        const __m128i IsOpaque = _mm_and_si128(_mm_cmpeq_epi16(_mm_and_si128(p0, AlphaMask), AlphaOne), _mm_cmpeq_epi16(_mm_and_si128(p1, AlphaMask), AlphaOne));
+
+        if (_mm_movemask_epi8(IsOpaque) != 0xFFFF)
+        {
+            Encode_Scalar(src + (size_t) i * 4, dst + i, 4);
+
+            continue;
+        }
+
+        // Limit the channels to One, like the scalar code. One encodes to 255, so the alpha of an opaque pixel needs no special case.
+        p0 = _mm_sub_epi16(p0, _mm_subs_epu16(p0, One));
+        p1 = _mm_sub_epi16(p1, _mm_subs_epu16(p1, One));
+
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_packus_epi16(Compress_SSE2(p0), Compress_SSE2(p1)));
+    }
+
+    Encode_Scalar(src + (size_t) i * 4, dst + i, count - i);
+}
+
+/// <summary>
+/// Blends a premultiplied linear color over a span of linear pixels 2 at a time. The product with the inverse alpha is rounded with the top bit
+/// of its low half, which gives the same result as the scalar code.
+/// </summary>
+static void BlendOver_SSE2(const uint16_t * color, uint16_t * dst, UINT count) noexcept
+{
+    const __m128i Color = _mm_set_epi16((short) color[3], (short) color[2], (short) color[1], (short) color[0], (short) color[3], (short) color[2], (short) color[1], (short) color[0]);
+    const __m128i InvAlpha = _mm_set1_epi16((short) GetInverseAlpha(color));
+
+    UINT i = 0;
+
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128i * d = (__m128i *) (dst + (size_t) i * 4);
+
+        const __m128i p = _mm_loadu_si128(d);
+
+        const __m128i Product = _mm_add_epi16(_mm_mulhi_epu16(p, InvAlpha), _mm_srli_epi16(_mm_mullo_epi16(p, InvAlpha), 15));
+
+        _mm_storeu_si128(d, _mm_add_epi16(Color, Product));
+    }
+
+    BlendOver_Scalar(color, dst + (size_t) i * 4, count - i);
+}
+
+/// <summary>
+/// Looks up opaque pixels in a table of blended gray levels 4 at a time: checks their alpha at once and reads the indices from memory, which takes
+/// fewer instructions than extracting them. Returns the number of pixels done: it stops at the first pixel that is not opaque.
+/// </summary>
+static UINT Lookup_SSE2(const FillTable & table, uint32_t * dst, UINT count) noexcept
+{
+    const uint16_t * Pairs = table.Pairs.get();
+
+    const __m128i AlphaMask = _mm_set1_epi32((int) 0xFF000000);
+
+    UINT i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128((const __m128i *) (dst + i)), AlphaMask), AlphaMask)) != 0xFFFF)
+            break;
+
+        for (UINT k = i; k < i + 4; ++k)
+        {
+            const BYTE * p = (const BYTE *) (dst + k);
+
+            uint16_t bg;
+
+            ::memcpy(&bg, p, sizeof(bg));
+
+            dst[k] = Pairs[bg] | table.Red[p[2]];
+        }
+    }
+
+    return i + Lookup_Scalar(table, dst + i, count - i);
+}
+
+/// <summary>
+/// Converts 16 8-bit sRGB values, scaled to 16 bits, to 15-bit linear values like Expand().
+/// </summary>
+TARGET_AVX2 static inline __m256i Expand_AVX2(__m256i x) noexcept
+{
+    const __m256i Linear = _mm256_mulhi_epu16(_mm256_add_epi16(x, _mm256_set1_epi16(13)), _mm256_set1_epi16(2536));
+
+    __m256i y = _mm256_sub_epi16(_mm256_set1_epi16((short) K3), _mm256_mulhi_epu16(x, _mm256_set1_epi16((short) K4)));
+
+    y = _mm256_add_epi16(_mm256_mulhi_epu16(y, x), _mm256_set1_epi16((short) K2));
+    y = _mm256_add_epi16(_mm256_mulhi_epu16(y, x), _mm256_set1_epi16((short) K1));
+    y = _mm256_add_epi16(_mm256_mulhi_epu16(y, x), _mm256_set1_epi16((short) K0));
+
+    const __m256i IsLinear = _mm256_cmpeq_epi16(_mm256_subs_epu16(x, _mm256_set1_epi16(LinearEnd - 1)), _mm256_setzero_si256());
+
+    return _mm256_blendv_epi8(_mm256_avg_epu16(y, _mm256_setzero_si256()), Linear, IsLinear);
+}
+
+/// <summary>
+/// Decodes a span of pixels 8 at a time. Groups of opaque pixels evaluate the polynomial on every channel, alpha included; other groups use SSE2 code.
+/// </summary>
+TARGET_AVX2 static void Decode_AVX2(const uint32_t * src, uint16_t * dst, UINT count) noexcept
+{
+    const __m256i AlphaMask = _mm256_set1_epi32((int) 0xFF000000);
+
+    UINT i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256i p = _mm256_loadu_si256((const __m256i *) (src + i));
+
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_and_si256(p, AlphaMask), AlphaMask)) != -1)
+        {
+            Decode_SSE2(src + i, dst + (size_t) i * 4, 8);
+
+            continue;
+        }
+
+        // Pixels 0, 1, 4, 5 in the low lane and 2, 3, 6, 7 in the high lane, so that the unpacks, which work per lane, keep the pixels in order.
+        const __m256i q = _mm256_permute4x64_epi64(p, _MM_SHUFFLE(3, 1, 2, 0));
+
+        _mm256_storeu_si256((__m256i *) (dst + (size_t) i * 4),      Expand_AVX2(_mm256_unpacklo_epi8(q, q)));
+        _mm256_storeu_si256((__m256i *) (dst + (size_t) i * 4 + 16), Expand_AVX2(_mm256_unpackhi_epi8(q, q)));
+    }
+
+    Decode_SSE2(src + i, dst + (size_t) i * 4, count - i);
+}
+
+/// <summary>
+/// Encodes a span of pixels 8 at a time. Groups of opaque pixels look up every channel, alpha included, with 4 gathers; other groups use SSE2 code.
+/// </summary>
+TARGET_AVX2 static void Encode_AVX2(const uint16_t * src, uint32_t * dst, UINT count) noexcept
+{
+    const int * Table = (const int *) _Tables.ToSRGB;
+
+    const __m256i AlphaMask = _mm256_set1_epi64x((long long) 0xFFFF000000000000ull);
+    const __m256i AlphaOne = _mm256_set1_epi64x((long long) ((uint64_t) LinearLight::One << 48));
+    const __m256i One = _mm256_set1_epi16((short) LinearLight::One);
+    const __m256i ValueMask = _mm256_set1_epi32(0xFF);
+    const __m256i Order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    UINT i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i p0 = _mm256_loadu_si256((const __m256i *) (src + (size_t) i * 4));      // Pixels 0 - 3
+        __m256i p1 = _mm256_loadu_si256((const __m256i *) (src + (size_t) i * 4 + 16)); // Pixels 4 - 7
+
+        const __m256i IsOpaque = _mm256_and_si256(_mm256_cmpeq_epi16(_mm256_and_si256(p0, AlphaMask), AlphaOne), _mm256_cmpeq_epi16(_mm256_and_si256(p1, AlphaMask), AlphaOne));
+
+        if (_mm256_movemask_epi8(IsOpaque) != -1)
+        {
+            Encode_SSE2(src + (size_t) i * 4, dst + i, 8);
+
+            continue;
+        }
+
+        // Limit the channels to One, like the scalar code. The table maps One to 255, so the alpha of an opaque pixel needs no special case.
+        p0 = _mm256_min_epu16(p0, One);
+        p1 = _mm256_min_epu16(p1, One);
+
+        const __m256i c0 = _mm256_and_si256(_mm256_i32gather_epi32(Table, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(p0)), 1), ValueMask);
+        const __m256i c1 = _mm256_and_si256(_mm256_i32gather_epi32(Table, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(p0, 1)), 1), ValueMask);
+        const __m256i c2 = _mm256_and_si256(_mm256_i32gather_epi32(Table, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(p1)), 1), ValueMask);
+        const __m256i c3 = _mm256_and_si256(_mm256_i32gather_epi32(Table, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(p1, 1)), 1), ValueMask);
+
+        // The packs interleave the lanes: pixels 0, 2, 4, 6, 1, 3, 5, 7.
+        const __m256i p = _mm256_packus_epi16(_mm256_packus_epi32(c0, c1), _mm256_packus_epi32(c2, c3));
+
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_permutevar8x32_epi32(p, Order));
+    }
+
+    Encode_SSE2(src + (size_t) i * 4, dst + i, count - i);
+}
+
+/// <summary>
+/// Looks up opaque pixels in a table of blended gray levels 8 at a time, with 2 gathers: one for the B and G channels together and one for
+/// the R channel. Returns the number of pixels done: it stops near the first pixel that is not opaque.
+/// </summary>
+TARGET_AVX2 static UINT Lookup_AVX2(const FillTable & table, uint32_t * dst, UINT count) noexcept
+{
+    const int * Pairs = (const int *) table.Pairs.get();
+    const int * Red = (const int *) table.Red;
+
+    const __m256i AlphaMask = _mm256_set1_epi32((int) 0xFF000000);
+    const __m256i PairMask = _mm256_set1_epi32(0xFFFF);
+    const __m256i ByteMask = _mm256_set1_epi32(0xFF);
+
+    UINT i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256i p = _mm256_loadu_si256((const __m256i *) (dst + i));
+
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_and_si256(p, AlphaMask), AlphaMask)) != -1)
+            break;
+
+        const __m256i bg = _mm256_i32gather_epi32(Pairs, _mm256_and_si256(p, PairMask), 2);
+        const __m256i ra = _mm256_i32gather_epi32(Red, _mm256_and_si256(_mm256_srli_epi32(p, 16), ByteMask), 4);
+
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_or_si256(_mm256_and_si256(bg, PairMask), ra));
+    }
+
+    return i + Lookup_Scalar(table, dst + i, count - i);
+}
+
+/// <summary>
+/// Blends a premultiplied linear color over a span of linear pixels 4 at a time.
+/// </summary>
+TARGET_AVX2 static void BlendOver_AVX2(const uint16_t * color, uint16_t * dst, UINT count) noexcept
+{
+    const __m256i Color = _mm256_set1_epi64x((long long) ((uint64_t) color[0] | ((uint64_t) color[1] << 16) | ((uint64_t) color[2] << 32) | ((uint64_t) color[3] << 48)));
+    const __m256i InvAlpha = _mm256_set1_epi16((short) GetInverseAlpha(color));
+
+    UINT i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256i * d = (__m256i *) (dst + (size_t) i * 4);
+
+        const __m256i p = _mm256_loadu_si256(d);
+
+        const __m256i Product = _mm256_add_epi16(_mm256_mulhi_epu16(p, InvAlpha), _mm256_srli_epi16(_mm256_mullo_epi16(p, InvAlpha), 15));
+
+        _mm256_storeu_si256(d, _mm256_add_epi16(Color, Product));
+    }
+
+    BlendOver_SSE2(color, dst + (size_t) i * 4, count - i);
+}
+
+#endif
+
+/// <summary>
+/// Blends a premultiplied linear color over a span of sRGB pixels a chunk at a time: decodes the chunk, blends and encodes it again.
+/// </summary>
+template<LinearLight::DecodeFunction Decode, LinearLight::EncodeFunction Encode, void (* BlendOver)(const uint16_t *, uint16_t *, UINT)>
+static void BlendChunks(const uint16_t * color, uint32_t * dst, UINT count) noexcept
+{
+    const UINT ChunkSize = 64;
+
+    alignas(32) uint16_t Chunk[ChunkSize * 4];
+
+    while (count != 0)
+    {
+        const UINT n = (std::min)(count, ChunkSize);
+
+        Decode(dst, Chunk, n);
+        BlendOver(color, Chunk, n);
+        Encode(Chunk, dst, n);
+
+        dst += n;
+        count -= n;
+    }
+}
+
+/// <summary>
+/// Blends a solid premultiplied sRGB color over a span of sRGB pixels in linear light. Over an opaque pixel every channel of the result only
+/// depends on the same channel of the pixel, so long spans first blend the color over the 256 gray levels once per color and then look up
+/// the opaque pixels in the result, the B and G channels in a table of all their combinations. A color gets its table on its second long span,
+/// so that alternating colors do not rebuild it for every span. Opaque colors do not depend on the destination and are stored as they are.
+/// </summary>
+template<LinearLight::DecodeFunction Decode, LinearLight::EncodeFunction Encode, void (* BlendOver)(const uint16_t *, uint16_t *, UINT), UINT (* Lookup)(const FillTable &, uint32_t *, UINT)>
+static void Fill(uint32_t color, uint32_t * dst, UINT count) noexcept
+{
+    if ((color >> 24) == 255)
+    {
+        std::fill(dst, dst + count, color);
+
+        return;
+    }
+
+    if (color == 0)
+        return;
+
+    const UINT TableThreshold = 512; // Spans shorter than this blend every pixel.
+
+    uint16_t Color[4];
+
+    LinearLight::Decode(color, Color);
+
+    if (count < TableThreshold)
+    {
+        BlendChunks<Decode, Encode, BlendOver>(Color, dst, count);
+
+        return;
+    }
+
+    FillTable & Table = _FillTable;
+
+    if (Table.Color != color)
+    {
+        if (Table.Candidate != color)
+        {
+            Table.Candidate = color;
+
+            BlendChunks<Decode, Encode, BlendOver>(Color, dst, count);
+
+            return;
+        }
+
+        if (!Table.Pairs)
+            Table.Pairs.reset(new (std::nothrow) uint16_t[65536 + 1]);
+
+        if (!Table.Pairs)
+        {
+            BlendChunks<Decode, Encode, BlendOver>(Color, dst, count);
+
+            return;
+        }
+
+        uint32_t Pixels[256];
+
+        for (uint32_t i = 0; i < 256; ++i)
+            Pixels[i] = 0xFF000000u | (i * 0x010101u);
+
+        BlendChunks<Decode, Encode, BlendOver>(Color, Pixels, 256);
+
+        uint16_t Blue[256];
+
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            Blue[i] = (uint16_t) (Pixels[i] & 0xFF);
+            Table.Red[i] = Pixels[i] & 0xFFFF0000u;
+        }
+
+        for (uint32_t g = 0; g < 256; ++g)
+        {
+            const uint16_t Green = (uint16_t) (Pixels[g] & 0xFF00);
+
+            uint16_t * Row = Table.Pairs.get() + (size_t) g * 256;
+
+            for (uint32_t b = 0; b < 256; ++b)
+                Row[b] = Blue[b] | Green;
+        }
+
+        Table.Color = color;
+    }
+
+    for (UINT i = 0; i < count; ++i)
+    {
+        i += Lookup(Table, dst + i, count - i);
+
+        if (i == count)
+            break;
+
+        BlendChunks<Decode, Encode, BlendOver>(Color, dst + i, 1);
+    }
+}
+
+/// <summary>
+/// Gets the function that decodes a span of pixels using the specified instruction set.
+/// </summary>
+LinearLight::DecodeFunction LinearLight::GetDecodeFunction(InstructionSet instructionSet) noexcept
+{
+#ifdef CORE_X86
+    if ((instructionSet >= InstructionSet::AVX2) && CPU::HasAVX2())
+        return Decode_AVX2;
+
+    if ((instructionSet >= InstructionSet::SSE2) && CPU::HasSSE2())
+        return Decode_SSE2;
+#else
+    (void) instructionSet;
+#endif
+
+    return Decode_Scalar;
+}
+
+/// <summary>
+/// Gets the function that encodes a span of pixels using the specified instruction set.
+/// </summary>
+LinearLight::EncodeFunction LinearLight::GetEncodeFunction(InstructionSet instructionSet) noexcept
+{
+#ifdef CORE_X86
+    if ((instructionSet >= InstructionSet::AVX2) && CPU::HasAVX2())
+        return Encode_AVX2;
+
+    if ((instructionSet >= InstructionSet::SSE2) && CPU::HasSSE2())
+        return Encode_SSE2;
+#else
+    (void) instructionSet;
+#endif
+
+    return Encode_Scalar;
+}
+
+/// <summary>
+/// Gets the function that blends a solid premultiplied color over a span of pixels (Source Over) in linear light using the specified instruction set.
+/// </summary>
+LinearLight::FillFunction LinearLight::GetFillFunction(InstructionSet instructionSet) noexcept
+{
+#ifdef CORE_X86
+    if ((instructionSet >= InstructionSet::AVX2) && CPU::HasAVX2())
+        return Fill<Decode_AVX2, Encode_AVX2, BlendOver_AVX2, Lookup_AVX2>;
+
+    if ((instructionSet >= InstructionSet::SSE2) && CPU::HasSSE2())
+        return Fill<Decode_SSE2, Encode_SSE2, BlendOver_SSE2, Lookup_SSE2>;
+#else
+    (void) instructionSet;
+#endif
+
+    return Fill<Decode_Scalar, Encode_Scalar, BlendOver_Scalar, Lookup_Scalar>;
+}
+
+/// <summary>
+/// Gets the instruction set used by the conversions.
+/// </summary>
+InstructionSet LinearLight::GetInstructionSet() noexcept
+{
+    return _InstructionSet;
+}
+
+/// <summary>
+/// Limits the instruction set used by the conversions, e.g. to compare the kernels. The CPU capabilities are never exceeded.
+/// </summary>
+void LinearLight::SetInstructionSet(InstructionSet instructionSet) noexcept
+{
+    _InstructionSet = (std::min)(instructionSet, CPU::GetInstructionSet());
+}
@@ -0,0 +1,48 @@
+
+/** $VER: LinearLight.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+#include "CPU.h"
+
+/// <summary>
+/// Identifies the space in which pixels are filtered and blended. The app scales and blends in sRGB; linear light is used by the headless renderer,
+/// the tests and the benchmarks.
+/// </summary>
+enum class ColorSpace
+{
+    SRGB,       // On the sRGB-encoded values, as they are stored. Fast, but averages darken high-contrast detail and translucent colors blend too dark.
+    Linear,     // In linear light: decoded before and encoded after. Physically correct averages and blends.
+};
+
+/// <summary>
+/// Converts premultiplied BGRA pixels between sRGB and linear light. Linear pixels have 4 15-bit channels (0 - 32767), premultiplied in linear light,
+/// in the order B, G, R, A, so that they fit the signed 16-bit multiply-adds of the kernels. Decoding evaluates a fixed-point polynomial in the 8-bit
+/// value and encoding one in the square root of the linear value; both round-trip every 8-bit value exactly. The scalar code looks both up in tables,
+/// the vector kernels evaluate the polynomials to the same values, except that AVX2 gathers the encoding from the table. Pixels that are not opaque
+/// are unpremultiplied before the conversion and premultiplied after it.
+/// </summary>
+class LinearLight
+{
+public:
+    static constexpr int Precision = 15;
+    static constexpr uint32_t One = (1 << Precision) - 1;
+
+    typedef void (* DecodeFunction)(const uint32_t * src, uint16_t * dst, UINT count);
+    typedef void (* EncodeFunction)(const uint16_t * src, uint32_t * dst, UINT count);
+    typedef void (* FillFunction)(uint32_t color, uint32_t * dst, UINT count);
+
+    static uint32_t ToLinear(uint32_t value) noexcept;
+    static uint32_t ToSRGB(uint32_t value) noexcept;
+
+    static void Decode(uint32_t pixel, uint16_t * dst) noexcept;
+    static uint32_t Encode(const uint16_t * src) noexcept;
+
+    static InstructionSet GetInstructionSet() noexcept;
+    static void SetInstructionSet(InstructionSet instructionSet) noexcept;
+
+    static DecodeFunction GetDecodeFunction(InstructionSet instructionSet) noexcept;
+    static EncodeFunction GetEncodeFunction(InstructionSet instructionSet) noexcept;
+    static FillFunction GetFillFunction(InstructionSet instructionSet) noexcept;
+};
@@ -0,0 +1,303 @@
+
+/** $VER: MappedFile.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "MappedFile.h"
+
+/*
+    The only Core file that talks to the operating system directly. The handles are closed as soon as the view exists; the view keeps the file open.
+*/
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <new>
+#include <string>
+#endif
+
+#include <utility>
+
+/// <summary>
+/// Initializes a new instance.
+/// </summary>
+MappedFile::MappedFile() noexcept : _Data(), _Size(), _IsOpen()
+{
+}
+
+/// <summary>
+/// Unmaps the file.
+/// </summary>
+MappedFile::~MappedFile() noexcept
+{
+    Close();
+}
+
+/// <summary>
+/// Takes over the mapping of another instance.
+/// </summary>
+MappedFile::MappedFile(MappedFile && other) noexcept : _Data(std::exchange(other._Data, nullptr)), _Size(std::exchange(other._Size, 0)), _IsOpen(std::exchange(other._IsOpen, false))
+{
+}
+
+/// <summary>
+/// Takes over the mapping of another instance.
+/// </summary>
+MappedFile & MappedFile::operator=(MappedFile && other) noexcept
+{
+    if (&other != this)
+    {
+        Close();
+
+        _Data   = std::exchange(other._Data, nullptr);
+        _Size   = std::exchange(other._Size, 0);
+        _IsOpen = std::exchange(other._IsOpen, false);
+    }
+
+    return *this;
+}
+
+#ifdef _WIN32
+
+/// <summary>
+/// Maps a file. An empty file is opened without a view.
+/// </summary>
+HRESULT MappedFile::Open(const WCHAR * filePath, FileAccess access) noexcept
+{
+    Close();
+
+    // Allow other processes to read, rename or delete the file while it is mapped.
+    HANDLE hFile = ::CreateFileW(filePath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, (access == FileAccess::Sequential) ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS, nullptr);
+
+    if (hFile == INVALID_HANDLE_VALUE)
+        return HRESULT_FROM_WIN32(::GetLastError());
+
+    LARGE_INTEGER FileSize = { };
+
+    HRESULT hr = ::GetFileSizeEx(hFile, &FileSize) ? S_OK : HRESULT_FROM_WIN32(::GetLastError());
+
+    if (SUCCEEDED(hr) && ((uint64_t) FileSize.QuadPart > (uint64_t) SIZE_MAX))
+        hr = E_OUTOFMEMORY;
+
+    if (SUCCEEDED(hr) && (FileSize.QuadPart != 0))
+    {
+        HANDLE hMapping = ::CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (hMapping != NULL)
+        {
+            _Data = (const BYTE *) ::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+
+            if (_Data == nullptr)
+                hr = HRESULT_FROM_WIN32(::GetLastError());
+
+            ::CloseHandle(hMapping);
+        }
+        else
+            hr = HRESULT_FROM_WIN32(::GetLastError());
+    }
+
+    ::CloseHandle(hFile);
+
+    if (FAILED(hr))
+        return hr;
+
+    _Size = (size_t) FileSize.QuadPart;
+    _IsOpen = true;
+
+    Advise(access);
+
+    return S_OK;
+}
+
+/// <summary>
+/// Unmaps the file.
+/// </summary>
+void MappedFile::Close() noexcept
+{
+    if (_Data != nullptr)
+        ::UnmapViewOfFile(_Data);
+
+    _Data = nullptr;
+    _Size = 0;
+    _IsOpen = false;
+}
+
+/// <summary>
+/// Asks the memory manager to start reading the file, so that the decoder rarely waits for a page fault.
+/// </summary>
+void MappedFile::Advise(FileAccess access) noexcept
+{
+    if ((access != FileAccess::Sequential) || (_Data == nullptr))
+        return;
+
+    WIN32_MEMORY_RANGE_ENTRY Range = { (PVOID) _Data, _Size };
+
+    ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &Range, 0); // A hint; the pages are still faulted in on demand if it fails.
+}
+
+#else
+
+/// <summary>
+/// Converts a wide path to the multi-byte (UTF-8) path expected by the file system.
+/// </summary>
+static HRESULT GetNativePath(const WCHAR * filePath, std::string & nativePath) noexcept
+{
+    try
+    {
+        nativePath.clear();
+
+        for (const WCHAR * p = filePath; *p != 0; ++p)
+        {
+            const uint32_t c = (uint32_t) *p;
+
+            if (c < 0x80)
+                nativePath += (char) c;
+            else
+            if (c < 0x800)
+            {
+                nativePath += (char) (0xC0 | (c >> 6));
+                nativePath += (char) (0x80 | (c & 0x3F));
+            }
+            else
+            if (c < 0x10000)
+            {
+                nativePath += (char) (0xE0 | (c >> 12));
+                nativePath += (char) (0x80 | ((c >> 6) & 0x3F));
+                nativePath += (char) (0x80 | (c & 0x3F));
+            }
+            else
+            {
+                nativePath += (char) (0xF0 | (c >> 18));
+                nativePath += (char) (0x80 | ((c >> 12) & 0x3F));
+                nativePath += (char) (0x80 | ((c >> 6) & 0x3F));
+                nativePath += (char) (0x80 | (c & 0x3F));
+            }
+        }
+    }
+    catch (const std::bad_alloc &)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    return S_OK;
+}
+
+/// <summary>
+/// Converts an errno value to an HRESULT.
+/// </summary>
+static HRESULT GetErrorCode(int errorNumber) noexcept
+{
+    switch (errorNumber)
+    {
+        case ENOENT:
+        case ENOTDIR:
+            return STG_E_FILENOTFOUND;
+
+        case EACCES:
+        case EPERM:
+            return E_ACCESSDENIED;
+
+        case ENOMEM:
+            return E_OUTOFMEMORY;
+
+        default:
+            return E_FAIL;
+    }
+}
+
+/// <summary>
+/// Maps a file. An empty file is opened without a view.
+/// </summary>
+HRESULT MappedFile::Open(const WCHAR * filePath, FileAccess access) noexcept
+{
+    Close();
+
+    std::string NativePath;
+
+    HRESULT hr = GetNativePath(filePath, NativePath);
+
+    if (FAILED(hr))
+        return hr;
+
+    const int fd = ::open(NativePath.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd == -1)
+        return GetErrorCode(errno);
+
+    struct stat Status = { };
+
+    if (::fstat(fd, &Status) != 0)
+        hr = GetErrorCode(errno);
+    else
+    if (!S_ISREG(Status.st_mode))
+        hr = E_INVALIDARG;
+    else
+    if ((uint64_t) Status.st_size > (uint64_t) SIZE_MAX)
+        hr = E_OUTOFMEMORY;
+
+    if (SUCCEEDED(hr) && (Status.st_size != 0))
+    {
+        void * Data = ::mmap(nullptr, (size_t) Status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (Data != MAP_FAILED)
+            _Data = (const BYTE *) Data;
+        else
+            hr = GetErrorCode(errno);
+    }
+
+    ::close(fd);
+
+    if (FAILED(hr))
+        return hr;
+
+    _Size = (size_t) Status.st_size;
+    _IsOpen = true;
+
+    Advise(access);
+
+    return S_OK;
+}
+
+/// <summary>
+/// Unmaps the file.
+/// </summary>
+void MappedFile::Close() noexcept
+{
+    if (_Data != nullptr)
+        ::munmap((void *) _Data, _Size);
+
+    _Data = nullptr;
+    _Size = 0;
+    _IsOpen = false;
+}
+
+/// <summary>
+/// Tells the kernel how the file will be read. Sequential access doubles the read-ahead window and starts reading the file right away, so that the decoder rarely waits for a page fault.
+/// </summary>
+void MappedFile::Advise(FileAccess access) noexcept
+{
+    if (_Data == nullptr)
+        return;
+
+    if (access == FileAccess::Sequential)
+    {
+        ::madvise((void *) _Data, _Size, MADV_SEQUENTIAL);
+        ::madvise((void *) _Data, _Size, MADV_WILLNEED);
+    }
+    else
+        ::madvise((void *) _Data, _Size, MADV_RANDOM);
+}
+
+#endif
@@ -0,0 +1,49 @@
+
+/** $VER: MappedFile.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+
+/// <summary>
+/// Identifies how the contents of a mapped file will be accessed.
+/// </summary>
+enum class FileAccess
+{
+    Sequential,     // Read once from start to end, e.g. by an image decoder. The system reads ahead aggressively.
+    Random,         // Read in no particular order. The system does not read ahead.
+};
+
+/// <summary>
+/// Maps a file read-only into memory: a file mapping on Windows, mmap elsewhere. The pages are read from the file, or taken from the file cache,
+/// when they are first touched, so the contents are never copied into a buffer of the process. The mapping is move-only.
+/// Truncating the file while it is mapped makes reading the lost pages fault (SIGBUS, EXCEPTION_IN_PAGE_ERROR).
+/// </summary>
+class MappedFile
+{
+public:
+    MappedFile() noexcept;
+    ~MappedFile() noexcept;
+
+    MappedFile(MappedFile && other) noexcept;
+    MappedFile & operator=(MappedFile && other) noexcept;
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    HRESULT Open(const WCHAR * filePath, FileAccess access = FileAccess::Sequential) noexcept;
+    void Close() noexcept;
+
+    bool IsOpen() const noexcept { return _IsOpen; }
+
+    const BYTE * Data() const noexcept { return _Data; }
+    size_t Size() const noexcept { return _Size; }
+
+private:
+    void Advise(FileAccess access) noexcept;
+
+private:
+    const BYTE * _Data;
+    size_t _Size;
+    bool _IsOpen;
+};
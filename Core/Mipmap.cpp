@@ -0,0 +1,288 @@
+
+/** $VER: Mipmap.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "Mipmap.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <new>
+
+/*
+    Every pixel of a level is the rounded average of a 2 x 2 block of the previous level: (p0 + p1 + q0 + q1 + 2) >> 2 for every channel.
+    Averaging keeps premultiplied pixels valid. Odd sizes are rounded up and the last column or row is repeated, so every level covers
+    the complete image. The scalar and the SIMD kernels produce identical results.
+*/
+
+static std::atomic<InstructionSet> _InstructionSet(CPU::GetInstructionSet());
+
+typedef void (* HalveFunction)(const uint32_t * row0, const uint32_t * row1, uint32_t * dst, UINT srcWidth, UINT dstWidth);
+
+/// <summary>
+/// Averages 4 pixels. The channels are processed in pairs in 16-bit lanes; 4 x 255 + 2 never overflows a lane.
+/// </summary>
+static inline uint32_t Average(uint32_t p0, uint32_t p1, uint32_t q0, uint32_t q1) noexcept
+{
+    const uint32_t Lo = (p0 & 0x00FF00FFu) + (p1 & 0x00FF00FFu) + (q0 & 0x00FF00FFu) + (q1 & 0x00FF00FFu) + 0x00020002u;
+    const uint32_t Hi = ((p0 >> 8) & 0x00FF00FFu) + ((p1 >> 8) & 0x00FF00FFu) + ((q0 >> 8) & 0x00FF00FFu) + ((q1 >> 8) & 0x00FF00FFu) + 0x00020002u;
+
+    return ((Lo >> 2) & 0x00FF00FFu) | (((Hi >> 2) & 0x00FF00FFu) << 8);
+}
+
+/// <summary>
+/// Halves the pixels from x onwards, repeating the last column if the source width is odd.
+/// </summary>
+static inline void Halve_Tail(const uint32_t * row0, const uint32_t * row1, uint32_t * dst, UINT srcWidth, UINT dstWidth, UINT x) noexcept
+{
+    for (; x < dstWidth; ++x)
+    {
+        const UINT x0 = x * 2;
+        const UINT x1 = (std::min)(x0 + 1, srcWidth - 1);
+
+        dst[x] = Average(row0[x0], row0[x1], row1[x0], row1[x1]);
+    }
+}
+
+/// <summary>
+/// Halves a pair of rows.
+/// </summary>
+static void Halve_Scalar(const uint32_t * row0, const uint32_t * row1, uint32_t * dst, UINT srcWidth, UINT dstWidth) noexcept
+{
+    Halve_Tail(row0, row1, dst, srcWidth, dstWidth, 0);
+}
+
+#ifdef CORE_X86
+
+/// <summary>
+/// Halves a pair of rows, 4 destination pixels at a time.
+/// </summary>
+static void Halve_SSE2(const uint32_t * row0, const uint32_t * row1, uint32_t * dst, UINT srcWidth, UINT dstWidth) noexcept
+{
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i Two = _mm_set1_epi16(2);
+
+    const UINT Pairs = srcWidth / 2; // Destination pixels with 2 source columns.
+
+    UINT x = 0;
+
+    for (; x + 4 <= Pairs; x += 4)
+    {
+        const __m128 a0 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) (row0 + x * 2)));
+        const __m128 a1 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) (row0 + x * 2 + 4)));
+        const __m128 b0 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) (row1 + x * 2)));
+        const __m128 b1 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) (row1 + x * 2 + 4)));
+
+        // Separate the even and the odd columns.
+        const __m128i ae = _mm_castps_si128(_mm_shuffle_ps(a0, a1, _MM_SHUFFLE(2, 0, 2, 0)));
+        const __m128i ao = _mm_castps_si128(_mm_shuffle_ps(a0, a1, _MM_SHUFFLE(3, 1, 3, 1)));
+        const __m128i be = _mm_castps_si128(_mm_shuffle_ps(b0, b1, _MM_SHUFFLE(2, 0, 2, 0)));
+        const __m128i bo = _mm_castps_si128(_mm_shuffle_ps(b0, b1, _MM_SHUFFLE(3, 1, 3, 1)));
+
+        __m128i Lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(ae, Zero), _mm_unpacklo_epi8(ao, Zero)), _mm_add_epi16(_mm_unpacklo_epi8(be, Zero), _mm_unpacklo_epi8(bo, Zero)));
+        __m128i Hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(ae, Zero), _mm_unpackhi_epi8(ao, Zero)), _mm_add_epi16(_mm_unpackhi_epi8(be, Zero), _mm_unpackhi_epi8(bo, Zero)));
+
+        Lo = _mm_srli_epi16(_mm_add_epi16(Lo, Two), 2);
+        Hi = _mm_srli_epi16(_mm_add_epi16(Hi, Two), 2);
+
+        _mm_storeu_si128((__m128i *) (dst + x), _mm_packus_epi16(Lo, Hi));
+    }
+
+    Halve_Tail(row0, row1, dst, srcWidth, dstWidth, x);
+}
+
+/// <summary>
+/// Halves a pair of rows, 8 destination pixels at a time.
+/// </summary>
+TARGET_AVX2 static void Halve_AVX2(const uint32_t * row0, const uint32_t * row1, uint32_t * dst, UINT srcWidth, UINT dstWidth) noexcept
+{
+    const __m256i Zero = _mm256_setzero_si256();
+    const __m256i Two = _mm256_set1_epi16(2);
+
+    const UINT Pairs = srcWidth / 2;
+
+    UINT x = 0;
+
+    for (; x + 8 <= Pairs; x += 8)
+    {
+        const __m256 a0 = _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i *) (row0 + x * 2)));
+        const __m256 a1 = _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i *) (row0 + x * 2 + 8)));
+        const __m256 b0 = _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i *) (row1 + x * 2)));
+        const __m256 b1 = _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i *) (row1 + x * 2 + 8)));
+
+        // Separate the even and the odd columns. The shuffles work per 128-bit lane, which leaves the pixel pairs in the order 0, 2, 1, 3.
+        const __m256i ae = _mm256_castps_si256(_mm256_shuffle_ps(a0, a1, _MM_SHUFFLE(2, 0, 2, 0)));
+        const __m256i ao = _mm256_castps_si256(_mm256_shuffle_ps(a0, a1, _MM_SHUFFLE(3, 1, 3, 1)));
+        const __m256i be = _mm256_castps_si256(_mm256_shuffle_ps(b0, b1, _MM_SHUFFLE(2, 0, 2, 0)));
+        const __m256i bo = _mm256_castps_si256(_mm256_shuffle_ps(b0, b1, _MM_SHUFFLE(3, 1, 3, 1)));
+
+        __m256i Lo = _mm256_add_epi16(_mm256_add_epi16(_mm256_unpacklo_epi8(ae, Zero), _mm256_unpacklo_epi8(ao, Zero)), _mm256_add_epi16(_mm256_unpacklo_epi8(be, Zero), _mm256_unpacklo_epi8(bo, Zero)));
+        __m256i Hi = _mm256_add_epi16(_mm256_add_epi16(_mm256_unpackhi_epi8(ae, Zero), _mm256_unpackhi_epi8(ao, Zero)), _mm256_add_epi16(_mm256_unpackhi_epi8(be, Zero), _mm256_unpackhi_epi8(bo, Zero)));
+
+        Lo = _mm256_srli_epi16(_mm256_add_epi16(Lo, Two), 2);
+        Hi = _mm256_srli_epi16(_mm256_add_epi16(Hi, Two), 2);
+
+        _mm256_storeu_si256((__m256i *) (dst + x), _mm256_permute4x64_epi64(_mm256_packus_epi16(Lo, Hi), _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+
+    Halve_Tail(row0, row1, dst, srcWidth, dstWidth, x);
+}
+
+#endif
+
+/// <summary>
+/// Builds the mip chain of a premultiplied BGRA image. The levels are halved until one of the dimensions reaches 1 pixel.
+/// </summary>
+HRESULT Mipmap::Build(const std::shared_ptr<const Raster> & image, ThreadPool * threadPool) noexcept
+{
+    _Levels.clear();
+
+    if ((image == nullptr) || image->IsEmpty() || (image->Format() != PixelFormat::PBGRA32))
+        return E_INVALIDARG;
+
+    try
+    {
+        _Levels.push_back(image);
+
+        while ((_Levels.back()->Width() > 1) && (_Levels.back()->Height() > 1))
+        {
+            auto Level = std::make_shared<Raster>();
+
+            HRESULT hr = Halve(*_Levels.back(), *Level, threadPool);
+
+            if (!SUCCEEDED(hr))
+            {
+                _Levels.clear();
+
+                return hr;
+            }
+
+            _Levels.push_back(Level);
+        }
+    }
+    catch (const std::bad_alloc &)
+    {
+        _Levels.clear();
+
+        return E_OUTOFMEMORY;
+    }
+
+    return S_OK;
+}
+
+/// <summary>
+/// Selects the smallest level that is at least as large as the specified size, or level 0 when enlarging.
+/// </summary>
+UINT Mipmap::SelectLevel(UINT width, UINT height) const noexcept
+{
+    UINT Level = 0;
+
+    while ((Level + 1 < (UINT) _Levels.size()) && (_Levels[Level + 1]->Width() >= width) && (_Levels[Level + 1]->Height() >= height))
+        ++Level;
+
+    return Level;
+}
+
+/// <summary>
+/// Scales the image to the specified size, starting from the nearest larger level.
+/// </summary>
+HRESULT Mipmap::Scale(Raster & dst, UINT width, UINT height, ScaleFilter filter, ThreadPool * threadPool) const noexcept
+{
+    if (_Levels.empty() || (width == 0) || (height == 0))
+        return E_INVALIDARG;
+
+    const Raster & Level = *_Levels[SelectLevel(width, height)];
+
+    if ((Level.Width() == width) && (Level.Height() == height))
+        return dst.CopyFrom(Level);
+
+    return Scaler::Scale(Level, dst, width, height, filter, threadPool);
+}
+
+/// <summary>
+/// Scales the image down to fit the specified size, preserving its aspect ratio.
+/// </summary>
+HRESULT Mipmap::Fit(Raster & dst, UINT maxWidth, UINT maxHeight, ScaleFilter filter, ThreadPool * threadPool) const noexcept
+{
+    if (_Levels.empty())
+        return E_INVALIDARG;
+
+    UINT Width, Height;
+
+    Scaler::GetFitSize(_Levels[0]->Width(), _Levels[0]->Height(), maxWidth, maxHeight, Width, Height);
+
+    return Scale(dst, Width, Height, filter, threadPool);
+}
+
+/// <summary>
+/// Gets the number of bytes used by all levels, including level 0.
+/// </summary>
+size_t Mipmap::GetSize() const noexcept
+{
+    size_t Size = 0;
+
+    for (const auto & Level : _Levels)
+        Size += Level->Size();
+
+    return Size;
+}
+
+/// <summary>
+/// Creates a raster of half the size, rounded up, by averaging every 2 x 2 block of pixels. The rows are split in bands over a thread pool.
+/// </summary>
+HRESULT Mipmap::Halve(const Raster & src, Raster & dst, ThreadPool * threadPool) noexcept
+{
+    if ((src.Format() != PixelFormat::PBGRA32) || src.IsEmpty() || (&src == &dst))
+        return E_INVALIDARG;
+
+    const UINT Width  = (src.Width()  + 1) / 2;
+    const UINT Height = (src.Height() + 1) / 2;
+
+    HRESULT hr = dst.Initialize(Width, Height);
+
+    if (!SUCCEEDED(hr))
+        return hr;
+
+    HalveFunction Function = Halve_Scalar;
+
+#ifdef CORE_X86
+    const InstructionSet Set = GetInstructionSet();
+
+    if (Set >= InstructionSet::AVX2)
+        Function = Halve_AVX2;
+    else
+    if (Set >= InstructionSet::SSE2)
+        Function = Halve_SSE2;
+#endif
+
+    ThreadPool & Pool = (threadPool != nullptr) ? *threadPool : ThreadPool::GetDefault();
+
+    Pool.ParallelFor(Height, [&](UINT begin, UINT end)
+    {
+        for (UINT y = begin; y < end; ++y)
+        {
+            const UINT y0 = y * 2;
+            const UINT y1 = (std::min)(y0 + 1, src.Height() - 1);
+
+            Function((const uint32_t *) src.Row(y0), (const uint32_t *) src.Row(y1), (uint32_t *) dst.Row(y), src.Width(), Width);
+        }
+    });
+
+    return S_OK;
+}
+
+/// <summary>
+/// Gets the instruction set used to build the levels.
+/// </summary>
+InstructionSet Mipmap::GetInstructionSet() noexcept
+{
+    return _InstructionSet;
+}
+
+/// <summary>
+/// Limits the instruction set used to build the levels, e.g. to compare the kernels. The CPU capabilities are never exceeded.
+/// </summary>
+void Mipmap::SetInstructionSet(InstructionSet instructionSet) noexcept
+{
+    _InstructionSet = (std::min)(instructionSet, CPU::GetInstructionSet());
+}
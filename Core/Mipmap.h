@@ -0,0 +1,46 @@
+
+/** $VER: Mipmap.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+#include "CPU.h"
+#include "Raster.h"
+#include "Scaler.h"
+
+#include <memory>
+#include <vector>
+
+class ThreadPool;
+
+/// <summary>
+/// Represents a mip chain of a premultiplied BGRA image: level 0 is the image itself and every next level is a 2 x 2 box-filtered half of the previous one.
+/// Any size is produced by one high-quality pass from the nearest level that is at least as large, which costs about 1 / 4^k of a pass from the full image.
+/// The levels are shared, immutable rasters so they can be handed to the image cache without copying.
+/// </summary>
+class Mipmap
+{
+public:
+    Mipmap() { }
+
+    HRESULT Build(const std::shared_ptr<const Raster> & image, ThreadPool * threadPool = nullptr) noexcept;
+    void Clear() noexcept { _Levels.clear(); }
+
+    UINT GetLevelCount() const noexcept { return (UINT) _Levels.size(); }
+    const std::shared_ptr<const Raster> & GetLevel(UINT level) const noexcept { return _Levels[level]; }
+
+    UINT SelectLevel(UINT width, UINT height) const noexcept;
+
+    HRESULT Scale(Raster & dst, UINT width, UINT height, ScaleFilter filter = ScaleFilter::Lanczos3, ThreadPool * threadPool = nullptr) const noexcept;
+    HRESULT Fit(Raster & dst, UINT maxWidth, UINT maxHeight, ScaleFilter filter = ScaleFilter::Lanczos3, ThreadPool * threadPool = nullptr) const noexcept;
+
+    size_t GetSize() const noexcept;
+
+    static HRESULT Halve(const Raster & src, Raster & dst, ThreadPool * threadPool = nullptr) noexcept;
+
+    static InstructionSet GetInstructionSet() noexcept;
+    static void SetInstructionSet(InstructionSet instructionSet) noexcept;
+
+private:
+    std::vector<std::shared_ptr<const Raster>> _Levels;
+};
@@ -0,0 +1,547 @@
+
+/** $VER: PixelConverter.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "PixelConverter.h"
+#include "Raster.h"
+
+#include <atomic>
+
+/*
+    All kernels may be called with src == dst when the source and destination pixels have the same size. Premultiplication rounds
+    to nearest, (c * a + 127) / 255, in every implementation. Unpremultiplication uses single-precision floats; the SIMD and the
+    scalar kernels perform the same IEEE operations.
+*/
+
+static std::atomic<InstructionSet> _InstructionSet(CPU::GetInstructionSet());
+
+// Scalar
+
+/// <summary>
+/// Divides by 255 and rounds to nearest. Exact for x in [0, 255 * 255].
+/// </summary>
+static inline uint32_t Div255(uint32_t x) noexcept
+{
+    x += 128;
+
+    return (x + (x >> 8)) >> 8;
+}
+
+/// <summary>
+/// Converts a row of pixels from one format to another. The layouts come from the format traits, so each instantiation is a loop without format branches.
+/// Straight alpha is premultiplied when the destination is premultiplied or has no alpha (composited on black); premultiplied alpha is unpremultiplied
+/// when the destination has straight alpha. Formats without alpha are opaque.
+/// </summary>
+template<PixelFormat Src, PixelFormat Dst>
+static void Convert_Scalar(const BYTE * src, BYTE * dst, UINT width) noexcept
+{
+    typedef PixelFormatTraits<Src> S;
+    typedef PixelFormatTraits<Dst> D;
+
+    if constexpr (Src == Dst)
+    {
+        if (src != dst)
+            ::memcpy(dst, src, (size_t) width * S::BytesPerPixel);
+    }
+    else
+    {
+        for (UINT i = 0; i < width; ++i, src += S::BytesPerPixel, dst += D::BytesPerPixel)
+        {
+            uint32_t r = src[S::R];
+            uint32_t g = src[S::G];
+            uint32_t b = src[S::B];
+            uint32_t a = 0xFF;
+
+            if constexpr (S::HasAlpha)
+                a = src[S::A];
+
+            if constexpr (S::HasAlpha && !S::IsPremultiplied && (D::IsPremultiplied || !D::HasAlpha))
+            {
+                r = Div255(r * a);
+                g = Div255(g * a);
+                b = Div255(b * a);
+            }
+            else
+            if constexpr (S::IsPremultiplied && D::HasAlpha && !D::IsPremultiplied)
+            {
+                if (a == 0)
+                    r = g = b = 0;
+                else
+                {
+                    const float Scale = 255.f / (float) a;
+
+                    r = (std::min)((uint32_t) ((float) r * Scale + .5f), 255u);
+                    g = (std::min)((uint32_t) ((float) g * Scale + .5f), 255u);
+                    b = (std::min)((uint32_t) ((float) b * Scale + .5f), 255u);
+                }
+            }
+
+            dst[D::R] = (BYTE) r;
+            dst[D::G] = (BYTE) g;
+            dst[D::B] = (BYTE) b;
+
+            if constexpr (D::HasAlpha)
+                dst[D::A] = (BYTE) a;
+        }
+    }
+}
+
+/// <summary>
+/// True if the red and the blue channel of a format are swapped compared to the compositor format.
+/// </summary>
+template<PixelFormat Format>
+static constexpr bool IsSwapped = (PixelFormatTraits<Format>::R != PixelFormatTraits<PixelFormat::PBGRA32>::R);
+
+#ifdef CORE_X86
+
+// SSE2
+
+/// <summary>
+/// Swaps the first and the third byte of each pixel.
+/// </summary>
+static inline __m128i SwapRB_SSE2(__m128i p) noexcept
+{
+    const __m128i MaskGA = _mm_set1_epi32((int) 0xFF00FF00);
+    const __m128i MaskB  = _mm_set1_epi32(0x000000FF);
+
+    return _mm_or_si128(_mm_and_si128(p, MaskGA), _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), MaskB), _mm_slli_epi32(_mm_and_si128(p, MaskB), 16)));
+}
+
+/// <summary>
+/// Multiplies 8 16-bit channels (2 pixels) with their alpha and divides by 255.
+/// </summary>
+static inline __m128i Premultiply2_SSE2(__m128i p) noexcept
+{
+    const __m128i Alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(p, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(p, Alpha), _mm_set1_epi16(128));
+
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+/// <summary>
+/// Premultiplies 4 pixels at a time.
+/// </summary>
+template<PixelFormat Src>
+static void Premultiply_SSE2(const BYTE * src, BYTE * dst, UINT width) noexcept
+{
+    constexpr bool Swap = IsSwapped<Src>;
+
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i AlphaMask = _mm_set1_epi32((int) 0xFF000000);
+
+    UINT i = 0;
+
+    for (; i + 4 <= width; i += 4, src += 16, dst += 16)
+    {
+        __m128i p = _mm_loadu_si128((const __m128i *) src);
+
+        if constexpr (Swap)
+            p = SwapRB_SSE2(p);
+
+        // Opaque pixels stay the same.
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(p, AlphaMask), AlphaMask)) != 0xFFFF)
+        {
+            const __m128i Lo = Premultiply2_SSE2(_mm_unpacklo_epi8(p, Zero));
+            const __m128i Hi = Premultiply2_SSE2(_mm_unpackhi_epi8(p, Zero));
+
+            p = _mm_or_si128(_mm_andnot_si128(AlphaMask, _mm_packus_epi16(Lo, Hi)), _mm_and_si128(p, AlphaMask));
+        }
+
+        _mm_storeu_si128((__m128i *) dst, p);
+    }
+
+    Convert_Scalar<Src, PixelFormat::PBGRA32>(src, dst, width - i);
+}
+
+/// <summary>
+/// Unpremultiplies 1 pixel stored as 4 32-bit integers.
+/// </summary>
+static inline __m128i Unpremultiply1_SSE2(__m128i p) noexcept
+{
+    const __m128 c = _mm_cvtepi32_ps(p);
+    const __m128 a = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 3, 3));
+
+    const __m128 Scale = _mm_and_ps(_mm_div_ps(_mm_set1_ps(255.f), a), _mm_cmpneq_ps(a, _mm_setzero_ps()));
+
+    return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(c, Scale), _mm_set1_ps(.5f)));
+}
+
+/// <summary>
+/// Unpremultiplies 4 pixels at a time.
+/// </summary>
+template<PixelFormat Dst>
+static void Unpremultiply_SSE2(const BYTE * src, BYTE * dst, UINT width) noexcept
+{
+    constexpr bool Swap = IsSwapped<Dst>;
+
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i AlphaMask = _mm_set1_epi32((int) 0xFF000000);
+
+    UINT i = 0;
+
+    for (; i + 4 <= width; i += 4, src += 16, dst += 16)
+    {
+        __m128i p = _mm_loadu_si128((const __m128i *) src);
+
+        // Opaque pixels stay the same.
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(p, AlphaMask), AlphaMask)) != 0xFFFF)
+        {
+            const __m128i Lo = _mm_unpacklo_epi8(p, Zero);
+            const __m128i Hi = _mm_unpackhi_epi8(p, Zero);
+
+            const __m128i p0 = Unpremultiply1_SSE2(_mm_unpacklo_epi16(Lo, Zero));
+            const __m128i p1 = Unpremultiply1_SSE2(_mm_unpackhi_epi16(Lo, Zero));
+            const __m128i p2 = Unpremultiply1_SSE2(_mm_unpacklo_epi16(Hi, Zero));
+            const __m128i p3 = Unpremultiply1_SSE2(_mm_unpackhi_epi16(Hi, Zero));
+
+            const __m128i Color = _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3));
+
+            // Fully transparent pixels become transparent black.
+            const __m128i Transparent = _mm_cmpeq_epi32(_mm_and_si128(p, AlphaMask), Zero);
+
+            p = _mm_andnot_si128(Transparent, _mm_or_si128(_mm_andnot_si128(AlphaMask, Color), _mm_and_si128(p, AlphaMask)));
+        }
+
+        if constexpr (Swap)
+            p = SwapRB_SSE2(p);
+
+        _mm_storeu_si128((__m128i *) dst, p);
+    }
+
+    Convert_Scalar<PixelFormat::PBGRA32, Dst>(src, dst, width - i);
+}
+
+/// <summary>
+/// Loads a 24bpp pixel into the low 24 bits of a 32-bit value without reading past the pixel.
+/// </summary>
+static inline int Load24(const BYTE * p) noexcept
+{
+    return (int) ((uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16));
+}
+
+/// <summary>
+/// Expands 4 pixels at a time.
+/// </summary>
+template<PixelFormat Src>
+static void Expand_SSE2(const BYTE * src, BYTE * dst, UINT width) noexcept
+{
+    constexpr bool Swap = IsSwapped<Src>;
+
+    const __m128i AlphaMask = _mm_set1_epi32((int) 0xFF000000);
+
+    UINT i = 0;
+
+    for (; i + 4 <= width; i += 4, src += 12, dst += 16)
+    {
+        int p0, p1, p2, p3;
+
+        ::memcpy(&p0, src,     4);
+        ::memcpy(&p1, src + 3, 4);
+        ::memcpy(&p2, src + 6, 4);
+        p3 = Load24(src + 9); // The last pixel of the row may be the last pixel of the buffer.
+
+        __m128i p = _mm_or_si128(_mm_set_epi32(p3, p2, p1, p0), AlphaMask);
+
+        if constexpr (Swap)
+            p = SwapRB_SSE2(p);
+
+        _mm_storeu_si128((__m128i *) dst, p);
+    }
+
+    Convert_Scalar<Src, PixelFormat::PBGRA32>(src, dst, width - i);
+}
+
+// AVX2
+
+/// <summary>
+/// Premultiplies 8 pixels at a time.
+/// </summary>
+template<PixelFormat Src>
+TARGET_AVX2 static void Premultiply_AVX2(const BYTE * src, BYTE * dst, UINT width) noexcept
+{
+    constexpr bool Swap = IsSwapped<Src>;
+
+    const __m256i Zero = _mm256_setzero_si256();
+    const __m256i AlphaMask = _mm256_set1_epi32((int) 0xFF000000);
+    const __m256i Round = _mm256_set1_epi16(128);
+    const __m256i SwapRB = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15, 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    const __m256i BroadcastAlpha = _mm256_setr_epi8(6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15, 6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15);
+
+    UINT i = 0;
+
+    for (; i + 8 <= width; i += 8, src += 32, dst += 32)
+    {
+        __m256i p = _mm256_loadu_si256((const __m256i *) src);
+
+        if constexpr (Swap)
+            p = _mm256_shuffle_epi8(p, SwapRB);
+
+        if ((uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(p, AlphaMask), AlphaMask)) != 0xFFFFFFFFu)
+        {
+            __m256i Lo = _mm256_unpacklo_epi8(p, Zero);
+            __m256i Hi = _mm256_unpackhi_epi8(p, Zero);
+
+            Lo = _mm256_add_epi16(_mm256_mullo_epi16(Lo, _mm256_shuffle_epi8(Lo, BroadcastAlpha)), Round);
+            Hi = _mm256_add_epi16(_mm256_mullo_epi16(Hi, _mm256_shuffle_epi8(Hi, BroadcastAlpha)), Round);
+
+            Lo = _mm256_srli_epi16(_mm256_add_epi16(Lo, _mm256_srli_epi16(Lo, 8)), 8);
+            Hi = _mm256_srli_epi16(_mm256_add_epi16(Hi, _mm256_srli_epi16(Hi, 8)), 8);
+
+            p = _mm256_or_si256(_mm256_andnot_si256(AlphaMask, _mm256_packus_epi16(Lo, Hi)), _mm256_and_si256(p, AlphaMask));
+        }
+
+        _mm256_storeu_si256((__m256i *) dst, p);
+    }
+
+    Premultiply_SSE2<Src>(src, dst, width - i);
+}
+
+/// <summary>
+/// Unpremultiplies 2 pixels stored as 8 32-bit integers, one pixel per lane.
+/// </summary>
+TARGET_AVX2 static inline __m256i Unpremultiply2_AVX2(__m256i p) noexcept
+{
+    const __m256 c = _mm256_cvtepi32_ps(p);
+    const __m256 a = _mm256_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 3, 3));
+
+    const __m256 Scale = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(255.f), a), _mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_NEQ_UQ));
+
+    return _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(c, Scale), _mm256_set1_ps(.5f)));
+}
+
+/// <summary>
+/// Unpremultiplies 8 pixels at a time.
+/// </summary>
+template<PixelFormat Dst>
+TARGET_AVX2 static void Unpremultiply_AVX2(const BYTE * src, BYTE * dst, UINT width) noexcept
+{
+    constexpr bool Swap = IsSwapped<Dst>;
+
+    const __m256i Zero = _mm256_setzero_si256();
+    const __m256i AlphaMask = _mm256_set1_epi32((int) 0xFF000000);
+    const __m256i Order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    const __m256i SwapRB = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15, 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+    UINT i = 0;
+
+    for (; i + 8 <= width; i += 8, src += 32, dst += 32)
+    {
+        __m256i p = _mm256_loadu_si256((const __m256i *) src);
+
+        if ((uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(p, AlphaMask), AlphaMask)) != 0xFFFFFFFFu)
+        {
+            // Each vector holds pixels (2n, 2n + 1); packing interleaves them as 0 2 4 6 | 1 3 5 7.
+            const __m256i p01 = Unpremultiply2_AVX2(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (src +  0))));
+            const __m256i p23 = Unpremultiply2_AVX2(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (src +  8))));
+            const __m256i p45 = Unpremultiply2_AVX2(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (src + 16))));
+            const __m256i p67 = Unpremultiply2_AVX2(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (src + 24))));
+
+            const __m256i Color = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(_mm256_packs_epi32(p01, p23), _mm256_packs_epi32(p45, p67)), Order);
+
+            const __m256i Transparent = _mm256_cmpeq_epi32(_mm256_and_si256(p, AlphaMask), Zero);
+
+            p = _mm256_andnot_si256(Transparent, _mm256_or_si256(_mm256_andnot_si256(AlphaMask, Color), _mm256_and_si256(p, AlphaMask)));
+        }
+
+        if constexpr (Swap)
+            p = _mm256_shuffle_epi8(p, SwapRB);
+
+        _mm256_storeu_si256((__m256i *) dst, p);
+    }
+
+    Unpremultiply_SSE2<Dst>(src, dst, width - i);
+}
+
+/// <summary>
+/// Expands 8 pixels at a time.
+/// </summary>
+template<PixelFormat Src>
+TARGET_AVX2 static void Expand_AVX2(const BYTE * src, BYTE * dst, UINT width) noexcept
+{
+    constexpr bool Swap = IsSwapped<Src>;
+
+    const __m256i AlphaMask = _mm256_set1_epi32((int) 0xFF000000);
+    const __m256i Shuffle = Swap ?
+        _mm256_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1) :
+        _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+
+    UINT i = 0;
+
+    // Each lane loads 16 bytes for 4 pixels. Stop early enough to never read past the end of the row.
+    for (; i + 10 <= width; i += 8, src += 24, dst += 32)
+    {
+        const __m256i p = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) src)), _mm_loadu_si128((const __m128i *) (src + 12)), 1);
+
+        _mm256_storeu_si256((__m256i *) dst, _mm256_or_si256(_mm256_shuffle_epi8(p, Shuffle), AlphaMask));
+    }
+
+    Expand_SSE2<Src>(src, dst, width - i);
+}
+
+#endif
+
+/// <summary>
+/// Contains the kernels of a conversion, one per instruction set. The SIMD kernels are null for conversions without one.
+/// </summary>
+struct Kernels
+{
+    PixelConverter::RowFunction Scalar;
+    PixelConverter::RowFunction SSE2;
+    PixelConverter::RowFunction AVX2;
+};
+
+/// <summary>
+/// Gets the kernels of a conversion. Every pair of formats has a scalar kernel; converting to and from the compositor format also has SIMD kernels.
+/// </summary>
+template<PixelFormat Src, PixelFormat Dst>
+static constexpr Kernels GetKernels() noexcept
+{
+    typedef PixelFormatTraits<Src> S;
+    typedef PixelFormatTraits<Dst> D;
+
+    if constexpr ((Src == PixelFormat::Unknown) || (Dst == PixelFormat::Unknown))
+        return { };
+#ifdef CORE_X86
+    else
+    if constexpr ((Dst == PixelFormat::PBGRA32) && (S::BytesPerPixel == 4) && S::HasAlpha && !S::IsPremultiplied)
+        return { Convert_Scalar<Src, Dst>, Premultiply_SSE2<Src>, Premultiply_AVX2<Src> };
+    else
+    if constexpr ((Dst == PixelFormat::PBGRA32) && (S::BytesPerPixel == 3))
+        return { Convert_Scalar<Src, Dst>, Expand_SSE2<Src>, Expand_AVX2<Src> };
+    else
+    if constexpr ((Src == PixelFormat::PBGRA32) && (D::BytesPerPixel == 4) && D::HasAlpha && !D::IsPremultiplied)
+        return { Convert_Scalar<Src, Dst>, Unpremultiply_SSE2<Dst>, Unpremultiply_AVX2<Dst> };
+#endif
+    else
+        return { Convert_Scalar<Src, Dst>, nullptr, nullptr };
+}
+
+#define KERNELS(src) \
+    { GetKernels<src, PixelFormat::Unknown>(), GetKernels<src, PixelFormat::PBGRA32>(), GetKernels<src, PixelFormat::BGRA32>(), GetKernels<src, PixelFormat::RGBA32>(), GetKernels<src, PixelFormat::BGR24>(), GetKernels<src, PixelFormat::RGB24>() }
+
+/// <summary>
+/// The dispatch table of the converter, indexed by the source and the destination format. This is the only place that branches on the formats.
+/// </summary>
+static constexpr Kernels _Kernels[(size_t) PixelFormat::Count][(size_t) PixelFormat::Count] =
+{
+    KERNELS(PixelFormat::Unknown),
+    KERNELS(PixelFormat::PBGRA32),
+    KERNELS(PixelFormat::BGRA32),
+    KERNELS(PixelFormat::RGBA32),
+    KERNELS(PixelFormat::BGR24),
+    KERNELS(PixelFormat::RGB24),
+};
+
+#undef KERNELS
+
+/// <summary>
+/// Returns true if the converter supports the conversion.
+/// </summary>
+bool PixelConverter::IsSupported(PixelFormat srcFormat, PixelFormat dstFormat) noexcept
+{
+    return GetRowFunction(srcFormat, dstFormat, InstructionSet::Scalar) != nullptr;
+}
+
+/// <summary>
+/// Gets the function that converts a row of pixels using the specified instruction set.
+/// </summary>
+PixelConverter::RowFunction PixelConverter::GetRowFunction(PixelFormat srcFormat, PixelFormat dstFormat, InstructionSet instructionSet) noexcept
+{
+    if ((srcFormat >= PixelFormat::Count) || (dstFormat >= PixelFormat::Count))
+        return nullptr;
+
+    const Kernels & k = _Kernels[(size_t) srcFormat][(size_t) dstFormat];
+
+#ifdef CORE_X86
+    if ((instructionSet >= InstructionSet::AVX2) && CPU::HasAVX2() && (k.AVX2 != nullptr))
+        return k.AVX2;
+
+    if ((instructionSet >= InstructionSet::SSE2) && CPU::HasSSE2() && (k.SSE2 != nullptr))
+        return k.SSE2;
+#else
+    (void) instructionSet;
+#endif
+
+    return k.Scalar;
+}
+
+/// <summary>
+/// Converts a block of pixels. The source and the destination may be the same buffer if both formats have the same pixel size.
+/// </summary>
+HRESULT PixelConverter::Convert(const BYTE * src, UINT srcStride, PixelFormat srcFormat, BYTE * dst, UINT dstStride, PixelFormat dstFormat, UINT width, UINT height) noexcept
+{
+    const RowFunction Function = GetRowFunction(srcFormat, dstFormat, GetInstructionSet());
+
+    if (Function == nullptr)
+        return E_NOTIMPL;
+
+    if ((src == dst) && (GetBitsPerPixel(srcFormat) != GetBitsPerPixel(dstFormat)))
+        return E_INVALIDARG;
+
+    for (UINT y = 0; y < height; ++y, src += srcStride, dst += dstStride)
+        Function(src, dst, width);
+
+    return S_OK;
+}
+
+/// <summary>
+/// Converts a raster to a new raster in the specified format.
+/// </summary>
+HRESULT PixelConverter::Convert(const Raster & src, Raster & dst, PixelFormat dstFormat) noexcept
+{
+    if (!IsSupported(src.Format(), dstFormat))
+        return E_NOTIMPL;
+
+    HRESULT hr = dst.Initialize(src.Width(), src.Height(), dstFormat);
+
+    if (SUCCEEDED(hr))
+        hr = Convert(src.Data(), src.Stride(), src.Format(), dst.Data(), dst.Stride(), dstFormat, src.Width(), src.Height());
+
+    return hr;
+}
+
+/// <summary>
+/// Converts a raster to the specified format. The conversion happens in place if both formats have the same pixel size.
+/// </summary>
+HRESULT PixelConverter::Convert(Raster & raster, PixelFormat dstFormat) noexcept
+{
+    if (raster.Format() == dstFormat)
+        return S_OK;
+
+    if (GetBitsPerPixel(raster.Format()) != GetBitsPerPixel(dstFormat))
+    {
+        Raster Converted;
+
+        HRESULT hr = Convert(raster, Converted, dstFormat);
+
+        if (SUCCEEDED(hr))
+            raster = std::move(Converted);
+
+        return hr;
+    }
+
+    HRESULT hr = Convert(raster.Data(), raster.Stride(), raster.Format(), raster.Data(), raster.Stride(), dstFormat, raster.Width(), raster.Height());
+
+    if (SUCCEEDED(hr))
+        hr = raster.SetFormat(dstFormat);
+
+    return hr;
+}
+
+/// <summary>
+/// Gets the instruction set used by the conversions.
+/// </summary>
+InstructionSet PixelConverter::GetInstructionSet() noexcept
+{
+    return _InstructionSet;
+}
+
+/// <summary>
+/// Limits the instruction set used by the conversions, e.g. to compare the kernels. The CPU capabilities are never exceeded.
+/// </summary>
+void PixelConverter::SetInstructionSet(InstructionSet instructionSet) noexcept
+{
+    _InstructionSet = (std::min)(instructionSet, CPU::GetInstructionSet());
+}
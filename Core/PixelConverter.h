@@ -0,0 +1,31 @@
+
+/** $VER: PixelConverter.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+#include "CPU.h"
+#include "PixelFormat.h"
+
+class Raster;
+
+/// <summary>
+/// Converts pixels between any two formats: premultiplies, unpremultiplies, swizzles, expands and drops channels. The kernels are instantiated per pair
+/// of formats from the format traits. Conversions to and from 32bpp premultiplied BGRA use AVX2 or SSE2 kernels when the CPU supports them.
+/// </summary>
+class PixelConverter
+{
+public:
+    typedef void (* RowFunction)(const BYTE * src, BYTE * dst, UINT width);
+
+    static bool IsSupported(PixelFormat srcFormat, PixelFormat dstFormat) noexcept;
+
+    static HRESULT Convert(const BYTE * src, UINT srcStride, PixelFormat srcFormat, BYTE * dst, UINT dstStride, PixelFormat dstFormat, UINT width, UINT height) noexcept;
+    static HRESULT Convert(const Raster & src, Raster & dst, PixelFormat dstFormat) noexcept;
+    static HRESULT Convert(Raster & raster, PixelFormat dstFormat) noexcept;
+
+    static InstructionSet GetInstructionSet() noexcept;
+    static void SetInstructionSet(InstructionSet instructionSet) noexcept;
+
+    static RowFunction GetRowFunction(PixelFormat srcFormat, PixelFormat dstFormat, InstructionSet instructionSet) noexcept;
+};
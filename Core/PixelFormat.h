@@ -0,0 +1,68 @@
+
+/** $VER: PixelFormat.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+
+/// <summary>
+/// Identifies the memory layout of a pixel. The channels are listed in byte order.
+/// </summary>
+enum class PixelFormat : uint32_t
+{
+    Unknown = 0,
+
+    PBGRA32,    // 8-bit B, G, R, A with premultiplied alpha. The native format of the compositor surfaces.
+    BGRA32,     // 8-bit B, G, R, A with straight alpha.
+    RGBA32,     // 8-bit R, G, B, A with straight alpha.
+    BGR24,      // 8-bit B, G, R
+    RGB24,      // 8-bit R, G, B
+
+    Count
+};
+
+/// <summary>
+/// Describes the layout of a pixel format at compile time: the size of a pixel, the byte offset of each channel (-1 if the format has no such channel),
+/// and how the channels are stored.
+/// </summary>
+template<UINT Bits, int RedOffset, int GreenOffset, int BlueOffset, int AlphaOffset, bool Premultiplied>
+struct PixelLayout
+{
+    static constexpr UINT BitsPerPixel = Bits;
+    static constexpr UINT BytesPerPixel = Bits / 8;
+
+    static constexpr int R = RedOffset;
+    static constexpr int G = GreenOffset;
+    static constexpr int B = BlueOffset;
+    static constexpr int A = AlphaOffset;
+
+    static constexpr bool HasAlpha = (AlphaOffset >= 0);
+    static constexpr bool IsPremultiplied = Premultiplied;
+    static constexpr bool IsFloat = false;      // All supported formats store 8-bit unsigned normalized channels.
+};
+
+template<PixelFormat Format> struct PixelFormatTraits : PixelLayout< 0, -1, -1, -1, -1, false> { };
+
+template<> struct PixelFormatTraits<PixelFormat::PBGRA32> : PixelLayout<32, 2, 1, 0, 3, true> { };
+template<> struct PixelFormatTraits<PixelFormat::BGRA32>  : PixelLayout<32, 2, 1, 0, 3, false> { };
+template<> struct PixelFormatTraits<PixelFormat::RGBA32>  : PixelLayout<32, 0, 1, 2, 3, false> { };
+template<> struct PixelFormatTraits<PixelFormat::BGR24>   : PixelLayout<24, 2, 1, 0, -1, false> { };
+template<> struct PixelFormatTraits<PixelFormat::RGB24>   : PixelLayout<24, 0, 1, 2, -1, false> { };
+
+/// <summary>
+/// Gets the number of bits per pixel for the specified pixel format.
+/// </summary>
+constexpr UINT GetBitsPerPixel(PixelFormat format) noexcept
+{
+    switch (format)
+    {
+        case PixelFormat::PBGRA32: return PixelFormatTraits<PixelFormat::PBGRA32>::BitsPerPixel;
+        case PixelFormat::BGRA32:  return PixelFormatTraits<PixelFormat::BGRA32>::BitsPerPixel;
+        case PixelFormat::RGBA32:  return PixelFormatTraits<PixelFormat::RGBA32>::BitsPerPixel;
+        case PixelFormat::BGR24:   return PixelFormatTraits<PixelFormat::BGR24>::BitsPerPixel;
+        case PixelFormat::RGB24:   return PixelFormatTraits<PixelFormat::RGB24>::BitsPerPixel;
+
+        default:
+            return 0;
+    }
+}
@@ -0,0 +1,155 @@
+
+/** $VER: Raster.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "Raster.h"
+
+#include <limits>
+#include <new>
+#include <string.h>
+
+/// <summary>
+/// Takes over the buffer of another raster, which becomes empty.
+/// </summary>
+Raster::Raster(Raster && other) noexcept : _Data(other._Data), _Capacity(other._Capacity), _Width(other._Width), _Height(other._Height), _Stride(other._Stride), _PixelFormat(other._PixelFormat), _BitsPerPixel(other._BitsPerPixel)
+{
+    other._Data = nullptr;
+    other._Capacity = 0;
+    other._Width = other._Height = other._Stride = other._BitsPerPixel = 0;
+}
+
+/// <summary>
+/// Releases the buffer of this raster and takes over the buffer of another raster, which becomes empty.
+/// </summary>
+Raster & Raster::operator=(Raster && other) noexcept
+{
+    if (this == &other)
+        return *this;
+
+    Reset();
+
+    _Data = other._Data;
+    _Capacity = other._Capacity;
+    _Width = other._Width;
+    _Height = other._Height;
+    _Stride = other._Stride;
+    _PixelFormat = other._PixelFormat;
+    _BitsPerPixel = other._BitsPerPixel;
+
+    other._Data = nullptr;
+    other._Capacity = 0;
+    other._Width = other._Height = other._Stride = other._BitsPerPixel = 0;
+
+    return *this;
+}
+
+/// <summary>
+/// Initializes this instance with a zero-filled (transparent) buffer of the specified size and format. The current buffer is reused if it has the right size class.
+/// </summary>
+HRESULT Raster::Initialize(UINT width, UINT height, PixelFormat pixelFormat) noexcept
+{
+    const UINT BitsPerPixel = GetBitsPerPixel(pixelFormat);
+
+    if ((width == 0) || (height == 0) || (BitsPerPixel == 0))
+        return E_INVALIDARG;
+
+    // The stride has to fit in 32 bits. The size of the buffer does not.
+    if ((uint64_t) width * BitsPerPixel > (uint64_t) std::numeric_limits<UINT>::max() - 8 * RasterAllocator::Alignment)
+        return E_INVALIDARG;
+
+    const UINT Stride = GetStride(width, BitsPerPixel);
+    const size_t Size = (size_t) Stride * height;
+
+    if ((_Data == nullptr) || (RasterAllocator::GetSizeClass(Size) != _Capacity))
+    {
+        Reset();
+
+        _Data = RasterAllocator::GetDefault().Allocate(Size, _Capacity);
+
+        if (_Data == nullptr)
+        {
+            _Capacity = 0;
+
+            return E_OUTOFMEMORY;
+        }
+    }
+
+    ::memset(_Data, 0, Size);
+
+    _Width = width;
+    _Height = height;
+    _Stride = Stride;
+    _PixelFormat = pixelFormat;
+    _BitsPerPixel = BitsPerPixel;
+
+    return S_OK;
+}
+
+/// <summary>
+/// Initializes this instance with a copy of the pixels of another raster.
+/// </summary>
+HRESULT Raster::CopyFrom(const Raster & other) noexcept
+{
+    if (this == &other)
+        return S_OK;
+
+    if (other.IsEmpty())
+    {
+        Reset();
+
+        return S_OK;
+    }
+
+    HRESULT hr = Initialize(other._Width, other._Height, other._PixelFormat);
+
+    if (SUCCEEDED(hr))
+        ::memcpy(_Data, other._Data, other.Size());
+
+    return hr;
+}
+
+/// <summary>
+/// Returns the buffer to the allocator. The raster becomes empty.
+/// </summary>
+void Raster::Reset() noexcept
+{
+    RasterAllocator::GetDefault().Release(_Data, _Capacity);
+
+    _Data = nullptr;
+    _Capacity = 0;
+    _Width = _Height = _Stride = _BitsPerPixel = 0;
+}
+
+/// <summary>
+/// Sets all pixels to zero (transparent black).
+/// </summary>
+void Raster::Clear() noexcept
+{
+    if (_Data != nullptr)
+        ::memset(_Data, 0, Size());
+}
+
+/// <summary>
+/// Changes the format of the pixels without touching the buffer, e.g. after an in-place conversion. Both formats must have the same pixel size.
+/// </summary>
+HRESULT Raster::SetFormat(PixelFormat pixelFormat) noexcept
+{
+    if (GetBitsPerPixel(pixelFormat) != _BitsPerPixel)
+        return E_INVALIDARG;
+
+    _PixelFormat = pixelFormat;
+
+    return S_OK;
+}
+
+/// <summary>
+/// Gets the stride of a raster: the size of a row rounded up to a multiple of 64 bytes so every row starts on a cache line and rows never share one,
+/// which also keeps the rows DWORD-aligned like WIC and GDI bitmaps.
+/// </summary>
+UINT Raster::GetStride(UINT width, UINT bitsPerPixel) noexcept
+{
+    const UINT RowSize = (width * bitsPerPixel + 7) / 8;
+
+    return (RowSize + (UINT) RasterAllocator::Alignment - 1) & ~((UINT) RasterAllocator::Alignment - 1);
+}
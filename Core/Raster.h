@@ -0,0 +1,121 @@
+
+/** $VER: Raster.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+#include "PixelFormat.h"
+#include "RasterAllocator.h"
+#include "Types.h"
+
+/// <summary>
+/// Represents a rectangle of pixels in a raster without owning them. A view remains valid as long as the raster is not initialized again, moved or destroyed.
+/// </summary>
+template<typename T>
+class BasicRasterView
+{
+public:
+    BasicRasterView() noexcept : _Data(), _Width(), _Height(), _Stride(), _PixelFormat() { }
+    BasicRasterView(T * data, UINT width, UINT height, UINT stride, PixelFormat pixelFormat) noexcept : _Data(data), _Width(width), _Height(height), _Stride(stride), _PixelFormat(pixelFormat) { }
+
+    /// <summary>
+    /// Converts a view of modifiable pixels into a view of constant pixels.
+    /// </summary>
+    operator BasicRasterView<const T>() const noexcept { return { _Data, _Width, _Height, _Stride, _PixelFormat }; }
+
+    UINT Width() const noexcept { return _Width; }
+    UINT Height() const noexcept { return _Height; }
+
+    T * Row(UINT y) const noexcept { return _Data + (size_t) y * _Stride; }
+
+    UINT Stride() const noexcept { return _Stride; }
+    PixelFormat Format() const noexcept { return _PixelFormat; }
+    UINT BitsPerPixel() const noexcept { return GetBitsPerPixel(_PixelFormat); }
+
+    bool IsEmpty() const noexcept { return (_Width == 0) || (_Height == 0); }
+
+    /// <summary>
+    /// Gets a view of a rectangle of this view, clipped to this view.
+    /// </summary>
+    BasicRasterView GetView(const RectI & rect) const noexcept
+    {
+        const int Left   = (std::max)(rect.left, 0);
+        const int Top    = (std::max)(rect.top, 0);
+        const int Right  = (std::min)(rect.right,  (int) _Width);
+        const int Bottom = (std::min)(rect.bottom, (int) _Height);
+
+        if ((Left >= Right) || (Top >= Bottom))
+            return { };
+
+        return { Row((UINT) Top) + (size_t) Left * GetBitsPerPixel(_PixelFormat) / 8, (UINT) (Right - Left), (UINT) (Bottom - Top), _Stride, _PixelFormat };
+    }
+
+private:
+    T * _Data;
+    UINT _Width;
+    UINT _Height;
+    UINT _Stride;
+    PixelFormat _PixelFormat;
+};
+
+typedef BasicRasterView<BYTE> RasterView;
+typedef BasicRasterView<const BYTE> ConstRasterView;
+
+/// <summary>
+/// Represents a bitmap image in system memory. The pixels are stored in a 64-byte aligned buffer from the raster allocator; every row starts
+/// on a cache line. Rasters can be moved but not copied: copies are explicit, see CopyFrom. The buffer returns to the pool of the allocator
+/// when the raster is destroyed or initialized with a size of a different size class.
+/// </summary>
+class Raster
+{
+public:
+    Raster() noexcept : _Data(), _Capacity(), _Width(), _Height(), _Stride(), _PixelFormat(), _BitsPerPixel() { }
+    ~Raster() noexcept { Reset(); }
+
+    Raster(const Raster &) = delete;
+    Raster & operator=(const Raster &) = delete;
+
+    Raster(Raster && other) noexcept;
+    Raster & operator=(Raster && other) noexcept;
+
+    HRESULT Initialize(UINT width, UINT height, PixelFormat pixelFormat = PixelFormat::PBGRA32) noexcept;
+    HRESULT CopyFrom(const Raster & other) noexcept;
+    void Reset() noexcept;
+    void Clear() noexcept;
+    HRESULT SetFormat(PixelFormat pixelFormat) noexcept;
+
+    UINT Width() const noexcept { return _Width; }
+    UINT Height() const noexcept { return _Height; }
+
+    BYTE * Data() noexcept { return _Data; }
+    const BYTE * Data() const noexcept { return _Data; }
+    size_t Size() const noexcept { return (size_t) _Stride * _Height; }
+
+    BYTE * Row(UINT y) noexcept { return _Data + (size_t) y * _Stride; }
+    const BYTE * Row(UINT y) const noexcept { return _Data + (size_t) y * _Stride; }
+
+    UINT Stride() const noexcept { return _Stride; }
+    PixelFormat Format() const noexcept { return _PixelFormat; }
+    UINT BitsPerPixel() const noexcept { return _BitsPerPixel; }
+
+    bool IsEmpty() const noexcept { return _Data == nullptr; }
+
+    RasterView GetView() noexcept { return { _Data, _Width, _Height, _Stride, _PixelFormat }; }
+    ConstRasterView GetView() const noexcept { return { _Data, _Width, _Height, _Stride, _PixelFormat }; }
+
+    RasterView GetView(const RectI & rect) noexcept { return GetView().GetView(rect); }
+    ConstRasterView GetView(const RectI & rect) const noexcept { return GetView().GetView(rect); }
+
+    static UINT GetStride(UINT width, UINT bitsPerPixel) noexcept;
+
+private:
+    BYTE * _Data;
+    size_t _Capacity;           // Size of the buffer, a size class of the allocator
+
+    UINT _Width;
+    UINT _Height;
+
+    UINT _Stride;
+    PixelFormat _PixelFormat;
+    UINT _BitsPerPixel;
+};
@@ -0,0 +1,206 @@
+
+/** $VER: RasterAllocator.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "RasterAllocator.h"
+
+#include <new>
+
+/// <summary>
+/// Frees the pooled buffers. Buffers that are still in use must not be released after this.
+/// </summary>
+RasterAllocator::~RasterAllocator() noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    TrimTo(0);
+}
+
+/// <summary>
+/// Allocates a 64-byte aligned buffer of at least the specified size. Returns the actual size of the buffer, which must be passed to Release.
+/// The contents of the buffer are undefined.
+/// </summary>
+BYTE * RasterAllocator::Allocate(size_t size, size_t & capacity) noexcept
+{
+    if (size == 0)
+        return nullptr;
+
+    capacity = GetSizeClass(size);
+
+    {
+        std::lock_guard<std::mutex> Lock(_Mutex);
+
+        ++_Allocations;
+
+        for (size_t i = 0; i < _Pool.size(); ++i)
+        {
+            if (_Pool[i].Capacity != capacity)
+                continue;
+
+            BYTE * Data = _Pool[i].Data;
+
+            _Pool[i] = _Pool.back();
+            _Pool.pop_back();
+
+            _BytesPooled -= capacity;
+            _BytesLive += capacity;
+            ++_PoolHits;
+
+            return Data;
+        }
+    }
+
+    BYTE * Data = (BYTE *) ::operator new(capacity, std::align_val_t(Alignment), std::nothrow);
+
+    if (Data == nullptr)
+    {
+        // Give the heap the pooled buffers and try again.
+        {
+            std::lock_guard<std::mutex> Lock(_Mutex);
+
+            TrimTo(0);
+        }
+
+        Data = (BYTE *) ::operator new(capacity, std::align_val_t(Alignment), std::nothrow);
+
+        if (Data == nullptr)
+            return nullptr;
+    }
+
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    _BytesLive += capacity;
+
+    return Data;
+}
+
+/// <summary>
+/// Returns a buffer to the pool. The oldest pooled buffers are freed when the pool exceeds its budget.
+/// </summary>
+void RasterAllocator::Release(BYTE * data, size_t capacity) noexcept
+{
+    if (data == nullptr)
+        return;
+
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    _BytesLive -= capacity;
+
+    if (capacity <= _PoolBudget)
+    {
+        try
+        {
+            _Pool.push_back({ data, capacity, ++_Clock });
+
+            _BytesPooled += capacity;
+
+            TrimTo(_PoolBudget);
+
+            return;
+        }
+        catch (const std::bad_alloc &)
+        {
+        }
+    }
+
+    ::operator delete(data, std::align_val_t(Alignment));
+}
+
+/// <summary>
+/// Frees all pooled buffers.
+/// </summary>
+void RasterAllocator::Trim() noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    TrimTo(0);
+}
+
+/// <summary>
+/// Sets the maximum number of bytes kept in the pool.
+/// </summary>
+void RasterAllocator::SetPoolBudget(size_t poolBudget) noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    _PoolBudget = poolBudget;
+
+    TrimTo(poolBudget);
+}
+
+/// <summary>
+/// Marks the end of a frame: the allocations since the previous mark become the allocations of the last frame.
+/// </summary>
+void RasterAllocator::MarkFrame() noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    _FrameAllocations = _Allocations - _FrameStart;
+    _FrameStart = _Allocations;
+}
+
+/// <summary>
+/// Gets the counters of the allocator.
+/// </summary>
+RasterAllocatorStatistics RasterAllocator::GetStatistics() const noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    return { _BytesLive, _BytesPooled, _PoolBudget, _Allocations, _PoolHits, _FrameAllocations };
+}
+
+/// <summary>
+/// Gets the size class of an allocation: a multiple of 4 kB up to 64 kB, above that 8 classes per power of two, which wastes at most 12.5%.
+/// Rasters of nearby sizes, e.g. during a resize, share a class and reuse each other's buffers.
+/// </summary>
+size_t RasterAllocator::GetSizeClass(size_t size) noexcept
+{
+    const size_t SmallStep = 4096;
+
+    if (size <= 16 * SmallStep)
+        return (size + SmallStep - 1) & ~(SmallStep - 1);
+
+    size_t PowerOfTwo = 16 * SmallStep;
+
+    while (PowerOfTwo * 2 < size)
+        PowerOfTwo *= 2;
+
+    const size_t Step = PowerOfTwo / 8;
+
+    return (size + Step - 1) / Step * Step;
+}
+
+/// <summary>
+/// Gets the allocator shared by all rasters. It is never destroyed because rasters with static storage duration may outlive it otherwise.
+/// </summary>
+RasterAllocator & RasterAllocator::GetDefault() noexcept
+{
+    static RasterAllocator * Default = new RasterAllocator();
+
+    return *Default;
+}
+
+/// <summary>
+/// Frees the least recently released buffers until the pool holds no more than the specified number of bytes. The caller holds the lock.
+/// </summary>
+void RasterAllocator::TrimTo(size_t budget) noexcept
+{
+    while (_BytesPooled > budget)
+    {
+        size_t Oldest = 0;
+
+        for (size_t i = 1; i < _Pool.size(); ++i)
+        {
+            if (_Pool[i].Released < _Pool[Oldest].Released)
+                Oldest = i;
+        }
+
+        ::operator delete(_Pool[Oldest].Data, std::align_val_t(Alignment));
+
+        _BytesPooled -= _Pool[Oldest].Capacity;
+
+        _Pool[Oldest] = _Pool.back();
+        _Pool.pop_back();
+    }
+}
@@ -0,0 +1,84 @@
+
+/** $VER: RasterAllocator.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+
+#include <mutex>
+#include <vector>
+
+/// <summary>
+/// Contains the counters of a raster allocator.
+/// </summary>
+struct RasterAllocatorStatistics
+{
+    size_t BytesLive;           // Bytes in buffers that are in use
+    size_t BytesPooled;         // Bytes in released buffers kept for reuse
+    size_t PoolBudget;          // Maximum number of pooled bytes
+
+    uint64_t Allocations;       // Buffers handed out
+    uint64_t PoolHits;          // Buffers handed out from the pool instead of the heap
+    uint64_t FrameAllocations;  // Buffers handed out during the last completed frame
+};
+
+/// <summary>
+/// Allocates the pixel buffers of rasters: 64-byte aligned blocks, rounded up to a size class. Released buffers are kept in a pool, per size class,
+/// and handed out again instead of being returned to the heap, up to a budget. The least recently released buffers are freed first.
+/// Thread-safe: images are decoded and scaled on worker threads.
+/// </summary>
+class RasterAllocator
+{
+public:
+    static const size_t Alignment = 64;
+    static const size_t DefaultPoolBudget = 128 * 1024 * 1024;
+
+    RasterAllocator(size_t poolBudget = DefaultPoolBudget) noexcept : _PoolBudget(poolBudget), _BytesLive(), _BytesPooled(), _Allocations(), _PoolHits(), _FrameStart(), _FrameAllocations(), _Clock() { }
+    ~RasterAllocator() noexcept;
+
+    RasterAllocator(const RasterAllocator &) = delete;
+    RasterAllocator & operator=(const RasterAllocator &) = delete;
+
+    BYTE * Allocate(size_t size, size_t & capacity) noexcept;
+    void Release(BYTE * data, size_t capacity) noexcept;
+
+    void Trim() noexcept;
+    void SetPoolBudget(size_t poolBudget) noexcept;
+
+    void MarkFrame() noexcept;
+
+    RasterAllocatorStatistics GetStatistics() const noexcept;
+
+    static size_t GetSizeClass(size_t size) noexcept;
+
+    static RasterAllocator & GetDefault() noexcept;
+
+private:
+    /// <summary>
+    /// Represents a released buffer.
+    /// </summary>
+    struct Block
+    {
+        BYTE * Data;
+        size_t Capacity;
+        uint64_t Released;      // Value of the clock when the buffer was released
+    };
+
+    void TrimTo(size_t budget) noexcept;
+
+private:
+    mutable std::mutex _Mutex;
+
+    std::vector<Block> _Pool;   // Unordered. Pools hold a few dozen buffers at most so a linear search is fine.
+
+    size_t _PoolBudget;
+    size_t _BytesLive;
+    size_t _BytesPooled;
+
+    uint64_t _Allocations;
+    uint64_t _PoolHits;
+    uint64_t _FrameStart;       // Allocations at the start of the current frame
+    uint64_t _FrameAllocations;
+
+    uint64_t _Clock;
+};
@@ -0,0 +1,393 @@
+
+/** $VER: Region.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "Region.h"
+
+#include <new>
+
+/*
+    The rectangles never overlap, so the area of a region is the sum of the areas of its rectangles and every pixel is drawn at most once
+    when a renderer visits the rectangles one by one. Regions are expected to contain a handful of rectangles; all operations are quadratic.
+    If memory runs out the region grows to its bounding box, which can only overestimate the area.
+*/
+
+// Merging 2 rectangles into their bounding box is considered free if it adds less than this number of pixels. The overhead of an extra rectangle,
+// i.e. an extra clip and draw pass or an extra dirty rectangle, is about the cost of filling a 64 x 64 pixel area.
+static const uint64_t MergeThreshold = 64 * 64;
+
+/// <summary>
+/// Gets the smallest rectangle that contains all rectangles of the region.
+/// </summary>
+RectI Region::GetBounds() const noexcept
+{
+    if (_Rects.empty())
+        return { };
+
+    RectI Bounds = _Rects[0];
+
+    for (const RectI & r : _Rects)
+        Bounds = GetBounds(Bounds, r);
+
+    return Bounds;
+}
+
+/// <summary>
+/// Gets the number of pixels in the region.
+/// </summary>
+uint64_t Region::GetArea() const noexcept
+{
+    uint64_t Area = 0;
+
+    for (const RectI & r : _Rects)
+        Area += GetArea(r);
+
+    return Area;
+}
+
+/// <summary>
+/// Returns true if the region contains every pixel of the rectangle.
+/// </summary>
+bool Region::Contains(const RectI & rect) const noexcept
+{
+    if (rect.IsEmpty())
+        return true;
+
+    try
+    {
+        std::vector<RectI> Pieces(1, rect);
+        std::vector<RectI> Remainder;
+
+        for (const RectI & r : _Rects)
+        {
+            Remainder.clear();
+
+            for (const RectI & Piece : Pieces)
+                Subtract(Piece, r, Remainder);
+
+            Pieces.swap(Remainder);
+
+            if (Pieces.empty())
+                return true;
+        }
+    }
+    catch (const std::bad_alloc &)
+    {
+    }
+
+    return false;
+}
+
+/// <summary>
+/// Returns true if the region and the rectangle have at least one pixel in common.
+/// </summary>
+bool Region::Intersects(const RectI & rect) const noexcept
+{
+    for (const RectI & r : _Rects)
+    {
+        if (!Intersect(r, rect).IsEmpty())
+            return true;
+    }
+
+    return false;
+}
+
+/// <summary>
+/// Adds the pixels of a rectangle to the region.
+/// </summary>
+void Region::Union(const RectI & rect) noexcept
+{
+    if (rect.IsEmpty())
+        return;
+
+    try
+    {
+        // Only add the parts of the rectangle that are not in the region yet.
+        std::vector<RectI> Pieces(1, rect);
+        std::vector<RectI> Remainder;
+
+        for (const RectI & r : _Rects)
+        {
+            Remainder.clear();
+
+            for (const RectI & Piece : Pieces)
+                Subtract(Piece, r, Remainder);
+
+            Pieces.swap(Remainder);
+
+            if (Pieces.empty())
+                return;
+        }
+
+        _Rects.insert(_Rects.end(), Pieces.begin(), Pieces.end());
+    }
+    catch (const std::bad_alloc &)
+    {
+        const RectI Bounds = _Rects.empty() ? rect : GetBounds(GetBounds(), rect);
+
+        _Rects.clear();
+        _Rects.shrink_to_fit();
+
+        try
+        {
+            _Rects.push_back(Bounds);
+        }
+        catch (const std::bad_alloc &)
+        {
+        }
+
+        return;
+    }
+
+    MergeAdjacent();
+}
+
+/// <summary>
+/// Adds the pixels of another region to the region.
+/// </summary>
+void Region::Union(const Region & region) noexcept
+{
+    if (&region == this)
+        return;
+
+    for (const RectI & r : region._Rects)
+        Union(r);
+}
+
+/// <summary>
+/// Removes the pixels that are not in the rectangle from the region.
+/// </summary>
+void Region::Intersect(const RectI & rect) noexcept
+{
+    size_t j = 0;
+
+    for (size_t i = 0; i < _Rects.size(); ++i)
+    {
+        const RectI r = Intersect(_Rects[i], rect);
+
+        if (!r.IsEmpty())
+            _Rects[j++] = r;
+    }
+
+    _Rects.resize(j);
+}
+
+/// <summary>
+/// Removes the pixels that are not in another region from the region.
+/// </summary>
+void Region::Intersect(const Region & region) noexcept
+{
+    if (&region == this)
+        return;
+
+    try
+    {
+        std::vector<RectI> Rects;
+
+        // The rectangles of both regions are disjoint so their pairwise intersections are disjoint too.
+        for (const RectI & a : _Rects)
+        {
+            for (const RectI & b : region._Rects)
+            {
+                const RectI r = Intersect(a, b);
+
+                if (!r.IsEmpty())
+                    Rects.push_back(r);
+            }
+        }
+
+        _Rects.swap(Rects);
+    }
+    catch (const std::bad_alloc &)
+    {
+        Intersect(region.GetBounds());
+
+        return;
+    }
+
+    MergeAdjacent();
+}
+
+/// <summary>
+/// Removes the pixels of a rectangle from the region.
+/// </summary>
+void Region::Subtract(const RectI & rect) noexcept
+{
+    if (rect.IsEmpty() || !Intersects(rect))
+        return;
+
+    try
+    {
+        std::vector<RectI> Rects;
+
+        for (const RectI & r : _Rects)
+            Subtract(r, rect, Rects);
+
+        _Rects.swap(Rects);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return; // Keeping the pixels overestimates the region.
+    }
+
+    MergeAdjacent();
+}
+
+/// <summary>
+/// Removes the pixels of another region from the region.
+/// </summary>
+void Region::Subtract(const Region & region) noexcept
+{
+    if (&region == this)
+    {
+        Clear();
+
+        return;
+    }
+
+    for (const RectI & r : region._Rects)
+        Subtract(r);
+}
+
+/// <summary>
+/// Reduces the number of rectangles, at the expense of adding pixels to the region. Merges adjacent rectangles, merges pairs of rectangles whose bounding box
+/// adds only a few pixels, and then keeps merging the pair that adds the fewest pixels until the region has at most the specified number of rectangles.
+/// </summary>
+void Region::Simplify(UINT maxRects) noexcept
+{
+    maxRects = (std::max)(maxRects, 1u);
+
+    MergeAdjacent();
+
+    // Give up on finding good pairs after a number of rounds; merging can split other rectangles.
+    for (size_t Round = 0; (_Rects.size() > 1) && (Round < _Rects.size() * 4); ++Round)
+    {
+        size_t Best1 = 0, Best2 = 0;
+        uint64_t BestWaste = ~0ull;
+
+        for (size_t i = 0; i < _Rects.size(); ++i)
+        {
+            for (size_t j = i + 1; j < _Rects.size(); ++j)
+            {
+                const uint64_t Area = GetArea(GetBounds(_Rects[i], _Rects[j]));
+                const uint64_t Waste = Area - GetArea(_Rects[i]) - GetArea(_Rects[j]);
+
+                if (Waste < BestWaste)
+                {
+                    Best1 = i, Best2 = j;
+                    BestWaste = Waste;
+                }
+            }
+        }
+
+        if ((BestWaste >= MergeThreshold) && (_Rects.size() <= maxRects))
+            return;
+
+        const RectI Bounds = GetBounds(_Rects[Best1], _Rects[Best2]);
+
+        _Rects.erase(_Rects.begin() + (ptrdiff_t) Best2);
+        _Rects.erase(_Rects.begin() + (ptrdiff_t) Best1);
+
+        // Rectangles inside the bounding box are absorbed; the bounding box gets split around the ones that stick out.
+        std::erase_if(_Rects, [&Bounds](const RectI & r) { return (r.left >= Bounds.left) && (r.top >= Bounds.top) && (r.right <= Bounds.right) && (r.bottom <= Bounds.bottom); });
+
+        Union(Bounds);
+    }
+
+    if (_Rects.size() > maxRects)
+    {
+        const RectI Bounds = GetBounds();
+
+        _Rects.resize(1);
+        _Rects[0] = Bounds;
+    }
+}
+
+/// <summary>
+/// Gets the intersection of 2 rectangles. The result is empty if they do not intersect.
+/// </summary>
+RectI Region::Intersect(const RectI & a, const RectI & b) noexcept
+{
+    return { (std::max)(a.left, b.left), (std::max)(a.top, b.top), (std::min)(a.right, b.right), (std::min)(a.bottom, b.bottom) };
+}
+
+/// <summary>
+/// Gets the smallest rectangle that contains 2 rectangles.
+/// </summary>
+RectI Region::GetBounds(const RectI & a, const RectI & b) noexcept
+{
+    if (a.IsEmpty())
+        return b;
+
+    if (b.IsEmpty())
+        return a;
+
+    return { (std::min)(a.left, b.left), (std::min)(a.top, b.top), (std::max)(a.right, b.right), (std::max)(a.bottom, b.bottom) };
+}
+
+/// <summary>
+/// Adds the parts of a rectangle that are outside a hole, at most 4 bands: above, below, left and right of the hole.
+/// </summary>
+void Region::Subtract(const RectI & rect, const RectI & hole, std::vector<RectI> & pieces)
+{
+    const RectI Overlap = Intersect(rect, hole);
+
+    if (Overlap.IsEmpty())
+    {
+        pieces.push_back(rect);
+
+        return;
+    }
+
+    if (rect.top < Overlap.top)
+        pieces.push_back({ rect.left, rect.top, rect.right, Overlap.top });
+
+    if (Overlap.bottom < rect.bottom)
+        pieces.push_back({ rect.left, Overlap.bottom, rect.right, rect.bottom });
+
+    if (rect.left < Overlap.left)
+        pieces.push_back({ rect.left, Overlap.top, Overlap.left, Overlap.bottom });
+
+    if (Overlap.right < rect.right)
+        pieces.push_back({ Overlap.right, Overlap.top, rect.right, Overlap.bottom });
+}
+
+/// <summary>
+/// Merges pairs of rectangles that share a complete edge. Returns true if any rectangles were merged.
+/// </summary>
+bool Region::MergeAdjacent() noexcept
+{
+    bool IsMerged = false;
+
+    for (size_t i = 0; i < _Rects.size(); ++i)
+    {
+        for (size_t j = 0; j < _Rects.size(); ++j)
+        {
+            if (j == i)
+                continue;
+
+            RectI & a = _Rects[i];
+            const RectI & b = _Rects[j];
+
+            const bool Horizontal = (a.top == b.top) && (a.bottom == b.bottom) && ((a.right == b.left) || (b.right == a.left));
+            const bool Vertical   = (a.left == b.left) && (a.right == b.right) && ((a.bottom == b.top) || (b.bottom == a.top));
+
+            if (Horizontal || Vertical)
+            {
+                a = GetBounds(a, b);
+
+                _Rects.erase(_Rects.begin() + (ptrdiff_t) j);
+
+                IsMerged = true;
+
+                if (j < i)
+                    --i;
+
+                j = (size_t) -1; // The grown rectangle may now be adjacent to rectangles that were checked before, including the ones before it.
+            }
+        }
+    }
+
+    return IsMerged;
+}
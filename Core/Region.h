@@ -0,0 +1,51 @@
+
+/** $VER: Region.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+#include "Types.h"
+
+#include <vector>
+
+/// <summary>
+/// Represents an area of pixels as a list of non-overlapping rectangles.
+/// </summary>
+class Region
+{
+public:
+    Region() { }
+    Region(const RectI & rect) noexcept { Union(rect); }
+
+    bool IsEmpty() const noexcept { return _Rects.empty(); }
+    const std::vector<RectI> & GetRects() const noexcept { return _Rects; }
+
+    RectI GetBounds() const noexcept;
+    uint64_t GetArea() const noexcept;
+
+    bool Contains(const RectI & rect) const noexcept;
+    bool Intersects(const RectI & rect) const noexcept;
+
+    void Clear() noexcept { _Rects.clear(); }
+
+    void Union(const RectI & rect) noexcept;
+    void Union(const Region & region) noexcept;
+    void Intersect(const RectI & rect) noexcept;
+    void Intersect(const Region & region) noexcept;
+    void Subtract(const RectI & rect) noexcept;
+    void Subtract(const Region & region) noexcept;
+
+    void Simplify(UINT maxRects) noexcept;
+
+    static RectI Intersect(const RectI & a, const RectI & b) noexcept;
+    static RectI GetBounds(const RectI & a, const RectI & b) noexcept;
+    static uint64_t GetArea(const RectI & rect) noexcept { return rect.IsEmpty() ? 0 : (uint64_t) rect.Width() * (uint64_t) rect.Height(); }
+
+private:
+    static void Subtract(const RectI & rect, const RectI & hole, std::vector<RectI> & pieces);
+
+    bool MergeAdjacent() noexcept;
+
+private:
+    std::vector<RectI> _Rects;
+};
@@ -0,0 +1,113 @@
+
+/** $VER: ResizeTracker.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "ResizeTracker.h"
+
+/// <summary>
+/// Initializes a new instance. The frame interval defaults to 60 Hz.
+/// </summary>
+ResizeTracker::ResizeTracker() noexcept : _IsMoving(), _IsLive(), _Interval(1. / 60.), _Frames(), _Missed(), _Total(), _Maximum()
+{
+}
+
+/// <summary>
+/// Signals the start of a move/size loop (WM_ENTERSIZEMOVE). The resize only becomes live when the size actually changes.
+/// </summary>
+void ResizeTracker::BeginMove() noexcept
+{
+    _IsMoving = true;
+}
+
+/// <summary>
+/// Signals the end of a move/size loop (WM_EXITSIZEMOVE). Returns true if the size changed during the loop and the high-quality pass is due.
+/// </summary>
+bool ResizeTracker::EndMove() noexcept
+{
+    _IsMoving = false;
+
+    return Stop();
+}
+
+/// <summary>
+/// Signals a size change. Returns true if the resize is live and the frame should use the preview; false if this is a single resize that can be rendered at full quality right away.
+/// Outside a move/size loop a resize becomes live when the size changes again within the settle delay, e.g. while a window manager or a touch gesture resizes the window.
+/// </summary>
+bool ResizeTracker::Resize() noexcept
+{
+    const Clock::time_point Now = Clock::now();
+
+    const bool IsLive = _IsMoving || _IsLive || ((Now - _LastResize) < std::chrono::milliseconds(SettleDelay));
+
+    _LastResize = Now;
+
+    if (IsLive && !_IsLive)
+        Start();
+
+    return IsLive;
+}
+
+/// <summary>
+/// Signals that the settle delay expired after the last size change. Returns true if a live resize outside a move/size loop ended and the high-quality pass is due.
+/// </summary>
+bool ResizeTracker::Settle() noexcept
+{
+    if (_IsMoving)
+        return false;
+
+    if ((Clock::now() - _LastResize) < std::chrono::milliseconds(SettleDelay))
+        return false;
+
+    return Stop();
+}
+
+/// <summary>
+/// Records the time it took to render a frame. Ignored unless the resize is live.
+/// </summary>
+void ResizeTracker::AddFrame(double seconds) noexcept
+{
+    if (!_IsLive)
+        return;
+
+    ++_Frames;
+
+    if (seconds > _Interval)
+        ++_Missed;
+
+    _Total += seconds;
+    _Maximum = (std::max)(_Maximum, seconds);
+}
+
+/// <summary>
+/// Gets the frame times of the live resize in progress or, if there is none, of the last one.
+/// </summary>
+ResizeStatistics ResizeTracker::GetStatistics() const noexcept
+{
+    return { _Frames, _Missed, (_Frames != 0) ? _Total / (double) _Frames : 0., _Maximum, _Interval };
+}
+
+/// <summary>
+/// Starts a live resize.
+/// </summary>
+void ResizeTracker::Start() noexcept
+{
+    _IsLive = true;
+
+    _Frames = 0;
+    _Missed = 0;
+    _Total = 0.;
+    _Maximum = 0.;
+}
+
+/// <summary>
+/// Stops the live resize. Returns true if one was in progress.
+/// </summary>
+bool ResizeTracker::Stop() noexcept
+{
+    const bool WasLive = _IsLive;
+
+    _IsLive = false;
+
+    return WasLive;
+}
@@ -0,0 +1,65 @@
+
+/** $VER: ResizeTracker.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+
+#include <chrono>
+
+/// <summary>
+/// Contains the frame times of the last live resize.
+/// </summary>
+struct ResizeStatistics
+{
+    UINT Frames;            // Frames rendered while resizing
+    UINT Missed;            // Frames that took longer than the frame interval
+    double Average;         // Average frame time, in seconds
+    double Maximum;         // Longest frame time, in seconds
+    double Interval;        // Frame interval (vsync), in seconds
+};
+
+/// <summary>
+/// Detects live resizing, either from an explicit move/size loop or from the rate of the size changes, so that the frames in between can use a cheap preview
+/// and a single high-quality pass can be scheduled when the size settles. Records the frame times of the live resize.
+/// </summary>
+class ResizeTracker
+{
+public:
+    static constexpr UINT SettleDelay = 150; // Milliseconds without a size change after which a resize outside a move/size loop has settled.
+
+    ResizeTracker() noexcept;
+
+    void BeginMove() noexcept;
+    bool EndMove() noexcept;
+
+    bool Resize() noexcept;
+    bool Settle() noexcept;
+
+    bool IsLive() const noexcept { return _IsLive; }
+    bool IsMoving() const noexcept { return _IsMoving; }
+
+    void AddFrame(double seconds) noexcept;
+    void SetFrameInterval(double seconds) noexcept { _Interval = seconds; }
+
+    ResizeStatistics GetStatistics() const noexcept;
+
+private:
+    void Start() noexcept;
+    bool Stop() noexcept;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    bool _IsMoving;
+    bool _IsLive;
+
+    Clock::time_point _LastResize;
+
+    double _Interval;
+
+    UINT _Frames;
+    UINT _Missed;
+    double _Total;
+    double _Maximum;
+};
@@ -0,0 +1,1359 @@
+
+/** $VER: Scaler.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "Scaler.h"
+#include "Raster.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <new>
+
+/*
+    Both passes multiply 8-bit channels with 14-bit signed weights and accumulate in 32 bits. The results are rounded, clamped to
+    [0, 255] and, after the vertical pass, the color channels are clamped to alpha so that the ringing of the sharper filters never
+    produces invalid premultiplied pixels. The scalar and the SIMD kernels produce identical results.
+
+    The linear kernels do the same on 15-bit channels. The products of a pair of taps still fit the 32-bit sums of the multiply-adds,
+    and so do the sums of all taps, because the negative lobes of the filters are small.
+*/
+
+static std::atomic<InstructionSet> _InstructionSet(CPU::GetInstructionSet());
+
+static const int32_t Rounding = 1 << (ScaleWeights::Precision - 1);
+
+/// <summary>
+/// Gets the radius of a filter in source pixels, before scaling.
+/// </summary>
+static double GetRadius(ScaleFilter filter) noexcept
+{
+    switch (filter)
+    {
+        case ScaleFilter::Box:          return 0.5;
+        case ScaleFilter::CatmullRom:   return 2.0;
+        case ScaleFilter::Lanczos3:     return 3.0;
+        default:                        return 0.5;
+    }
+}
+
+/// <summary>
+/// Evaluates a filter at the specified distance from its center.
+/// </summary>
+static double Evaluate(ScaleFilter filter, double x) noexcept
+{
+    const double Pi = 3.14159265358979323846;
+
+    switch (filter)
+    {
+        case ScaleFilter::Box:
+            return ((x >= -0.5) && (x < 0.5)) ? 1.0 : 0.0;
+
+        case ScaleFilter::CatmullRom:
+        {
+            x = std::fabs(x);
+
+            if (x < 1.0)
+                return (1.5 * x - 2.5) * x * x + 1.0;
+
+            if (x < 2.0)
+                return ((-0.5 * x + 2.5) * x - 4.0) * x + 2.0;
+
+            return 0.0;
+        }
+
+        case ScaleFilter::Lanczos3:
+        {
+            if (x == 0.0)
+                return 1.0;
+
+            if ((x <= -3.0) || (x >= 3.0))
+                return 0.0;
+
+            return 3.0 * std::sin(Pi * x) * std::sin(Pi * x / 3.0) / (Pi * Pi * x * x);
+        }
+
+        default:
+            return 0.0;
+    }
+}
+
+/// <summary>
+/// Calculates the weights to resample srcSize pixels to dstSize pixels.
+/// </summary>
+HRESULT ScaleWeights::Initialize(UINT srcSize, UINT dstSize, ScaleFilter filter) noexcept
+{
+    if ((srcSize == 0) || (dstSize == 0))
+        return E_INVALIDARG;
+
+    const double Scale = (double) srcSize / (double) dstSize;
+    const double FilterScale = (std::max)(Scale, 1.0); // Widen the filter when downscaling to avoid aliasing.
+    const double Support = GetRadius(filter) * FilterScale;
+
+    // Use the same, SIMD friendly, number of taps for every destination pixel.
+    UINT Taps = (UINT) std::ceil(Support * 2.0) + 1;
+
+    Taps = (std::min)((Taps + 3) & ~3u, srcSize);
+
+    std::vector<double> Weights;
+
+    try
+    {
+        Weights.resize(Taps);
+
+        _Start.assign(dstSize, 0);
+        _Weights.assign((size_t) dstSize * Taps, 0);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    for (UINT i = 0; i < dstSize; ++i)
+    {
+        const double Center = ((double) i + 0.5) * Scale;
+
+        const int First = (std::max)((int) std::floor(Center - Support), 0);
+        const int Last  = (std::min)((int) std::ceil (Center + Support), (int) srcSize);
+
+        // Keep all taps inside the source.
+        const UINT Start = (UINT) (std::min)(First, (int) (srcSize - Taps));
+
+        double Sum = 0.;
+
+        for (UINT k = 0; k < Taps; ++k)
+        {
+            const int j = (int) (Start + k);
+
+            Weights[k] = ((j >= First) && (j < Last)) ? Evaluate(filter, ((double) j + 0.5 - Center) / FilterScale) : 0.;
+
+            Sum += Weights[k];
+        }
+
+        // Fall back to the nearest pixel if the filter misses every pixel.
+        if (Sum == 0.)
+        {
+            const UINT Nearest = (std::min)((UINT) Center, srcSize - 1);
+
+            Weights[Nearest - Start] = 1.;
+            Sum = 1.;
+        }
+
+        // Quantize and assign the rounding error to the largest weight so that the weights add up to exactly 1.
+        int16_t * w = _Weights.data() + (size_t) i * Taps;
+
+        int Total = 0;
+        UINT Largest = 0;
+
+        for (UINT k = 0; k < Taps; ++k)
+        {
+            w[k] = (int16_t) std::lround(Weights[k] / Sum * (double) (1 << Precision));
+
+            Total += w[k];
+
+            if (std::abs(w[k]) > std::abs(w[Largest]))
+                Largest = k;
+        }
+
+        w[Largest] = (int16_t) (w[Largest] + (1 << Precision) - Total);
+
+        _Start[i] = Start;
+    }
+
+    _Taps = Taps;
+
+    return S_OK;
+}
+
+/// <summary>
+/// Converts a 32-bit accumulator to an 8-bit channel.
+/// </summary>
+static inline uint32_t ToChannel(int32_t x) noexcept
+{
+    x = (x + Rounding) >> ScaleWeights::Precision;
+
+    return (uint32_t) (std::min)((std::max)(x, 0), 255);
+}
+
+/// <summary>
+/// Clamps the color channels of a premultiplied pixel to its alpha.
+/// </summary>
+static inline uint32_t ClampToAlpha(uint32_t p) noexcept
+{
+    const uint32_t a = p >> 24;
+
+    const uint32_t b = (std::min)( p        & 0xFF, a);
+    const uint32_t g = (std::min)((p >>  8) & 0xFF, a);
+    const uint32_t r = (std::min)((p >> 16) & 0xFF, a);
+
+    return b | (g << 8) | (r << 16) | (a << 24);
+}
+
+/// <summary>
+/// Converts a 32-bit accumulator to a 15-bit linear channel.
+/// </summary>
+static inline uint16_t ToLinearChannel(int32_t x) noexcept
+{
+    x = (x + Rounding) >> ScaleWeights::Precision;
+
+    return (uint16_t) (std::min)((std::max)(x, 0), (int32_t) LinearLight::One);
+}
+
+typedef void (* HorizontalFunction)(const BYTE * src, uint32_t * dst, UINT width, const ScaleWeights & weights);
+typedef void (* VerticalFunction)(const BYTE * const * rows, const int16_t * weights, UINT taps, uint32_t * dst, UINT x, UINT width);
+
+typedef void (* LinearHorizontalFunction)(const uint16_t * src, uint16_t * dst, UINT width, const ScaleWeights & weights);
+typedef void (* LinearVerticalFunction)(const BYTE * const * rows, const int16_t * weights, UINT taps, uint16_t * dst, UINT x, UINT width);
+
+/// <summary>
+/// Resamples a row horizontally.
+/// </summary>
+static void Horizontal_Scalar(const BYTE * src, uint32_t * dst, UINT width, const ScaleWeights & weights) noexcept
+{
+    const UINT Taps = weights.Taps();
+
+    for (UINT x = 0; x < width; ++x)
+    {
+        const BYTE * s = src + (size_t) weights.Start(x) * 4;
+        const int16_t * w = weights.Weights(x);
+
+        int32_t b = 0, g = 0, r = 0, a = 0;
+
+        for (UINT k = 0; k < Taps; ++k, s += 4)
+        {
+            b += s[0] * w[k];
+            g += s[1] * w[k];
+            r += s[2] * w[k];
+            a += s[3] * w[k];
+        }
+
+        dst[x] = ToChannel(b) | (ToChannel(g) << 8) | (ToChannel(r) << 16) | (ToChannel(a) << 24);
+    }
+}
+
+/// <summary>
+/// Resamples a set of rows vertically into one row, starting at pixel x.
+/// </summary>
+static void Vertical_Scalar(const BYTE * const * rows, const int16_t * weights, UINT taps, uint32_t * dst, UINT x, UINT width) noexcept
+{
+    for (; x < width; ++x)
+    {
+        int32_t b = 0, g = 0, r = 0, a = 0;
+
+        for (UINT k = 0; k < taps; ++k)
+        {
+            const BYTE * s = rows[k] + (size_t) x * 4;
+
+            b += s[0] * weights[k];
+            g += s[1] * weights[k];
+            r += s[2] * weights[k];
+            a += s[3] * weights[k];
+        }
+
+        dst[x] = ClampToAlpha(ToChannel(b) | (ToChannel(g) << 8) | (ToChannel(r) << 16) | (ToChannel(a) << 24));
+    }
+}
+
+/// <summary>
+/// Resamples a row of linear pixels horizontally.
+/// </summary>
+static void LinearHorizontal_Scalar(const uint16_t * src, uint16_t * dst, UINT width, const ScaleWeights & weights) noexcept
+{
+    const UINT Taps = weights.Taps();
+
+    for (UINT x = 0; x < width; ++x, dst += 4)
+    {
+        const uint16_t * s = src + (size_t) weights.Start(x) * 4;
+        const int16_t * w = weights.Weights(x);
+
+        int32_t b = 0, g = 0, r = 0, a = 0;
+
+        for (UINT k = 0; k < Taps; ++k, s += 4)
+        {
+            b += s[0] * w[k];
+            g += s[1] * w[k];
+            r += s[2] * w[k];
+            a += s[3] * w[k];
+        }
+
+        dst[0] = ToLinearChannel(b);
+        dst[1] = ToLinearChannel(g);
+        dst[2] = ToLinearChannel(r);
+        dst[3] = ToLinearChannel(a);
+    }
+}
+
+/// <summary>
+/// Resamples a set of rows of linear pixels vertically into one row, starting at pixel x.
+/// </summary>
+static void LinearVertical_Scalar(const BYTE * const * rows, const int16_t * weights, UINT taps, uint16_t * dst, UINT x, UINT width) noexcept
+{
+    for (; x < width; ++x)
+    {
+        int32_t b = 0, g = 0, r = 0, a = 0;
+
+        for (UINT k = 0; k < taps; ++k)
+        {
+            const uint16_t * s = (const uint16_t *) rows[k] + (size_t) x * 4;
+
+            b += s[0] * weights[k];
+            g += s[1] * weights[k];
+            r += s[2] * weights[k];
+            a += s[3] * weights[k];
+        }
+
+        uint16_t * d = dst + (size_t) x * 4;
+
+        d[3] = ToLinearChannel(a);
+        d[0] = (std::min)(ToLinearChannel(b), d[3]);
+        d[1] = (std::min)(ToLinearChannel(g), d[3]);
+        d[2] = (std::min)(ToLinearChannel(r), d[3]);
+    }
+}
+
+#ifdef CORE_X86
+
+/// <summary>
+/// Packs 2 weights into a 32-bit value for _mm_madd_epi16.
+/// </summary>
+static inline int WeightPair(int16_t w0, int16_t w1) noexcept
+{
+    return (int) (((uint32_t) (uint16_t) w1 << 16) | (uint16_t) w0);
+}
+
+/// <summary>
+/// Converts 4 32-bit accumulators to a pixel.
+/// </summary>
+static inline uint32_t ToPixel_SSE2(__m128i acc) noexcept
+{
+    acc = _mm_srai_epi32(_mm_add_epi32(acc, _mm_set1_epi32(Rounding)), ScaleWeights::Precision);
+
+    const __m128i p = _mm_packs_epi32(acc, acc);
+
+    return (uint32_t) _mm_cvtsi128_si32(_mm_packus_epi16(p, p));
+}
+
+/// <summary>
+/// Clamps the color channels of 4 premultiplied pixels to their alpha.
+/// </summary>
+static inline __m128i ClampToAlpha_SSE2(__m128i p) noexcept
+{
+    __m128i a = _mm_and_si128(p, _mm_set1_epi32((int) 0xFF000000));
+
+    a = _mm_or_si128(a, _mm_srli_epi32(a, 8));
+    a = _mm_or_si128(a, _mm_srli_epi32(a, 16));
+
+    return _mm_min_epu8(p, a);
+}
+
+/// <summary>
+/// Accumulates 2 pixels weighted by 2 taps: returns the weighted sum of each channel.
+/// </summary>
+static inline __m128i MultiplyAdd2_SSE2(const BYTE * s, int weightPair) noexcept
+{
+    __m128i p = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) s), _mm_setzero_si128()); // b0 g0 r0 a0 b1 g1 r1 a1
+
+    p = _mm_unpacklo_epi16(p, _mm_srli_si128(p, 8)); // b0 b1 g0 g1 r0 r1 a0 a1
+
+    return _mm_madd_epi16(p, _mm_set1_epi32(weightPair));
+}
+
+/// <summary>
+/// Accumulates 1 pixel weighted by 1 tap.
+/// </summary>
+static inline __m128i MultiplyAdd1_SSE2(const BYTE * s, int16_t weight) noexcept
+{
+    int32_t Pixel;
+
+    ::memcpy(&Pixel, s, 4);
+
+    const __m128i Zero = _mm_setzero_si128();
+
+    const __m128i p = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(Pixel), Zero), Zero); // b0 0 g0 0 r0 0 a0 0
+
+    return _mm_madd_epi16(p, _mm_set1_epi32((uint16_t) weight));
+}
+
+/// <summary>
+/// Resamples a row horizontally, 2 taps at a time.
+/// </summary>
+static void Horizontal_SSE2(const BYTE * src, uint32_t * dst, UINT width, const ScaleWeights & weights) noexcept
+{
+    const UINT Taps = weights.Taps();
+
+    for (UINT x = 0; x < width; ++x)
+    {
+        const BYTE * s = src + (size_t) weights.Start(x) * 4;
+        const int16_t * w = weights.Weights(x);
+
+        __m128i Acc = _mm_setzero_si128();
+
+        UINT k = 0;
+
+        for (; k + 2 <= Taps; k += 2)
+            Acc = _mm_add_epi32(Acc, MultiplyAdd2_SSE2(s + k * 4, WeightPair(w[k], w[k + 1])));
+
+        if (k < Taps)
+            Acc = _mm_add_epi32(Acc, MultiplyAdd1_SSE2(s + k * 4, w[k]));
+
+        dst[x] = ToPixel_SSE2(Acc);
+    }
+}
+
+/// <summary>
+/// Resamples a set of rows vertically into one row, starting at pixel x, 4 pixels and 2 rows at a time.
+/// </summary>
+static void Vertical_SSE2(const BYTE * const * rows, const int16_t * weights, UINT taps, uint32_t * dst, UINT x, UINT width) noexcept
+{
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i Round = _mm_set1_epi32(Rounding);
+
+    for (; x + 4 <= width; x += 4)
+    {
+        __m128i Acc0 = Zero, Acc1 = Zero, Acc2 = Zero, Acc3 = Zero;
+
+        for (UINT k = 0; k < taps; k += 2)
+        {
+            const bool HasPair = (k + 1 < taps);
+
+            const __m128i r0 = _mm_loadu_si128((const __m128i *) (rows[k] + (size_t) x * 4));
+            const __m128i r1 = HasPair ? _mm_loadu_si128((const __m128i *) (rows[k + 1] + (size_t) x * 4)) : Zero;
+
+            const __m128i w = _mm_set1_epi32(WeightPair(weights[k], HasPair ? weights[k + 1] : (int16_t) 0));
+
+            const __m128i Lo = _mm_unpacklo_epi8(r0, r1); // Channels 0 - 7 of both rows, interleaved
+            const __m128i Hi = _mm_unpackhi_epi8(r0, r1); // Channels 8 - 15 of both rows, interleaved
+
+            Acc0 = _mm_add_epi32(Acc0, _mm_madd_epi16(_mm_unpacklo_epi8(Lo, Zero), w));
+            Acc1 = _mm_add_epi32(Acc1, _mm_madd_epi16(_mm_unpackhi_epi8(Lo, Zero), w));
+            Acc2 = _mm_add_epi32(Acc2, _mm_madd_epi16(_mm_unpacklo_epi8(Hi, Zero), w));
+            Acc3 = _mm_add_epi32(Acc3, _mm_madd_epi16(_mm_unpackhi_epi8(Hi, Zero), w));
+        }
+
+        Acc0 = _mm_srai_epi32(_mm_add_epi32(Acc0, Round), ScaleWeights::Precision);
+        Acc1 = _mm_srai_epi32(_mm_add_epi32(Acc1, Round), ScaleWeights::Precision);
+        Acc2 = _mm_srai_epi32(_mm_add_epi32(Acc2, Round), ScaleWeights::Precision);
+        Acc3 = _mm_srai_epi32(_mm_add_epi32(Acc3, Round), ScaleWeights::Precision);
+
+        const __m128i p = _mm_packus_epi16(_mm_packs_epi32(Acc0, Acc1), _mm_packs_epi32(Acc2, Acc3));
+
+        _mm_storeu_si128((__m128i *) (dst + x), ClampToAlpha_SSE2(p));
+    }
+
+    Vertical_Scalar(rows, weights, taps, dst, x, width);
+}
+
+/// <summary>
+/// Resamples a row horizontally, 4 taps at a time.
+/// </summary>
+TARGET_AVX2 static void Horizontal_AVX2(const BYTE * src, uint32_t * dst, UINT width, const ScaleWeights & weights) noexcept
+{
+    const __m256i Interleave = _mm256_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15, 0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15);
+
+    const UINT Taps = weights.Taps();
+
+    for (UINT x = 0; x < width; ++x)
+    {
+        const BYTE * s = src + (size_t) weights.Start(x) * 4;
+        const int16_t * w = weights.Weights(x);
+
+        __m256i Acc256 = _mm256_setzero_si256();
+
+        UINT k = 0;
+
+        for (; k + 4 <= Taps; k += 4)
+        {
+            // Pixels 0 and 1 in the low lane, 2 and 3 in the high lane, with their channels interleaved.
+            const __m256i p = _mm256_shuffle_epi8(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (s + k * 4))), Interleave);
+
+            const int w01 = WeightPair(w[k],     w[k + 1]);
+            const int w23 = WeightPair(w[k + 2], w[k + 3]);
+
+            Acc256 = _mm256_add_epi32(Acc256, _mm256_madd_epi16(p, _mm256_setr_epi32(w01, w01, w01, w01, w23, w23, w23, w23)));
+        }
+
+        __m128i Acc = _mm_add_epi32(_mm256_castsi256_si128(Acc256), _mm256_extracti128_si256(Acc256, 1));
+
+        for (; k + 2 <= Taps; k += 2)
+            Acc = _mm_add_epi32(Acc, MultiplyAdd2_SSE2(s + k * 4, WeightPair(w[k], w[k + 1])));
+
+        if (k < Taps)
+            Acc = _mm_add_epi32(Acc, MultiplyAdd1_SSE2(s + k * 4, w[k]));
+
+        dst[x] = ToPixel_SSE2(Acc);
+    }
+}
+
+/// <summary>
+/// Resamples a set of rows vertically into one row, starting at pixel x, 8 pixels and 2 rows at a time.
+/// </summary>
+TARGET_AVX2 static void Vertical_AVX2(const BYTE * const * rows, const int16_t * weights, UINT taps, uint32_t * dst, UINT x, UINT width) noexcept
+{
+    const __m256i Zero = _mm256_setzero_si256();
+    const __m256i Round = _mm256_set1_epi32(Rounding);
+    const __m256i AlphaMask = _mm256_set1_epi32((int) 0xFF000000);
+    const __m256i BroadcastAlpha = _mm256_setr_epi8(3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15, 3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15);
+
+    for (; x + 8 <= width; x += 8)
+    {
+        __m256i Acc0 = Zero, Acc1 = Zero, Acc2 = Zero, Acc3 = Zero;
+
+        for (UINT k = 0; k < taps; k += 2)
+        {
+            const bool HasPair = (k + 1 < taps);
+
+            const __m256i r0 = _mm256_loadu_si256((const __m256i *) (rows[k] + (size_t) x * 4));
+            const __m256i r1 = HasPair ? _mm256_loadu_si256((const __m256i *) (rows[k + 1] + (size_t) x * 4)) : Zero;
+
+            const __m256i w = _mm256_set1_epi32(WeightPair(weights[k], HasPair ? weights[k + 1] : (int16_t) 0));
+
+            const __m256i Lo = _mm256_unpacklo_epi8(r0, r1);
+            const __m256i Hi = _mm256_unpackhi_epi8(r0, r1);
+
+            Acc0 = _mm256_add_epi32(Acc0, _mm256_madd_epi16(_mm256_unpacklo_epi8(Lo, Zero), w));
+            Acc1 = _mm256_add_epi32(Acc1, _mm256_madd_epi16(_mm256_unpackhi_epi8(Lo, Zero), w));
+            Acc2 = _mm256_add_epi32(Acc2, _mm256_madd_epi16(_mm256_unpacklo_epi8(Hi, Zero), w));
+            Acc3 = _mm256_add_epi32(Acc3, _mm256_madd_epi16(_mm256_unpackhi_epi8(Hi, Zero), w));
+        }
+
+        Acc0 = _mm256_srai_epi32(_mm256_add_epi32(Acc0, Round), ScaleWeights::Precision);
+        Acc1 = _mm256_srai_epi32(_mm256_add_epi32(Acc1, Round), ScaleWeights::Precision);
+        Acc2 = _mm256_srai_epi32(_mm256_add_epi32(Acc2, Round), ScaleWeights::Precision);
+        Acc3 = _mm256_srai_epi32(_mm256_add_epi32(Acc3, Round), ScaleWeights::Precision);
+
+        const __m256i p = _mm256_packus_epi16(_mm256_packs_epi32(Acc0, Acc1), _mm256_packs_epi32(Acc2, Acc3));
+
+        _mm256_storeu_si256((__m256i *) (dst + x), _mm256_min_epu8(p, _mm256_or_si256(_mm256_shuffle_epi8(p, BroadcastAlpha), AlphaMask)));
+    }
+
+    Vertical_SSE2(rows, weights, taps, dst, x, width);
+}
+
+/// <summary>
+/// Converts 2 pixels of 32-bit accumulators to 15-bit linear channels, with the color channels clamped to alpha.
+/// </summary>
+static inline __m128i ToLinearPixels_SSE2(__m128i acc0, __m128i acc1) noexcept
+{
+    const __m128i Round = _mm_set1_epi32(Rounding);
+
+    acc0 = _mm_srai_epi32(_mm_add_epi32(acc0, Round), ScaleWeights::Precision);
+    acc1 = _mm_srai_epi32(_mm_add_epi32(acc1, Round), ScaleWeights::Precision);
+
+    const __m128i p = _mm_max_epi16(_mm_packs_epi32(acc0, acc1), _mm_setzero_si128());
+
+    return _mm_min_epi16(p, _mm_shufflehi_epi16(_mm_shufflelo_epi16(p, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)));
+}
+
+/// <summary>
+/// Accumulates 4 linear pixels weighted by 4 taps. Taps 0 and 2, and 1 and 3, are interleaved, and their weights are loaded together and shuffled
+/// into pairs.
+/// </summary>
+static inline __m128i LinearMultiplyAdd4_SSE2(const uint16_t * s, const int16_t * w) noexcept
+{
+    const __m128i p01 = _mm_loadu_si128((const __m128i *) s);       // b0 g0 r0 a0 b1 g1 r1 a1
+    const __m128i p23 = _mm_loadu_si128((const __m128i *) (s + 8)); // b2 g2 r2 a2 b3 g3 r3 a3
+
+    const __m128i Pairs = _mm_shufflelo_epi16(_mm_loadl_epi64((const __m128i *) w), _MM_SHUFFLE(3, 1, 2, 0)); // w0 w2 w1 w3
+
+    return _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(p01, p23), _mm_shuffle_epi32(Pairs, _MM_SHUFFLE(0, 0, 0, 0))),
+                         _mm_madd_epi16(_mm_unpackhi_epi16(p01, p23), _mm_shuffle_epi32(Pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+}
+
+/// <summary>
+/// Resamples a row of linear pixels horizontally, 2 pixels and 4 taps at a time. Rows whose number of taps is not a multiple of 4, and the last
+/// pixel, are resampled a pixel and 2 taps at a time.
+/// </summary>
+static void LinearHorizontal_SSE2(const uint16_t * src, uint16_t * dst, UINT width, const ScaleWeights & weights) noexcept
+{
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i Round = _mm_set1_epi32(Rounding);
+
+    const UINT Taps = weights.Taps();
+
+    UINT x = 0;
+
+    if (Taps % 4 == 0)
+    {
+        for (; x + 2 <= width; x += 2)
+        {
+            const uint16_t * s0 = src + (size_t) weights.Start(x) * 4;
+            const uint16_t * s1 = src + (size_t) weights.Start(x + 1) * 4;
+            const int16_t * w0 = weights.Weights(x);
+            const int16_t * w1 = weights.Weights(x + 1);
+
+            __m128i Acc0 = Zero, Acc1 = Zero;
+
+            for (UINT k = 0; k < Taps; k += 4)
+            {
+                Acc0 = _mm_add_epi32(Acc0, LinearMultiplyAdd4_SSE2(s0 + k * 4, w0 + k));
+                Acc1 = _mm_add_epi32(Acc1, LinearMultiplyAdd4_SSE2(s1 + k * 4, w1 + k));
+            }
+
+            Acc0 = _mm_srai_epi32(_mm_add_epi32(Acc0, Round), ScaleWeights::Precision);
+            Acc1 = _mm_srai_epi32(_mm_add_epi32(Acc1, Round), ScaleWeights::Precision);
+
+            _mm_storeu_si128((__m128i *) (dst + (size_t) x * 4), _mm_max_epi16(_mm_packs_epi32(Acc0, Acc1), Zero));
+        }
+    }
+
+    for (; x < width; ++x)
+    {
+        const uint16_t * s = src + (size_t) weights.Start(x) * 4;
+        const int16_t * w = weights.Weights(x);
+
+        __m128i Acc = Zero;
+
+        UINT k = 0;
+
+        for (; k + 2 <= Taps; k += 2)
+        {
+            const __m128i p = _mm_loadu_si128((const __m128i *) (s + k * 4)); // b0 g0 r0 a0 b1 g1 r1 a1
+
+            Acc = _mm_add_epi32(Acc, _mm_madd_epi16(_mm_unpacklo_epi16(p, _mm_srli_si128(p, 8)), _mm_set1_epi32(WeightPair(w[k], w[k + 1]))));
+        }
+
+        if (k < Taps)
+            Acc = _mm_add_epi32(Acc, _mm_madd_epi16(_mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *) (s + k * 4)), Zero), _mm_set1_epi32((uint16_t) w[k])));
+
+        Acc = _mm_srai_epi32(_mm_add_epi32(Acc, Round), ScaleWeights::Precision);
+
+        _mm_storel_epi64((__m128i *) (dst + (size_t) x * 4), _mm_max_epi16(_mm_packs_epi32(Acc, Acc), Zero));
+    }
+}
+
+/// <summary>
+/// Resamples a set of rows of linear pixels vertically into one row, starting at pixel x, 4 pixels and 2 rows at a time.
+/// </summary>
+static void LinearVertical_SSE2(const BYTE * const * rows, const int16_t * weights, UINT taps, uint16_t * dst, UINT x, UINT width) noexcept
+{
+    const __m128i Zero = _mm_setzero_si128();
+
+    for (; x + 4 <= width; x += 4)
+    {
+        __m128i Acc0 = Zero, Acc1 = Zero, Acc2 = Zero, Acc3 = Zero;
+
+        for (UINT k = 0; k < taps; k += 2)
+        {
+            const bool HasPair = (k + 1 < taps);
+
+            const __m128i * s0 = (const __m128i *) (rows[k] + (size_t) x * 8);
+            const __m128i * s1 = HasPair ? (const __m128i *) (rows[k + 1] + (size_t) x * 8) : nullptr;
+
+            const __m128i r0a = _mm_loadu_si128(s0);
+            const __m128i r0b = _mm_loadu_si128(s0 + 1);
+            const __m128i r1a = HasPair ? _mm_loadu_si128(s1) : Zero;
+            const __m128i r1b = HasPair ? _mm_loadu_si128(s1 + 1) : Zero;
+
+            const __m128i w = _mm_set1_epi32(WeightPair(weights[k], HasPair ? weights[k + 1] : (int16_t) 0));
+
+            Acc0 = _mm_add_epi32(Acc0, _mm_madd_epi16(_mm_unpacklo_epi16(r0a, r1a), w));
+            Acc1 = _mm_add_epi32(Acc1, _mm_madd_epi16(_mm_unpackhi_epi16(r0a, r1a), w));
+            Acc2 = _mm_add_epi32(Acc2, _mm_madd_epi16(_mm_unpacklo_epi16(r0b, r1b), w));
+            Acc3 = _mm_add_epi32(Acc3, _mm_madd_epi16(_mm_unpackhi_epi16(r0b, r1b), w));
+        }
+
+        __m128i * d = (__m128i *) (dst + (size_t) x * 4);
+
+        _mm_storeu_si128(d,     ToLinearPixels_SSE2(Acc0, Acc1));
+        _mm_storeu_si128(d + 1, ToLinearPixels_SSE2(Acc2, Acc3));
+    }
+
+    LinearVertical_Scalar(rows, weights, taps, dst, x, width);
+}
+
+/// <summary>
+/// Resamples a row of linear pixels horizontally, 4 taps at a time. Pairs of destination pixels are resampled together, the first in the low lane
+/// and the second in the high lane, so that their sums need no reduction across the lanes. The last pixel, and rows whose number of taps is not
+/// a multiple of 4, are resampled a pixel at a time.
+/// </summary>
+TARGET_AVX2 static void LinearHorizontal_AVX2(const uint16_t * src, uint16_t * dst, UINT width, const ScaleWeights & weights) noexcept
+{
+    const __m256i Interleave = _mm256_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15, 0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15);
+
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i Round = _mm_set1_epi32(Rounding);
+
+    const UINT Taps = weights.Taps();
+
+    UINT x = 0;
+
+    if (Taps % 4 == 0)
+    {
+        const __m256i Round256 = _mm256_set1_epi32(Rounding);
+
+        for (; x + 2 <= width; x += 2)
+        {
+            const uint16_t * s0 = src + (size_t) weights.Start(x) * 4;
+            const uint16_t * s1 = src + (size_t) weights.Start(x + 1) * 4;
+            const int16_t * w0 = weights.Weights(x);
+            const int16_t * w1 = weights.Weights(x + 1);
+
+            __m256i Acc = _mm256_setzero_si256();
+
+            for (UINT k = 0; k < Taps; k += 4)
+            {
+                // Taps k and k + 1, and k + 2 and k + 3, with their channels interleaved, and the weight pairs of both taps.
+                const __m256i p01 = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) (s0 + k * 4))),     _mm_loadu_si128((const __m128i *) (s1 + k * 4)), 1), Interleave);
+                const __m256i p23 = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) (s0 + k * 4 + 8))), _mm_loadu_si128((const __m128i *) (s1 + k * 4 + 8)), 1), Interleave);
+
+                const __m256i w = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadl_epi64((const __m128i *) (w0 + k))), _mm_loadl_epi64((const __m128i *) (w1 + k)), 1);
+
+                Acc = _mm256_add_epi32(Acc, _mm256_add_epi32(_mm256_madd_epi16(p01, _mm256_shuffle_epi32(w, _MM_SHUFFLE(0, 0, 0, 0))), _mm256_madd_epi16(p23, _mm256_shuffle_epi32(w, _MM_SHUFFLE(1, 1, 1, 1)))));
+            }
+
+            Acc = _mm256_srai_epi32(_mm256_add_epi32(Acc, Round256), ScaleWeights::Precision);
+
+            const __m256i p = _mm256_max_epi16(_mm256_packs_epi32(Acc, Acc), _mm256_setzero_si256());
+
+            _mm_storeu_si128((__m128i *) (dst + (size_t) x * 4), _mm256_castsi256_si128(_mm256_permute4x64_epi64(p, _MM_SHUFFLE(2, 2, 2, 0))));
+        }
+    }
+
+    for (; x < width; ++x)
+    {
+        const uint16_t * s = src + (size_t) weights.Start(x) * 4;
+        const int16_t * w = weights.Weights(x);
+
+        __m256i Acc256 = _mm256_setzero_si256();
+
+        UINT k = 0;
+
+        for (; k + 4 <= Taps; k += 4)
+        {
+            // Pixels 0 and 1 in the low lane, 2 and 3 in the high lane, with their channels interleaved.
+            const __m256i p = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *) (s + k * 4)), Interleave);
+
+            const int w01 = WeightPair(w[k],     w[k + 1]);
+            const int w23 = WeightPair(w[k + 2], w[k + 3]);
+
+            Acc256 = _mm256_add_epi32(Acc256, _mm256_madd_epi16(p, _mm256_setr_epi32(w01, w01, w01, w01, w23, w23, w23, w23)));
+        }
+
+        __m128i Acc = _mm_add_epi32(_mm256_castsi256_si128(Acc256), _mm256_extracti128_si256(Acc256, 1));
+
+        for (; k + 2 <= Taps; k += 2)
+        {
+            const __m128i p = _mm_loadu_si128((const __m128i *) (s + k * 4));
+
+            Acc = _mm_add_epi32(Acc, _mm_madd_epi16(_mm_unpacklo_epi16(p, _mm_srli_si128(p, 8)), _mm_set1_epi32(WeightPair(w[k], w[k + 1]))));
+        }
+
+        if (k < Taps)
+            Acc = _mm_add_epi32(Acc, _mm_madd_epi16(_mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *) (s + k * 4)), Zero), _mm_set1_epi32((uint16_t) w[k])));
+
+        Acc = _mm_srai_epi32(_mm_add_epi32(Acc, Round), ScaleWeights::Precision);
+
+        _mm_storel_epi64((__m128i *) (dst + (size_t) x * 4), _mm_max_epi16(_mm_packs_epi32(Acc, Acc), Zero));
+    }
+}
+
+/// <summary>
+/// Resamples a set of rows of linear pixels vertically into one row, starting at pixel x, 8 pixels and 2 rows at a time.
+/// </summary>
+TARGET_AVX2 static void LinearVertical_AVX2(const BYTE * const * rows, const int16_t * weights, UINT taps, uint16_t * dst, UINT x, UINT width) noexcept
+{
+    const __m256i Zero = _mm256_setzero_si256();
+    const __m256i Round = _mm256_set1_epi32(Rounding);
+    const __m256i BroadcastAlpha = _mm256_setr_epi8(6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15, 6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15);
+
+    for (; x + 8 <= width; x += 8)
+    {
+        __m256i Acc0 = Zero, Acc1 = Zero, Acc2 = Zero, Acc3 = Zero;
+
+        for (UINT k = 0; k < taps; k += 2)
+        {
+            const bool HasPair = (k + 1 < taps);
+
+            const __m256i * s0 = (const __m256i *) (rows[k] + (size_t) x * 8);
+            const __m256i * s1 = HasPair ? (const __m256i *) (rows[k + 1] + (size_t) x * 8) : nullptr;
+
+            const __m256i r0a = _mm256_loadu_si256(s0);
+            const __m256i r0b = _mm256_loadu_si256(s0 + 1);
+            const __m256i r1a = HasPair ? _mm256_loadu_si256(s1) : Zero;
+            const __m256i r1b = HasPair ? _mm256_loadu_si256(s1 + 1) : Zero;
+
+            const __m256i w = _mm256_set1_epi32(WeightPair(weights[k], HasPair ? weights[k + 1] : (int16_t) 0));
+
+            // Per lane: the low half holds the first pixel, the high half the second.
+            Acc0 = _mm256_add_epi32(Acc0, _mm256_madd_epi16(_mm256_unpacklo_epi16(r0a, r1a), w));
+            Acc1 = _mm256_add_epi32(Acc1, _mm256_madd_epi16(_mm256_unpackhi_epi16(r0a, r1a), w));
+            Acc2 = _mm256_add_epi32(Acc2, _mm256_madd_epi16(_mm256_unpacklo_epi16(r0b, r1b), w));
+            Acc3 = _mm256_add_epi32(Acc3, _mm256_madd_epi16(_mm256_unpackhi_epi16(r0b, r1b), w));
+        }
+
+        Acc0 = _mm256_srai_epi32(_mm256_add_epi32(Acc0, Round), ScaleWeights::Precision);
+        Acc1 = _mm256_srai_epi32(_mm256_add_epi32(Acc1, Round), ScaleWeights::Precision);
+        Acc2 = _mm256_srai_epi32(_mm256_add_epi32(Acc2, Round), ScaleWeights::Precision);
+        Acc3 = _mm256_srai_epi32(_mm256_add_epi32(Acc3, Round), ScaleWeights::Precision);
+
+        const __m256i p0 = _mm256_max_epi16(_mm256_packs_epi32(Acc0, Acc1), Zero);
+        const __m256i p1 = _mm256_max_epi16(_mm256_packs_epi32(Acc2, Acc3), Zero);
+
+        __m256i * d = (__m256i *) (dst + (size_t) x * 4);
+
+        _mm256_storeu_si256(d,     _mm256_min_epi16(p0, _mm256_shuffle_epi8(p0, BroadcastAlpha)));
+        _mm256_storeu_si256(d + 1, _mm256_min_epi16(p1, _mm256_shuffle_epi8(p1, BroadcastAlpha)));
+    }
+
+    LinearVertical_SSE2(rows, weights, taps, dst, x, width);
+}
+
+#endif
+
+/// <summary>
+/// Selects the kernels of both passes for the current instruction set.
+/// </summary>
+static void SelectKernels(HorizontalFunction & horizontal, VerticalFunction & vertical) noexcept
+{
+    horizontal = Horizontal_Scalar;
+    vertical = Vertical_Scalar;
+
+#ifdef CORE_X86
+    const InstructionSet Set = Scaler::GetInstructionSet();
+
+    if (Set >= InstructionSet::AVX2)
+    {
+        horizontal = Horizontal_AVX2;
+        vertical = Vertical_AVX2;
+    }
+    else
+    if (Set >= InstructionSet::SSE2)
+    {
+        horizontal = Horizontal_SSE2;
+        vertical = Vertical_SSE2;
+    }
+#endif
+}
+
+/// <summary>
+/// Selects the linear kernels of both passes for the current instruction set.
+/// </summary>
+static void SelectLinearKernels(LinearHorizontalFunction & horizontal, LinearVerticalFunction & vertical) noexcept
+{
+    horizontal = LinearHorizontal_Scalar;
+    vertical = LinearVertical_Scalar;
+
+#ifdef CORE_X86
+    const InstructionSet Set = Scaler::GetInstructionSet();
+
+    if (Set >= InstructionSet::AVX2)
+    {
+        horizontal = LinearHorizontal_AVX2;
+        vertical = LinearVertical_AVX2;
+    }
+    else
+    if (Set >= InstructionSet::SSE2)
+    {
+        horizontal = LinearHorizontal_SSE2;
+        vertical = LinearVertical_SSE2;
+    }
+#endif
+}
+
+/// <summary>
+/// Runs both passes in linear light. Every band resamples the source rows that its destination rows need into a ring of as many rows as there are
+/// vertical taps, so that the linear rows, which take twice the memory of PBGRA32 rows, stay in the cache instead of going through an intermediate
+/// raster. Source rows at the border of 2 bands are resampled by both.
+/// </summary>
+static HRESULT ScaleLinear(const Raster & src, Raster & dst, const ScaleWeights & hWeights, const ScaleWeights & vWeights, ThreadPool & pool) noexcept
+{
+    LinearHorizontalFunction Horizontal;
+    LinearVerticalFunction Vertical;
+
+    SelectLinearKernels(Horizontal, Vertical);
+
+    const LinearLight::DecodeFunction Decode = LinearLight::GetDecodeFunction(LinearLight::GetInstructionSet());
+    const LinearLight::EncodeFunction Encode = LinearLight::GetEncodeFunction(LinearLight::GetInstructionSet());
+
+    const UINT Width = dst.Width();
+    const UINT Taps = vWeights.Taps();
+    const size_t Stride = (size_t) Width * 4;
+
+    std::atomic<HRESULT> Status(S_OK);
+
+    pool.ParallelFor(dst.Height(), [&](UINT begin, UINT end)
+    {
+        std::vector<uint16_t> Row, Ring;
+        std::vector<const BYTE *> Rows;
+
+        try
+        {
+            Row.resize((size_t) (std::max)(src.Width(), Width) * 4);
+            Ring.resize(Stride * Taps);
+            Rows.resize(Taps);
+        }
+        catch (const std::bad_alloc &)
+        {
+            Status = E_OUTOFMEMORY;
+
+            return;
+        }
+
+        UINT Next = vWeights.Start(begin); // The first source row that is not in the ring yet
+
+        for (UINT y = begin; y < end; ++y)
+        {
+            const UINT Start = vWeights.Start(y);
+
+            // Source row i goes to ring row i % Taps, so that the taps of every destination row are in the ring.
+            for (Next = (std::max)(Next, Start); Next < Start + Taps; ++Next)
+            {
+                Decode((const uint32_t *) src.Row(Next), Row.data(), src.Width());
+                Horizontal(Row.data(), Ring.data() + Stride * (Next % Taps), Width, hWeights);
+            }
+
+            for (UINT k = 0; k < Taps; ++k)
+                Rows[k] = (const BYTE *) (Ring.data() + Stride * ((Start + k) % Taps));
+
+            Vertical(Rows.data(), vWeights.Weights(y), Taps, Row.data(), 0, Width);
+            Encode(Row.data(), (uint32_t *) dst.Row(y), Width);
+        }
+    });
+
+    return Status;
+}
+
+/// <summary>
+/// Scales a premultiplied BGRA raster to the specified size.
+/// </summary>
+HRESULT Scaler::Scale(const Raster & src, Raster & dst, UINT width, UINT height, ScaleFilter filter, ThreadPool * threadPool, ColorSpace colorSpace) noexcept
+{
+    if ((src.Format() != PixelFormat::PBGRA32) || src.IsEmpty() || (&src == &dst))
+        return E_INVALIDARG;
+
+    ScaleWeights HWeights, VWeights;
+
+    HRESULT hr = HWeights.Initialize(src.Width(), width, filter);
+
+    if (SUCCEEDED(hr))
+        hr = VWeights.Initialize(src.Height(), height, filter);
+
+    // In linear light, every band resamples into rows of its own.
+    if (colorSpace == ColorSpace::Linear)
+    {
+        if (SUCCEEDED(hr))
+            hr = dst.Initialize(width, height);
+
+        if (!SUCCEEDED(hr))
+            return hr;
+
+        return ScaleLinear(src, dst, HWeights, VWeights, (threadPool != nullptr) ? *threadPool : ThreadPool::GetDefault());
+    }
+
+    Raster Intermediate;
+
+    if (SUCCEEDED(hr))
+        hr = Intermediate.Initialize(width, src.Height());
+
+    // The taps of the vertical pass are consecutive rows so every destination row can use a slice of this table.
+    std::vector<const BYTE *> Rows;
+
+    if (SUCCEEDED(hr))
+    {
+        try
+        {
+            Rows.resize(src.Height());
+
+            for (UINT y = 0; y < src.Height(); ++y)
+                Rows[y] = Intermediate.Row(y);
+        }
+        catch (const std::bad_alloc &)
+        {
+            hr = E_OUTOFMEMORY;
+        }
+    }
+
+    if (SUCCEEDED(hr))
+        hr = dst.Initialize(width, height);
+
+    if (!SUCCEEDED(hr))
+        return hr;
+
+    HorizontalFunction Horizontal;
+    VerticalFunction Vertical;
+
+    SelectKernels(Horizontal, Vertical);
+
+    ThreadPool & Pool = (threadPool != nullptr) ? *threadPool : ThreadPool::GetDefault();
+
+    // Horizontal pass: source rows to intermediate rows.
+    Pool.ParallelFor(src.Height(), [&](UINT begin, UINT end)
+    {
+        for (UINT y = begin; y < end; ++y)
+            Horizontal(src.Row(y), (uint32_t *) Intermediate.Row(y), width, HWeights);
+    });
+
+    // Vertical pass: intermediate rows to destination rows.
+    Pool.ParallelFor(height, [&](UINT begin, UINT end)
+    {
+        for (UINT y = begin; y < end; ++y)
+            Vertical(Rows.data() + VWeights.Start(y), VWeights.Weights(y), VWeights.Taps(), (uint32_t *) dst.Row(y), 0, width);
+    });
+
+    return S_OK;
+}
+
+/// <summary>
+/// Scales a premultiplied BGRA raster down to fit the specified size, preserving its aspect ratio. Rasters that already fit are copied.
+/// </summary>
+HRESULT Scaler::Fit(const Raster & src, Raster & dst, UINT maxWidth, UINT maxHeight, ScaleFilter filter, ThreadPool * threadPool, ColorSpace colorSpace) noexcept
+{
+    UINT Width, Height;
+
+    GetFitSize(src.Width(), src.Height(), maxWidth, maxHeight, Width, Height);
+
+    if ((Width == src.Width()) && (Height == src.Height()))
+        return dst.CopyFrom(src);
+
+    return Scale(src, dst, Width, Height, filter, threadPool, colorSpace);
+}
+
+/// <summary>
+/// Calculates the size of an image scaled down to fit the specified size, preserving its aspect ratio.
+/// </summary>
+void Scaler::GetFitSize(UINT width, UINT height, UINT maxWidth, UINT maxHeight, UINT & fitWidth, UINT & fitHeight) noexcept
+{
+    // Fit big images.
+    const FLOAT HScalar = (width  > maxWidth)  ? (FLOAT) maxWidth  / (FLOAT) width  : 1.f;
+    const FLOAT VScalar = (height > maxHeight) ? (FLOAT) maxHeight / (FLOAT) height : 1.f;
+
+    const FLOAT Scalar = (std::min)(HScalar, VScalar);
+
+    fitWidth  = (std::max)((UINT) ((FLOAT) width  * Scalar), 1u);
+    fitHeight = (std::max)((UINT) ((FLOAT) height * Scalar), 1u);
+}
+
+/// <summary>
+/// Gets the largest of 1, 2, 4 and 8 by which a decoder can divide the size of an image while it still covers the size that fits the specified size.
+/// JPEG decoders scale by these factors in the DCT, e.g. scale_denom in libjpeg and IWICBitmapSourceTransform in WIC, at a fraction of the cost
+/// of a full decode. The result still gets its final high-quality fit.
+/// </summary>
+UINT Scaler::GetDecodeScale(UINT width, UINT height, UINT maxWidth, UINT maxHeight) noexcept
+{
+    if ((width == 0) || (height == 0) || (maxWidth == 0) || (maxHeight == 0))
+        return 1;
+
+    UINT FitWidth, FitHeight;
+
+    GetFitSize(width, height, maxWidth, maxHeight, FitWidth, FitHeight);
+
+    UINT Scale = 1;
+
+    while ((Scale < MaxDecodeScale) && (width / (Scale * 2) >= FitWidth) && (height / (Scale * 2) >= FitHeight))
+        Scale *= 2;
+
+    return Scale;
+}
+
+/// <summary>
+/// Gets the instruction set used by the scaler.
+/// </summary>
+InstructionSet Scaler::GetInstructionSet() noexcept
+{
+    return _InstructionSet;
+}
+
+/// <summary>
+/// Limits the instruction set used by the scaler, e.g. to compare the kernels. The CPU capabilities are never exceeded.
+/// </summary>
+void Scaler::SetInstructionSet(InstructionSet instructionSet) noexcept
+{
+    _InstructionSet = (std::min)(instructionSet, CPU::GetInstructionSet());
+}
+
+/// <summary>
+/// Prepares scaling an image of the specified size. The rows of the image must then be written in order with Write.
+/// </summary>
+HRESULT StreamingScaler::Initialize(UINT srcWidth, UINT srcHeight, UINT width, UINT height, ScaleFilter filter, ThreadPool * threadPool) noexcept
+{
+    if ((srcWidth == 0) || (srcHeight == 0) || (width == 0) || (height == 0))
+        return E_INVALIDARG;
+
+    // Box-filter to the smallest power-of-two reduction that is still at least as large as the destination. The sums of a block must fit in 32 bits.
+    const UINT MaxBlockSize = 1024;
+
+    UINT BlockWidth = 1, BlockHeight = 1;
+
+    while ((BlockWidth < MaxBlockSize) && (srcWidth / (BlockWidth * 2) >= width))
+        BlockWidth *= 2;
+
+    while ((BlockHeight < MaxBlockSize) && (srcHeight / (BlockHeight * 2) >= height))
+        BlockHeight *= 2;
+
+    const UINT ReducedWidth  = (srcWidth  + BlockWidth  - 1) / BlockWidth;
+    const UINT ReducedHeight = (srcHeight + BlockHeight - 1) / BlockHeight;
+
+    HRESULT hr = _HWeights.Initialize(ReducedWidth, width, filter);
+
+    if (SUCCEEDED(hr))
+        hr = _VWeights.Initialize(ReducedHeight, height, filter);
+
+    // A destination row needs Taps consecutive rows of the ring; a strip adds at most StripRows rows before the finished destination rows are written.
+    const UINT Capacity = _VWeights.Taps() + StripRows;
+
+    if (SUCCEEDED(hr))
+        hr = _Ring.Initialize(width, Capacity);
+
+    if (SUCCEEDED(hr))
+        hr = _Dst.Initialize(width, height);
+
+    if (SUCCEEDED(hr) && (BlockWidth * BlockHeight > 1))
+        hr = _Band.Initialize(ReducedWidth, StripRows);
+
+    if (SUCCEEDED(hr))
+    {
+        try
+        {
+            _Sums.assign((BlockWidth * BlockHeight > 1) ? (size_t) ReducedWidth * 4 : 0, 0);
+            _RingRows.resize((size_t) Capacity * 2);
+        }
+        catch (const std::bad_alloc &)
+        {
+            hr = E_OUTOFMEMORY;
+        }
+    }
+
+    if (!SUCCEEDED(hr))
+        return hr;
+
+    for (UINT i = 0; i < Capacity * 2; ++i)
+        _RingRows[i] = _Ring.Row(i % Capacity);
+
+    _SrcWidth = srcWidth;
+    _SrcHeight = srcHeight;
+    _BlockWidth = BlockWidth;
+    _BlockHeight = BlockHeight;
+    _ReducedWidth = ReducedWidth;
+    _ReducedHeight = ReducedHeight;
+    _RowsWritten = 0;
+    _RowsReduced = 0;
+    _NextRow = 0;
+    _Capacity = Capacity;
+    _ThreadPool = (threadPool != nullptr) ? threadPool : &ThreadPool::GetDefault();
+
+    SelectKernels(_Horizontal, _Vertical);
+
+    return S_OK;
+}
+
+/// <summary>
+/// Writes the next rows of the image, in PBGRA32. The destination rows that depend on them are produced before this returns.
+/// </summary>
+HRESULT StreamingScaler::Write(const BYTE * data, UINT stride, UINT count) noexcept
+{
+    if ((data == nullptr) || (_Capacity == 0) || (count > _SrcHeight - _RowsWritten))
+        return E_INVALIDARG;
+
+    while (count != 0)
+    {
+        const UINT n = (std::min)(count, StripRows);
+
+        const BYTE * Rows[StripRows];
+        UINT Completed = 0;
+
+        if (_Band.IsEmpty())
+        {
+            for (UINT i = 0; i < n; ++i)
+                Rows[i] = data + (size_t) i * stride;
+
+            Completed = n;
+        }
+        else
+        {
+            // Count the blocks of rows that this strip completes. Every thread of the box filter writes the same band rows.
+            for (UINT i = 0; i < n; ++i)
+            {
+                const UINT y = _RowsWritten + i;
+
+                if (((y + 1) % _BlockHeight == 0) || (y + 1 == _SrcHeight))
+                {
+                    Rows[Completed] = _Band.Row(Completed);
+                    ++Completed;
+                }
+            }
+
+            _ThreadPool->ParallelFor(_ReducedWidth, [&](UINT begin, UINT end)
+            {
+                Reduce(data, stride, n, begin, end);
+            });
+        }
+
+        _RowsWritten += n;
+
+        Resample(Rows, Completed);
+
+        data += (size_t) n * stride;
+        count -= n;
+    }
+
+    return S_OK;
+}
+
+/// <summary>
+/// Gets the scaled image once all rows have been written. Releases the buffers of the scaler.
+/// </summary>
+HRESULT StreamingScaler::GetResult(Raster & dst) noexcept
+{
+    if ((_Capacity == 0) || (_RowsWritten != _SrcHeight))
+        return E_PENDING;
+
+    dst = std::move(_Dst);
+
+    _Band.Reset();
+    _Ring.Reset();
+    _Sums.clear();
+    _Capacity = 0;
+
+    return S_OK;
+}
+
+/// <summary>
+/// Gets the number of bytes used by the scaler, including the destination image.
+/// </summary>
+size_t StreamingScaler::GetSize() const noexcept
+{
+    return (size_t) _Band.Size() + _Ring.Size() + _Dst.Size() + _Sums.size() * sizeof(uint32_t) + _RingRows.size() * sizeof(const BYTE *);
+}
+
+/// <summary>
+/// Box-filters columns [begin, end) of the reduced image. Adds the rows of a strip to the sums and writes a band row for every completed block.
+/// </summary>
+void StreamingScaler::Reduce(const BYTE * data, UINT stride, UINT count, UINT begin, UINT end) noexcept
+{
+    UINT Completed = 0;
+
+    for (UINT i = 0; i < count; ++i)
+    {
+        const uint32_t * Row = (const uint32_t *) (data + (size_t) i * stride);
+
+        for (UINT x = begin; x < end; ++x)
+        {
+            const UINT First = x * _BlockWidth;
+            const UINT Last = (std::min)(First + _BlockWidth, _SrcWidth);
+
+            uint32_t b = 0, g = 0, r = 0, a = 0;
+
+            for (UINT j = First; j < Last; ++j)
+            {
+                const uint32_t p = Row[j];
+
+                b +=  p        & 0xFF;
+                g += (p >>  8) & 0xFF;
+                r += (p >> 16) & 0xFF;
+                a +=  p >> 24;
+            }
+
+            uint32_t * Sum = _Sums.data() + (size_t) x * 4;
+
+            Sum[0] += b;
+            Sum[1] += g;
+            Sum[2] += r;
+            Sum[3] += a;
+        }
+
+        const UINT y = _RowsWritten + i;
+
+        if (((y + 1) % _BlockHeight != 0) && (y + 1 != _SrcHeight))
+            continue;
+
+        // Average the block, rounded to nearest. Partial blocks at the right and bottom edge average the pixels they cover.
+        uint32_t * Dst = (uint32_t *) _Band.Row(Completed++);
+
+        const UINT Rows = y % _BlockHeight + 1;
+
+        for (UINT x = begin; x < end; ++x)
+        {
+            const uint32_t n = ((std::min)((x + 1) * _BlockWidth, _SrcWidth) - x * _BlockWidth) * Rows;
+
+            uint32_t * Sum = _Sums.data() + (size_t) x * 4;
+
+            Dst[x] = ((Sum[0] + n / 2) / n) | (((Sum[1] + n / 2) / n) << 8) | (((Sum[2] + n / 2) / n) << 16) | (((Sum[3] + n / 2) / n) << 24);
+
+            Sum[0] = Sum[1] = Sum[2] = Sum[3] = 0;
+        }
+    }
+}
+
+/// <summary>
+/// Resamples rows of the reduced image horizontally into the ring, then resamples every destination row whose taps are all in the ring.
+/// </summary>
+void StreamingScaler::Resample(const BYTE * const * rows, UINT count) noexcept
+{
+    const UINT Width = _Dst.Width();
+    const UINT Taps = _VWeights.Taps();
+
+    // Rows below the last tap of the last destination row are not needed.
+    if (_NextRow < _Dst.Height())
+    {
+        _ThreadPool->ParallelFor(count, [&](UINT begin, UINT end)
+        {
+            for (UINT i = begin; i < end; ++i)
+                _Horizontal(rows[i], (uint32_t *) _Ring.Row((_RowsReduced + i) % _Capacity), Width, _HWeights);
+        });
+    }
+
+    _RowsReduced += count;
+
+    UINT End = _NextRow;
+
+    while ((End < _Dst.Height()) && (_VWeights.Start(End) + Taps <= _RowsReduced))
+        ++End;
+
+    _ThreadPool->ParallelFor(End - _NextRow, [&](UINT begin, UINT end)
+    {
+        for (UINT y = _NextRow + begin; y < _NextRow + end; ++y)
+            _Vertical(_RingRows.data() + _VWeights.Start(y) % _Capacity, _VWeights.Weights(y), Taps, (uint32_t *) _Dst.Row(y), 0, Width);
+    });
+
+    _NextRow = End;
+}
+
+/// <summary>
+/// Scales an image that is read in strips to the specified size. The reader can return a failure, e.g. E_ABORT, to stop.
+/// </summary>
+HRESULT StreamingScaler::Scale(UINT srcWidth, UINT srcHeight, const RowReader & reader, Raster & dst, UINT width, UINT height, ScaleFilter filter, ThreadPool * threadPool) noexcept
+{
+    StreamingScaler Scaler;
+
+    HRESULT hr = Scaler.Initialize(srcWidth, srcHeight, width, height, filter, threadPool);
+
+    Raster Strip;
+
+    if (SUCCEEDED(hr))
+        hr = Strip.Initialize(srcWidth, (std::min)(srcHeight, StripRows));
+
+    for (UINT y = 0; SUCCEEDED(hr) && (y < srcHeight); y += StripRows)
+    {
+        const UINT n = (std::min)(srcHeight - y, StripRows);
+
+        hr = reader(y, n, Strip.Data(), Strip.Stride());
+
+        if (SUCCEEDED(hr))
+            hr = Scaler.Write(Strip.Data(), Strip.Stride(), n);
+    }
+
+    if (SUCCEEDED(hr))
+        hr = Scaler.GetResult(dst);
+
+    return hr;
+}
+
+/// <summary>
+/// Scales an image that is read in strips down to fit the specified size, preserving its aspect ratio. Images that already fit are read as they are.
+/// </summary>
+HRESULT StreamingScaler::Fit(UINT srcWidth, UINT srcHeight, const RowReader & reader, Raster & dst, UINT maxWidth, UINT maxHeight, ScaleFilter filter, ThreadPool * threadPool) noexcept
+{
+    UINT Width, Height;
+
+    Scaler::GetFitSize(srcWidth, srcHeight, maxWidth, maxHeight, Width, Height);
+
+    if ((Width != srcWidth) || (Height != srcHeight))
+        return Scale(srcWidth, srcHeight, reader, dst, Width, Height, filter, threadPool);
+
+    HRESULT hr = dst.Initialize(srcWidth, srcHeight);
+
+    for (UINT y = 0; SUCCEEDED(hr) && (y < srcHeight); y += StripRows)
+        hr = reader(y, (std::min)(srcHeight - y, StripRows), dst.Row(y), dst.Stride());
+
+    return hr;
+}
@@ -0,0 +1,128 @@
+
+/** $VER: Scaler.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+#include "CPU.h"
+#include "LinearLight.h"
+#include "Raster.h"
+
+#include <functional>
+#include <vector>
+
+class ThreadPool;
+
+/// <summary>
+/// Identifies a resampling filter.
+/// </summary>
+enum class ScaleFilter
+{
+    Box,            // Averages the covered pixels. Fastest, softest.
+    CatmullRom,     // Cubic with B = 0, C = 0.5. Sharp with little ringing.
+    Lanczos3,       // Windowed sinc with 3 lobes. Sharpest.
+};
+
+/// <summary>
+/// Contains the fixed-point filter weights of one dimension. Every destination pixel uses the same number of taps, starting at its own source pixel.
+/// </summary>
+class ScaleWeights
+{
+public:
+    static const int Precision = 14; // The weights of a destination pixel add up to 1 << Precision.
+
+    ScaleWeights() : _Taps() { }
+
+    HRESULT Initialize(UINT srcSize, UINT dstSize, ScaleFilter filter) noexcept;
+
+    UINT Taps() const noexcept { return _Taps; }
+    UINT Start(UINT i) const noexcept { return _Start[i]; }
+    const int16_t * Weights(UINT i) const noexcept { return _Weights.data() + (size_t) i * _Taps; }
+
+private:
+    UINT _Taps;
+    std::vector<UINT> _Start;
+    std::vector<int16_t> _Weights;
+};
+
+/// <summary>
+/// Resamples premultiplied BGRA rasters with a separable filter: a horizontal pass followed by a vertical pass, both split in bands over a thread pool.
+/// Uses AVX2 or SSE2 kernels when the CPU supports them and falls back to scalar code otherwise. In linear light, every source row is decoded to
+/// 15-bit linear channels before the horizontal pass, the intermediate rows keep the 15-bit channels in a ring per band, and every destination row is encoded after
+/// the vertical pass.
+/// </summary>
+class Scaler
+{
+public:
+    static constexpr UINT MaxDecodeScale = 8;
+
+    static HRESULT Scale(const Raster & src, Raster & dst, UINT width, UINT height, ScaleFilter filter = ScaleFilter::Lanczos3, ThreadPool * threadPool = nullptr, ColorSpace colorSpace = ColorSpace::SRGB) noexcept;
+    static HRESULT Fit(const Raster & src, Raster & dst, UINT maxWidth, UINT maxHeight, ScaleFilter filter = ScaleFilter::Lanczos3, ThreadPool * threadPool = nullptr, ColorSpace colorSpace = ColorSpace::SRGB) noexcept;
+
+    static void GetFitSize(UINT width, UINT height, UINT maxWidth, UINT maxHeight, UINT & fitWidth, UINT & fitHeight) noexcept;
+    static UINT GetDecodeScale(UINT width, UINT height, UINT maxWidth, UINT maxHeight) noexcept;
+
+    static InstructionSet GetInstructionSet() noexcept;
+    static void SetInstructionSet(InstructionSet instructionSet) noexcept;
+};
+
+/// <summary>
+/// Scales a premultiplied BGRA image that arrives as a stream of rows, top to bottom, without ever holding the whole image. Every incoming row is first
+/// box-filtered by the largest power of two that keeps the image at least as large as the destination (the level the mip chain would select),
+/// then resampled horizontally into a ring of rows that feeds the vertical filter. Memory is proportional to the destination size plus a strip
+/// of source rows, so images far larger than memory can be scaled straight from the decoder.
+/// </summary>
+class StreamingScaler
+{
+public:
+    static constexpr UINT StripRows = 16;  // Source rows read at a time by Scale and Fit
+
+    typedef std::function<HRESULT(UINT y, UINT count, BYTE * data, UINT stride)> RowReader; // Reads source rows y to y + count - 1 in PBGRA32.
+
+    StreamingScaler() noexcept : _SrcWidth(), _SrcHeight(), _BlockWidth(), _BlockHeight(), _ReducedWidth(), _ReducedHeight(), _RowsWritten(), _RowsReduced(), _NextRow(), _Capacity(), _Horizontal(), _Vertical(), _ThreadPool() { }
+
+    HRESULT Initialize(UINT srcWidth, UINT srcHeight, UINT width, UINT height, ScaleFilter filter = ScaleFilter::Lanczos3, ThreadPool * threadPool = nullptr) noexcept;
+    HRESULT Write(const BYTE * data, UINT stride, UINT count) noexcept;
+    HRESULT GetResult(Raster & dst) noexcept;
+
+    size_t GetSize() const noexcept;
+
+    static HRESULT Scale(UINT srcWidth, UINT srcHeight, const RowReader & reader, Raster & dst, UINT width, UINT height, ScaleFilter filter = ScaleFilter::Lanczos3, ThreadPool * threadPool = nullptr) noexcept;
+    static HRESULT Fit(UINT srcWidth, UINT srcHeight, const RowReader & reader, Raster & dst, UINT maxWidth, UINT maxHeight, ScaleFilter filter = ScaleFilter::Lanczos3, ThreadPool * threadPool = nullptr) noexcept;
+
+private:
+    typedef void (* HorizontalFunction)(const BYTE * src, uint32_t * dst, UINT width, const ScaleWeights & weights);
+    typedef void (* VerticalFunction)(const BYTE * const * rows, const int16_t * weights, UINT taps, uint32_t * dst, UINT x, UINT width);
+
+    void Reduce(const BYTE * data, UINT stride, UINT count, UINT begin, UINT end) noexcept;
+    void Resample(const BYTE * const * rows, UINT count) noexcept;
+
+private:
+    UINT _SrcWidth;
+    UINT _SrcHeight;
+
+    UINT _BlockWidth;                   // Size of the box filter, a power of two
+    UINT _BlockHeight;
+    UINT _ReducedWidth;                 // Size of the image after the box filter
+    UINT _ReducedHeight;
+
+    UINT _RowsWritten;                  // Source rows written so far
+    UINT _RowsReduced;                  // Box-filtered rows resampled into the ring so far
+    UINT _NextRow;                      // Next destination row
+
+    ScaleWeights _HWeights;
+    ScaleWeights _VWeights;
+
+    std::vector<uint32_t> _Sums;        // Channel sums of the box filter, per column of the reduced image
+    Raster _Band;                       // Box-filtered rows of the current strip
+    Raster _Ring;                       // Horizontally resampled rows, indexed by row modulo capacity
+    UINT _Capacity;
+    std::vector<const BYTE *> _RingRows; // The rows of the ring, twice, so that the taps of any destination row are consecutive entries
+
+    Raster _Dst;
+
+    HorizontalFunction _Horizontal;
+    VerticalFunction _Vertical;
+
+    ThreadPool * _ThreadPool;
+};
@@ -0,0 +1,686 @@
+
+/** $VER: SoftwareCompositor.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "SoftwareCompositor.h"
+
+#include <new>
+#include <string.h>
+#include <vector>
+
+/// <summary>
+/// Multiplies all channels of a premultiplied pixel with a coverage value (0 - 255).
+/// </summary>
+static inline uint32_t Scale(uint32_t pixel, uint32_t coverage) noexcept
+{
+    uint32_t rb = (pixel & 0x00FF00FF) * coverage + 0x00800080;
+    uint32_t ag = ((pixel >> 8) & 0x00FF00FF) * coverage + 0x00800080;
+
+    rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+    ag = (ag + ((ag >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+
+    return rb | ag;
+}
+
+/// <summary>
+/// Blends a premultiplied source pixel over a premultiplied destination pixel.
+/// </summary>
+static inline uint32_t BlendOver(uint32_t s, uint32_t d) noexcept
+{
+    const uint32_t Alpha = s >> 24;
+
+    if (Alpha == 255)
+        return s;
+
+    if (s == 0)
+        return d;
+
+    return s + Scale(d, 255 - Alpha);
+}
+
+/// <summary>
+/// Interpolates between 2 premultiplied pixels. The weight of the second pixel is 0 - 256.
+/// </summary>
+static inline uint32_t Lerp(uint32_t p0, uint32_t p1, uint32_t weight) noexcept
+{
+    const uint32_t w0 = 256 - weight;
+
+    const uint32_t rb = (((p0 & 0x00FF00FF) * w0 + (p1 & 0x00FF00FF) * weight + 0x00800080) >> 8) & 0x00FF00FF;
+    const uint32_t ag = (((p0 >> 8) & 0x00FF00FF) * w0 + ((p1 >> 8) & 0x00FF00FF) * weight + 0x00800080) & 0xFF00FF00;
+
+    return rb | ag;
+}
+
+/// <summary>
+/// Initializes this instance with a transparent target of the specified size.
+/// </summary>
+HRESULT SoftwareCompositor::Initialize(UINT width, UINT height) noexcept
+{
+    return _Target.Initialize(width, height, PixelFormat::PBGRA32);
+}
+
+/// <summary>
+/// Blends a premultiplied layer into the target at the specified offset.
+/// </summary>
+HRESULT SoftwareCompositor::Compose(const Raster & layer, int x, int y, BlendMode mode) noexcept
+{
+    return Blender::Blend(layer, _Target, x, y, GetClip(), mode);
+}
+
+/// <summary>
+/// Blends a premultiplied layer into the target, scaled with nearest-neighbor sampling and faded with an opacity (0 - 1). The top-left corner of the layer is placed at (x, y).
+/// Each row is transformed into a buffer first so that the blending itself uses the SIMD kernels.
+/// </summary>
+HRESULT SoftwareCompositor::Compose(const Raster & layer, FLOAT x, FLOAT y, FLOAT scaleX, FLOAT scaleY, FLOAT opacity) noexcept
+{
+    if (layer.IsEmpty() || (scaleX <= 0.f) || (scaleY <= 0.f) || (opacity <= 0.f))
+        return S_OK;
+
+    if (layer.Format() != PixelFormat::PBGRA32)
+        return E_INVALIDARG;
+
+    if ((scaleX == 1.f) && (scaleY == 1.f) && (opacity >= 1.f))
+        return Compose(layer, (int) std::floor(x + .5f), (int) std::floor(y + .5f));
+
+    const RectI Bounds = GetPixelBounds({ x, y, x + (FLOAT) layer.Width() * scaleX, y + (FLOAT) layer.Height() * scaleY });
+
+    if (Bounds.IsEmpty())
+        return S_OK;
+
+    const UINT Width = (UINT) Bounds.Width();
+
+    try
+    {
+        _Row.resize(Width);
+        _Columns.resize(Width);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    for (UINT i = 0; i < Width; ++i)
+        _Columns[i] = (UINT) std::clamp((int) (((FLOAT) (Bounds.left + (int) i) + .5f - x) / scaleX), 0, (int) layer.Width() - 1);
+
+    const uint32_t Alpha = (uint32_t) (std::clamp(opacity, 0.f, 1.f) * 255.f + .5f);
+    const Blender::SpanFunction BlendSpan = Blender::GetSpanFunction(BlendMode::SourceOver, Blender::GetInstructionSet(), false);
+
+    for (int ty = Bounds.top; ty < Bounds.bottom; ++ty)
+    {
+        const UINT sy = (UINT) std::clamp((int) (((FLOAT) ty + .5f - y) / scaleY), 0, (int) layer.Height() - 1);
+
+        const uint32_t * s = (const uint32_t *) layer.Row(sy);
+
+        if (Alpha == 255)
+        {
+            for (UINT i = 0; i < Width; ++i)
+                _Row[i] = s[_Columns[i]];
+        }
+        else
+        {
+            for (UINT i = 0; i < Width; ++i)
+                _Row[i] = Scale(s[_Columns[i]], Alpha);
+        }
+
+        BlendSpan(_Row.data(), (uint32_t *) _Target.Row((UINT) ty) + Bounds.left, Width);
+    }
+
+    return S_OK;
+}
+
+/// <summary>
+/// Creates a bitmap from a premultiplied BGRA raster.
+/// </summary>
+HRESULT SoftwareCompositor::CreateBitmap(const Raster & raster, std::unique_ptr<Bitmap> & bitmap) noexcept
+{
+    if (raster.Format() != PixelFormat::PBGRA32)
+        return E_INVALIDARG;
+
+    Raster Copy;
+
+    HRESULT hr = Copy.CopyFrom(raster);
+
+    if (FAILED(hr))
+        return hr;
+
+    try
+    {
+        bitmap = std::make_unique<SoftwareBitmap>(std::move(Copy));
+    }
+    catch (const std::bad_alloc &)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    return S_OK;
+}
+
+/// <summary>
+/// Creates a text format. The software compositor always uses the built-in font.
+/// </summary>
+HRESULT SoftwareCompositor::CreateTextFormat(const WCHAR *, FLOAT fontSize, TextAlignment textAlignment, ParagraphAlignment paragraphAlignment, std::unique_ptr<TextFormat> & textFormat) noexcept
+{
+    try
+    {
+        textFormat = std::make_unique<SoftwareTextFormat>(fontSize, textAlignment, paragraphAlignment);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    return S_OK;
+}
+
+/// <summary>
+/// Replaces all pixels of the target, inside the clip rectangle, with the specified color.
+/// </summary>
+void SoftwareCompositor::Clear(const Color & color) noexcept
+{
+    const uint32_t Pixel = color.ToPBGRA();
+    const RectI Clip = GetClip();
+
+    for (int y = Clip.top; y < Clip.bottom; ++y)
+    {
+        uint32_t * d = (uint32_t *) _Target.Row((UINT) y);
+
+        std::fill(d + Clip.left, d + Clip.right, Pixel);
+    }
+}
+
+/// <summary>
+/// Fills a rectangle by tiling a pattern bitmap, anchored at the origin of the target. Every distinct row of the pattern is tiled once into a buffer
+/// with wrapped span copies; the rows of the rectangle are then blended from the buffer with the SIMD kernels.
+/// </summary>
+void SoftwareCompositor::FillRectangle(const RectF & rect, const Bitmap * pattern) noexcept
+{
+    if (pattern == nullptr)
+        return;
+
+    const Raster & Pattern = static_cast<const SoftwareBitmap *>(pattern)->GetRaster();
+    const RectI Bounds = GetPixelBounds(rect);
+
+    if (Bounds.IsEmpty() || Pattern.IsEmpty())
+        return;
+
+    const UINT Width = (UINT) Bounds.Width();
+    const UINT Rows = (std::min)(Pattern.Height(), (UINT) Bounds.Height());
+
+    // Big patterns are tiled one row at a time.
+    const UINT CachedRows = ((size_t) Rows * Width <= MaxTilePixels) ? Rows : 1;
+
+    try
+    {
+        _Row.resize((size_t) CachedRows * Width);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return;
+    }
+
+    const UINT PatternWidth = Pattern.Width();
+
+    auto TileRow = [&](int y, uint32_t * t)
+    {
+        const uint32_t * s = (const uint32_t * ) Pattern.Row((UINT) y % Pattern.Height());
+
+        const UINT Phase = (UINT) Bounds.left % PatternWidth;
+        const UINT Count = (std::min)(PatternWidth, Width);
+
+        for (UINT i = 0; i < Count; ++i)
+            t[i] = s[(Phase + i) % PatternWidth];
+
+        // Double the tiled part until the row is full. The copied part is always a whole number of periods.
+        for (UINT n = Count; n < Width; n *= 2)
+            ::memcpy(t + n, t, (size_t) (std::min)(n, Width - n) * 4);
+    };
+
+    if (CachedRows == Rows)
+    {
+        for (UINT i = 0; i < Rows; ++i)
+            TileRow(Bounds.top + (int) i, _Row.data() + (size_t) i * Width);
+    }
+
+    const Blender::SpanFunction BlendSpan = Blender::GetSpanFunction(BlendMode::SourceOver, Blender::GetInstructionSet(), false);
+
+    for (int y = Bounds.top; y < Bounds.bottom; ++y)
+    {
+        const uint32_t * t = _Row.data();
+
+        if (CachedRows == Rows)
+            t += (size_t) ((UINT) (y - Bounds.top) % Rows) * Width;
+        else
+            TileRow(y, _Row.data());
+
+        BlendSpan(t, (uint32_t *) _Target.Row((UINT) y) + Bounds.left, Width);
+    }
+}
+
+/// <summary>
+/// Draws a bitmap stretched to the specified rectangle. A bitmap at its own size is blended directly at an integer offset and bilinearly interpolated
+/// at a fractional offset; a stretched bitmap uses nearest-neighbor sampling.
+/// </summary>
+void SoftwareCompositor::DrawBitmap(const Bitmap * bitmap, const RectF & rect) noexcept
+{
+    if ((bitmap == nullptr) || (rect.Width() <= 0.f) || (rect.Height() <= 0.f))
+        return;
+
+    const Raster & Source = static_cast<const SoftwareBitmap *>(bitmap)->GetRaster();
+
+    if (Source.IsEmpty())
+        return;
+
+    const bool IsStretched = (std::abs(rect.Width() - (FLOAT) Source.Width()) > 1.f / 256.f) || (std::abs(rect.Height() - (FLOAT) Source.Height()) > 1.f / 256.f);
+
+    if (IsStretched)
+    {
+        Compose(Source, rect.left, rect.top, rect.Width() / (FLOAT) Source.Width(), rect.Height() / (FLOAT) Source.Height(), 1.f);
+
+        return;
+    }
+
+    // Target pixel x gets (1 - w) * S[x - ox - 1] + w * S[x - ox], with w the weight of the source pixel to the right.
+    int ox = (int) std::floor(rect.left);
+    int oy = (int) std::floor(rect.top);
+
+    UINT wx = (UINT) std::lround((1.f - (rect.left - (FLOAT) ox)) * 256.f);
+    UINT wy = (UINT) std::lround((1.f - (rect.top  - (FLOAT) oy)) * 256.f);
+
+    if (wx == 0)
+        ++ox, wx = 256;
+
+    if (wy == 0)
+        ++oy, wy = 256;
+
+    if ((wx == 256) && (wy == 256))
+    {
+        Compose(Source, ox, oy);
+
+        return;
+    }
+
+    const int SourceWidth  = (int) Source.Width();
+    const int SourceHeight = (int) Source.Height();
+
+    const RectI Bounds = Region::Intersect({ ox, oy, ox + SourceWidth + (wx != 256), oy + SourceHeight + (wy != 256) }, GetClip());
+
+    if (Bounds.IsEmpty())
+        return;
+
+    const UINT Width = (UINT) Bounds.Width();
+
+    // The buffer holds 2 horizontally interpolated source rows, shared by consecutive target rows, and the interpolated target row.
+    try
+    {
+        _Row.resize((size_t) Width * 3);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return;
+    }
+
+    const Blender::LerpFunction LerpSpan = Blender::GetLerpFunction(Blender::GetInstructionSet());
+
+    // Interpolates a source row horizontally. Pixels outside the source are transparent, which anti-aliases the edges.
+    auto InterpolateRow = [&](int sy, uint32_t * t) noexcept
+    {
+        if ((sy < 0) || (sy >= SourceHeight))
+        {
+            ::memset(t, 0, (size_t) Width * 4);
+
+            return;
+        }
+
+        const uint32_t * s = (const uint32_t *) Source.Row((UINT) sy);
+
+        int sx = Bounds.left - ox;
+
+        const int Last = sx + (int) Width;
+        const int End = (std::min)(Last, SourceWidth);
+
+        // Only the first and the last pixel of the span can fall outside the source.
+        if (sx == 0)
+        {
+            *t++ = Lerp(0, s[0], wx);
+            ++sx;
+        }
+
+        if (End > sx)
+        {
+            if (wx == 256)
+                ::memcpy(t, s + sx, (size_t) (End - sx) * 4);
+            else
+                LerpSpan(s + sx - 1, s + sx, t, (UINT) (End - sx), wx);
+
+            t += End - sx;
+            sx = End;
+        }
+
+        if (sx < Last)
+            *t = Lerp(s[SourceWidth - 1], 0, wx);
+    };
+
+    const Blender::SpanFunction BlendSpan = Blender::GetSpanFunction(BlendMode::SourceOver, Blender::GetInstructionSet(), false);
+
+    uint32_t * Top    = _Row.data();
+    uint32_t * Bottom = _Row.data() + Width;
+    uint32_t * Result = _Row.data() + Width * 2;
+
+    if (wy != 256)
+        InterpolateRow(Bounds.top - oy - 1, Bottom);
+
+    for (int y = Bounds.top; y < Bounds.bottom; ++y)
+    {
+        std::swap(Top, Bottom);
+
+        InterpolateRow(y - oy, Bottom);
+
+        if (wy != 256)
+            LerpSpan(Top, Bottom, Result, Width, wy);
+
+        BlendSpan((wy != 256) ? Result : Bottom, (uint32_t *) _Target.Row((UINT) y) + Bounds.left, Width);
+    }
+}
+
+/// <summary>
+/// Fills an anti-aliased ellipse. The coverage of a pixel is estimated from its distance to the outline. Coverage is only computed for the pixels
+/// near the outline; the pixels in between are filled with a solid SIMD span. In linear light the edge pixels are filled as spans of 1 pixel.
+/// </summary>
+void SoftwareCompositor::FillEllipse(const PointF & center, FLOAT radiusX, FLOAT radiusY, const Color & color) noexcept
+{
+    if ((radiusX <= 0.f) || (radiusY <= 0.f))
+        return;
+
+    const uint32_t Pixel = color.ToPBGRA();
+    const RectI Bounds = GetPixelBounds({ center.x - radiusX - 1.f, center.y - radiusY - 1.f, center.x + radiusX + 1.f, center.y + radiusY + 1.f });
+
+    const bool IsLinear = (_ColorSpace == ColorSpace::Linear);
+
+    const Blender::FillFunction Fill = IsLinear ? LinearLight::GetFillFunction(LinearLight::GetInstructionSet()) : Blender::GetFillFunction(Blender::GetInstructionSet());
+
+    for (int y = Bounds.top; y < Bounds.bottom; ++y)
+    {
+        uint32_t * d = (uint32_t *) _Target.Row((UINT) y);
+
+        const FLOAT v = ((FLOAT) y + .5f - center.y) / radiusY;
+
+        // Signed distance to the outline: the implicit function divided by the length of its gradient.
+        auto GetCoverage = [&](int x) noexcept -> uint32_t
+        {
+            const FLOAT u = ((FLOAT) x + .5f - center.x) / radiusX;
+
+            const FLOAT F = u * u + v * v - 1.f;
+            const FLOAT Gx = 2.f * u / radiusX;
+            const FLOAT Gy = 2.f * v / radiusY;
+            const FLOAT G = std::sqrt(Gx * Gx + Gy * Gy);
+
+            const FLOAT Distance = (G > 1e-6f) ? F / G : -1.f;
+
+            return (uint32_t) (std::clamp(.5f - Distance, 0.f, 1.f) * 255.f + .5f);
+        };
+
+        // Start near the outline: the half-width of the ellipse at the row edge closest to the center, widened by 2 pixels.
+        const FLOAT Dy = (std::max)(std::abs((FLOAT) y + .5f - center.y) - 1.f, 0.f) / radiusY;
+        const FLOAT HalfWidth = (Dy < 1.f) ? radiusX * std::sqrt(1.f - Dy * Dy) : 0.f;
+
+        int Left  = (std::max)(Bounds.left,  (int) std::floor(center.x - HalfWidth) - 2);
+        int Right = (std::min)(Bounds.right, (int) std::ceil (center.x + HalfWidth) + 2);
+
+        // Walk inwards from both ends until the coverage is complete.
+        while (Left < Right)
+        {
+            const uint32_t Coverage = GetCoverage(Left);
+
+            if (Coverage == 255)
+                break;
+
+            if (Coverage != 0)
+            {
+                if (IsLinear)
+                    Fill(Scale(Pixel, Coverage), d + Left, 1);
+                else
+                    d[Left] = BlendOver(Scale(Pixel, Coverage), d[Left]);
+            }
+
+            ++Left;
+        }
+
+        while (Right > Left)
+        {
+            const uint32_t Coverage = GetCoverage(Right - 1);
+
+            if (Coverage == 255)
+                break;
+
+            if (Coverage != 0)
+            {
+                if (IsLinear)
+                    Fill(Scale(Pixel, Coverage), d + Right - 1, 1);
+                else
+                    d[Right - 1] = BlendOver(Scale(Pixel, Coverage), d[Right - 1]);
+            }
+
+            --Right;
+        }
+
+        if (Left < Right)
+            Fill(Pixel, d + Left, (UINT) (Right - Left));
+    }
+}
+
+/// <summary>
+/// Draws text with the built-in font. Lines are wrapped at spaces to fit the width of the layout rectangle. The line breaks come from the text layout cache.
+/// </summary>
+void SoftwareCompositor::DrawString(const WCHAR * text, UINT length, const TextFormat * textFormat, const RectF & rect, const Color & color) noexcept
+{
+    if ((text == nullptr) || (length == 0) || (textFormat == nullptr))
+        return;
+
+    const SoftwareTextFormat * Format = static_cast<const SoftwareTextFormat *>(textFormat);
+    const Font & TextFont = Format->GetFont();
+
+    const std::vector<TextLine> * Lines = nullptr;
+
+    if (FAILED(_TextLayoutCache.Get(text, length, TextFont, rect.Width(), &Lines)))
+        return;
+
+    const FLOAT TextHeight = TextFont.LineHeight() * (FLOAT) Lines->size();
+
+    FLOAT y = rect.top;
+
+    if (Format->GetParagraphAlignment() == ParagraphAlignment::Center)
+        y += (rect.Height() - TextHeight) / 2.f;
+    else
+    if (Format->GetParagraphAlignment() == ParagraphAlignment::Far)
+        y += rect.Height() - TextHeight;
+
+    const RectI Clip = GetClip();
+    const uint32_t Pixel = color.ToPBGRA();
+
+    for (const TextLine & l : *Lines)
+    {
+        FLOAT x = rect.left;
+
+        if (Format->GetTextAlignment() == TextAlignment::Center)
+            x += (rect.Width() - l.Width) / 2.f;
+        else
+        if (Format->GetTextAlignment() == TextAlignment::Trailing)
+            x += rect.Width() - l.Width;
+
+        DrawLine(text + l.Offset, l.Length, TextFont, x, y, Clip, Pixel);
+
+        y += TextFont.LineHeight();
+    }
+}
+
+/// <summary>
+/// Restricts drawing to a rectangle, in pixels, inside the current clip rectangle.
+/// </summary>
+void SoftwareCompositor::PushClip(const RectI & rect) noexcept
+{
+    try
+    {
+        _Clips.push_back(Region::Intersect(GetClip(), rect));
+    }
+    catch (const std::bad_alloc &)
+    {
+        _Clips.clear(); // Drawing too much is better than drawing too little.
+    }
+}
+
+/// <summary>
+/// Restores the clip rectangle of the previous PushClip.
+/// </summary>
+void SoftwareCompositor::PopClip() noexcept
+{
+    if (!_Clips.empty())
+        _Clips.pop_back();
+}
+
+/// <summary>
+/// Presents the frame: copies the target to the front buffer, if there is one.
+/// </summary>
+HRESULT SoftwareCompositor::Present() noexcept
+{
+    if (_FrontBuffer == nullptr)
+    {
+        ++_FrameCount;
+
+        return S_OK;
+    }
+
+    return Present(Region({ 0, 0, (int) _Target.Width(), (int) _Target.Height() }));
+}
+
+/// <summary>
+/// Presents the frame: copies the dirty region of the target to the front buffer, if there is one. The rest of the front buffer keeps the previous frame.
+/// </summary>
+HRESULT SoftwareCompositor::Present(const Region & dirtyRegion) noexcept
+{
+    ++_FrameCount;
+
+    if (_FrontBuffer == nullptr)
+        return S_OK;
+
+    // A front buffer of a different size has no usable previous frame.
+    if ((_FrontBuffer->Width() != _Target.Width()) || (_FrontBuffer->Height() != _Target.Height()) || (_FrontBuffer->Format() != _Target.Format()))
+        return _FrontBuffer->CopyFrom(_Target);
+
+    for (const RectI & Rect : dirtyRegion.GetRects())
+    {
+        const ConstRasterView Src = _Target.GetView(Rect);
+
+        if (Src.IsEmpty())
+            continue;
+
+        const RasterView Dst = _FrontBuffer->GetView(Rect);
+        const size_t Size = (size_t) Src.Width() * 4;
+
+        for (UINT y = 0; y < Src.Height(); ++y)
+            ::memcpy(Dst.Row(y), Src.Row(y), Size);
+    }
+
+    return S_OK;
+}
+
+/// <summary>
+/// Gets the current clip rectangle, in pixels. Without a clip rectangle drawing is only clipped by the target.
+/// </summary>
+RectI SoftwareCompositor::GetClip() const noexcept
+{
+    if (_Clips.empty())
+        return { 0, 0, (int) _Target.Width(), (int) _Target.Height() };
+
+    return _Clips.back();
+}
+
+/// <summary>
+/// Gets the pixels whose centers lie inside the specified rectangle, clipped to the clip rectangle.
+/// </summary>
+RectI SoftwareCompositor::GetPixelBounds(const RectF & rect) const noexcept
+{
+    const RectI Bounds =
+    {
+        (int) std::floor(rect.left   + .5f),
+        (int) std::floor(rect.top    + .5f),
+        (int) std::floor(rect.right  + .5f),
+        (int) std::floor(rect.bottom + .5f),
+    };
+
+    return Region::Intersect(Bounds, GetClip());
+}
+
+/// <summary>
+/// Draws a single line of text. The glyphs are positioned at a quarter pixel and blended from the glyph cache.
+/// </summary>
+void SoftwareCompositor::DrawLine(const WCHAR * text, UINT length, const Font & font, FLOAT x, FLOAT y, const RectI & clip, uint32_t color) noexcept
+{
+    const int SubpixelPositions = (int) GlyphCache::SubpixelPositions;
+
+    const int Top = (int) std::floor((y + font.GlyphTop()) * (FLOAT) SubpixelPositions + .5f);
+
+    const int Upper = (int) std::floor((FLOAT) Top / (FLOAT) SubpixelPositions);
+    const UINT PhaseY = (UINT) (Top - Upper * SubpixelPositions);
+
+    for (UINT i = 0; i < length; ++i, x += font.Advance())
+    {
+        if (text[i] == L' ')
+            continue;
+
+        const int Origin = (int) std::floor(x * (FLOAT) SubpixelPositions + .5f);
+
+        const int Left = (int) std::floor((FLOAT) Origin / (FLOAT) SubpixelPositions);
+        const UINT PhaseX = (UINT) (Origin - Left * SubpixelPositions);
+
+        CachedGlyph Glyph;
+
+        if (SUCCEEDED(_GlyphCache.GetGlyph(font, text[i], PhaseX, PhaseY, Glyph)))
+        {
+            if (Glyph.Width != 0)
+                BlendMask(_GlyphCache.GetRow(Glyph, 0), _GlyphCache.GetStride(), Glyph.Width, Glyph.Height, Left, Upper, clip, color);
+
+            continue;
+        }
+
+        // Glyphs that do not fit in a page of the cache are rasterized every time.
+        UINT Width, Height;
+
+        GlyphCache::GetSize(font, PhaseX, PhaseY, Width, Height);
+
+        try
+        {
+            _Coverage.resize((size_t) Width * Height);
+        }
+        catch (const std::bad_alloc &)
+        {
+            return;
+        }
+
+        GlyphCache::Rasterize(font, text[i], PhaseX, PhaseY, _Coverage.data(), Width, Width, Height);
+
+        BlendMask(_Coverage.data(), Width, Width, Height, Left, Upper, clip, color);
+    }
+}
+
+/// <summary>
+/// Blends a color into the target through an 8-bit coverage mask.
+/// </summary>
+void SoftwareCompositor::BlendMask(const BYTE * mask, size_t stride, UINT width, UINT height, int x, int y, const RectI & clip, uint32_t color) noexcept
+{
+    const RectI Bounds = Region::Intersect({ x, y, x + (int) width, y + (int) height }, clip);
+
+    for (int py = Bounds.top; py < Bounds.bottom; ++py)
+    {
+        const BYTE * m = mask + (size_t) (py - y) * stride;
+        uint32_t * d = (uint32_t *) _Target.Row((UINT) py);
+
+        for (int px = Bounds.left; px < Bounds.right; ++px)
+        {
+            const uint32_t Coverage = m[px - x];
+
+            if (Coverage != 0)
+                d[px] = BlendOver(Scale(color, Coverage), d[px]);
+        }
+    }
+}
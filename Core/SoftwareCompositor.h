@@ -0,0 +1,122 @@
+
+/** $VER: SoftwareCompositor.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+#include "Compositor.h"
+#include "Raster.h"
+#include "Font.h"
+#include "GlyphCache.h"
+#include "TextLayout.h"
+#include "Blender.h"
+#include "LinearLight.h"
+#include "Region.h"
+
+#include <vector>
+
+/// <summary>
+/// Represents a bitmap in system memory.
+/// </summary>
+class SoftwareBitmap : public Bitmap
+{
+public:
+    SoftwareBitmap(Raster && raster) noexcept : _Raster(std::move(raster)) { }
+
+    SizeF GetSize() const noexcept override { return { (FLOAT) _Raster.Width(), (FLOAT) _Raster.Height() }; }
+
+    const Raster & GetRaster() const noexcept { return _Raster; }
+
+private:
+    Raster _Raster;
+};
+
+/// <summary>
+/// Represents the text format of the built-in font.
+/// </summary>
+class SoftwareTextFormat : public TextFormat
+{
+public:
+    SoftwareTextFormat(FLOAT fontSize, TextAlignment textAlignment, ParagraphAlignment paragraphAlignment) noexcept : _Font(fontSize), _TextAlignment(textAlignment), _ParagraphAlignment(paragraphAlignment) { }
+
+    const Font & GetFont() const noexcept { return _Font; }
+
+    TextAlignment GetTextAlignment() const noexcept { return _TextAlignment; }
+    ParagraphAlignment GetParagraphAlignment() const noexcept { return _ParagraphAlignment; }
+
+private:
+    Font _Font;
+    TextAlignment _TextAlignment;
+    ParagraphAlignment _ParagraphAlignment;
+};
+
+/// <summary>
+/// Implements a compositor that renders into a premultiplied BGRA raster in system memory. 1 DIP equals 1 pixel.
+/// Presenting copies the target, or only its dirty region, to the front buffer, if there is one.
+/// </summary>
+class SoftwareCompositor : public Compositor
+{
+public:
+    SoftwareCompositor() : _FrontBuffer(), _FrameCount(), _ColorSpace(ColorSpace::SRGB) { }
+
+    HRESULT Initialize(UINT width, UINT height) noexcept;
+
+    const Raster & GetTarget() const noexcept { return _Target; }
+    uint64_t GetFrameCount() const noexcept { return _FrameCount; }
+
+    void SetFrontBuffer(Raster * frontBuffer) noexcept { _FrontBuffer = frontBuffer; }
+
+    ColorSpace GetColorSpace() const noexcept { return _ColorSpace; }
+    void SetColorSpace(ColorSpace colorSpace) noexcept { _ColorSpace = colorSpace; } // Space in which translucent fills are blended
+
+    GlyphCache & GetGlyphCache() noexcept { return _GlyphCache; }
+    const GlyphCache & GetGlyphCache() const noexcept { return _GlyphCache; }
+
+    TextLayoutCache & GetTextLayoutCache() noexcept { return _TextLayoutCache; }
+    const TextLayoutCache & GetTextLayoutCache() const noexcept { return _TextLayoutCache; }
+
+    HRESULT Compose(const Raster & layer, int x, int y, BlendMode mode = BlendMode::SourceOver) noexcept;
+    HRESULT Compose(const Raster & layer, FLOAT x, FLOAT y, FLOAT scaleX, FLOAT scaleY, FLOAT opacity) noexcept;
+
+    // Compositor
+    SizeF GetSize() const noexcept override { return { (FLOAT) _Target.Width(), (FLOAT) _Target.Height() }; }
+
+    HRESULT CreateBitmap(const Raster & raster, std::unique_ptr<Bitmap> & bitmap) noexcept override;
+    HRESULT CreateTextFormat(const WCHAR * fontName, FLOAT fontSize, TextAlignment textAlignment, ParagraphAlignment paragraphAlignment, std::unique_ptr<TextFormat> & textFormat) noexcept override;
+
+    void BeginDraw() noexcept override { }
+    HRESULT EndDraw() noexcept override { return S_OK; }
+
+    void PushClip(const RectI & rect) noexcept override;
+    void PopClip() noexcept override;
+
+    void Clear(const Color & color) noexcept override;
+    void FillRectangle(const RectF & rect, const Bitmap * pattern) noexcept override;
+    void DrawBitmap(const Bitmap * bitmap, const RectF & rect) noexcept override;
+    void FillEllipse(const PointF & center, FLOAT radiusX, FLOAT radiusY, const Color & color) noexcept override;
+    void DrawString(const WCHAR * text, UINT length, const TextFormat * textFormat, const RectF & rect, const Color & color) noexcept override;
+
+    HRESULT Present() noexcept override;
+    HRESULT Present(const Region & dirtyRegion) noexcept override;
+
+private:
+    RectI GetClip() const noexcept;
+    RectI GetPixelBounds(const RectF & rect) const noexcept;
+
+    void DrawLine(const WCHAR * text, UINT length, const Font & font, FLOAT x, FLOAT y, const RectI & clip, uint32_t color) noexcept;
+    void BlendMask(const BYTE * mask, size_t stride, UINT width, UINT height, int x, int y, const RectI & clip, uint32_t color) noexcept;
+
+private:
+    static constexpr size_t MaxTilePixels = 1024 * 1024; // Maximum size of the buffer with the tiled rows of a pattern
+
+    Raster _Target;
+    Raster * _FrontBuffer;      // Receives the presented pixels, if set.
+    std::vector<RectI> _Clips;  // Clip stack. Every entry is already intersected with the previous one.
+    std::vector<uint32_t> _Row; // Rows of a transformed layer, a tiled pattern or an interpolated bitmap
+    std::vector<UINT> _Columns; // Source column of every pixel of a transformed layer
+    GlyphCache _GlyphCache;
+    TextLayoutCache _TextLayoutCache;
+    std::vector<BYTE> _Coverage; // Coverage of a glyph that is too large for the glyph cache
+    uint64_t _FrameCount;
+    ColorSpace _ColorSpace;
+};
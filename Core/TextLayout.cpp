@@ -0,0 +1,189 @@
+
+/** $VER: TextLayout.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "TextLayout.h"
+
+#include <new>
+#include <string.h>
+
+/// <summary>
+/// Gets the lines of a string laid out in a box of the specified width. The lines remain valid until the next call.
+/// </summary>
+HRESULT TextLayoutCache::Get(const WCHAR * text, UINT length, const Font & font, FLOAT width, const std::vector<TextLine> ** lines) noexcept
+{
+    if ((text == nullptr) || (lines == nullptr))
+        return E_INVALIDARG;
+
+    const UINT MaxChars = (std::max)((UINT) (width / font.Advance()), 1u);
+    const uint64_t Hash = GetHash(text, length);
+
+    for (auto Entry = _Layouts.begin(); Entry != _Layouts.end(); ++Entry)
+    {
+        if ((Entry->Hash != Hash) || (Entry->FontSize != font.FontSize()) || (Entry->Text.size() != length) || (::memcmp(Entry->Text.data(), text, length * sizeof(WCHAR)) != 0))
+            continue;
+
+        _Layouts.splice(_Layouts.begin(), _Layouts, Entry);
+
+        if (Entry->Width == width)
+            ++_Hits;
+        else
+        if ((MaxChars >= Entry->MinChars) && (MaxChars <= Entry->MaxChars))
+            ++_Resizes;
+        else
+        {
+            HRESULT hr = BreakLines(text, length, font, MaxChars, Entry->Lines, Entry->MinChars, Entry->MaxChars);
+
+            if (FAILED(hr))
+            {
+                _Layouts.erase(Entry);
+
+                return hr;
+            }
+
+            ++_Relayouts;
+        }
+
+        Entry->Width = width;
+
+        *lines = &Entry->Lines;
+
+        return S_OK;
+    }
+
+    ++_Misses;
+
+    try
+    {
+        _Layouts.push_front({ Hash, std::wstring(text, length), font.FontSize(), width, 0, 0, { } });
+    }
+    catch (const std::bad_alloc &)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    Layout & l = _Layouts.front();
+
+    HRESULT hr = BreakLines(text, length, font, MaxChars, l.Lines, l.MinChars, l.MaxChars);
+
+    if (FAILED(hr))
+    {
+        _Layouts.pop_front();
+
+        return hr;
+    }
+
+    if (_Layouts.size() > MaxLayouts)
+        _Layouts.pop_back();
+
+    *lines = &l.Lines;
+
+    return S_OK;
+}
+
+/// <summary>
+/// Gets the counters of the cache.
+/// </summary>
+TextLayoutStatistics TextLayoutCache::GetStatistics() const noexcept
+{
+    return { _Hits, _Resizes, _Relayouts, _Misses, (UINT) _Layouts.size() };
+}
+
+/// <summary>
+/// Resets the counters of the cache.
+/// </summary>
+void TextLayoutCache::ResetStatistics() noexcept
+{
+    _Hits = 0;
+    _Resizes = 0;
+    _Relayouts = 0;
+    _Misses = 0;
+}
+
+/// <summary>
+/// Gets the FNV-1a hash of a string.
+/// </summary>
+uint64_t TextLayoutCache::GetHash(const WCHAR * text, UINT length) noexcept
+{
+    uint64_t Hash = 14695981039346656037ull;
+
+    for (UINT i = 0; i < length; ++i)
+    {
+        Hash ^= (uint64_t) text[i];
+        Hash *= 1099511628211ull;
+    }
+
+    return Hash;
+}
+
+/// <summary>
+/// Breaks a string into lines of at most the specified number of characters. Lines end at a hard line break or are wrapped at the last space
+/// that fits. Also returns the range of characters per line that produces the same lines: any width if no line had to be wrapped.
+/// </summary>
+HRESULT TextLayoutCache::BreakLines(const WCHAR * text, UINT length, const Font & font, UINT maxChars, std::vector<TextLine> & lines, UINT & minChars, UINT & maxCharsLimit) noexcept
+{
+    lines.clear();
+
+    bool IsWrapped = false;
+    UINT LongestLine = 1;
+
+    try
+    {
+        UINT Start = 0;
+
+        while (Start < length)
+        {
+            // Find the end of the line: a hard line break or the last space before the line overflows.
+            UINT End = Start;
+            UINT Break = length;
+
+            while ((End < length) && (text[End] != L'\n') && (End - Start < maxChars))
+            {
+                if (text[End] == L' ')
+                    Break = End;
+
+                ++End;
+            }
+
+            if ((End < length) && (text[End] != L'\n'))
+                IsWrapped = true;
+
+            LongestLine = (std::max)(LongestLine, End - Start);
+
+            UINT Next = End;
+
+            if ((End < length) && ((text[End] == L'\n') || (text[End] == L' ')))
+                Next = End + 1;
+            else
+            if ((End < length) && (Break != length))
+                End = Break, Next = Break + 1; // Wrap at the last space. Otherwise the word gets broken.
+
+            while ((End > Start) && (text[End - 1] == L' '))
+                --End;
+
+            lines.push_back({ Start, End - Start, font.Measure(text + Start, End - Start) });
+
+            Start = Next;
+        }
+    }
+    catch (const std::bad_alloc &)
+    {
+        lines.clear();
+
+        return E_OUTOFMEMORY;
+    }
+
+    if (IsWrapped)
+    {
+        minChars = maxChars;
+        maxCharsLimit = maxChars;
+    }
+    else
+    {
+        minChars = LongestLine;
+        maxCharsLimit = ~0u;
+    }
+
+    return S_OK;
+}
@@ -0,0 +1,76 @@
+
+/** $VER: TextLayout.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+#include "Font.h"
+
+#include <list>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Contains the counters of a text layout cache.
+/// </summary>
+struct TextLayoutStatistics
+{
+    uint64_t Hits;          // Lookups served by a layout of the same text, format and box
+    uint64_t Resizes;       // Lookups with a different box that were served because the line breaks did not change
+    uint64_t Relayouts;     // Lookups with a different box that required breaking the lines again
+    uint64_t Misses;        // Lookups that required a new layout
+    UINT Layouts;           // Cached layouts
+};
+
+/// <summary>
+/// Represents a line of a text layout: a run of glyphs of the built-in font that starts at an offset in the text.
+/// </summary>
+struct TextLine
+{
+    UINT Offset;
+    UINT Length;
+    FLOAT Width;
+};
+
+/// <summary>
+/// Caches the line breaks of strings drawn with the built-in font, keyed by the hash of the string, the font size and the layout box.
+/// A change of the box only breaks the lines again when the number of characters that fit on a line changes the result, so a resize rarely
+/// invalidates a layout. The least recently used layout is discarded when the cache is full.
+/// </summary>
+class TextLayoutCache
+{
+public:
+    static const UINT MaxLayouts = 16;
+
+    TextLayoutCache() noexcept : _Hits(), _Resizes(), _Relayouts(), _Misses() { }
+
+    HRESULT Get(const WCHAR * text, UINT length, const Font & font, FLOAT width, const std::vector<TextLine> ** lines) noexcept;
+
+    void Clear() noexcept { _Layouts.clear(); }
+
+    TextLayoutStatistics GetStatistics() const noexcept;
+    void ResetStatistics() noexcept;
+
+    static uint64_t GetHash(const WCHAR * text, UINT length) noexcept;
+    static HRESULT BreakLines(const WCHAR * text, UINT length, const Font & font, UINT maxChars, std::vector<TextLine> & lines, UINT & minChars, UINT & maxCharsLimit) noexcept;
+
+private:
+    struct Layout
+    {
+        uint64_t Hash;
+        std::wstring Text;
+        FLOAT FontSize;
+        FLOAT Width;                // Width of the layout box
+        UINT MinChars;              // Range of characters per line that produce the same line breaks
+        UINT MaxChars;
+        std::vector<TextLine> Lines;
+    };
+
+private:
+    std::list<Layout> _Layouts;     // Most recently used first. A linear search is fine for a handful of strings.
+
+    uint64_t _Hits;
+    uint64_t _Resizes;
+    uint64_t _Relayouts;
+    uint64_t _Misses;
+};
@@ -0,0 +1,180 @@
+
+/** $VER: ThreadPool.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "ThreadPool.h"
+
+#include <new>
+
+/// <summary>
+/// Initializes a new instance. A thread count of 0 creates one thread per logical processor.
+/// </summary>
+ThreadPool::ThreadPool(UINT threadCount) : _IsStopping(false)
+{
+    if (threadCount == 0)
+        threadCount = (std::max)(std::thread::hardware_concurrency(), 1u);
+
+    _Threads.reserve(threadCount);
+
+    for (UINT i = 0; i < threadCount; ++i)
+        _Threads.emplace_back(&ThreadPool::Run, this);
+}
+
+/// <summary>
+/// Finishes the queued tasks and stops the worker threads.
+/// </summary>
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> Lock(_Mutex);
+
+        _IsStopping = true;
+    }
+
+    _Condition.notify_all();
+
+    for (auto & Thread : _Threads)
+        Thread.join();
+}
+
+/// <summary>
+/// Queues a task for execution on a worker thread.
+/// </summary>
+HRESULT ThreadPool::Submit(Task task) noexcept
+{
+    try
+    {
+        std::lock_guard<std::mutex> Lock(_Mutex);
+
+        _Tasks.push_back(std::move(task));
+    }
+    catch (const std::bad_alloc &)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    _Condition.notify_one();
+
+    return S_OK;
+}
+
+/// <summary>
+/// Splits the range [0, count) in chunks and processes them on the worker threads and the calling thread. Returns when all chunks have been processed.
+/// The calling thread takes part in the work so it is safe to call this method from a task.
+/// </summary>
+void ThreadPool::ParallelFor(UINT count, const RangeTask & task) noexcept
+{
+    if (count == 0)
+        return;
+
+    // Use a few chunks per thread to even out the load.
+    const UINT ChunkCount = (std::min)(count, (GetThreadCount() + 1) * 4);
+
+    if (ChunkCount == 1)
+    {
+        task(0, count);
+
+        return;
+    }
+
+    struct State
+    {
+        std::atomic<UINT> Next;
+        UINT Done;
+        std::mutex Mutex;
+        std::condition_variable Condition;
+    };
+
+    std::shared_ptr<State> Shared;
+
+    try
+    {
+        Shared = std::make_shared<State>();
+    }
+    catch (const std::bad_alloc &)
+    {
+        task(0, count);
+
+        return;
+    }
+
+    Shared->Next = 0;
+    Shared->Done = 0;
+
+    // Processes chunks until none are left.
+    auto Worker = [Shared, count, ChunkCount, &task]()
+    {
+        UINT Processed = 0;
+
+        for (UINT Chunk = Shared->Next++; Chunk < ChunkCount; Chunk = Shared->Next++)
+        {
+            const UINT Begin = (UINT) (((uint64_t) count * Chunk)       / ChunkCount);
+            const UINT End   = (UINT) (((uint64_t) count * (Chunk + 1)) / ChunkCount);
+
+            task(Begin, End);
+
+            ++Processed;
+        }
+
+        if (Processed != 0)
+        {
+            std::lock_guard<std::mutex> Lock(Shared->Mutex);
+
+            Shared->Done += Processed;
+
+            if (Shared->Done == ChunkCount)
+                Shared->Condition.notify_all();
+        }
+    };
+
+    // Helpers that start after all chunks have been taken return immediately without touching the task.
+    const UINT HelperCount = (std::min)(GetThreadCount(), ChunkCount - 1);
+
+    for (UINT i = 0; i < HelperCount; ++i)
+    {
+        if (FAILED(Submit(Worker)))
+            break;
+    }
+
+    Worker();
+
+    std::unique_lock<std::mutex> Lock(Shared->Mutex);
+
+    Shared->Condition.wait(Lock, [&Shared, ChunkCount]() { return Shared->Done == ChunkCount; });
+}
+
+/// <summary>
+/// Gets the pool shared by the application.
+/// </summary>
+ThreadPool & ThreadPool::GetDefault() noexcept
+{
+    static ThreadPool Default;
+
+    return Default;
+}
+
+/// <summary>
+/// Executes queued tasks until the pool is destroyed.
+/// </summary>
+void ThreadPool::Run() noexcept
+{
+    for (;;)
+    {
+        Task Next;
+
+        {
+            std::unique_lock<std::mutex> Lock(_Mutex);
+
+            _Condition.wait(Lock, [this]() { return _IsStopping || !_Tasks.empty(); });
+
+            if (_Tasks.empty())
+                return;
+
+            Next = std::move(_Tasks.front());
+            _Tasks.pop_front();
+        }
+
+        Next();
+    }
+}
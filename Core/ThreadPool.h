@@ -0,0 +1,48 @@
+
+/** $VER: ThreadPool.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// Runs tasks on a fixed set of worker threads.
+/// </summary>
+class ThreadPool
+{
+public:
+    typedef std::function<void()> Task;
+    typedef std::function<void(UINT begin, UINT end)> RangeTask;
+
+    ThreadPool(UINT threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool & operator=(const ThreadPool &) = delete;
+
+    UINT GetThreadCount() const noexcept { return (UINT) _Threads.size(); }
+
+    HRESULT Submit(Task task) noexcept;
+    void ParallelFor(UINT count, const RangeTask & task) noexcept;
+
+    static ThreadPool & GetDefault() noexcept;
+
+private:
+    void Run() noexcept;
+
+private:
+    std::vector<std::thread> _Threads;
+
+    std::mutex _Mutex;
+    std::condition_variable _Condition;
+    std::deque<Task> _Tasks;
+    bool _IsStopping;
+};
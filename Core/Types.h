@@ -0,0 +1,80 @@
+
+/** $VER: Types.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+
+/// <summary>
+/// Represents a point in device-independent pixels.
+/// </summary>
+struct PointF
+{
+    FLOAT x;
+    FLOAT y;
+};
+
+/// <summary>
+/// Represents a size in device-independent pixels.
+/// </summary>
+struct SizeF
+{
+    FLOAT width;
+    FLOAT height;
+};
+
+/// <summary>
+/// Represents a rectangle in device-independent pixels.
+/// </summary>
+struct RectF
+{
+    FLOAT left;
+    FLOAT top;
+    FLOAT right;
+    FLOAT bottom;
+
+    FLOAT Width() const noexcept { return right - left; }
+    FLOAT Height() const noexcept { return bottom - top; }
+};
+
+/// <summary>
+/// Represents a rectangle in pixels.
+/// </summary>
+struct RectI
+{
+    int left;
+    int top;
+    int right;
+    int bottom;
+
+    int Width() const noexcept { return right - left; }
+    int Height() const noexcept { return bottom - top; }
+
+    bool IsEmpty() const noexcept { return (left >= right) || (top >= bottom); }
+};
+
+/// <summary>
+/// Represents a color with straight (non-premultiplied) alpha.
+/// </summary>
+struct Color
+{
+    FLOAT r;
+    FLOAT g;
+    FLOAT b;
+    FLOAT a;
+
+    /// <summary>
+    /// Gets the color as a premultiplied BGRA pixel.
+    /// </summary>
+    uint32_t ToPBGRA() const noexcept
+    {
+        const FLOAT A = std::clamp(a, 0.f, 1.f);
+
+        const uint32_t B8 = (uint32_t) (std::clamp(b, 0.f, 1.f) * A * 255.f + .5f);
+        const uint32_t G8 = (uint32_t) (std::clamp(g, 0.f, 1.f) * A * 255.f + .5f);
+        const uint32_t R8 = (uint32_t) (std::clamp(r, 0.f, 1.f) * A * 255.f + .5f);
+        const uint32_t A8 = (uint32_t) (A * 255.f + .5f);
+
+        return B8 | (G8 << 8) | (R8 << 16) | (A8 << 24);
+    }
+};
@@ -0,0 +1,447 @@
+
+/** $VER: VisualTree.cpp (2026.10.17) P. Stuer **/
+
+#include "Core.h"
+
+#include "VisualTree.h"
+
+#include <new>
+
+/*
+    A frame has three passes. Update walks the tree, computes the placement of every visual in target coordinates and damages the old and the new
+    bounds of every visual whose placement or content changed. Rasterize redraws the content of those visuals into their caches. Compose clears each
+    damaged rectangle and blends the caches that overlap it, in tree order. Nothing is walked if no visual changed since the previous frame.
+*/
+
+/// <summary>
+/// Initializes a new instance.
+/// </summary>
+Visual::Visual(VisualTree * tree, Visual * parent) noexcept : _Tree(tree), _Parent(parent), _OffsetX(), _OffsetY(), _ScaleX(1.f), _ScaleY(1.f), _Opacity(1.f), _Clip(), _HasClip(),
+    _Width(), _Height(), _Version(), _CacheVersion(), _Placement(), _IsPlaced()
+{
+}
+
+/// <summary>
+/// Creates a visual and adds it on top of the other children of this visual.
+/// </summary>
+HRESULT Visual::CreateChild(Visual ** child) noexcept
+{
+    if (child == nullptr)
+        return E_INVALIDARG;
+
+    try
+    {
+        _Children.push_back(std::make_unique<Visual>(_Tree, this));
+    }
+    catch (const std::bad_alloc &)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    *child = _Children.back().get();
+
+    Invalidate();
+
+    return S_OK;
+}
+
+/// <summary>
+/// Removes and destroys a child and its children. The area they covered gets composed again in the next frame.
+/// </summary>
+void Visual::RemoveChild(Visual * child) noexcept
+{
+    auto it = std::find_if(_Children.begin(), _Children.end(), [child](const std::unique_ptr<Visual> & c) { return c.get() == child; });
+
+    if (it == _Children.end())
+        return;
+
+    child->Damage(_Tree->_Removed);
+
+    _Children.erase(it);
+
+    Invalidate();
+}
+
+/// <summary>
+/// Sets the content of the visual: a function that draws it into a cache of the specified size, in pixels. An empty function removes the content.
+/// </summary>
+void Visual::SetContent(UINT width, UINT height, const VisualContent & content) noexcept
+{
+    try
+    {
+        _Content = content;
+    }
+    catch (const std::bad_alloc &)
+    {
+        _Content = nullptr;
+    }
+
+    _Width = width;
+    _Height = height;
+
+    ++_Version;
+
+    Invalidate();
+}
+
+/// <summary>
+/// Marks the content as changed, e.g. because the data that the content function draws has changed. The content is rasterized again in the next frame.
+/// </summary>
+void Visual::InvalidateContent() noexcept
+{
+    ++_Version;
+
+    Invalidate();
+}
+
+/// <summary>
+/// Sets the position of the visual relative to its parent, in the coordinates of the parent.
+/// </summary>
+void Visual::SetOffset(FLOAT x, FLOAT y) noexcept
+{
+    if ((x == _OffsetX) && (y == _OffsetY))
+        return;
+
+    _OffsetX = x;
+    _OffsetY = y;
+
+    Invalidate();
+}
+
+/// <summary>
+/// Sets the scale of the visual and its children. The cache is stretched; the content is not rasterized again.
+/// </summary>
+void Visual::SetScale(FLOAT x, FLOAT y) noexcept
+{
+    if ((x == _ScaleX) && (y == _ScaleY))
+        return;
+
+    _ScaleX = x;
+    _ScaleY = y;
+
+    Invalidate();
+}
+
+/// <summary>
+/// Sets the opacity (0 - 1) of the visual and its children.
+/// </summary>
+void Visual::SetOpacity(FLOAT opacity) noexcept
+{
+    opacity = std::clamp(opacity, 0.f, 1.f);
+
+    if (opacity == _Opacity)
+        return;
+
+    _Opacity = opacity;
+
+    Invalidate();
+}
+
+/// <summary>
+/// Restricts the visual and its children to a rectangle, in the local coordinates of the visual.
+/// </summary>
+void Visual::SetClip(const RectF & clip) noexcept
+{
+    if (_HasClip && (clip.left == _Clip.left) && (clip.top == _Clip.top) && (clip.right == _Clip.right) && (clip.bottom == _Clip.bottom))
+        return;
+
+    _Clip = clip;
+    _HasClip = true;
+
+    Invalidate();
+}
+
+/// <summary>
+/// Removes the clip rectangle. The visual is only clipped by its parent.
+/// </summary>
+void Visual::RemoveClip() noexcept
+{
+    if (!_HasClip)
+        return;
+
+    _HasClip = false;
+
+    Invalidate();
+}
+
+/// <summary>
+/// Tells the tree that it has to be updated in the next frame.
+/// </summary>
+void Visual::Invalidate() noexcept
+{
+    _Tree->_IsChanged = true;
+}
+
+/// <summary>
+/// Adds the area covered by this visual and its children in the last frame to a region.
+/// </summary>
+void Visual::Damage(Region & damage) const noexcept
+{
+    if (_IsPlaced)
+        VisualTree::AddDamage(damage, _Placement.Bounds);
+
+    for (const auto & Child : _Children)
+        Child->Damage(damage);
+}
+
+/// <summary>
+/// Computes the placement of this visual and its children from the placement of the parent. A visual that moved or changed damages its old and its new bounds.
+/// </summary>
+HRESULT Visual::Update(const Placement & parent) noexcept
+{
+    VisualStatistics & Statistics = _Tree->_Statistics;
+
+    Placement p = { };
+
+    p.ScaleX  = parent.ScaleX * _ScaleX;
+    p.ScaleY  = parent.ScaleY * _ScaleY;
+    p.OffsetX = parent.OffsetX + parent.ScaleX * _OffsetX;
+    p.OffsetY = parent.OffsetY + parent.ScaleY * _OffsetY;
+    p.Opacity = parent.Opacity * _Opacity;
+    p.Version = _Content ? _Version : 0;
+    p.Clip    = parent.Clip;
+
+    // Pixels belong to a rectangle if their centers lie inside it, like in the software compositor.
+    auto ToPixels = [&p](FLOAT left, FLOAT top, FLOAT right, FLOAT bottom) -> RectI
+    {
+        return
+        {
+            (int) std::floor(p.OffsetX + left   * p.ScaleX + .5f),
+            (int) std::floor(p.OffsetY + top    * p.ScaleY + .5f),
+            (int) std::floor(p.OffsetX + right  * p.ScaleX + .5f),
+            (int) std::floor(p.OffsetY + bottom * p.ScaleY + .5f),
+        };
+    };
+
+    if (_HasClip)
+        p.Clip = Region::Intersect(p.Clip, ToPixels(_Clip.left, _Clip.top, _Clip.right, _Clip.bottom));
+
+    if (_Content && (_Width != 0) && (_Height != 0) && (p.Opacity > 0.f) && (p.ScaleX > 0.f) && (p.ScaleY > 0.f))
+        p.Bounds = Region::Intersect(p.Clip, ToPixels(0.f, 0.f, (FLOAT) _Width, (FLOAT) _Height));
+
+    if (p.Bounds.IsEmpty())
+        p.Bounds = { };
+
+    const bool IsChanged = !_IsPlaced || (p.Version != _Placement.Version) || (p.OffsetX != _Placement.OffsetX) || (p.OffsetY != _Placement.OffsetY) ||
+        (p.ScaleX != _Placement.ScaleX) || (p.ScaleY != _Placement.ScaleY) || (p.Opacity != _Placement.Opacity) ||
+        (p.Bounds.left != _Placement.Bounds.left) || (p.Bounds.top != _Placement.Bounds.top) || (p.Bounds.right != _Placement.Bounds.right) || (p.Bounds.bottom != _Placement.Bounds.bottom);
+
+    if (IsChanged)
+    {
+        if (_IsPlaced)
+            VisualTree::AddDamage(_Tree->_Damage, _Placement.Bounds);
+
+        VisualTree::AddDamage(_Tree->_Damage, p.Bounds);
+    }
+
+    _Placement = p;
+    _IsPlaced = true;
+
+    HRESULT hr = S_OK;
+
+    // Only visible content gets rasterized. Content that is scrolled into view later is rasterized then.
+    if (!p.Bounds.IsEmpty() && (_CacheVersion != _Version))
+        hr = Rasterize();
+    else
+    if (!_Content && !_Cache.GetTarget().IsEmpty())
+        _Cache = SoftwareCompositor();
+
+    Statistics.Visuals++;
+    Statistics.CachedBytes += _Cache.GetTarget().Size();
+
+    for (const auto & Child : _Children)
+    {
+        if (SUCCEEDED(hr))
+            hr = Child->Update(p);
+    }
+
+    return hr;
+}
+
+/// <summary>
+/// Draws the content into the cache.
+/// </summary>
+HRESULT Visual::Rasterize() noexcept
+{
+    const Raster & Cache = _Cache.GetTarget();
+
+    HRESULT hr = S_OK;
+
+    if ((Cache.Width() != _Width) || (Cache.Height() != _Height))
+        hr = _Cache.Initialize(_Width, _Height);
+    else
+        _Cache.Clear({ 0.f, 0.f, 0.f, 0.f });
+
+    if (SUCCEEDED(hr))
+    {
+        _Cache.BeginDraw();
+
+        _Content(_Cache);
+
+        hr = _Cache.EndDraw();
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        _CacheVersion = _Version;
+
+        _Tree->_Statistics.Rasterized++;
+    }
+
+    return hr;
+}
+
+/// <summary>
+/// Blends the cache of this visual and its children into the part of the target inside the specified rectangle.
+/// </summary>
+HRESULT Visual::Compose(SoftwareCompositor & target, const RectI & rect) const noexcept
+{
+    HRESULT hr = S_OK;
+
+    const RectI Bounds = Region::Intersect(_Placement.Bounds, rect);
+
+    if (!Bounds.IsEmpty())
+    {
+        target.PushClip(Bounds);
+
+        hr = target.Compose(_Cache.GetTarget(), _Placement.OffsetX, _Placement.OffsetY, _Placement.ScaleX, _Placement.ScaleY, _Placement.Opacity);
+
+        target.PopClip();
+
+        _Tree->_Statistics.Composed++;
+    }
+
+    for (const auto & Child : _Children)
+    {
+        if (SUCCEEDED(hr))
+            hr = Child->Compose(target, rect);
+    }
+
+    return hr;
+}
+
+/// <summary>
+/// Initializes a new instance. The root visual has no content; its children fill the target on a transparent background.
+/// </summary>
+VisualTree::VisualTree() noexcept : _Root(this, nullptr), _Background(), _IsChanged(true), _IsInvalid(true), _Width(), _Height(), _Statistics()
+{
+}
+
+/// <summary>
+/// Sets the color of the area that is not covered by any visual.
+/// </summary>
+void VisualTree::SetBackground(const Color & color) noexcept
+{
+    if ((color.r == _Background.r) && (color.g == _Background.g) && (color.b == _Background.b) && (color.a == _Background.a))
+        return;
+
+    _Background = color;
+    _IsInvalid = true;
+}
+
+/// <summary>
+/// Composes the area of the target that changed since the previous frame. Returns S_FALSE if nothing changed. The caller presents the damaged area (GetDamage).
+/// </summary>
+HRESULT VisualTree::Render(SoftwareCompositor & target) noexcept
+{
+    const UINT Width  = target.GetTarget().Width();
+    const UINT Height = target.GetTarget().Height();
+
+    if ((Width != _Width) || (Height != _Height))
+        _IsInvalid = true;
+
+    _Width = Width;
+    _Height = Height;
+
+    _Statistics.Rasterized = 0;
+    _Statistics.Composed = 0;
+
+    _Damage.Clear();
+
+    if (!_IsChanged && !_IsInvalid)
+    {
+        ++_Statistics.SkippedFrames;
+
+        return S_FALSE;
+    }
+
+    const RectI Target = { 0, 0, (int) Width, (int) Height };
+
+    _Damage.Union(_Removed);
+    _Removed.Clear();
+
+    _Statistics.Visuals = 0;
+    _Statistics.CachedBytes = 0;
+
+    Visual::Placement Parent = { };
+
+    Parent.Clip = Target;
+    Parent.ScaleX = Parent.ScaleY = 1.f;
+    Parent.Opacity = 1.f;
+
+    HRESULT hr = _Root.Update(Parent);
+
+    if (_IsInvalid)
+    {
+        _Damage.Clear();
+        _Damage.Union(Target);
+    }
+    else
+    {
+        _Damage.Intersect(Target);
+        _Damage.Simplify(MaxRects);
+    }
+
+    _IsChanged = false;
+    _IsInvalid = FAILED(hr); // A failed frame has to be composed completely the next time.
+
+    if (SUCCEEDED(hr) && _Damage.IsEmpty())
+    {
+        ++_Statistics.SkippedFrames;
+
+        return S_FALSE;
+    }
+
+    for (const RectI & Rect : _Damage.GetRects())
+    {
+        if (!SUCCEEDED(hr))
+            break;
+
+        target.PushClip(Rect);
+
+        target.Clear(_Background);
+
+        hr = _Root.Compose(target, Rect);
+
+        target.PopClip();
+    }
+
+    ++_Statistics.Frames;
+
+    _Statistics.TotalRasterized += _Statistics.Rasterized;
+    _Statistics.TotalComposed += _Statistics.Composed;
+
+    return hr;
+}
+
+/// <summary>
+/// Gets the counters of the tree.
+/// </summary>
+VisualStatistics VisualTree::GetStatistics() const noexcept
+{
+    return _Statistics;
+}
+
+/// <summary>
+/// Adds a rectangle to a damaged region. The region is simplified as it grows so that thousands of changed visuals do not make it expensive.
+/// </summary>
+void VisualTree::AddDamage(Region & damage, const RectI & rect) noexcept
+{
+    if (rect.IsEmpty())
+        return;
+
+    damage.Union(rect);
+
+    if (damage.GetRects().size() > 4 * MaxRects)
+        damage.Simplify(MaxRects);
+}
@@ -0,0 +1,167 @@
+
+/** $VER: VisualTree.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+#include "SoftwareCompositor.h"
+#include "Region.h"
+#include "Types.h"
+
+#include <functional>
+#include <vector>
+
+class VisualTree;
+
+/// <summary>
+/// Draws the content of a visual. Coordinates are relative to the top-left corner of the visual, in pixels.
+/// </summary>
+typedef std::function<void (Compositor & compositor)> VisualContent;
+
+/// <summary>
+/// Contains the counters of a visual tree.
+/// </summary>
+struct VisualStatistics
+{
+    UINT Visuals;               // Visuals in the tree, including the root
+    UINT Rasterized;            // Visuals whose content was rasterized in the last frame
+    UINT Composed;              // Cached layers blended into the target in the last frame
+    uint64_t CachedBytes;       // Memory used by the cached rasters
+
+    uint64_t Frames;            // Frames that had to be (partially) composed
+    uint64_t SkippedFrames;     // Frames without damage
+    uint64_t TotalRasterized;
+    uint64_t TotalComposed;
+};
+
+/// <summary>
+/// Represents a node of a retained visual tree. A visual has a transform (offset and scale), an opacity, a clip rectangle, content and children.
+/// The content is rasterized once into a cache in the local coordinates of the visual and only rasterized again when the content or its size changes.
+/// Changes to the transform, opacity or clip only cause the cache to be blended again. The children are drawn on top of the content of their parent.
+/// </summary>
+class Visual
+{
+public:
+    Visual(VisualTree * tree, Visual * parent) noexcept;
+
+    Visual(const Visual &) = delete;
+    Visual & operator=(const Visual &) = delete;
+
+    HRESULT CreateChild(Visual ** child) noexcept;
+    void RemoveChild(Visual * child) noexcept;
+
+    const std::vector<std::unique_ptr<Visual>> & GetChildren() const noexcept { return _Children; }
+    Visual * GetParent() const noexcept { return _Parent; }
+
+    void SetContent(UINT width, UINT height, const VisualContent & content) noexcept;
+    void InvalidateContent() noexcept;
+
+    void SetOffset(FLOAT x, FLOAT y) noexcept;
+    void SetScale(FLOAT x, FLOAT y) noexcept;
+    void SetOpacity(FLOAT opacity) noexcept;
+    void SetClip(const RectF & clip) noexcept;
+    void RemoveClip() noexcept;
+
+    PointF GetOffset() const noexcept { return { _OffsetX, _OffsetY }; }
+    PointF GetScale() const noexcept { return { _ScaleX, _ScaleY }; }
+    FLOAT GetOpacity() const noexcept { return _Opacity; }
+
+    bool HasContent() const noexcept { return (bool) _Content; }
+    const Raster & GetCache() const noexcept { return _Cache.GetTarget(); }
+
+private:
+    /// <summary>
+    /// Describes how the visual was composed in the last frame, in the coordinates of the target.
+    /// </summary>
+    struct Placement
+    {
+        RectI Bounds;           // Pixels covered by the cache, clipped
+        RectI Clip;             // Clip rectangle inherited by the children
+        FLOAT OffsetX;
+        FLOAT OffsetY;
+        FLOAT ScaleX;
+        FLOAT ScaleY;
+        FLOAT Opacity;
+        uint64_t Version;       // Version of the content
+    };
+
+    void Invalidate() noexcept;
+    void Damage(Region & damage) const noexcept;
+
+    HRESULT Update(const Placement & parent) noexcept;
+    HRESULT Rasterize() noexcept;
+    HRESULT Compose(SoftwareCompositor & target, const RectI & rect) const noexcept;
+
+    friend class VisualTree;
+
+private:
+    VisualTree * _Tree;
+    Visual * _Parent;
+    std::vector<std::unique_ptr<Visual>> _Children;
+
+    FLOAT _OffsetX;
+    FLOAT _OffsetY;
+    FLOAT _ScaleX;
+    FLOAT _ScaleY;
+    FLOAT _Opacity;
+    RectF _Clip;
+    bool _HasClip;
+
+    VisualContent _Content;
+    UINT _Width;
+    UINT _Height;
+    uint64_t _Version;          // Incremented every time the content changes
+
+    SoftwareCompositor _Cache;
+    uint64_t _CacheVersion;     // Version of the content in the cache
+
+    Placement _Placement;       // Placement in the last frame
+    bool _IsPlaced;             // False if the visual has not been composed yet
+};
+
+/// <summary>
+/// Composes a retained tree of visuals into a software compositor. A frame only blends the cached layers that overlap the area damaged since the
+/// previous frame; visuals whose content did not change are never drawn again. The opacity of a visual multiplies that of its children.
+/// </summary>
+class VisualTree
+{
+public:
+    VisualTree() noexcept;
+
+    VisualTree(const VisualTree &) = delete;
+    VisualTree & operator=(const VisualTree &) = delete;
+
+    Visual * GetRoot() noexcept { return &_Root; }
+
+    void SetBackground(const Color & color) noexcept;
+
+    HRESULT Render(SoftwareCompositor & target) noexcept;
+
+    void InvalidateAll() noexcept { _IsInvalid = true; }
+
+    const Region & GetDamage() const noexcept { return _Damage; }
+    VisualStatistics GetStatistics() const noexcept;
+
+    static const UINT MaxRects = 8; // The damage is simplified to at most this number of rectangles.
+
+private:
+    static void AddDamage(Region & damage, const RectI & rect) noexcept;
+
+    friend class Visual;
+
+private:
+    Visual _Root;
+
+    Color _Background;
+
+    bool _IsChanged;            // True if a visual has changed since the last frame.
+    bool _IsInvalid;            // True if the next frame has to be composed completely.
+    Region _Removed;            // Area of the visuals that were removed since the last frame
+
+    UINT _Width;
+    UINT _Height;
+
+    Region _Damage;
+
+    VisualStatistics _Statistics;
+};
@@ -0,0 +1,283 @@
+
+/** $VER: AnimationTest.cpp (2026.10.17) P. Stuer **/
+
+#include "Test.h"
+
+#include "Animation.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <future>
+#include <limits>
+#include <thread>
+
+/// <summary>
+/// Provides an animation of opaque frames that each cover the whole canvas with a color derived from their index. Frames from the gated index
+/// on wait until the gate opens.
+/// </summary>
+class TestAnimation : public AnimationSource
+{
+public:
+    TestAnimation(UINT frameCount, UINT loopCount, UINT delay, std::shared_future<void> gate = std::shared_future<void>(), UINT gatedIndex = 0) noexcept :
+        _FrameCount(frameCount), _LoopCount(loopCount), _Delay(delay), _Gate(gate), _GatedIndex(gatedIndex) { }
+
+    UINT GetWidth() const noexcept override { return Width; }
+    UINT GetHeight() const noexcept override { return Height; }
+
+    UINT GetFrameCount() const noexcept override { return _FrameCount; }
+    UINT GetLoopCount() const noexcept override { return _LoopCount; }
+
+    HRESULT ReadFrame(UINT index, AnimationFrame & frame, Raster & raster) noexcept override
+    {
+        if (_Gate.valid() && (index >= _GatedIndex))
+            _Gate.wait();
+
+        frame = { { 0, 0, (int) Width, (int) Height }, _Delay, FrameDisposal::None, FrameBlend::Source };
+
+        HRESULT hr = raster.Initialize(Width, Height);
+
+        if (SUCCEEDED(hr))
+        {
+            for (UINT y = 0; y < Height; ++y)
+                for (UINT x = 0; x < Width; ++x)
+                    ((uint32_t *) raster.Row(y))[x] = GetColor(index);
+        }
+
+        return hr;
+    }
+
+    static uint32_t GetColor(UINT index) noexcept { return 0xFF000000 | (index * 0x010203); }
+
+    static const UINT Width = 4;
+    static const UINT Height = 4;
+
+private:
+    UINT _FrameCount;
+    UINT _LoopCount;
+    UINT _Delay;
+    std::shared_future<void> _Gate;
+    UINT _GatedIndex;
+};
+
+/// <summary>
+/// Waits until a condition becomes true.
+/// </summary>
+static bool WaitFor(const std::function<bool()> & condition)
+{
+    for (UINT i = 0; i < 10000; ++i)
+    {
+        if (condition())
+            return true;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return false;
+}
+
+/// <summary>
+/// Waits until the player has decoded the specified number of frames.
+/// </summary>
+static bool WaitDecoded(const AnimationPlayer & player, uint64_t decoded)
+{
+    return WaitFor([&player, decoded]() { return player.GetStatistics().Decoded >= decoded; });
+}
+
+/// <summary>
+/// Gets the color of the top-left pixel of the current frame, or 0 if there is none.
+/// </summary>
+static uint32_t GetFrameColor(const AnimationPlayer & player) noexcept
+{
+    const Raster * Frame = player.GetFrame();
+
+    return (Frame != nullptr) ? ((const uint32_t *) Frame->Row(0))[0] : 0;
+}
+
+/// <summary>
+/// Gets a pixel of a raster.
+/// </summary>
+static uint32_t GetPixel(const Raster & raster, UINT x, UINT y) noexcept
+{
+    return ((const uint32_t *) raster.Row(y))[x];
+}
+
+/// <summary>
+/// Creates a frame of a single color.
+/// </summary>
+static HRESULT CreateFrame(Raster & raster, UINT width, UINT height, uint32_t color) noexcept
+{
+    HRESULT hr = raster.Initialize(width, height);
+
+    if (SUCCEEDED(hr))
+    {
+        for (UINT y = 0; y < height; ++y)
+            for (UINT x = 0; x < width; ++x)
+                ((uint32_t *) raster.Row(y))[x] = color;
+    }
+
+    return hr;
+}
+
+/// <summary>
+/// Checks the disposal and blend rules of the canvas: a frame disposed to the background leaves transparent black, a frame disposed to the previous
+/// content restores what was under it, Source replaces pixels, Over blends them, and frames that stick out of the canvas are clipped.
+/// </summary>
+TEST(AnimationCanvas)
+{
+    const uint32_t A = 0xFF0000FF, B = 0xFF00FF00, C = 0xFFFF0000, D = 0xFFFFFFFF;
+
+    AnimationCanvas Canvas;
+
+    Raster Frame;
+
+    if (!CHECK(SUCCEEDED(Canvas.Initialize(4, 4))))
+        return;
+
+    CHECK(FAILED(AnimationCanvas().Compose({ { 0, 0, 1, 1 }, 0, FrameDisposal::None, FrameBlend::Source }, Frame)));
+
+    CHECK(SUCCEEDED(CreateFrame(Frame, 4, 4, A)) && SUCCEEDED(Canvas.Compose({ { 0, 0, 4, 4 }, 0, FrameDisposal::None, FrameBlend::Source }, Frame)));
+    CHECK((GetPixel(Canvas.GetRaster(), 0, 0) == A) && (GetPixel(Canvas.GetRaster(), 3, 3) == A));
+
+    CHECK(SUCCEEDED(CreateFrame(Frame, 2, 2, B)) && SUCCEEDED(Canvas.Compose({ { 1, 1, 3, 3 }, 0, FrameDisposal::Background, FrameBlend::Source }, Frame)));
+    CHECK((GetPixel(Canvas.GetRaster(), 1, 1) == B) && (GetPixel(Canvas.GetRaster(), 2, 2) == B) && (GetPixel(Canvas.GetRaster(), 0, 0) == A));
+
+    // The previous frame is cleared to transparent black before this one is drawn.
+    CHECK(SUCCEEDED(CreateFrame(Frame, 1, 1, C)) && SUCCEEDED(Canvas.Compose({ { 0, 0, 1, 1 }, 0, FrameDisposal::Previous, FrameBlend::Source }, Frame)));
+    CHECK((GetPixel(Canvas.GetRaster(), 0, 0) == C) && (GetPixel(Canvas.GetRaster(), 1, 1) == 0) && (GetPixel(Canvas.GetRaster(), 2, 2) == 0) && (GetPixel(Canvas.GetRaster(), 3, 3) == A));
+
+    // The previous frame is restored to what was under it; this one sticks out of the canvas.
+    CHECK(SUCCEEDED(CreateFrame(Frame, 2, 2, D)) && SUCCEEDED(Canvas.Compose({ { 3, 3, 5, 5 }, 0, FrameDisposal::None, FrameBlend::Source }, Frame)));
+    CHECK((GetPixel(Canvas.GetRaster(), 0, 0) == A) && (GetPixel(Canvas.GetRaster(), 3, 3) == D) && (GetPixel(Canvas.GetRaster(), 2, 2) == 0));
+
+    // Half transparent black replaces or darkens the white pixel.
+    CHECK(SUCCEEDED(CreateFrame(Frame, 1, 1, 0x80000000)) && SUCCEEDED(Canvas.Compose({ { 3, 3, 4, 4 }, 0, FrameDisposal::None, FrameBlend::Over }, Frame)));
+
+    const uint32_t Over = GetPixel(Canvas.GetRaster(), 3, 3);
+
+    CHECK(((Over >> 24) == 0xFF) && ((Over & 0xFF) >= 0x7E) && ((Over & 0xFF) <= 0x80));
+
+    CHECK(SUCCEEDED(Canvas.Compose({ { 3, 3, 4, 4 }, 0, FrameDisposal::None, FrameBlend::Source }, Frame)));
+    CHECK(GetPixel(Canvas.GetRaster(), 3, 3) == 0x80000000);
+
+    Canvas.Reset();
+
+    CHECK(GetPixel(Canvas.GetRaster(), 0, 0) == 0);
+}
+
+/// <summary>
+/// Checks the playback: frames follow their deadlines, late updates drop frames instead of drifting, looping animations wrap, a long animation
+/// streams through a bounded ring, and a frame that is not decoded in time counts as one underrun and restarts the timeline when it arrives.
+/// </summary>
+TEST(AnimationPlayer)
+{
+    ThreadPool Pool(2);
+
+    std::atomic<UINT> Notifications(0);
+
+    AnimationPlayer Player([&Notifications]() { ++Notifications; }, &Pool);
+
+    CHECK(Player.Open(nullptr) == E_INVALIDARG);
+    CHECK(Player.Open(std::make_unique<TestAnimation>(0, 1, 20)) == E_INVALIDARG);
+
+    // Resident, played once.
+    if (CHECK(SUCCEEDED(Player.Open(std::make_unique<TestAnimation>(3, 1, 20)))) && CHECK(WaitDecoded(Player, 3)))
+    {
+        CHECK(Player.GetFrame() == nullptr);
+        CHECK(Player.GetDeadline() == std::numeric_limits<double>::infinity());
+
+        CHECK(Player.Update(0.) && (GetFrameColor(Player) == TestAnimation::GetColor(0)));
+        CHECK(!Player.Update(0.01) && (GetFrameColor(Player) == TestAnimation::GetColor(0)));
+        CHECK(Player.Update(0.02) && (GetFrameColor(Player) == TestAnimation::GetColor(1)));
+        CHECK(Player.Update(10.) && (GetFrameColor(Player) == TestAnimation::GetColor(2)));
+
+        // The animation has ended.
+        CHECK(!Player.Update(20.) && (Player.GetDeadline() == std::numeric_limits<double>::infinity()));
+
+        const AnimationStatistics Statistics = Player.GetStatistics();
+
+        CHECK(Statistics.IsResident && (Statistics.Capacity == 3) && (Statistics.Decoded == 3) && (Statistics.Presented == 3) && (Statistics.Dropped == 0) && (Statistics.Underruns == 0));
+    }
+
+    // Resident, looping forever, with the default delay for frames without one.
+    if (CHECK(SUCCEEDED(Player.Open(std::make_unique<TestAnimation>(4, 0, 0)))) && CHECK(WaitDecoded(Player, 4)))
+    {
+        CHECK(Player.Update(0.) && (std::abs(Player.GetDeadline() - AnimationPlayer::DefaultDelay / 1000.) < 1e-9));
+
+        // 3 deadlines passed: 2 frames are dropped and the deadline stays on the original timeline.
+        CHECK(Player.Update(0.35) && (GetFrameColor(Player) == TestAnimation::GetColor(3)));
+        CHECK(std::abs(Player.GetDeadline() - 0.4) < 1e-9);
+
+        CHECK(Player.Update(0.401) && (GetFrameColor(Player) == TestAnimation::GetColor(0)));
+
+        const AnimationStatistics Statistics = Player.GetStatistics();
+
+        CHECK((Statistics.Decoded == 4) && (Statistics.Presented == 3) && (Statistics.Dropped == 2));
+    }
+
+    // Streaming through a ring of 3 frames.
+    const size_t FrameSize = (size_t) Raster::GetStride(TestAnimation::Width, 32) * TestAnimation::Height;
+
+    if (CHECK(SUCCEEDED(Player.Open(std::make_unique<TestAnimation>(10, 1, 20), 2, 3 * FrameSize))) && CHECK(WaitDecoded(Player, 3)))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        AnimationStatistics Statistics = Player.GetStatistics();
+
+        CHECK(!Statistics.IsResident && (Statistics.Capacity == 3) && (Statistics.Decoded == 3) && (Statistics.DecodeAhead == 3));
+
+        bool IsInOrder = true;
+
+        for (UINT i = 0; i < 10; ++i)
+        {
+            IsInOrder &= WaitDecoded(Player, (std::min)(i + 1, 10U)) && Player.Update((i != 0) ? i * 0.02 + 0.001 : 0.) && (GetFrameColor(Player) == TestAnimation::GetColor(i));
+
+            // The ring never holds more than its capacity.
+            IsInOrder &= (Player.GetStatistics().DecodeAhead <= 2);
+        }
+
+        CHECK(IsInOrder);
+
+        Statistics = Player.GetStatistics();
+
+        CHECK((Statistics.Decoded == 10) && (Statistics.Presented == 10) && (Statistics.Dropped == 0) && (Statistics.Underruns == 0));
+        CHECK(Statistics.MemoryUsage <= 5 * FrameSize);
+    }
+
+    // Frame 1 is late.
+    {
+        std::promise<void> Gate;
+
+        Notifications = 0;
+
+        if (CHECK(SUCCEEDED(Player.Open(std::make_unique<TestAnimation>(2, 1, 20, Gate.get_future().share(), 1)))) && CHECK(WaitDecoded(Player, 1)))
+        {
+            CHECK(WaitFor([&Notifications]() { return Notifications == 1; }));
+            CHECK(Player.Update(0.) && (GetFrameColor(Player) == TestAnimation::GetColor(0)));
+
+            CHECK(!Player.Update(1.) && !Player.Update(1.5));
+            CHECK(Player.GetDeadline() == std::numeric_limits<double>::infinity());
+            CHECK(Player.GetStatistics().Underruns == 1);
+
+            Gate.set_value();
+
+            CHECK(WaitDecoded(Player, 2));
+
+            // The player asks to be updated when the frame arrives, and the frame gets its full delay from then on.
+            CHECK(WaitFor([&Notifications]() { return Notifications == 2; }));
+            CHECK(Player.Update(2.) && (GetFrameColor(Player) == TestAnimation::GetColor(1)));
+
+            const AnimationStatistics Statistics = Player.GetStatistics();
+
+            CHECK((Statistics.Presented == 2) && (Statistics.Dropped == 0) && (Statistics.Underruns == 1));
+        }
+        else
+            Gate.set_value();
+
+        Player.Close();
+    }
+
+    CHECK(!Player.IsOpen() && (Player.GetFrame() == nullptr));
+}
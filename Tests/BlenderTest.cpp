@@ -0,0 +1,116 @@
+
+/** $VER: BlenderTest.cpp (2026.10.17) P. Stuer **/
+
+#include "Test.h"
+
+#include "Blender.h"
+
+#include <vector>
+
+/// <summary>
+/// Checks that every instruction set blends, fills and interpolates spans to the same pixels, for every blend mode, with and without streaming
+/// stores, for lengths and alignments around the vector sizes, and that source-over follows its formula.
+/// </summary>
+TEST(Blender)
+{
+    const UINT Counts[] = { 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 33, 100, 1001 };
+
+    for (BlendMode Mode : { BlendMode::Clear, BlendMode::Copy, BlendMode::SourceOver, BlendMode::Plus, BlendMode::Multiply })
+    {
+        for (const bool IsStreaming : { false, true })
+        {
+            for (UINT Count : Counts)
+            {
+                for (UINT Offset = 0; Offset < 8; ++Offset)
+                {
+                    std::vector<uint32_t> Src(Count + 8), Dst(Count + 8), Reference, Result;
+
+                    for (auto & p : Src)
+                        p = test.RandomPixel();
+
+                    for (auto & p : Dst)
+                        p = test.RandomPixel();
+
+                    Reference = Dst;
+
+                    Blender::GetSpanFunction(Mode, InstructionSet::Scalar, IsStreaming)(Src.data() + 1, Reference.data() + Offset, Count);
+
+                    for (InstructionSet Set : Test::GetInstructionSets())
+                    {
+                        Result = Dst;
+
+                        Blender::GetSpanFunction(Mode, Set, IsStreaming)(Src.data() + 1, Result.data() + Offset, Count);
+
+                        CHECK(Result == Reference);
+                    }
+                }
+            }
+        }
+    }
+
+    // Source-over: D = S + D * (255 - Sa) / 255, within rounding.
+    {
+        std::vector<uint32_t> Src(1000), Dst(1000), Result;
+
+        for (auto & p : Src)
+            p = test.RandomPixel();
+
+        for (auto & p : Dst)
+            p = test.RandomPixel();
+
+        Result = Dst;
+
+        Blender::GetSpanFunction(BlendMode::SourceOver, InstructionSet::Scalar, false)(Src.data(), Result.data(), (UINT) Src.size());
+
+        for (size_t i = 0; i < Src.size(); ++i)
+        {
+            const uint32_t ia = 255 - (Src[i] >> 24);
+
+            for (UINT c = 0; c < 32; c += 8)
+            {
+                const uint32_t Expected = ((Src[i] >> c) & 0xFF) + (((Dst[i] >> c) & 0xFF) * ia + 127) / 255;
+
+                const int Difference = (int) ((Result[i] >> c) & 0xFF) - (int) Expected;
+
+                CHECK((Difference >= -1) && (Difference <= 1));
+            }
+        }
+    }
+
+    // Fills and interpolations.
+    for (UINT Count : Counts)
+    {
+        std::vector<uint32_t> a(Count), b(Count), Reference(Count), Result(Count);
+
+        for (UINT i = 0; i < Count; ++i)
+        {
+            a[i] = test.RandomPixel();
+            b[i] = test.RandomPixel();
+        }
+
+        const uint32_t Color = test.RandomPixel();
+        const UINT Weight = test.Random() % 257;
+
+        Reference = a;
+
+        Blender::GetFillFunction(InstructionSet::Scalar)(Color, Reference.data(), Count);
+
+        for (InstructionSet Set : Test::GetInstructionSets())
+        {
+            Result = a;
+
+            Blender::GetFillFunction(Set)(Color, Result.data(), Count);
+
+            CHECK(Result == Reference);
+        }
+
+        Blender::GetLerpFunction(InstructionSet::Scalar)(a.data(), b.data(), Reference.data(), Count, Weight);
+
+        for (InstructionSet Set : Test::GetInstructionSets())
+        {
+            Blender::GetLerpFunction(Set)(a.data(), b.data(), Result.data(), Count, Weight);
+
+            CHECK(Result == Reference);
+        }
+    }
+}
@@ -0,0 +1,343 @@
+
+/** $VER: DamageTest.cpp (2026.10.17) P. Stuer **/
+
+#include "Test.h"
+
+#include "HeadlessRenderer.h"
+
+#include <string.h>
+
+/// <summary>
+/// Fills a raster with a solid premultiplied color.
+/// </summary>
+static HRESULT CreateSolid(Raster & raster, UINT width, UINT height, uint32_t color) noexcept
+{
+    HRESULT hr = raster.Initialize(width, height);
+
+    if (SUCCEEDED(hr))
+    {
+        for (UINT y = 0; y < height; ++y)
+            std::fill((uint32_t *) raster.Row(y), (uint32_t *) raster.Row(y) + width, color);
+    }
+
+    return hr;
+}
+
+/// <summary>
+/// Returns true if the rectangles of a region are not empty and do not overlap.
+/// </summary>
+static bool IsDisjoint(const Region & region) noexcept
+{
+    const auto & Rects = region.GetRects();
+
+    for (size_t i = 0; i < Rects.size(); ++i)
+    {
+        if (Rects[i].IsEmpty())
+            return false;
+
+        for (size_t j = i + 1; j < Rects.size(); ++j)
+        {
+            if (!Region::Intersect(Rects[i], Rects[j]).IsEmpty())
+                return false;
+        }
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Returns true if a region contains exactly the set pixels of a mask.
+/// </summary>
+static bool IsEqual(const Region & region, const bool * mask, int size) noexcept
+{
+    uint64_t Area = 0;
+
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            if (mask[y * size + x] != region.Contains({ x, y, x + 1, y + 1 }))
+                return false;
+
+            Area += mask[y * size + x];
+        }
+    }
+
+    return region.GetArea() == Area;
+}
+
+/// <summary>
+/// Checks the region operations on overlapping, touching, contained and empty rectangles, that touching rectangles are merged, that a simplified
+/// region contains at least the original pixels with at most the requested number of rectangles, and random sequences of operations against a pixel mask.
+/// </summary>
+TEST(Region)
+{
+    // Empty inputs
+    {
+        Region r;
+
+        CHECK(r.IsEmpty() && (r.GetArea() == 0) && r.GetBounds().IsEmpty());
+        CHECK(r.Contains({ 5, 5, 5, 5 }) && !r.Contains({ 0, 0, 1, 1 }) && !r.Intersects({ 0, 0, 10, 10 }));
+
+        r.Union({ 10, 10, 10, 20 });
+        r.Union({ 10, 10, 0, 0 });
+        r.Union(Region());
+
+        CHECK(r.IsEmpty());
+
+        r.Union({ 0, 0, 10, 10 });
+        r.Subtract({ 5, 5, 5, 20 });
+        r.Subtract(Region());
+
+        CHECK(r.GetRects().size() == 1 && (r.GetArea() == 100));
+
+        r.Intersect(Region());
+
+        CHECK(r.IsEmpty());
+
+        r.Union({ 0, 0, 10, 10 });
+        r.Intersect(RectI { 20, 20, 30, 30 });
+
+        CHECK(r.IsEmpty());
+
+        r.Simplify(1);
+
+        CHECK(r.IsEmpty());
+    }
+
+    // Overlapping rectangles are stored as disjoint pieces.
+    {
+        Region r({ 0, 0, 10, 10 });
+
+        r.Union({ 5, 5, 15, 15 });
+
+        CHECK(IsDisjoint(r) && (r.GetArea() == 175));
+        CHECK(r.Contains({ 0, 0, 10, 10 }) && r.Contains({ 5, 5, 15, 15 }) && !r.Contains({ 10, 0, 11, 1 }));
+
+        const RectI Bounds = r.GetBounds();
+
+        CHECK((Bounds.left == 0) && (Bounds.top == 0) && (Bounds.right == 15) && (Bounds.bottom == 15));
+
+        r.Intersect(RectI { 5, 5, 10, 10 });
+
+        CHECK(IsDisjoint(r) && (r.GetArea() == 25) && r.Contains({ 5, 5, 10, 10 }));
+
+        // Subtracting from the middle leaves a frame.
+        r = Region({ 0, 0, 10, 10 });
+
+        r.Subtract({ 3, 3, 7, 7 });
+
+        CHECK(IsDisjoint(r) && (r.GetArea() == 84) && !r.Intersects({ 3, 3, 7, 7 }));
+
+        r.Union({ 3, 3, 7, 7 });
+
+        CHECK((r.GetRects().size() == 1) && (r.GetArea() == 100));
+    }
+
+    // Touching rectangles that share a complete edge are merged, ones that share part of an edge are not.
+    {
+        Region r({ 0, 0, 10, 10 });
+
+        r.Union({ 10, 0, 20, 10 });
+        r.Union({ 0, 10, 20, 20 });
+
+        CHECK(r.GetRects().size() == 1);
+
+        const RectI Rect = r.GetRects()[0];
+
+        CHECK((Rect.left == 0) && (Rect.top == 0) && (Rect.right == 20) && (Rect.bottom == 20));
+
+        r.Union({ 20, 5, 30, 25 });
+
+        CHECK((r.GetRects().size() == 2) && IsDisjoint(r) && (r.GetArea() == 600));
+    }
+
+    // A contained rectangle adds nothing, a containing one covers the region.
+    {
+        Region r({ 0, 0, 100, 100 });
+
+        r.Union({ 10, 10, 20, 20 });
+
+        CHECK((r.GetRects().size() == 1) && (r.GetArea() == 10000));
+
+        r = Region({ 10, 10, 20, 20 });
+
+        r.Union({ 40, 40, 50, 50 });
+        r.Union({ 0, 0, 100, 100 });
+
+        CHECK(IsDisjoint(r) && (r.GetArea() == 10000));
+
+        r.Simplify(DamageTracker::MaxRects);
+
+        CHECK((r.GetRects().size() == 1) && (r.GetArea() == 10000));
+
+        r.Subtract({ -10, -10, 110, 110 });
+
+        CHECK(r.IsEmpty());
+
+        // A region intersected or subtracted with itself.
+        r = Region({ 0, 0, 10, 10 });
+
+        r.Union({ 20, 20, 30, 30 });
+        r.Intersect(r);
+
+        CHECK(r.GetArea() == 200);
+
+        r.Subtract(r);
+
+        CHECK(r.IsEmpty());
+    }
+
+    // Simplifying merges cheap pairs and falls back to fewer, larger rectangles; 1 rectangle is the bounding box.
+    {
+        Region r;
+
+        for (int i = 0; i < 20; ++i)
+            r.Union({ i * 50, (i % 5) * 50, i * 50 + 10, (i % 5) * 50 + 10 });
+
+        CHECK((r.GetRects().size() == 20) && (r.GetArea() == 2000));
+
+        Region Simplified = r;
+
+        Simplified.Simplify(DamageTracker::MaxRects);
+
+        CHECK((Simplified.GetRects().size() <= DamageTracker::MaxRects) && IsDisjoint(Simplified));
+
+        for (const RectI & Rect : r.GetRects())
+            CHECK(Simplified.Contains(Rect));
+
+        Simplified.Simplify(1);
+
+        const RectI Bounds = r.GetBounds();
+        const RectI Rect = Simplified.GetRects()[0];
+
+        CHECK(Simplified.GetRects().size() == 1);
+        CHECK((Rect.left == Bounds.left) && (Rect.top == Bounds.top) && (Rect.right == Bounds.right) && (Rect.bottom == Bounds.bottom));
+
+        // A gap of a few pixels is cheaper to fill than to keep as a separate rectangle.
+        r = Region({ 0, 0, 100, 10 });
+
+        r.Union({ 0, 12, 100, 20 });
+        r.Simplify(DamageTracker::MaxRects);
+
+        CHECK((r.GetRects().size() == 1) && (r.GetArea() == 2000));
+    }
+
+    // More damaged elements than MaxRects are reduced to at most MaxRects rectangles that cover all of them.
+    {
+        DamageTracker Tracker;
+
+        Tracker.BeginFrame(1000, 1000);
+        Tracker.EndFrame();
+
+        Tracker.BeginFrame(1000, 1000);
+
+        for (UINT i = 0; i < 30; ++i)
+            Tracker.Add(i, { (FLOAT) ((i * 97) % 900), (FLOAT) ((i * 61) % 900), (FLOAT) ((i * 97) % 900 + 20), (FLOAT) ((i * 61) % 900 + 20) }, 1);
+
+        const Region & Damage = Tracker.EndFrame();
+
+        CHECK((Damage.GetRects().size() <= DamageTracker::MaxRects) && IsDisjoint(Damage));
+
+        for (int i = 0; i < 30; ++i)
+            CHECK(Damage.Contains({ (i * 97) % 900, (i * 61) % 900, (i * 97) % 900 + 20, (i * 61) % 900 + 20 }));
+    }
+
+    // Random operations against a pixel mask.
+    {
+        const int Size = 32;
+
+        bool Mask[Size * Size] = { };
+        Region r;
+
+        for (UINT i = 0; i < 500; ++i)
+        {
+            const int x1 = (int) (test.Random() % Size), x2 = (int) (test.Random() % (Size + 1));
+            const int y1 = (int) (test.Random() % Size), y2 = (int) (test.Random() % (Size + 1));
+
+            const RectI Rect = { (std::min)(x1, x2), (std::min)(y1, y2), (std::max)(x1, x2), (std::max)(y1, y2) };
+
+            const UINT Operation = test.Random() % 4;
+
+            for (int y = 0; y < Size; ++y)
+            {
+                for (int x = 0; x < Size; ++x)
+                {
+                    const bool IsInside = (x >= Rect.left) && (x < Rect.right) && (y >= Rect.top) && (y < Rect.bottom);
+
+                    switch (Operation)
+                    {
+                        case 0:
+                        case 1: Mask[y * Size + x] |= IsInside; break;
+                        case 2: Mask[y * Size + x] &= !IsInside; break;
+                        case 3: Mask[y * Size + x] &= IsInside || (i % 8 != 0); break;
+                    }
+                }
+            }
+
+            switch (Operation)
+            {
+                case 0:
+                case 1: r.Union(Rect); break;
+                case 2: r.Subtract(Rect); break;
+                case 3: if (i % 8 == 0) r.Intersect(Rect); break;
+            }
+
+            if (!CHECK(IsDisjoint(r) && IsEqual(r, Mask, Size)))
+                break;
+        }
+    }
+}
+
+/// <summary>
+/// Checks that the headless frames that only redraw and present the damaged area are identical to frames that are redrawn completely, while the
+/// image, the child image, the message and the color space change.
+/// </summary>
+TEST(Damage)
+{
+    const UINT Width = 640, Height = 480;
+
+    Raster Images[3], ChildImages[2];
+
+    if (!CHECK(SUCCEEDED(CreateSolid(Images[0], 320, 240, 0xFF2040C0)) && SUCCEEDED(CreateSolid(Images[1], 200, 400, 0xFFC04020)) && SUCCEEDED(CreateSolid(Images[2], 800, 100, 0x80404000)) &&
+               SUCCEEDED(CreateSolid(ChildImages[0], 64, 64, 0x80008000)) && SUCCEEDED(CreateSolid(ChildImages[1], 256, 256, 0x40400000))))
+        return;
+
+    HeadlessRenderer Partial, Full;
+
+    if (!CHECK(SUCCEEDED(Partial.Initialize(Width, Height)) && SUCCEEDED(Full.Initialize(Width, Height))))
+        return;
+
+    const WCHAR * Messages[] = { L"Damage", L"Partial redraws", L"" };
+
+    for (UINT i = 0; i < 24; ++i)
+    {
+        for (HeadlessRenderer * Renderer : { &Partial, &Full })
+        {
+            switch (i % 4)
+            {
+                case 0: Renderer->SetImage(Images[i % 3]); break;
+                case 1: Renderer->SetChildImage(ChildImages[i % 2]); break;
+                case 2: Renderer->SetMessage(Messages[i % 3]); break;
+                case 3: if (i == 11) Renderer->SetColorSpace(ColorSpace::Linear); break;
+            }
+        }
+
+        CHECK(SUCCEEDED(Partial.Render()));
+
+        Full.Invalidate();
+
+        CHECK(Full.Render() == S_OK);
+
+        const Raster & a = Partial.GetFrontBuffer();
+        const Raster & b = Full.GetFrontBuffer();
+
+        if (!CHECK((a.Width() == b.Width()) && (a.Height() == b.Height())))
+            return;
+
+        CHECK(::memcmp(a.Data(), b.Data(), a.Size()) == 0);
+    }
+
+    // A frame without changes draws nothing.
+    CHECK(Partial.Render() == S_FALSE);
+}
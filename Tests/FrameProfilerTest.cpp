@@ -0,0 +1,138 @@
+
+/** $VER: FrameProfilerTest.cpp (2026.10.17) P. Stuer **/
+
+#include "Test.h"
+
+#include "FrameProfiler.h"
+
+#include <algorithm>
+#include <memory>
+
+#if CORE_PROFILING
+
+/// <summary>
+/// Checks the nearest-rank percentiles of a phase, that the ring keeps the last frames, that phases timed between frames go to the next frame,
+/// and the layout of the CSV and JSON exports.
+/// </summary>
+TEST(FrameProfiler)
+{
+    auto Profiler = std::make_unique<FrameProfiler>();
+
+    PhaseSummary Summary;
+
+    CHECK(SUCCEEDED(Profiler->GetSummary(FramePhase::Draw, Summary)) && (Summary.Count == 0));
+
+    // 100 frames with a draw phase of 1 to 100 ms, in shuffled order.
+    UINT Durations[100];
+
+    for (UINT i = 0; i < _countof(Durations); ++i)
+        Durations[i] = i + 1;
+
+    for (UINT i = _countof(Durations) - 1; i > 0; --i)
+        std::swap(Durations[i], Durations[test.Random() % (i + 1)]);
+
+    for (UINT Duration : Durations)
+    {
+        Profiler->BeginFrame();
+
+        // A phase can be timed more than once per frame.
+        Profiler->AddPhase(FramePhase::Draw, std::chrono::microseconds(Duration * 1000 - 250));
+        Profiler->AddPhase(FramePhase::Draw, std::chrono::microseconds(250));
+
+        Profiler->EndFrame();
+    }
+
+    CHECK(Profiler->GetFrameCount() == 100);
+
+    if (CHECK(SUCCEEDED(Profiler->GetSummary(FramePhase::Draw, Summary))))
+    {
+        CHECK(Summary.Count == 100);
+        CHECK(std::abs(Summary.Mean - .0505) < 1e-9);
+        CHECK(std::abs(Summary.P50 - .050) < 1e-9);
+        CHECK(std::abs(Summary.P95 - .095) < 1e-9);
+        CHECK(std::abs(Summary.P99 - .099) < 1e-9);
+        CHECK(std::abs(Summary.Maximum - .100) < 1e-9);
+    }
+
+    CHECK(SUCCEEDED(Profiler->GetSummary(FramePhase::Present, Summary)) && (Summary.Count == 100) && (Summary.Maximum == 0.));
+
+    // A phase timed between frames is attributed to the next frame.
+    Profiler->AddPhase(FramePhase::Bitmap, std::chrono::milliseconds(7));
+
+    Profiler->BeginFrame();
+    Profiler->EndFrame();
+
+    std::vector<FrameRecord> Frames;
+
+    if (CHECK(SUCCEEDED(Profiler->GetFrames(Frames)) && (Frames.size() == 101)))
+    {
+        CHECK((Frames[0].Frame == 0) && (Frames[100].Frame == 100));
+        CHECK((std::abs(Frames[100].Phases[(size_t) FramePhase::Bitmap] - .007) < 1e-9) && (Frames[99].Phases[(size_t) FramePhase::Bitmap] == 0.));
+        CHECK(Frames[100].Start >= Frames[99].Start);
+    }
+
+    // The ring keeps the last Capacity frames.
+    for (UINT i = 0; i < FrameProfiler::Capacity; ++i)
+    {
+        Profiler->BeginFrame();
+        Profiler->EndFrame();
+    }
+
+    if (CHECK(SUCCEEDED(Profiler->GetFrames(Frames)) && (Frames.size() == FrameProfiler::Capacity)))
+        CHECK((Frames.front().Frame == 101) && (Frames.back().Frame == 100 + FrameProfiler::Capacity));
+
+    // The exports of a few frames
+    Profiler = std::make_unique<FrameProfiler>();
+
+    for (UINT i = 0; i < 3; ++i)
+    {
+        Profiler->BeginFrame();
+        Profiler->AddPhase(FramePhase::Flush, std::chrono::microseconds(1500));
+        Profiler->EndFrame();
+    }
+
+    std::string Text;
+
+    if (CHECK(SUCCEEDED(Profiler->Export(ProfileFormat::CSV, Text))))
+    {
+        CHECK(Text.starts_with("Frame,Start,Total,Resources,Bitmap,Damage,Draw,Flush,Compose,Present\n"));
+        CHECK(std::count(Text.begin(), Text.end(), '\n') == 4);
+        CHECK(std::count(Text.begin(), Text.end(), ',') == 4 * 9);
+        CHECK(Text.find("\n2,") != std::string::npos);
+        CHECK(Text.find(",1.500,") != std::string::npos);
+    }
+
+    if (CHECK(SUCCEEDED(Profiler->Export(ProfileFormat::JSON, Text))))
+    {
+        CHECK(Text.starts_with("{\n  \"frames\": [\n"));
+        CHECK(Text.ends_with("  }\n}\n"));
+        CHECK(Text.find("{ \"frame\": 2, ") != std::string::npos);
+        CHECK(Text.find("\"Flush\": 1.500") != std::string::npos);
+        CHECK(Text.find("\"Flush\": { \"count\": 3, \"mean\": 1.500, \"p50\": 1.500, \"p95\": 1.500, \"p99\": 1.500, \"max\": 1.500 },") != std::string::npos);
+        CHECK(Text.find("\"Total\": { \"count\": 3, ") != std::string::npos);
+        CHECK(std::count(Text.begin(), Text.end(), '{') == std::count(Text.begin(), Text.end(), '}'));
+        CHECK(std::count(Text.begin(), Text.end(), '[') == std::count(Text.begin(), Text.end(), ']'));
+    }
+}
+
+#else
+
+/// <summary>
+/// Checks that the stand-in profiler records and exports nothing. Configure with COMPOSITING_PROFILING to test the real profiler.
+/// </summary>
+TEST(FrameProfiler)
+{
+    FrameProfiler Profiler;
+
+    Profiler.BeginFrame();
+    Profiler.AddPhase(FramePhase::Draw, std::chrono::milliseconds(1));
+    Profiler.EndFrame();
+
+    CHECK(Profiler.GetFrameCount() == 0);
+
+    std::string Text;
+
+    CHECK(Profiler.Export(ProfileFormat::CSV, Text) == E_NOTIMPL);
+}
+
+#endif
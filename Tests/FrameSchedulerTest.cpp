@@ -0,0 +1,111 @@
+
+/** $VER: FrameSchedulerTest.cpp (2026.10.17) P. Stuer **/
+
+#include "Test.h"
+
+#include "FrameScheduler.h"
+
+#include <cmath>
+#include <limits>
+
+/// <summary>
+/// Returns true if two times are equal, give or take rounding.
+/// </summary>
+static bool IsSameTime(double a, double b) noexcept
+{
+    return std::abs(a - b) < 1e-9;
+}
+
+/// <summary>
+/// Checks that the vsync clock ignores invalid intervals and returns the first vsync strictly after a time, before and after its phase.
+/// </summary>
+TEST(VsyncClock)
+{
+    VsyncClock Clock;
+
+    CHECK(IsSameTime(Clock.GetInterval(), 1. / 60.));
+
+    Clock.SetInterval(.01);
+    Clock.SetInterval(0.);
+    Clock.SetInterval(-1.);
+
+    CHECK(IsSameTime(Clock.GetInterval(), .01));
+
+    Clock.Synchronize(.005);
+
+    CHECK(IsSameTime(Clock.GetNextVsync(.005), .015));
+    CHECK(IsSameTime(Clock.GetNextVsync(.012), .015));
+    CHECK(IsSameTime(Clock.GetNextVsync(0.), .005));
+    CHECK(IsSameTime(Clock.GetNextVsync(-.02), -.015));
+    CHECK(IsSameTime(Clock.GetNextVsync(10.001), 10.005));
+}
+
+/// <summary>
+/// Checks that the scheduler merges invalidations into one frame per vsync, counts frames that miss their vsync, serves animation ticks in order, and
+/// holds back frames and ticks while the window is occluded except for the periodic occlusion test.
+/// </summary>
+TEST(FrameScheduler)
+{
+    const double Infinity = std::numeric_limits<double>::infinity();
+
+    FrameScheduler Scheduler;
+
+    Scheduler.SetFrameInterval(.01);
+    Scheduler.Synchronize(0.);
+
+    // An idle window waits for nothing.
+    CHECK(!Scheduler.IsFrameDue(0.) && (Scheduler.GetWaitTime(0.) == Infinity));
+
+    Scheduler.Invalidate();
+    Scheduler.Invalidate();
+
+    CHECK(Scheduler.IsFrameDue(0.));
+
+    Scheduler.BeginFrame(.001);
+    Scheduler.EndFrame(.004);
+
+    CHECK(!Scheduler.IsFrameDue(.004));
+
+    // The next frame waits for the vsync after the start of the previous one.
+    Scheduler.Invalidate();
+
+    CHECK(!Scheduler.IsFrameDue(.005) && IsSameTime(Scheduler.GetWaitTime(.005), .005));
+    CHECK(Scheduler.IsFrameDue(.01));
+
+    Scheduler.BeginFrame(.01);
+    Scheduler.EndFrame(.035);
+
+    FrameSchedulerStatistics Statistics = Scheduler.GetStatistics();
+
+    CHECK((Statistics.Frames == 2) && (Statistics.Invalidations == 3) && (Statistics.Missed == 1) && IsSameTime(Statistics.MaxLateness, .015));
+
+    // Animation ticks: the earliest one wins and each is served once.
+    Scheduler.ScheduleTick(.1);
+    Scheduler.ScheduleTick(.2);
+
+    CHECK(IsSameTime(Scheduler.GetWaitTime(.05), .05));
+    CHECK(!Scheduler.TakeTick(.09) && Scheduler.TakeTick(.1) && !Scheduler.TakeTick(.1));
+
+    Scheduler.ScheduleTick(.3);
+    Scheduler.CancelTick();
+
+    CHECK(!Scheduler.TakeTick(1.) && (Scheduler.GetWaitTime(1.) == Infinity));
+
+    // An occluded window renders nothing and only wakes up for the occlusion test.
+    Scheduler.SetOccluded(true, 1.);
+    Scheduler.Invalidate();
+    Scheduler.ScheduleTick(1.);
+
+    CHECK(Scheduler.IsOccluded() && !Scheduler.IsFrameDue(2.) && !Scheduler.TakeTick(1.1));
+    CHECK(IsSameTime(Scheduler.GetWaitTime(1.), FrameScheduler::OcclusionTestInterval));
+    CHECK(!Scheduler.TakeOcclusionTest(1.1) && Scheduler.TakeOcclusionTest(1.25) && !Scheduler.TakeOcclusionTest(1.3));
+
+    // A window that shows again is redrawn and the held back tick is served.
+    Scheduler.SetOccluded(false, 1.4);
+
+    CHECK(!Scheduler.IsOccluded() && Scheduler.IsFrameDue(1.4) && Scheduler.TakeTick(1.4));
+
+    Statistics = Scheduler.GetStatistics();
+
+    CHECK((Statistics.Ticks == 2) && (Statistics.OcclusionTests == 1) && (Statistics.Invalidations == 5));
+}
@@ -0,0 +1,132 @@
+
+/** $VER: GlyphCacheTest.cpp (2026.10.17) P. Stuer **/
+
+#include "Test.h"
+
+#include "GlyphCache.h"
+
+#include <string.h>
+
+/// <summary>
+/// Returns true if the atlas holds the coverage of a glyph as rasterized on its own.
+/// </summary>
+static bool IsRasterized(const GlyphCache & cache, const CachedGlyph & glyph, const Font & font, WCHAR c, UINT phaseX, UINT phaseY) noexcept
+{
+    std::vector<BYTE> Coverage((size_t) glyph.Width * glyph.Height);
+
+    GlyphCache::Rasterize(font, c, phaseX, phaseY, Coverage.data(), glyph.Width, glyph.Width, glyph.Height);
+
+    for (UINT y = 0; y < glyph.Height; ++y)
+    {
+        if (::memcmp(cache.GetRow(glyph, y), Coverage.data() + (size_t) y * glyph.Width, glyph.Width) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Returns true if 2 glyphs share pixels in the atlas.
+/// </summary>
+static bool IsOverlapping(const CachedGlyph & a, const CachedGlyph & b) noexcept
+{
+    return (a.Page == b.Page) && (a.X < b.X + b.Width) && (b.X < a.X + a.Width) && (a.Y < b.Y + b.Height) && (b.Y < a.Y + a.Height);
+}
+
+/// <summary>
+/// Checks the hits and misses of the glyph cache, that the skyline packer fills a page without overlaps before it adds the next one, and that a
+/// full atlas clears its least recently used page.
+/// </summary>
+TEST(GlyphCache)
+{
+    const UINT PageSize = 64;
+
+    GlyphCache Cache(PageSize, 2);
+
+    const Font Font(10.f); // 1 pixel per cell: a glyph at phase 0 is 5 x 7 pixels.
+
+    CachedGlyph Glyph, Again;
+
+    CHECK(Cache.GetGlyph(Font, L'A', GlyphCache::SubpixelPositions, 0, Glyph) == E_INVALIDARG);
+
+    // A miss rasterizes the glyph, a hit returns the same location.
+    CHECK(SUCCEEDED(Cache.GetGlyph(Font, L'A', 0, 0, Glyph)) && (Glyph.Width == 5) && (Glyph.Height == 7));
+    CHECK(SUCCEEDED(Cache.GetGlyph(Font, L'A', 0, 0, Again)) && (::memcmp(&Glyph, &Again, sizeof(Glyph)) == 0));
+    CHECK(IsRasterized(Cache, Glyph, Font, L'A', 0, 0));
+
+    // Other phases are other glyphs with their own bitmap.
+    CHECK(SUCCEEDED(Cache.GetGlyph(Font, L'A', 2, 3, Again)) && (Again.Width == 6) && (Again.Height == 8) && !IsOverlapping(Glyph, Again));
+    CHECK(IsRasterized(Cache, Again, Font, L'A', 2, 3));
+
+    // A space has no pixels.
+    CHECK(SUCCEEDED(Cache.GetGlyph(Font, L' ', 0, 0, Again)) && (Again.Width == 0));
+
+    GlyphCacheStatistics Statistics = Cache.GetStatistics();
+
+    CHECK((Statistics.Hits == 1) && (Statistics.Misses == 3) && (Statistics.Glyphs == 3) && (Statistics.Pages == 1));
+    CHECK(std::abs(Statistics.HitRate - .25f) < 1e-6f);
+
+    // A glyph that is larger than a page cannot be cached.
+    CHECK(Cache.GetGlyph(::Font(200.f), L'A', 0, 0, Again) == E_INVALIDARG);
+
+    // The skyline packs 12 x 9 glyphs of 5 x 7 pixels in a 64 x 64 page.
+    Cache.Clear();
+    Cache.ResetStatistics();
+
+    const UINT GlyphsPerPage = (PageSize / 5) * (PageSize / 7);
+
+    std::vector<CachedGlyph> Glyphs(2 * GlyphsPerPage);
+
+    for (UINT i = 0; i < 2 * GlyphsPerPage; ++i)
+    {
+        const WCHAR c = (WCHAR) (0x100 + i); // Distinct keys; characters outside the font are drawn as a question mark.
+
+        if (!CHECK(SUCCEEDED(Cache.GetGlyph(Font, c, 0, 0, Glyphs[i]))))
+            return;
+
+        CHECK(Glyphs[i].Page == ((i < GlyphsPerPage) ? 0u : 1u));
+        CHECK((Glyphs[i].X + Glyphs[i].Width <= PageSize) && (Glyphs[i].Y + Glyphs[i].Height <= PageSize));
+
+        if (i == GlyphsPerPage - 1)
+            CHECK(std::abs(Cache.GetStatistics().Occupancy - (FLOAT) (GlyphsPerPage * 35) / (FLOAT) (PageSize * PageSize)) < 1e-6f);
+    }
+
+    for (UINT i = 0; i < Glyphs.size(); ++i)
+    {
+        for (UINT j = i + 1; j < Glyphs.size(); ++j)
+        {
+            if (IsOverlapping(Glyphs[i], Glyphs[j]))
+            {
+                CHECK(false);
+
+                i = j = (UINT) Glyphs.size();
+            }
+        }
+    }
+
+    CHECK(IsRasterized(Cache, Glyphs[0], Font, 0x100, 0, 0) && IsRasterized(Cache, Glyphs.back(), Font, (WCHAR) (0x100 + Glyphs.size() - 1), 0, 0));
+
+    Statistics = Cache.GetStatistics();
+
+    CHECK((Statistics.Pages == 2) && (Statistics.Glyphs == 2 * GlyphsPerPage) && (Statistics.Evictions == 0));
+
+    // Using a glyph of the first page makes the second page the least recently used one, so it gets cleared for the next glyph.
+    CHECK(SUCCEEDED(Cache.GetGlyph(Font, 0x100, 0, 0, Again)) && (Again.Page == 0));
+
+    CHECK(SUCCEEDED(Cache.GetGlyph(Font, L'B', 0, 0, Glyph)));
+    CHECK((Glyph.Page == 1) && (Glyph.X == 0) && (Glyph.Y == 0));
+    CHECK(IsRasterized(Cache, Glyph, Font, L'B', 0, 0));
+
+    Statistics = Cache.GetStatistics();
+
+    CHECK((Statistics.Pages == 2) && (Statistics.Glyphs == GlyphsPerPage + 1) && (Statistics.Evictions == 1));
+
+    // The glyphs of the first page are still there; the ones of the second page have to be rasterized again.
+    const uint64_t Misses = Statistics.Misses;
+
+    CHECK(SUCCEEDED(Cache.GetGlyph(Font, 0x101, 0, 0, Again)) && (::memcmp(&Again, &Glyphs[1], sizeof(Again)) == 0));
+    CHECK(Cache.GetStatistics().Misses == Misses);
+
+    CHECK(SUCCEEDED(Cache.GetGlyph(Font, (WCHAR) (0x100 + GlyphsPerPage), 0, 0, Again)) && (Again.Page == 1));
+    CHECK(Cache.GetStatistics().Misses == Misses + 1);
+}
@@ -0,0 +1,123 @@
+
+/** $VER: ImageCacheTest.cpp (2026.10.17) P. Stuer **/
+
+#include "Test.h"
+
+#include "ImageCache.h"
+
+/// <summary>
+/// Creates a raster of the specified size.
+/// </summary>
+static std::shared_ptr<const Raster> CreateImage(UINT width, UINT height) noexcept
+{
+    auto Image = std::make_shared<Raster>();
+
+    if (FAILED(Image->Initialize(width, height)))
+        return nullptr;
+
+    return Image;
+}
+
+/// <summary>
+/// Checks the size accounting and the least recently used eviction of the image cache, that requests for a smaller size are served from a
+/// cached level instead of decoding the source again, and that a decode for a smaller size keeps the mip chain.
+/// </summary>
+TEST(ImageCache)
+{
+    const auto a = CreateImage(100, 100), b = CreateImage(100, 100), c = CreateImage(100, 100), d = CreateImage(100, 100);
+
+    if (!CHECK((a != nullptr) && (b != nullptr) && (c != nullptr) && (d != nullptr)))
+        return;
+
+    const size_t Size = a->Size();
+
+    ImageCache Cache(Size * 3);
+
+    CHECK(Cache.Insert(L"a", a) == S_OK);
+    CHECK(Cache.Insert(L"b", b) == S_OK);
+    CHECK(Cache.Insert(L"c", c) == S_OK);
+
+    ImageCacheStatistics Statistics = Cache.GetStatistics();
+
+    CHECK((Statistics.Size == Size * 3) && (Statistics.Count == 3) && (Statistics.Evictions == 0));
+
+    // Using a makes b the least recently used image, so b gets evicted.
+    CHECK(Cache.Find(L"a", 100, 100) == a);
+    CHECK(Cache.Insert(L"d", d) == S_OK);
+
+    CHECK(Cache.Find(L"b", 100, 100) == nullptr);
+    CHECK(Cache.Find(L"a", 100, 100) == a);
+    CHECK(Cache.Find(L"c", 100, 100) == c);
+    CHECK(Cache.Find(L"d", 100, 100) == d);
+
+    Statistics = Cache.GetStatistics();
+
+    CHECK((Statistics.Size == Size * 3) && (Statistics.Count == 3) && (Statistics.Evictions == 1));
+
+    // An image of the same source and size replaces the cached one.
+    CHECK(Cache.Insert(L"a", b) == S_OK);
+    CHECK(Cache.Find(L"a", 100, 100) == b);
+    CHECK(Cache.GetStatistics().Size == Size * 3);
+
+    // An image larger than the budget is not kept.
+    CHECK(Cache.Insert(L"e", CreateImage(200, 200)) == S_FALSE);
+    CHECK(Cache.Find(L"e", 200, 200) == nullptr);
+    CHECK(Cache.GetStatistics().Size == Size * 3);
+
+    CHECK(Cache.Insert(L"e", std::make_shared<Raster>()) == E_INVALIDARG);
+
+    Cache.Remove(L"a");
+
+    Statistics = Cache.GetStatistics();
+
+    CHECK((Statistics.Size == Size * 2) && (Statistics.Count == 2));
+
+    Cache.SetBudget(Size);
+
+    Statistics = Cache.GetStatistics();
+
+    CHECK((Statistics.Size == Size) && (Statistics.Count == 1) && (Statistics.Evictions == 2));
+
+    Cache.Clear();
+
+    CHECK(Cache.GetStatistics().Size == 0);
+
+    // Misses decode the source, smaller sizes are scaled from the cached level and repeated requests are hits.
+    Cache.SetBudget(ImageCache::DefaultBudget);
+    Cache.ResetStatistics();
+
+    UINT Loads = 0;
+
+    auto Loader = [&Loads](Raster & raster) -> HRESULT
+    {
+        ++Loads;
+
+        return raster.Initialize(400, 300);
+    };
+
+    std::shared_ptr<const Raster> Image;
+
+    CHECK(SUCCEEDED(Cache.Get(L"f", 400, 300, Loader, Image)) && (Image != nullptr) && (Image->Width() == 400));
+    CHECK(SUCCEEDED(Cache.Fit(L"f", 200, 200, 400, 300, Loader, Image)) && (Image != nullptr) && (Image->Width() == 200) && (Image->Height() == 150));
+    CHECK(SUCCEEDED(Cache.Get(L"f", 200, 150, Loader, Image)) && (Image != nullptr));
+
+    Statistics = Cache.GetStatistics();
+
+    CHECK(Loads == 1);
+    CHECK((Statistics.Misses == 1) && (Statistics.LevelHits == 1) && (Statistics.Hits == 1));
+    CHECK(Statistics.Size == Cache.Find(L"f", 400, 300)->Size() + Cache.Find(L"f", 200, 150)->Size()); // The rows are padded to cache lines.
+
+    // A miss for a smaller size keeps the mip chain of the decoded image, so that other sizes are scaled from the nearest level.
+    CHECK(SUCCEEDED(Cache.Get(L"h", 100, 75, Loader, Image)) && (Image != nullptr) && (Image->Width() == 100) && (Image->Height() == 75));
+
+    CHECK(Loads == 2);
+    CHECK((Cache.Find(L"h", 400, 300) != nullptr) && (Cache.Find(L"h", 200, 150) != nullptr) && (Cache.Find(L"h", 1, 1) != nullptr));
+
+    Cache.Remove(L"h");
+
+    // A failed decode is not cached.
+    auto Failing = [](Raster &) -> HRESULT { return E_FAIL; };
+
+    CHECK(Cache.Get(L"g", 10, 10, Failing, Image) == E_FAIL);
+    CHECK(Cache.GetStatistics().Count == 2);
+}
@@ -0,0 +1,94 @@
+
+/** $VER: ImageLoaderTest.cpp (2026.10.17) P. Stuer **/
+
+#include "Test.h"
+
+#include "ImageLoader.h"
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <future>
+#include <thread>
+
+/// <summary>
+/// Waits until the loader has no stage queued or running.
+/// </summary>
+static bool WaitIdle(const ImageLoader & loader) noexcept
+{
+    for (UINT i = 0; i < 10000; ++i)
+    {
+        if (!loader.IsBusy())
+            return true;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return false;
+}
+
+/// <summary>
+/// Checks that a newer load supersedes an older one that is still decoding, that a cancelled load never publishes a result, that a result is
+/// scaled to fit and can only be taken once, and that a failed decode is reported.
+/// </summary>
+TEST(ImageLoader)
+{
+    ThreadPool Pool(2);
+
+    std::atomic<UINT> Completions(0);
+
+    ImageLoader Loader([&Completions]() { ++Completions; }, &Pool);
+
+    WCHAR Source[16] = { };
+    std::shared_ptr<const Raster> Image;
+
+    CHECK(Loader.Load(L"a", [](Raster & raster) { return raster.Initialize(1, 1); }, 0, 100) == E_INVALIDARG);
+
+    // The first load decodes until the gate opens. The second load supersedes it meanwhile.
+    {
+        std::promise<void> Gate;
+        std::shared_future<void> IsOpen = Gate.get_future().share();
+
+        auto Slow = [IsOpen](Raster & raster) { IsOpen.wait(); return raster.Initialize(10, 10); };
+        auto Fast = [](Raster & raster) { return raster.Initialize(400, 300); };
+
+        CHECK(SUCCEEDED(Loader.Load(L"a", Slow, 200, 200)));
+        CHECK(SUCCEEDED(Loader.Load(L"b", Fast, 200, 200)));
+
+        Gate.set_value();
+
+        CHECK(WaitIdle(Loader));
+
+        CHECK(Loader.GetResult(Source, _countof(Source), Image) == S_OK);
+        CHECK(::wcscmp(Source, L"b") == 0);
+        CHECK((Image != nullptr) && (Image->Width() == 200) && (Image->Height() == 150));
+
+        CHECK(Loader.GetResult(Source, _countof(Source), Image) == E_PENDING);
+        CHECK(Completions == 1);
+    }
+
+    // A cancelled load publishes nothing.
+    {
+        std::promise<void> Gate;
+        std::shared_future<void> IsOpen = Gate.get_future().share();
+
+        CHECK(SUCCEEDED(Loader.Load(L"c", [IsOpen](Raster & raster) { IsOpen.wait(); return raster.Initialize(10, 10); }, 200, 200)));
+
+        Loader.Cancel();
+
+        Gate.set_value();
+
+        CHECK(WaitIdle(Loader));
+
+        CHECK(Loader.GetResult(Source, _countof(Source), Image) == E_PENDING);
+        CHECK(Completions == 1);
+    }
+
+    // A failed decode is the result of the load.
+    CHECK(SUCCEEDED(Loader.Load(L"d", [](Raster &) { return E_FAIL; }, 200, 200)));
+
+    CHECK(WaitIdle(Loader));
+
+    CHECK(Loader.GetResult(Source, _countof(Source), Image) == E_FAIL);
+    CHECK(Image == nullptr);
+    CHECK(Completions == 2);
+}
@@ -0,0 +1,138 @@
+
+/** $VER: LinearLightTest.cpp (2026.10.17) P. Stuer **/
+
+#include "Test.h"
+
+#include "LinearLight.h"
+
+#include <vector>
+
+/// <summary>
+/// Checks the conversions to and from linear light: every 8-bit value and every premultiplied gray round-trips exactly, every linear value encodes
+/// monotonically, and every instruction set decodes, encodes and fills to the same values. Fills keep opaque pixels opaque, and long fills, which
+/// look the destination up in tables of blended gray levels, match fills of a pixel at a time.
+/// </summary>
+TEST(LinearLight)
+{
+    for (uint32_t i = 0; i < 256; ++i)
+        CHECK(LinearLight::ToSRGB(LinearLight::ToLinear(i)) == i);
+
+    CHECK(LinearLight::ToSRGB(LinearLight::One) == 255);
+
+    for (uint32_t a = 0; a < 256; ++a)
+    {
+        for (uint32_t c = 0; c <= a; ++c)
+        {
+            const uint32_t Pixel = (a << 24) | (c * 0x010101u);
+
+            uint16_t Linear[4];
+
+            LinearLight::Decode(Pixel, Linear);
+
+            CHECK(LinearLight::Encode(Linear) == Pixel);
+        }
+    }
+
+    // Every linear value, as an opaque gray: every instruction set encodes it to the same value, and the encoding never decreases.
+    {
+        const UINT Levels = LinearLight::One + 1;
+
+        std::vector<uint16_t> Linear((size_t) Levels * 4);
+        std::vector<uint32_t> Reference(Levels), Result(Levels);
+
+        for (uint32_t i = 0; i < Levels; ++i)
+        {
+            Linear[i * 4] = Linear[i * 4 + 1] = Linear[i * 4 + 2] = (uint16_t) i;
+            Linear[i * 4 + 3] = LinearLight::One;
+        }
+
+        LinearLight::GetEncodeFunction(InstructionSet::Scalar)(Linear.data(), Reference.data(), Levels);
+
+        for (uint32_t i = 1; i < Levels; ++i)
+            CHECK((Reference[i] & 0xFF) >= (Reference[i - 1] & 0xFF));
+
+        for (InstructionSet Set : Test::GetInstructionSets())
+        {
+            LinearLight::GetEncodeFunction(Set)(Linear.data(), Result.data(), Levels);
+
+            CHECK(Result == Reference);
+        }
+    }
+
+    const UINT Count = 1003;
+
+    std::vector<uint32_t> Src(Count), Reference(Count), Result(Count);
+    std::vector<uint16_t> LinearReference((size_t) Count * 4), Linear((size_t) Count * 4);
+
+    for (UINT Trial = 0; Trial < 3; ++Trial)
+    {
+        // Opaque pixels, runs of opaque and translucent pixels, and random pixels.
+        for (UINT i = 0; i < Count; ++i)
+        {
+            const uint32_t Pixel = test.RandomPixel();
+
+            Src[i] = ((Trial == 0) || ((Trial == 1) && ((i / 8) % 2 != 0))) ? Pixel | 0xFF000000u : Pixel;
+        }
+
+        LinearLight::GetDecodeFunction(InstructionSet::Scalar)(Src.data(), LinearReference.data(), Count);
+        LinearLight::GetEncodeFunction(InstructionSet::Scalar)(LinearReference.data(), Reference.data(), Count);
+
+        if (Trial == 0)
+            CHECK(Reference == Src);
+
+        for (InstructionSet Set : Test::GetInstructionSets())
+        {
+            LinearLight::GetDecodeFunction(Set)(Src.data(), Linear.data(), Count);
+
+            CHECK(Linear == LinearReference);
+
+            LinearLight::GetEncodeFunction(Set)(LinearReference.data(), Result.data(), Count);
+
+            CHECK(Result == Reference);
+        }
+
+        // Short and long fills. Every color fills twice, so that a long fill blends every pixel the first time and looks the pixels up in the
+        // table the second time. The colors alternate so that the table has to be rebuilt.
+        for (UINT n : { 100u, Count })
+        {
+            for (uint32_t Color : { 0x40302010u, 0x80808080u, 0x40302010u, 0xFF102030u, 0u })
+            {
+                Reference = Src;
+
+                for (UINT i = 0; i < n; ++i)
+                    LinearLight::GetFillFunction(InstructionSet::Scalar)(Color, Reference.data() + i, 1);
+
+                for (InstructionSet Set : Test::GetInstructionSets())
+                {
+                    for (UINT Pass = 0; Pass < 2; ++Pass)
+                    {
+                        Result = Src;
+
+                        LinearLight::GetFillFunction(Set)(Color, Result.data(), n);
+
+                        CHECK(Result == Reference);
+                    }
+                }
+            }
+        }
+    }
+
+    // Translucent colors over opaque pixels.
+    for (uint32_t a = 1; a < 255; ++a)
+    {
+        const uint32_t Color = (a << 24) | (a / 2 * 0x010101u);
+
+        for (InstructionSet Set : Test::GetInstructionSets())
+        {
+            uint32_t Pixels[9];
+
+            for (uint32_t i = 0; i < _countof(Pixels); ++i)
+                Pixels[i] = 0xFF000000u | (i * 0x1F1F1Fu);
+
+            LinearLight::GetFillFunction(Set)(Color, Pixels, _countof(Pixels));
+
+            for (uint32_t Pixel : Pixels)
+                CHECK((Pixel >> 24) == 255);
+        }
+    }
+}
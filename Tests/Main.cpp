@@ -0,0 +1,12 @@
+
+/** $VER: Main.cpp (2026.10.17) P. Stuer **/
+
+#include "Test.h"
+
+/// <summary>
+/// Entry point of the test runner.
+/// </summary>
+int main(int argc, char * argv[])
+{
+    return Test::Run(argc, argv);
+}
@@ -0,0 +1,81 @@
+
+/** $VER: MappedFileTest.cpp (2026.10.17) P. Stuer **/
+
+#include "Test.h"
+
+#include "MappedFile.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string.h>
+
+/// <summary>
+/// Checks that a mapped file shows the contents of the file, that an empty file opens without a view, that a missing file fails to open,
+/// and that moving a mapping transfers it.
+/// </summary>
+TEST(MappedFile)
+{
+    const std::filesystem::path Directory = std::filesystem::temp_directory_path();
+    const std::filesystem::path FilePath = Directory / "MappedFileTest.bin";
+    const std::filesystem::path EmptyFilePath = Directory / "MappedFileTest.empty";
+
+    // Not a multiple of the page size, so the last page is partially filled.
+    std::vector<char> Contents(3 * 4096 + 123);
+
+    for (char & c : Contents)
+        c = (char) test.Random();
+
+    {
+        std::ofstream File(FilePath, std::ios::binary | std::ios::trunc);
+
+        File.write(Contents.data(), (std::streamsize) Contents.size());
+
+        std::ofstream EmptyFile(EmptyFilePath, std::ios::binary | std::ios::trunc);
+
+        if (!CHECK(File.good() && EmptyFile.good()))
+            return;
+    }
+
+    for (FileAccess Access : { FileAccess::Sequential, FileAccess::Random })
+    {
+        MappedFile File;
+
+        CHECK(!File.IsOpen() && (File.Data() == nullptr) && (File.Size() == 0));
+
+        if (!CHECK(SUCCEEDED(File.Open(FilePath.wstring().c_str(), Access))))
+            continue;
+
+        CHECK(File.IsOpen() && (File.Data() != nullptr) && (File.Size() == Contents.size()));
+        CHECK(::memcmp(File.Data(), Contents.data(), Contents.size()) == 0);
+
+        // Moving transfers the mapping; the source is left closed.
+        MappedFile Moved(std::move(File));
+
+        CHECK(!File.IsOpen() && (File.Data() == nullptr) && (File.Size() == 0));
+        CHECK(Moved.IsOpen() && (Moved.Size() == Contents.size()) && (::memcmp(Moved.Data(), Contents.data(), Contents.size()) == 0));
+
+        File = std::move(Moved);
+
+        CHECK(File.IsOpen() && !Moved.IsOpen() && (::memcmp(File.Data(), Contents.data(), Contents.size()) == 0));
+
+        File.Close();
+
+        CHECK(!File.IsOpen() && (File.Data() == nullptr) && (File.Size() == 0));
+    }
+
+    {
+        MappedFile File;
+
+        CHECK(SUCCEEDED(File.Open(EmptyFilePath.wstring().c_str())) && File.IsOpen() && (File.Size() == 0) && (File.Data() == nullptr));
+
+        // Opening another file closes the current one; a failed open leaves the instance closed.
+        CHECK(SUCCEEDED(File.Open(FilePath.wstring().c_str())) && (File.Size() == Contents.size()));
+        CHECK(FAILED(File.Open((Directory / "MappedFileTest.missing").wstring().c_str())));
+        CHECK(!File.IsOpen() && (File.Data() == nullptr));
+    }
+
+    std::error_code ec;
+
+    std::filesystem::remove(FilePath, ec);
+    std::filesystem::remove(EmptyFilePath, ec);
+}
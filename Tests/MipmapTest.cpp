@@ -0,0 +1,65 @@
+
+/** $VER: MipmapTest.cpp (2026.10.17) P. Stuer **/
+
+#include "Test.h"
+
+#include "Mipmap.h"
+
+#include <string.h>
+
+/// <summary>
+/// Checks that every instruction set halves an image to the exact 2 x 2 box average, rounded to nearest, for odd and even sizes. The last column
+/// and row of an odd size are averaged with themselves.
+/// </summary>
+TEST(Mipmap)
+{
+    const InstructionSet Saved = Mipmap::GetInstructionSet();
+
+    for (UINT Width = 1; Width < 70; Width += 3)
+    {
+        for (UINT Height = 1; Height < 9; ++Height)
+        {
+            Raster Src;
+
+            if (!CHECK(SUCCEEDED(Src.Initialize(Width, Height))))
+                return;
+
+            for (UINT y = 0; y < Height; ++y)
+            {
+                uint32_t * p = (uint32_t *) Src.Row(y);
+
+                for (UINT x = 0; x < Width; ++x)
+                    p[x] = test.RandomPixel();
+            }
+
+            for (InstructionSet Set : Test::GetInstructionSets())
+            {
+                Raster Dst;
+
+                Mipmap::SetInstructionSet(Set);
+
+                if (!CHECK(SUCCEEDED(Mipmap::Halve(Src, Dst))))
+                    continue;
+
+                if (!CHECK((Dst.Width() == (Width + 1) / 2) && (Dst.Height() == (Height + 1) / 2)))
+                    continue;
+
+                for (UINT y = 0; y < Dst.Height(); ++y)
+                {
+                    for (UINT x = 0; x < Dst.Width(); ++x)
+                    {
+                        const UINT x0 = 2 * x, x1 = (std::min)(x0 + 1, Width - 1);
+                        const UINT y0 = 2 * y, y1 = (std::min)(y0 + 1, Height - 1);
+
+                        const BYTE * p[4] = { Src.Row(y0) + 4 * x0, Src.Row(y0) + 4 * x1, Src.Row(y1) + 4 * x0, Src.Row(y1) + 4 * x1 };
+
+                        for (UINT c = 0; c < 4; ++c)
+                            CHECK(Dst.Row(y)[4 * x + c] == ((p[0][c] + p[1][c] + p[2][c] + p[3][c] + 2) >> 2));
+                    }
+                }
+            }
+        }
+    }
+
+    Mipmap::SetInstructionSet(Saved);
+}
@@ -0,0 +1,79 @@
+
+/** $VER: PixelConverterTest.cpp (2026.10.17) P. Stuer **/
+
+#include "Test.h"
+
+#include "PixelConverter.h"
+
+#include <vector>
+
+/// <summary>
+/// Checks that every pair of formats converts and that every instruction set converts a row to the same bytes, for widths around the vector
+/// sizes, and that premultiplication rounds to nearest.
+/// </summary>
+TEST(PixelConverter)
+{
+    const PixelFormat Formats[] = { PixelFormat::PBGRA32, PixelFormat::BGRA32, PixelFormat::RGBA32, PixelFormat::BGR24, PixelFormat::RGB24 };
+
+    const UINT MaxWidth = 70;
+
+    std::vector<BYTE> Src(MaxWidth * 4), Reference(MaxWidth * 4), Dst(MaxWidth * 4);
+
+    for (PixelFormat SrcFormat : Formats)
+    {
+        for (PixelFormat DstFormat : Formats)
+        {
+            if (!CHECK(PixelConverter::IsSupported(SrcFormat, DstFormat)))
+                continue;
+
+            for (UINT Width = 0; Width < MaxWidth; ++Width)
+            {
+                for (UINT i = 0; i < Width; ++i)
+                {
+                    const uint32_t Pixel = test.RandomPixel(); // Premultiplied, so it is valid in every 32-bit format.
+
+                    ::memcpy(Src.data() + (size_t) i * 4, &Pixel, 4);
+                }
+
+                const PixelConverter::RowFunction Scalar = PixelConverter::GetRowFunction(SrcFormat, DstFormat, InstructionSet::Scalar);
+
+                if (!CHECK(Scalar != nullptr))
+                    continue;
+
+                Scalar(Src.data(), Reference.data(), Width);
+
+                for (InstructionSet Set : Test::GetInstructionSets())
+                {
+                    const PixelConverter::RowFunction Convert = PixelConverter::GetRowFunction(SrcFormat, DstFormat, Set);
+
+                    Convert(Src.data(), Dst.data(), Width);
+
+                    CHECK(::memcmp(Reference.data(), Dst.data(), (size_t) Width * GetBitsPerPixel(DstFormat) / 8) == 0);
+                }
+            }
+        }
+    }
+
+    // Premultiplication: (c * a + 127) / 255 for every color and alpha.
+    for (InstructionSet Set : Test::GetInstructionSets())
+    {
+        const PixelConverter::RowFunction Premultiply = PixelConverter::GetRowFunction(PixelFormat::BGRA32, PixelFormat::PBGRA32, Set);
+
+        std::vector<uint32_t> Straight(256), Premultiplied(256);
+
+        for (uint32_t a = 0; a < 256; ++a)
+        {
+            for (uint32_t c = 0; c < 256; ++c)
+                Straight[c] = (a << 24) | (c << 16) | ((255 - c) << 8) | c;
+
+            Premultiply((const BYTE *) Straight.data(), (BYTE *) Premultiplied.data(), 256);
+
+            for (uint32_t c = 0; c < 256; ++c)
+            {
+                const uint32_t Expected = (a << 24) | (((c * a + 127) / 255) << 16) | ((((255 - c) * a + 127) / 255) << 8) | ((c * a + 127) / 255);
+
+                CHECK(Premultiplied[c] == Expected);
+            }
+        }
+    }
+}
@@ -0,0 +1,150 @@
+
+/** $VER: RasterTest.cpp (2026.10.17) P. Stuer **/
+
+#include "Test.h"
+
+#include "Raster.h"
+
+#include <string.h>
+
+/// <summary>
+/// Checks the size classes of the raster allocator, that released buffers are reused from the pool, and that the pool frees its least recently
+/// released buffers to stay within its budget.
+/// </summary>
+TEST(RasterAllocator)
+{
+    CHECK(RasterAllocator::GetSizeClass(1) == 4096);
+    CHECK(RasterAllocator::GetSizeClass(4096) == 4096);
+    CHECK(RasterAllocator::GetSizeClass(4097) == 8192);
+    CHECK(RasterAllocator::GetSizeClass(65536) == 65536);
+    CHECK(RasterAllocator::GetSizeClass(65537) == 65536 + 8192);
+    CHECK(RasterAllocator::GetSizeClass(1000000) == 1048576);
+    CHECK(RasterAllocator::GetSizeClass(1048577) == 1048576 + 131072);
+
+    RasterAllocator Allocator(64 * 1024);
+
+    size_t Capacity1 = 0, Capacity2 = 0, Capacity3 = 0;
+
+    CHECK(Allocator.Allocate(0, Capacity1) == nullptr);
+
+    BYTE * Data1 = Allocator.Allocate(5000, Capacity1);
+
+    if (!CHECK(Data1 != nullptr))
+        return;
+
+    CHECK((Capacity1 == 8192) && (((uintptr_t) Data1 % RasterAllocator::Alignment) == 0));
+
+    RasterAllocatorStatistics Statistics = Allocator.GetStatistics();
+
+    CHECK((Statistics.BytesLive == 8192) && (Statistics.BytesPooled == 0) && (Statistics.Allocations == 1) && (Statistics.PoolHits == 0));
+
+    // A released buffer is handed out again for a request of the same size class.
+    Allocator.Release(Data1, Capacity1);
+
+    Statistics = Allocator.GetStatistics();
+
+    CHECK((Statistics.BytesLive == 0) && (Statistics.BytesPooled == 8192));
+
+    BYTE * Data2 = Allocator.Allocate(8000, Capacity2);
+
+    CHECK((Data2 == Data1) && (Capacity2 == Capacity1));
+
+    Statistics = Allocator.GetStatistics();
+
+    CHECK((Statistics.BytesLive == 8192) && (Statistics.BytesPooled == 0) && (Statistics.Allocations == 2) && (Statistics.PoolHits == 1));
+
+    Allocator.MarkFrame();
+
+    CHECK(Allocator.GetStatistics().FrameAllocations == 2);
+
+    // 2 buffers of 40 kB do not fit in a pool of 64 kB: the one released first is freed.
+    Data1 = Allocator.Allocate(40 * 1024, Capacity1);
+    BYTE * Data3 = Allocator.Allocate(40 * 1024, Capacity3);
+
+    Allocator.MarkFrame();
+
+    CHECK(Allocator.GetStatistics().FrameAllocations == 2);
+
+    Allocator.Release(Data1, Capacity1);
+    Allocator.Release(Data3, Capacity3);
+    Allocator.Release(Data2, Capacity2);
+
+    Statistics = Allocator.GetStatistics();
+
+    CHECK((Statistics.BytesLive == 0) && (Statistics.BytesPooled == 40 * 1024 + 8192));
+
+    // A buffer larger than the budget is never pooled.
+    Data1 = Allocator.Allocate(100 * 1024, Capacity1);
+
+    Allocator.Release(Data1, Capacity1);
+
+    CHECK(Allocator.GetStatistics().BytesPooled == 40 * 1024 + 8192);
+
+    Allocator.Trim();
+
+    CHECK(Allocator.GetStatistics().BytesPooled == 0);
+}
+
+/// <summary>
+/// Checks the layout of a raster: rows padded to cache lines, a zero-filled buffer and a stride that fits in 32 bits, and that rasters move, copy,
+/// reuse their buffer and clip views.
+/// </summary>
+TEST(Raster)
+{
+    Raster r;
+
+    CHECK(r.IsEmpty() && (r.Initialize(0, 1) == E_INVALIDARG));
+    CHECK((r.Initialize(0x40000000, 1) == E_INVALIDARG) && r.IsEmpty());
+
+    if (!CHECK(SUCCEEDED(r.Initialize(100, 10))))
+        return;
+
+    CHECK((r.Stride() == 448) && (r.Size() == 448 * 10) && (((uintptr_t) r.Data() % RasterAllocator::Alignment) == 0));
+
+    bool IsZero = true;
+
+    for (size_t i = 0; i < r.Size(); ++i)
+        IsZero &= (r.Data()[i] == 0);
+
+    CHECK(IsZero);
+
+    for (UINT y = 0; y < r.Height(); ++y)
+    {
+        uint32_t * p = (uint32_t *) r.Row(y);
+
+        for (UINT x = 0; x < r.Width(); ++x)
+            p[x] = test.RandomPixel();
+    }
+
+    // Copies are explicit.
+    Raster Copy;
+
+    CHECK(SUCCEEDED(Copy.CopyFrom(r)) && (Copy.Width() == 100) && (Copy.Height() == 10) && (Copy.Data() != r.Data()));
+    CHECK(::memcmp(Copy.Data(), r.Data(), r.Size()) == 0);
+
+    // Moving transfers the buffer and leaves the source empty.
+    const BYTE * Data = r.Data();
+
+    Raster Moved(std::move(r));
+
+    CHECK((Moved.Data() == Data) && r.IsEmpty() && (r.Width() == 0) && (r.Size() == 0));
+
+    r = std::move(Moved);
+
+    CHECK((r.Data() == Data) && Moved.IsEmpty());
+
+    // A size of the same size class reuses the buffer and clears it.
+    CHECK(SUCCEEDED(r.Initialize(101, 10)) && (r.Data() == Data) && (((const uint32_t *) r.Row(9))[100] == 0));
+
+    // Views are clipped to the raster.
+    const ConstRasterView View = Copy.GetView({ -5, 8, 10, 20 });
+
+    CHECK((View.Width() == 10) && (View.Height() == 2) && (View.Row(0) == Copy.Row(8)) && (View.Stride() == Copy.Stride()));
+    CHECK(Copy.GetView({ 100, 0, 110, 10 }).IsEmpty());
+
+    CHECK(SUCCEEDED(r.Initialize(1000, 3)) && (r.Stride() == 4032) && (r.Size() == (size_t) 4032 * 3));
+
+    r.Reset();
+
+    CHECK(r.IsEmpty() && (r.Size() == 0));
+}
@@ -0,0 +1,83 @@
+
+/** $VER: ResizeTrackerTest.cpp (2026.10.17) P. Stuer **/
+
+#include "Test.h"
+
+#include "ResizeTracker.h"
+
+#include <thread>
+
+/// <summary>
+/// Checks the detection of live resizes, inside a move/size loop and from the rate of the size changes, that a resize settles once the size has
+/// not changed for the settle delay, and the frame times of the live resize.
+/// </summary>
+TEST(ResizeTracker)
+{
+    // Outside a move/size loop a single resize is not live, a second one within the settle delay is.
+    {
+        ResizeTracker Tracker;
+
+        CHECK(!Tracker.Resize());
+        CHECK(!Tracker.IsLive());
+
+        CHECK(Tracker.Resize());
+        CHECK(Tracker.IsLive());
+
+        CHECK(Tracker.Resize());
+        CHECK(!Tracker.Settle()); // The size changed less than the settle delay ago.
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(ResizeTracker::SettleDelay + 20));
+
+        CHECK(Tracker.Settle());
+        CHECK(!Tracker.IsLive());
+        CHECK(!Tracker.Settle()); // The high-quality pass is due only once.
+    }
+
+    // Inside a move/size loop every resize is live until the loop ends, whatever the delay.
+    {
+        ResizeTracker Tracker;
+
+        Tracker.SetFrameInterval(.01);
+
+        Tracker.AddFrame(.5); // Not live: ignored
+
+        Tracker.BeginMove();
+
+        CHECK(Tracker.IsMoving());
+        CHECK(!Tracker.EndMove()); // A move without a size change needs no high-quality pass.
+        CHECK(!Tracker.IsMoving());
+
+        Tracker.BeginMove();
+
+        CHECK(Tracker.Resize());
+
+        Tracker.AddFrame(.005);
+        Tracker.AddFrame(.015);
+        Tracker.AddFrame(.010);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(ResizeTracker::SettleDelay + 20));
+
+        CHECK(!Tracker.Settle());
+        CHECK(Tracker.IsLive());
+
+        CHECK(Tracker.EndMove());
+        CHECK(!Tracker.IsLive());
+
+        // The statistics of the last live resize remain available after it ended.
+        const ResizeStatistics Statistics = Tracker.GetStatistics();
+
+        CHECK(Statistics.Frames == 3);
+        CHECK(Statistics.Missed == 1);
+        CHECK(std::abs(Statistics.Average - .01) < 1e-9);
+        CHECK(Statistics.Maximum == .015);
+        CHECK(Statistics.Interval == .01);
+
+        // A new live resize starts with new statistics.
+        Tracker.BeginMove();
+
+        CHECK(Tracker.Resize());
+        CHECK(Tracker.GetStatistics().Frames == 0);
+
+        CHECK(Tracker.EndMove());
+    }
+}
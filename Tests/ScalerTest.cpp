@@ -0,0 +1,215 @@
+
+/** $VER: ScalerTest.cpp (2026.10.17) P. Stuer **/
+
+#include "Test.h"
+
+#include "Raster.h"
+#include "Scaler.h"
+
+#include <string.h>
+
+/// <summary>
+/// Fills a raster with random premultiplied pixels.
+/// </summary>
+static HRESULT CreateRandom(Test & test, Raster & raster, UINT width, UINT height) noexcept
+{
+    HRESULT hr = raster.Initialize(width, height);
+
+    if (SUCCEEDED(hr))
+    {
+        for (UINT y = 0; y < height; ++y)
+        {
+            uint32_t * p = (uint32_t *) raster.Row(y);
+
+            for (UINT x = 0; x < width; ++x)
+                p[x] = test.RandomPixel();
+        }
+    }
+
+    return hr;
+}
+
+/// <summary>
+/// Returns true if two rasters have the same size and the same pixels.
+/// </summary>
+static bool IsEqual(const Raster & a, const Raster & b) noexcept
+{
+    if ((a.Width() != b.Width()) || (a.Height() != b.Height()))
+        return false;
+
+    for (UINT y = 0; y < a.Height(); ++y)
+    {
+        if (::memcmp(a.Row(y), b.Row(y), (size_t) a.Width() * 4) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Returns true if every pixel of a raster is premultiplied, i.e. no color channel exceeds alpha.
+/// </summary>
+static bool IsPremultiplied(const Raster & raster) noexcept
+{
+    for (UINT y = 0; y < raster.Height(); ++y)
+    {
+        const uint32_t * p = (const uint32_t *) raster.Row(y);
+
+        for (UINT x = 0; x < raster.Width(); ++x)
+        {
+            const uint32_t a = p[x] >> 24;
+
+            if (((p[x] & 0xFF) > a) || (((p[x] >> 8) & 0xFF) > a) || (((p[x] >> 16) & 0xFF) > a))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Checks that every instruction set scales to the same pixels, with every filter and in both color spaces, that the output stays premultiplied
+/// and that scaling to the same size returns the source.
+/// </summary>
+TEST(Scaler)
+{
+    const InstructionSet Saved = Scaler::GetInstructionSet();
+
+    const struct { UINT SrcWidth, SrcHeight, Width, Height; } Sizes[] = { { 97, 61, 31, 17 }, { 64, 48, 160, 120 }, { 333, 7, 40, 21 }, { 1, 50, 9, 3 }, { 257, 129, 256, 128 } };
+
+    for (const auto & Size : Sizes)
+    {
+        Raster Src;
+
+        if (!CHECK(SUCCEEDED(CreateRandom(test, Src, Size.SrcWidth, Size.SrcHeight))))
+            break;
+
+        for (ScaleFilter Filter : { ScaleFilter::Box, ScaleFilter::CatmullRom, ScaleFilter::Lanczos3 })
+        {
+            for (ColorSpace Space : { ColorSpace::SRGB, ColorSpace::Linear })
+            {
+                Raster Reference;
+
+                for (InstructionSet Set : Test::GetInstructionSets())
+                {
+                    Raster Dst;
+
+                    Scaler::SetInstructionSet(Set);
+
+                    if (!CHECK(SUCCEEDED(Scaler::Scale(Src, Dst, Size.Width, Size.Height, Filter, nullptr, Space))))
+                        continue;
+
+                    CHECK(IsPremultiplied(Dst));
+
+                    if (Reference.IsEmpty())
+                        Reference = std::move(Dst);
+                    else
+                        CHECK(IsEqual(Reference, Dst));
+                }
+
+                Raster Same;
+
+                if (CHECK(SUCCEEDED(Scaler::Scale(Src, Same, Size.SrcWidth, Size.SrcHeight, Filter, nullptr, Space))))
+                    CHECK(IsEqual(Src, Same));
+            }
+        }
+    }
+
+    Scaler::SetInstructionSet(Saved);
+}
+
+/// <summary>
+/// Checks that the streaming scaler produces the same pixels as a power-of-two box reduction followed by Scaler::Scale, whatever number of rows
+/// the decoder writes at a time.
+/// </summary>
+TEST(StreamingScaler)
+{
+    for (UINT i = 0; i < 40; ++i)
+    {
+        const UINT SrcWidth  = 1 + test.Random() % 700;
+        const UINT SrcHeight = 1 + test.Random() % 700;
+
+        const UINT Width  = (i % 3 == 0) ? 1 + test.Random() % 300 : 1 + test.Random() % SrcWidth;
+        const UINT Height = (i % 3 == 0) ? 1 + test.Random() % 300 : 1 + test.Random() % SrcHeight;
+
+        const ScaleFilter Filter = (ScaleFilter) (i % 3);
+
+        Raster Src;
+
+        if (!CHECK(SUCCEEDED(CreateRandom(test, Src, SrcWidth, SrcHeight))))
+            return;
+
+        // The reference: average blocks of the largest power of two that keeps the image at least as large as the destination, rounded to nearest.
+        UINT BlockWidth = 1, BlockHeight = 1;
+
+        while ((BlockWidth < 1024) && (SrcWidth / (BlockWidth * 2) >= Width))
+            BlockWidth *= 2;
+
+        while ((BlockHeight < 1024) && (SrcHeight / (BlockHeight * 2) >= Height))
+            BlockHeight *= 2;
+
+        Raster Reduced, Reference;
+
+        if (!CHECK(SUCCEEDED(Reduced.Initialize((SrcWidth + BlockWidth - 1) / BlockWidth, (SrcHeight + BlockHeight - 1) / BlockHeight))))
+            return;
+
+        for (UINT y = 0; y < Reduced.Height(); ++y)
+        {
+            for (UINT x = 0; x < Reduced.Width(); ++x)
+            {
+                uint32_t Sum[4] = { }, n = 0;
+
+                for (UINT v = y * BlockHeight; v < (std::min)((y + 1) * BlockHeight, SrcHeight); ++v)
+                {
+                    for (UINT u = x * BlockWidth; u < (std::min)((x + 1) * BlockWidth, SrcWidth); ++u, ++n)
+                    {
+                        const uint32_t p = ((const uint32_t *) Src.Row(v))[u];
+
+                        for (UINT c = 0; c < 4; ++c)
+                            Sum[c] += (p >> (8 * c)) & 0xFF;
+                    }
+                }
+
+                uint32_t Pixel = 0;
+
+                for (UINT c = 0; c < 4; ++c)
+                    Pixel |= ((Sum[c] + n / 2) / n) << (8 * c);
+
+                ((uint32_t *) Reduced.Row(y))[x] = Pixel;
+            }
+        }
+
+        if (!CHECK(SUCCEEDED(Scaler::Scale(Reduced, Reference, Width, Height, Filter))))
+            continue;
+
+        StreamingScaler Streaming;
+        Raster Dst;
+
+        const UINT Step = 1 + test.Random() % 40;
+
+        HRESULT hr = Streaming.Initialize(SrcWidth, SrcHeight, Width, Height, Filter);
+
+        for (UINT y = 0; (y < SrcHeight) && SUCCEEDED(hr); y += Step)
+            hr = Streaming.Write(Src.Row(y), Src.Stride(), (std::min)(Step, SrcHeight - y));
+
+        if (SUCCEEDED(hr))
+            hr = Streaming.GetResult(Dst);
+
+        if (CHECK(SUCCEEDED(hr)))
+            CHECK(IsEqual(Reference, Dst));
+    }
+}
+
+/// <summary>
+/// Checks that the decode scale is the largest power of two up to the maximum that still covers the fit.
+/// </summary>
+TEST(DecodeScale)
+{
+    CHECK(Scaler::GetDecodeScale(4000, 3000, 1000, 750) == 4);
+    CHECK(Scaler::GetDecodeScale(4000, 3000, 999, 999) == 4);
+    CHECK(Scaler::GetDecodeScale(4000, 3000, 1001, 1001) == 2);
+    CHECK(Scaler::GetDecodeScale(800, 600, 1920, 1080) == 1);
+    CHECK(Scaler::GetDecodeScale(100000, 100000, 100, 100) == Scaler::MaxDecodeScale);
+    CHECK(Scaler::GetDecodeScale(0, 3000, 1000, 750) == 1);
+    CHECK(Scaler::GetDecodeScale(4000, 3000, 0, 0) == 1);
+}
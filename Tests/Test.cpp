@@ -0,0 +1,132 @@
+
+/** $VER: Test.cpp (2026.10.17) P. Stuer **/
+
+#include "Test.h"
+
+#include <algorithm>
+
+#include <stdio.h>
+#include <string.h>
+
+/// <summary>
+/// Counts a check and reports it if it fails.
+/// </summary>
+bool Test::Check(bool condition, const char * expression, const char * file, int line) noexcept
+{
+    ++_Checks;
+
+    if (condition)
+        return true;
+
+    if (++_Failures <= MaxReports)
+        ::printf("%s(%d): %s: check failed: %s\n", file, line, _Name, expression);
+
+    return false;
+}
+
+/// <summary>
+/// Gets the next number of a linear congruential generator. The sequence is the same in every run.
+/// </summary>
+uint32_t Test::Random() noexcept
+{
+    _Seed = _Seed * 1664525u + 1013904223u;
+
+    return _Seed;
+}
+
+/// <summary>
+/// Gets a random premultiplied pixel. Opaque and transparent pixels are more likely than others because most kernels treat them separately.
+/// </summary>
+uint32_t Test::RandomPixel() noexcept
+{
+    const uint32_t r = Random();
+
+    switch (r % 5)
+    {
+        case 0: return 0;
+        case 1: return 0xFF000000u | (Random() >> 8);
+    }
+
+    const uint32_t a = r >> 24;
+    const uint32_t c = Random();
+
+    return (a << 24) | ((((c >> 16) & 0xFF) * a / 255) << 16) | ((((c >> 8) & 0xFF) * a / 255) << 8) | ((c & 0xFF) * a / 255);
+}
+
+/// <summary>
+/// Gets the instruction sets supported by this machine, from the lowest to the highest.
+/// </summary>
+std::vector<InstructionSet> Test::GetInstructionSets() noexcept
+{
+    std::vector<InstructionSet> InstructionSets;
+
+    for (InstructionSet Set : { InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX2 })
+    {
+        if (Set <= CPU::GetInstructionSet())
+            InstructionSets.push_back(Set);
+    }
+
+    return InstructionSets;
+}
+
+/// <summary>
+/// Registers a test. Called by the TEST macro during static initialization.
+/// </summary>
+int Test::Register(const char * name, Function function) noexcept
+{
+    GetEntries().push_back({ name, function });
+
+    return (int) GetEntries().size();
+}
+
+/// <summary>
+/// Runs the named tests, or all tests if no name is specified. Usage: Tests [name ...]. Returns 0 if every check passed.
+/// </summary>
+int Test::Run(int argc, char * argv[]) noexcept
+{
+    // The registration order depends on the link order.
+    std::sort(GetEntries().begin(), GetEntries().end(), [](const Entry & a, const Entry & b) { return ::strcmp(a.Name, b.Name) < 0; });
+
+    UINT Selected = 0, Failed = 0;
+
+    for (const auto & Entry : GetEntries())
+    {
+        bool IsSelected = (argc < 2);
+
+        for (int i = 1; i < argc; ++i)
+            IsSelected |= (::strcmp(Entry.Name, argv[i]) == 0);
+
+        if (!IsSelected)
+            continue;
+
+        Test Context(Entry.Name);
+
+        Entry.Code(Context);
+
+        ::printf("[%s] %u checks, %u failed\n", Entry.Name, Context.GetChecks(), Context.GetFailures());
+
+        ++Selected;
+
+        if ((Context.GetFailures() != 0) || (Context.GetChecks() == 0))
+            ++Failed;
+    }
+
+    if (Selected == 0)
+    {
+        ::fprintf(stderr, "Usage: %s [name ...]\n", argv[0]);
+
+        return 1;
+    }
+
+    return (Failed == 0) ? 0 : 1;
+}
+
+/// <summary>
+/// Gets the registered tests.
+/// </summary>
+std::vector<Test::Entry> & Test::GetEntries() noexcept
+{
+    static std::vector<Entry> Entries;
+
+    return Entries;
+}
@@ -0,0 +1,63 @@
+
+/** $VER: Test.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "Core.h"
+#include "CPU.h"
+
+#include <vector>
+
+/// <summary>
+/// Runs a group of checks and counts the ones that fail.
+/// </summary>
+class Test
+{
+public:
+    typedef void (* Function)(Test & test);
+
+    Test(const char * name) noexcept : _Name(name), _Checks(), _Failures(), _Seed(0x12345678) { }
+
+    bool Check(bool condition, const char * expression, const char * file, int line) noexcept;
+
+    UINT GetChecks() const noexcept { return _Checks; }
+    UINT GetFailures() const noexcept { return _Failures; }
+
+    uint32_t Random() noexcept;
+    uint32_t RandomPixel() noexcept;
+
+    static std::vector<InstructionSet> GetInstructionSets() noexcept;
+
+    static int Register(const char * name, Function function) noexcept;
+    static int Run(int argc, char * argv[]) noexcept;
+
+    static const UINT MaxReports = 10; // Failures reported per test. The others are only counted.
+
+private:
+    struct Entry
+    {
+        const char * Name;
+        Function Code;
+    };
+
+    static std::vector<Entry> & GetEntries() noexcept;
+
+private:
+    const char * _Name;
+    UINT _Checks;
+    UINT _Failures;
+    uint32_t _Seed;
+};
+
+/// <summary>
+/// Defines and registers a test.
+/// </summary>
+#define TEST(name) \
+    static void Test_##name(Test & test); \
+    static const int Test_##name##_Registered = Test::Register(#name, Test_##name); \
+    static void Test_##name(Test & test)
+
+/// <summary>
+/// Checks a condition of the current test. Evaluates to the condition.
+/// </summary>
+#define CHECK(condition) test.Check((condition), #condition, __FILE__, __LINE__)
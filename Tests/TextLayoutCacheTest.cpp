@@ -0,0 +1,107 @@
+
+/** $VER: TextLayoutCacheTest.cpp (2026.10.17) P. Stuer **/
+
+#include "Test.h"
+
+#include "TextLayout.h"
+
+#include <string.h>
+
+/// <summary>
+/// Returns true if the lines of a layout are the expected strings.
+/// </summary>
+static bool IsEqual(const WCHAR * text, const std::vector<TextLine> & lines, std::initializer_list<const WCHAR *> expected) noexcept
+{
+    if (lines.size() != expected.size())
+        return false;
+
+    size_t i = 0;
+
+    for (const WCHAR * Line : expected)
+    {
+        const TextLine & l = lines[i++];
+
+        if ((l.Length != ::wcslen(Line)) || (::wcsncmp(text + l.Offset, Line, l.Length) != 0))
+            return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Checks the line breaks, that a layout is reused for the same box, kept for a new box with the same line breaks and broken again otherwise,
+/// and that the least recently used layout is discarded.
+/// </summary>
+TEST(TextLayoutCache)
+{
+    TextLayoutCache Cache;
+
+    const Font Font(10.f); // 6 pixels per character
+
+    const std::vector<TextLine> * Lines = nullptr;
+
+    CHECK(Cache.Get(nullptr, 0, Font, 100.f, &Lines) == E_INVALIDARG);
+
+    // Hard line breaks and wrapping at the last space that fits; a word longer than a line gets broken.
+    const WCHAR * Text = L"ab cd\nefg";
+
+    if (CHECK(SUCCEEDED(Cache.Get(Text, 9, Font, 600.f, &Lines))))
+    {
+        CHECK(IsEqual(Text, *Lines, { L"ab cd", L"efg" }));
+        CHECK(((*Lines)[0].Width == 30.f) && ((*Lines)[1].Width == 18.f));
+    }
+
+    Text = L"hello world";
+
+    if (CHECK(SUCCEEDED(Cache.Get(Text, 11, Font, 48.f, &Lines))))
+        CHECK(IsEqual(Text, *Lines, { L"hello", L"world" }));
+
+    Cache.Clear();
+    Cache.ResetStatistics();
+
+    // A hit, a resize that keeps the line breaks and relayouts that change them.
+    Text = L"Hello";
+
+    CHECK(SUCCEEDED(Cache.Get(Text, 5, Font, 600.f, &Lines)) && IsEqual(Text, *Lines, { L"Hello" }));
+    CHECK(SUCCEEDED(Cache.Get(Text, 5, Font, 600.f, &Lines)));
+    CHECK(SUCCEEDED(Cache.Get(Text, 5, Font, 31.f, &Lines)) && IsEqual(Text, *Lines, { L"Hello" })); // Still 5 characters per line
+    CHECK(SUCCEEDED(Cache.Get(Text, 5, Font, 24.f, &Lines)) && IsEqual(Text, *Lines, { L"Hell", L"o" }));
+    CHECK(SUCCEEDED(Cache.Get(Text, 5, Font, 29.f, &Lines)) && IsEqual(Text, *Lines, { L"Hell", L"o" })); // Still 4 characters per line
+    CHECK(SUCCEEDED(Cache.Get(Text, 5, Font, 300.f, &Lines)) && IsEqual(Text, *Lines, { L"Hello" }));
+
+    TextLayoutStatistics Statistics = Cache.GetStatistics();
+
+    CHECK((Statistics.Misses == 1) && (Statistics.Hits == 1) && (Statistics.Resizes == 2) && (Statistics.Relayouts == 2) && (Statistics.Layouts == 1));
+
+    // Another font size, another string or another length is another layout.
+    CHECK(SUCCEEDED(Cache.Get(Text, 5, ::Font(20.f), 300.f, &Lines)));
+    CHECK(SUCCEEDED(Cache.Get(L"World", 5, Font, 300.f, &Lines)) && IsEqual(L"World", *Lines, { L"World" }));
+    CHECK(SUCCEEDED(Cache.Get(Text, 4, Font, 300.f, &Lines)) && IsEqual(Text, *Lines, { L"Hell" }));
+
+    Statistics = Cache.GetStatistics();
+
+    CHECK((Statistics.Misses == 4) && (Statistics.Layouts == 4));
+
+    // The least recently used layout is discarded when the cache is full.
+    Cache.Clear();
+    Cache.ResetStatistics();
+
+    WCHAR Strings[TextLayoutCache::MaxLayouts + 1][8];
+
+    for (UINT i = 0; i < _countof(Strings); ++i)
+    {
+        ::swprintf(Strings[i], _countof(Strings[i]), L"Text %u", i);
+
+        CHECK(SUCCEEDED(Cache.Get(Strings[i], (UINT) ::wcslen(Strings[i]), Font, 300.f, &Lines)));
+    }
+
+    Statistics = Cache.GetStatistics();
+
+    CHECK((Statistics.Layouts == TextLayoutCache::MaxLayouts) && (Statistics.Misses == _countof(Strings)));
+
+    CHECK(SUCCEEDED(Cache.Get(Strings[1], (UINT) ::wcslen(Strings[1]), Font, 300.f, &Lines)));
+    CHECK(Cache.GetStatistics().Hits == 1);
+
+    CHECK(SUCCEEDED(Cache.Get(Strings[0], (UINT) ::wcslen(Strings[0]), Font, 300.f, &Lines)));
+    CHECK(Cache.GetStatistics().Misses == _countof(Strings) + 1);
+}
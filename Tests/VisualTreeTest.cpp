@@ -0,0 +1,105 @@
+
+/** $VER: VisualTreeTest.cpp (2026.10.17) P. Stuer **/
+
+#include "Test.h"
+
+#include "VisualTree.h"
+
+#include <string.h>
+
+/// <summary>
+/// Checks that a frame composed from the damage of the retained tree is identical to a frame that is composed completely, and that every pixel
+/// that changed since the previous frame lies in the damage. The tree gets moved, scaled, faded, clipped, invalidated and pruned.
+/// </summary>
+TEST(VisualTree)
+{
+    const UINT Width = 400, Height = 300;
+
+    SoftwareCompositor Partial, Full;
+    Raster Previous;
+
+    if (!CHECK(SUCCEEDED(Partial.Initialize(Width, Height)) && SUCCEEDED(Full.Initialize(Width, Height)) && SUCCEEDED(Previous.Initialize(Width, Height))))
+        return;
+
+    VisualTree Tree;
+
+    Tree.SetBackground({ 1.f, 1.f, 1.f, 1.f });
+
+    Visual * Panel = nullptr, * Ball = nullptr, * Badge = nullptr, * Marker = nullptr;
+
+    if (!CHECK(SUCCEEDED(Tree.GetRoot()->CreateChild(&Panel)) && SUCCEEDED(Panel->CreateChild(&Ball)) && SUCCEEDED(Tree.GetRoot()->CreateChild(&Badge)) &&
+               SUCCEEDED(Tree.GetRoot()->CreateChild(&Marker))))
+        return;
+
+    Panel->SetOffset(20.3f, 10.f);
+    Panel->SetContent(100, 100, [](Compositor & compositor) { compositor.Clear({ 1.f, 0.f, 0.f, .5f }); });
+
+    Ball->SetOffset(50.f, 50.f);
+    Ball->SetContent(80, 80, [](Compositor & compositor) { compositor.FillEllipse({ 40.f, 40.f }, 38.f, 38.f, { 0.f, 0.f, 1.f, 1.f }); });
+
+    UINT BadgeColor = 0;
+
+    Badge->SetContent(30, 30, [&BadgeColor](Compositor & compositor) { compositor.Clear({ (FLOAT) (BadgeColor % 3) / 2.f, 1.f, 0.f, 1.f }); });
+
+    Marker->SetOffset(200.f, 20.f);
+    Marker->SetContent(40, 40, [](Compositor & compositor) { compositor.Clear({ 0.f, 0.f, 0.f, .75f }); });
+
+    CHECK(SUCCEEDED(Tree.Render(Partial)));
+
+    for (UINT i = 0; i < 60; ++i)
+    {
+        switch (i % 7)
+        {
+            case 0: Panel->SetOffset(20.f + (FLOAT) i, 10.f + (FLOAT) i / 2.f); break;
+            case 1: if (Ball != nullptr) Ball->SetOpacity(.3f + .01f * (FLOAT) i); break;
+            case 2: Panel->SetScale(1.f + .02f * (FLOAT) i, 1.f); break;
+            case 3: Panel->SetClip({ 0.f, 0.f, 90.f - (FLOAT) i, 120.f }); break;
+            case 4: Badge->SetOffset(300.f - (FLOAT) i, 200.f); break;
+            case 5: ++BadgeColor; Badge->InvalidateContent(); break;
+            case 6: break; // Nothing changed
+        }
+
+        if ((i == 40) && (Ball != nullptr))
+        {
+            Panel->RemoveChild(Ball);
+
+            Ball = nullptr;
+        }
+
+        if (i == 50)
+            Tree.GetRoot()->RemoveChild(Marker);
+
+        if (!CHECK(SUCCEEDED(Previous.CopyFrom(Partial.GetTarget()))))
+            return;
+
+        const HRESULT hr = Tree.Render(Partial);
+
+        CHECK(SUCCEEDED(hr));
+        CHECK((hr == S_FALSE) == Tree.GetDamage().IsEmpty());
+
+        // Every pixel that changed has to be in the damage.
+        const Region & Damage = Tree.GetDamage();
+
+        for (UINT y = 0; y < Height; ++y)
+        {
+            const uint32_t * a = (const uint32_t *) Previous.Row(y);
+            const uint32_t * b = (const uint32_t *) Partial.GetTarget().Row(y);
+
+            for (UINT x = 0; x < Width; ++x)
+            {
+                if (a[x] != b[x])
+                    CHECK(Damage.Contains({ (int) x, (int) y, (int) x + 1, (int) y + 1 }));
+            }
+        }
+
+        Tree.InvalidateAll();
+
+        CHECK(SUCCEEDED(Tree.Render(Full)));
+
+        CHECK(::memcmp(Partial.GetTarget().Data(), Full.GetTarget().Data(), Partial.GetTarget().Size()) == 0);
+    }
+
+    // A frame without changes composes nothing.
+    CHECK(Tree.Render(Partial) == S_FALSE);
+    CHECK(Tree.GetStatistics().Composed == 0);
+}
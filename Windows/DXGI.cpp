@@ -1,5 +1,5 @@
 
-/** $VER: DXGI.cpp (2024.04.04) P. Stuer **/
+/** $VER: DXGI.cpp (2026.10.17) P. Stuer **/
 
 #include <CppCoreCheck/Warnings.h>
 
@@ -29,9 +29,9 @@ DXGI::DXGI()
 }
 
 /// <summary>
-/// Creates a custom swap chain.
+/// Creates a custom swap chain. The flags (DXGI_SWAP_CHAIN_FLAG) have to be passed to ResizeBuffers as well.
 /// </summary>
-HRESULT DXGI::CreateSwapChain(IDXGIDevice * dxgiDevice, UINT width, UINT height, IDXGISwapChain1 ** swapChain) const noexcept
+HRESULT DXGI::CreateSwapChain(IDXGIDevice * dxgiDevice, UINT width, UINT height, UINT flags, IDXGISwapChain1 ** swapChain) const noexcept
 {
     DXGI_SWAP_CHAIN_DESC1 scd = {};
 
@@ -43,8 +43,9 @@ HRESULT DXGI::CreateSwapChain(IDXGIDevice * dxgiDevice, UINT width, UINT height,
     scd.BufferUsage      = DXGI_USAGE_RENDER_TARGET_OUTPUT;
     scd.BufferCount      = 2;
     scd.Scaling          = DXGI_SCALING_STRETCH;
-    scd.SwapEffect       = DXGI_SWAP_EFFECT_FLIP_DISCARD;   // Flip Model
+    scd.SwapEffect       = DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL;// Flip Model. Keeps the contents of the previous frame so frames can be presented with dirty rectangles.
     scd.AlphaMode        = DXGI_ALPHA_MODE_PREMULTIPLIED;   // Enable transparency
+    scd.Flags            = flags;
 
     return Factory->CreateSwapChainForComposition(dxgiDevice, &scd, nullptr, swapChain);
 }
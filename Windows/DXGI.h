@@ -10,7 +10,7 @@ class DXGI
 public:
     DXGI();
 
-    HRESULT CreateSwapChain(IDXGIDevice * dxgiDevice, UINT width, UINT height, IDXGISwapChain1 ** swapChain) const noexcept;
+    HRESULT CreateSwapChain(IDXGIDevice * dxgiDevice, UINT width, UINT height, UINT flags, IDXGISwapChain1 ** swapChain) const noexcept;
 
 public:
     CComPtr<IDXGIFactory2> Factory;
@@ -0,0 +1,208 @@
+
+/** $VER: DeviceManager.cpp (2026.10.17) P. Stuer **/
+
+#include <CppCoreCheck/Warnings.h>
+
+#pragma warning(disable: 4100 4625 4626 4710 4711 5045 ALL_CPPCORECHECK_WARNINGS)
+
+#include "framework.h"
+
+#include "DeviceManager.h"
+
+#include "Direct3D.h"
+#include "Direct2D.h"
+#include "DXGI.h"
+
+#pragma hdrstop
+
+/// <summary>
+/// Initializes a new instance.
+/// </summary>
+DeviceManager::DeviceManager() noexcept : _IsCommitPending(), _Statistics()
+{
+}
+
+/// <summary>
+/// Creates the Direct2D and DirectComposition devices on top of the Direct3D device. The devices survive the loss of the resources that were created with them.
+/// </summary>
+HRESULT DeviceManager::Initialize() noexcept
+{
+    if (_CompositionDevice != nullptr)
+        return S_OK;
+
+    HRESULT hr = _Direct3D.GetDXGIDevice(&_DXGIDevice);
+
+    if (SUCCEEDED(hr))
+        _Statistics.Devices++;
+
+    // Create the Direct2D device that links back to the Direct3D device.
+    if (SUCCEEDED(hr))
+        hr = _Direct2D.Factory->CreateDevice(_DXGIDevice, &_D2DDevice);
+
+    if (SUCCEEDED(hr))
+        _Statistics.Devices++;
+
+    // Create the DirectComposition device that links back to the Direct3D device.
+    if (SUCCEEDED(hr))
+        hr = ::DCompositionCreateDevice(_DXGIDevice, __uuidof(_CompositionDevice), (void **) &_CompositionDevice);
+
+    if (SUCCEEDED(hr))
+        _Statistics.Devices++;
+
+    return hr;
+}
+
+/// <summary>
+/// Creates the composition target of a top-level window and the root of the visual tree.
+/// </summary>
+HRESULT DeviceManager::CreateTarget(HWND hWnd) noexcept
+{
+    HRESULT hr = _CompositionDevice->CreateTargetForHwnd(hWnd, true, &_CompositionTarget);
+
+    if (SUCCEEDED(hr))
+    {
+        _Statistics.Targets++;
+
+        hr = CreateVisual(&_RootVisual);
+    }
+
+    if (SUCCEEDED(hr))
+        hr = _CompositionTarget->SetRoot(_RootVisual);
+
+    if (SUCCEEDED(hr))
+        _IsCommitPending = true;
+
+    return hr;
+}
+
+/// <summary>
+/// Creates a Direct2D device context on the shared device.
+/// </summary>
+HRESULT DeviceManager::CreateDeviceContext(UINT dpi, ID2D1DeviceContext ** dc) noexcept
+{
+    HRESULT hr = _D2DDevice->CreateDeviceContext(D2D1_DEVICE_CONTEXT_OPTIONS_NONE, dc);
+
+    if (SUCCEEDED(hr))
+    {
+        (*dc)->SetDpi((FLOAT) dpi, (FLOAT) dpi);
+
+        _Statistics.DeviceContexts++;
+    }
+
+    return hr;
+}
+
+/// <summary>
+/// Creates a swap chain for composition on the shared device.
+/// </summary>
+HRESULT DeviceManager::CreateSwapChain(UINT width, UINT height, IDXGISwapChain1 ** swapChain, UINT flags) noexcept
+{
+    HRESULT hr = _DXGI.CreateSwapChain(_DXGIDevice, width, height, flags, swapChain);
+
+    if (SUCCEEDED(hr))
+        _Statistics.SwapChains++;
+
+    return hr;
+}
+
+/// <summary>
+/// Creates a visual. The visual is not part of the tree until it is added.
+/// </summary>
+HRESULT DeviceManager::CreateVisual(IDCompositionVisual ** visual) noexcept
+{
+    HRESULT hr = _CompositionDevice->CreateVisual(visual);
+
+    if (SUCCEEDED(hr))
+        _Statistics.Visuals++;
+
+    return hr;
+}
+
+/// <summary>
+/// Sets the content of a visual, e.g. a swap chain.
+/// </summary>
+HRESULT DeviceManager::SetContent(IDCompositionVisual * visual, IUnknown * content) noexcept
+{
+    HRESULT hr = visual->SetContent(content);
+
+    if (SUCCEEDED(hr))
+        _IsCommitPending = true;
+
+    return hr;
+}
+
+/// <summary>
+/// Sets the offset of a visual relative to its parent, in pixels.
+/// </summary>
+HRESULT DeviceManager::SetOffset(IDCompositionVisual * visual, FLOAT x, FLOAT y) noexcept
+{
+    HRESULT hr = visual->SetOffsetX(x);
+
+    if (SUCCEEDED(hr))
+        hr = visual->SetOffsetY(y);
+
+    if (SUCCEEDED(hr))
+        _IsCommitPending = true;
+
+    return hr;
+}
+
+/// <summary>
+/// Adds a visual to the root of the tree, on top of the visuals that were added before.
+/// </summary>
+HRESULT DeviceManager::AddVisual(IDCompositionVisual * visual) noexcept
+{
+    HRESULT hr = _RootVisual->AddVisual(visual, TRUE, nullptr);
+
+    if (SUCCEEDED(hr))
+        _IsCommitPending = true;
+
+    return hr;
+}
+
+/// <summary>
+/// Removes a visual from the root of the tree.
+/// </summary>
+HRESULT DeviceManager::RemoveVisual(IDCompositionVisual * visual) noexcept
+{
+    if (_RootVisual == nullptr)
+        return S_OK;
+
+    HRESULT hr = _RootVisual->RemoveVisual(visual);
+
+    if (SUCCEEDED(hr))
+        _IsCommitPending = true;
+
+    return hr;
+}
+
+/// <summary>
+/// Begins a frame.
+/// </summary>
+void DeviceManager::BeginFrame() noexcept
+{
+    _Statistics.Commits = 0;
+}
+
+/// <summary>
+/// Ends a frame: commits the changes to the visual tree, if any. A frame that only presents swap chains does not need a commit.
+/// </summary>
+HRESULT DeviceManager::EndFrame() noexcept
+{
+    _Statistics.Frames++;
+
+    if (!_IsCommitPending)
+        return S_OK;
+
+    HRESULT hr = _CompositionDevice->Commit();
+
+    if (SUCCEEDED(hr))
+    {
+        _IsCommitPending = false;
+
+        _Statistics.Commits++;
+        _Statistics.TotalCommits++;
+    }
+
+    return hr;
+}
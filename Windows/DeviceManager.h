@@ -0,0 +1,64 @@
+
+/** $VER: DeviceManager.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "framework.h"
+
+/// <summary>
+/// Counts the device objects created by the device manager and the commits of the visual tree.
+/// </summary>
+struct DeviceStatistics
+{
+    UINT Devices;               // Direct3D, Direct2D and DirectComposition devices
+    UINT DeviceContexts;        // Direct2D device contexts
+    UINT SwapChains;
+    UINT Targets;               // Composition targets
+    UINT Visuals;
+
+    UINT Commits;               // Commits of the last frame
+    uint64_t TotalCommits;
+    uint64_t Frames;
+};
+
+/// <summary>
+/// Owns the devices shared by every layer of the window and the visual tree that composes them. The swap chain of the main window is the content of the root visual;
+/// every other layer is a child visual with its own offset. Changes to the tree are collected during a frame and committed once, at the end of the frame,
+/// so that the composition engine shows all layers of the frame at the same time.
+/// </summary>
+class DeviceManager
+{
+public:
+    DeviceManager() noexcept;
+
+    HRESULT Initialize() noexcept;
+    HRESULT CreateTarget(HWND hWnd) noexcept;
+
+    HRESULT CreateDeviceContext(UINT dpi, ID2D1DeviceContext ** dc) noexcept;
+    HRESULT CreateSwapChain(UINT width, UINT height, IDXGISwapChain1 ** swapChain, UINT flags = 0) noexcept;
+    HRESULT CreateVisual(IDCompositionVisual ** visual) noexcept;
+
+    IDCompositionVisual * GetRoot() const noexcept { return _RootVisual; }
+
+    HRESULT SetContent(IDCompositionVisual * visual, IUnknown * content) noexcept;
+    HRESULT SetOffset(IDCompositionVisual * visual, FLOAT x, FLOAT y) noexcept;
+    HRESULT AddVisual(IDCompositionVisual * visual) noexcept;
+    HRESULT RemoveVisual(IDCompositionVisual * visual) noexcept;
+
+    void BeginFrame() noexcept;
+    HRESULT EndFrame() noexcept;
+
+    DeviceStatistics GetStatistics() const noexcept { return _Statistics; }
+
+private:
+    CComPtr<IDXGIDevice> _DXGIDevice;
+    CComPtr<ID2D1Device1> _D2DDevice;
+    CComPtr<IDCompositionDevice> _CompositionDevice;
+
+    CComPtr<IDCompositionTarget> _CompositionTarget;
+    CComPtr<IDCompositionVisual> _RootVisual;
+
+    bool _IsCommitPending; // True if the tree has changed since the last commit.
+
+    DeviceStatistics _Statistics;
+};
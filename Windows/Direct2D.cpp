@@ -1,5 +1,5 @@
 
-/** $VER: Direct2D.cpp (2024.04.04) P. Stuer **/
+/** $VER: Direct2D.cpp (2026.10.17) P. Stuer **/
 
 #include <CppCoreCheck/Warnings.h>
 
@@ -8,7 +8,9 @@
 #include "framework.h"
 
 #include "Direct2D.h"
+#include "MappedStream.h"
 #include "WIC.h"
+#include "Raster.h"
 
 #pragma hdrstop
 
@@ -74,13 +76,28 @@ HRESULT Direct2D::Load(const WCHAR * resourceName, const WCHAR * resourceType, I
 }
 
 /// <summary>
-/// Loads a bitmap source from the specified file path.
+/// Creates a decoder for the specified file path. The file is memory-mapped; the decoder reads straight from the mapped pages and keeps the mapping alive.
+/// </summary>
+HRESULT Direct2D::Load(const WCHAR * uri, IWICBitmapDecoder ** decoder) const noexcept
+{
+    CComPtr<IStream> Stream;
+
+    HRESULT hr = MappedStream::Create(uri, &Stream);
+
+    if (SUCCEEDED(hr))
+        hr = _WIC.Factory->CreateDecoderFromStream(Stream, nullptr, WICDecodeMetadataCacheOnLoad, decoder);
+
+    return hr;
+}
+
+/// <summary>
+/// Loads a bitmap source from the specified file path. The file is memory-mapped; the decoder reads straight from the mapped pages and keeps the mapping alive.
 /// </summary>
 HRESULT Direct2D::Load(const WCHAR * uri, IWICBitmapSource ** source) const noexcept
 {
-    CComPtr <IWICBitmapDecoder> Decoder;
+    CComPtr<IWICBitmapDecoder> Decoder;
 
-    HRESULT hr = _WIC.Factory->CreateDecoderFromFilename(uri, nullptr, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &Decoder);
+    HRESULT hr = Load(uri, &Decoder);
 
     IWICBitmapFrameDecode * Frame = nullptr;
 
@@ -94,25 +111,17 @@ HRESULT Direct2D::Load(const WCHAR * uri, IWICBitmapSource ** source) const noex
 }
 
 /// <summary>
-/// Gets a scaler that changes the width and the height of the bitmap source.
+/// Loads a bitmap source from the specified file path, reduced by the decoder as far as it can while still covering the size that fits the specified size.
+/// JPEG files are decoded at 1/2, 1/4 or 1/8 of their size when that is enough, which is several times faster and smaller than a full decode.
 /// </summary>
-HRESULT Direct2D::CreateScaler(IWICBitmapSource * source, UINT width, UINT height, UINT maxWidth, UINT maxHeight, IWICBitmapScaler ** scaler) const noexcept
+HRESULT Direct2D::Load(const WCHAR * uri, UINT maxWidth, UINT maxHeight, IWICBitmapSource ** source) const noexcept
 {
-    HRESULT hr = _WIC.Factory->CreateBitmapScaler(scaler);
-
-    if (SUCCEEDED(hr))
-    {
-        // Fit big images.
-        FLOAT HScalar = (width  > maxWidth)  ? (FLOAT) maxWidth  / (FLOAT) width  : 1.f;
-        FLOAT VScalar = (height > maxHeight) ? (FLOAT) maxHeight / (FLOAT) height : 1.f;
-
-        FLOAT Scalar = (std::min)(HScalar, VScalar);
+    CComPtr<IWICBitmapSource> Frame;
 
-        width  = (UINT) ((FLOAT) width  * Scalar);
-        height = (UINT) ((FLOAT) height * Scalar);
+    HRESULT hr = Load(uri, &Frame);
 
-        hr = (*scaler)->Initialize(source, width, height, WICBitmapInterpolationModeCubic);
-    }
+    if (SUCCEEDED(hr))
+        hr = _WIC.GetReducedSource(Frame, maxWidth, maxHeight, source);
 
     return hr;
 }
@@ -122,19 +131,29 @@ HRESULT Direct2D::CreateScaler(IWICBitmapSource * source, UINT width, UINT heigh
 /// </summary>
 HRESULT Direct2D::CreateBitmap(IWICBitmapSource * source, ID2D1RenderTarget * renderTarget, ID2D1Bitmap ** bitmap) const noexcept
 {
-    CComPtr<IWICFormatConverter> Converter;
+    Raster Pixels;
 
-    HRESULT hr = _WIC.Factory->CreateFormatConverter(&Converter);
+    HRESULT hr = _WIC.CreateRaster(source, Pixels);
 
     if (SUCCEEDED(hr))
-        hr = Converter->Initialize(source, GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone, nullptr, 0.f, WICBitmapPaletteTypeMedianCut);
-
-    if (SUCCEEDED(hr))
-        hr = renderTarget->CreateBitmapFromWicBitmap(Converter, nullptr, bitmap);
+        hr = CreateBitmap(Pixels, renderTarget, bitmap);
 
     return hr;
 }
 
+/// <summary>
+/// Gets a Direct2D bitmap from a premultiplied BGRA raster.
+/// </summary>
+HRESULT Direct2D::CreateBitmap(const Raster & raster, ID2D1RenderTarget * renderTarget, ID2D1Bitmap ** bitmap) const noexcept
+{
+    if (raster.Format() != PixelFormat::PBGRA32)
+        return E_INVALIDARG;
+
+    D2D1_BITMAP_PROPERTIES Properties = D2D1::BitmapProperties(D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED), 96.f, 96.f);
+
+    return renderTarget->CreateBitmap(D2D1::SizeU(raster.Width(), raster.Height()), raster.Data(), raster.Stride(), Properties, bitmap);
+}
+
 /// <summary>
 /// Gets the data and size of a resource. 
 /// </summary>
@@ -1,10 +1,12 @@
 
-/** $VER: Direct2D.h (2024.01.17) P. Stuer **/
+/** $VER: Direct2D.h (2026.10.17) P. Stuer **/
 
 #pragma once
 
 #include "framework.h"
 
+class Raster;
+
 class Direct2D
 {
 public:
@@ -13,11 +15,12 @@ public:
     HRESULT GetDPI(HWND hWnd, UINT & dpi) const;
 
     HRESULT Load(const WCHAR * resourceName, const WCHAR * resourceType, IWICBitmapSource ** source) const noexcept;
+    HRESULT Load(const WCHAR * uri, IWICBitmapDecoder ** decoder) const noexcept;
     HRESULT Load(const WCHAR * uri, IWICBitmapSource ** source) const noexcept;
-
-    HRESULT CreateScaler(IWICBitmapSource * source, UINT width, UINT height, UINT maxWidth, UINT maxHeight, IWICBitmapScaler ** scaler) const noexcept;
+    HRESULT Load(const WCHAR * uri, UINT maxWidth, UINT maxHeight, IWICBitmapSource ** source) const noexcept;
 
     HRESULT CreateBitmap(IWICBitmapSource * source, ID2D1RenderTarget * renderTarget, ID2D1Bitmap ** bitmap) const noexcept;
+    HRESULT CreateBitmap(const Raster & raster, ID2D1RenderTarget * renderTarget, ID2D1Bitmap ** bitmap) const noexcept;
 
 private:
     static HRESULT GetResource(const WCHAR * resourceName, const WCHAR * resourceType, void ** resourceData, DWORD * resourceSize);
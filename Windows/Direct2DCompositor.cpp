@@ -0,0 +1,364 @@
+
+/** $VER: Direct2DCompositor.cpp (2026.10.17) P. Stuer **/
+
+#include <CppCoreCheck/Warnings.h>
+
+#pragma warning(disable: 4100 4625 4626 4710 4711 5045 ALL_CPPCORECHECK_WARNINGS)
+
+#include "framework.h"
+
+#include "Direct2DCompositor.h"
+#include "DirectWrite.h"
+
+#include "Raster.h"
+#include "Region.h"
+
+#include <algorithm>
+#include <vector>
+
+#pragma hdrstop
+
+/// <summary>
+/// Gets a brush that tiles this bitmap. The brush is created on first use.
+/// </summary>
+HRESULT Direct2DBitmap::GetBrush(ID2D1RenderTarget * renderTarget, ID2D1BitmapBrush ** bitmapBrush) const noexcept
+{
+    HRESULT hr = S_OK;
+
+    if (_Brush == nullptr)
+    {
+        D2D1_BITMAP_BRUSH_PROPERTIES BrushProperties = D2D1::BitmapBrushProperties(D2D1_EXTEND_MODE_WRAP, D2D1_EXTEND_MODE_WRAP);
+
+        hr = renderTarget->CreateBitmapBrush(_Bitmap, BrushProperties, &_Brush);
+    }
+
+    if (SUCCEEDED(hr))
+        hr = _Brush.CopyTo(bitmapBrush);
+
+    return hr;
+}
+
+/// <summary>
+/// Attaches the compositor to a device context and the swap chain it renders to.
+/// </summary>
+HRESULT Direct2DCompositor::Attach(ID2D1DeviceContext * dc, IDXGISwapChain1 * swapChain) noexcept
+{
+    if (_DC != dc)
+    {
+        _SolidBrush.Release();
+
+        _DC = dc;
+    }
+
+    _SwapChain = swapChain;
+
+    HRESULT hr = (_DC != nullptr) && (_SwapChain != nullptr) ? S_OK : E_INVALIDARG;
+
+    if (SUCCEEDED(hr) && (_SolidBrush == nullptr))
+        hr = _DC->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::Black), &_SolidBrush);
+
+    return hr;
+}
+
+/// <summary>
+/// Releases the device context and the swap chain.
+/// </summary>
+void Direct2DCompositor::Detach() noexcept
+{
+    _SolidBrush.Release();
+    _SwapChain.Release();
+    _DC.Release();
+}
+
+/// <summary>
+/// Creates a Direct2D bitmap from a premultiplied BGRA raster.
+/// </summary>
+HRESULT Direct2DCompositor::CreateBitmap(const Raster & raster, std::unique_ptr<Bitmap> & bitmap) noexcept
+{
+    if (raster.Format() != PixelFormat::PBGRA32)
+        return E_INVALIDARG;
+
+    const D2D1_BITMAP_PROPERTIES Properties = D2D1::BitmapProperties(D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED), 96.f, 96.f);
+
+    CComPtr<ID2D1Bitmap> D2DBitmap;
+
+    HRESULT hr = _DC->CreateBitmap(D2D1::SizeU(raster.Width(), raster.Height()), raster.Data(), raster.Stride(), Properties, &D2DBitmap);
+
+    if (SUCCEEDED(hr))
+    {
+        try
+        {
+            bitmap = std::make_unique<Direct2DBitmap>(D2DBitmap);
+        }
+        catch (const std::bad_alloc &)
+        {
+            hr = E_OUTOFMEMORY;
+        }
+    }
+
+    return hr;
+}
+
+/// <summary>
+/// Creates a DirectWrite text format.
+/// </summary>
+HRESULT Direct2DCompositor::CreateTextFormat(const WCHAR * fontName, FLOAT fontSize, TextAlignment textAlignment, ParagraphAlignment paragraphAlignment, std::unique_ptr<TextFormat> & textFormat) noexcept
+{
+    CComPtr<IDWriteTextFormat> DWTextFormat;
+
+    HRESULT hr = _DirectWrite.Factory->CreateTextFormat(fontName, NULL, DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL, DWRITE_FONT_STRETCH_NORMAL, fontSize, L"", &DWTextFormat);
+
+    if (SUCCEEDED(hr))
+    {
+        static const DWRITE_TEXT_ALIGNMENT TextAlignments[] = { DWRITE_TEXT_ALIGNMENT_LEADING, DWRITE_TEXT_ALIGNMENT_TRAILING, DWRITE_TEXT_ALIGNMENT_CENTER };
+        static const DWRITE_PARAGRAPH_ALIGNMENT ParagraphAlignments[] = { DWRITE_PARAGRAPH_ALIGNMENT_NEAR, DWRITE_PARAGRAPH_ALIGNMENT_FAR, DWRITE_PARAGRAPH_ALIGNMENT_CENTER };
+
+        DWTextFormat->SetTextAlignment(TextAlignments[(int) textAlignment]);
+        DWTextFormat->SetParagraphAlignment(ParagraphAlignments[(int) paragraphAlignment]);
+
+        try
+        {
+            textFormat = std::make_unique<Direct2DTextFormat>(DWTextFormat);
+        }
+        catch (const std::bad_alloc &)
+        {
+            hr = E_OUTOFMEMORY;
+        }
+    }
+
+    return hr;
+}
+
+/// <summary>
+/// Starts drawing.
+/// </summary>
+void Direct2DCompositor::BeginDraw() noexcept
+{
+    _DC->BeginDraw();
+
+    _DC->SetTransform(D2D1::Matrix3x2F::Identity());
+}
+
+/// <summary>
+/// Ends drawing.
+/// </summary>
+HRESULT Direct2DCompositor::EndDraw() noexcept
+{
+    return _DC->EndDraw();
+}
+
+/// <summary>
+/// Restricts drawing to a rectangle, in pixels. The rectangle is converted to DIPs and not anti-aliased so that it lines up with the pixels of the back buffer.
+/// </summary>
+void Direct2DCompositor::PushClip(const RectI & rect) noexcept
+{
+    FLOAT DPIX, DPIY;
+
+    _DC->GetDpi(&DPIX, &DPIY);
+
+    const FLOAT ScaleX = USER_DEFAULT_SCREEN_DPI / DPIX;
+    const FLOAT ScaleY = USER_DEFAULT_SCREEN_DPI / DPIY;
+
+    _DC->PushAxisAlignedClip(D2D1::RectF((FLOAT) rect.left * ScaleX, (FLOAT) rect.top * ScaleY, (FLOAT) rect.right * ScaleX, (FLOAT) rect.bottom * ScaleY), D2D1_ANTIALIAS_MODE_ALIASED);
+}
+
+/// <summary>
+/// Restores the clip rectangle of the previous PushClip.
+/// </summary>
+void Direct2DCompositor::PopClip() noexcept
+{
+    _DC->PopAxisAlignedClip();
+}
+
+/// <summary>
+/// Replaces all pixels of the target with the specified color.
+/// </summary>
+void Direct2DCompositor::Clear(const Color & color) noexcept
+{
+    _DC->Clear(D2D1::ColorF(color.r, color.g, color.b, color.a));
+}
+
+/// <summary>
+/// Fills a rectangle by tiling a pattern bitmap.
+/// </summary>
+void Direct2DCompositor::FillRectangle(const RectF & rect, const Bitmap * pattern) noexcept
+{
+    if (pattern == nullptr)
+        return;
+
+    CComPtr<ID2D1BitmapBrush> Brush;
+
+    if (SUCCEEDED(static_cast<const Direct2DBitmap *>(pattern)->GetBrush(_DC, &Brush)))
+        _DC->FillRectangle(D2D1::RectF(rect.left, rect.top, rect.right, rect.bottom), Brush);
+}
+
+/// <summary>
+/// Draws a bitmap stretched to the specified rectangle.
+/// </summary>
+void Direct2DCompositor::DrawBitmap(const Bitmap * bitmap, const RectF & rect) noexcept
+{
+    if (bitmap == nullptr)
+        return;
+
+    _DC->DrawBitmap(static_cast<const Direct2DBitmap *>(bitmap)->Get(), D2D1::RectF(rect.left, rect.top, rect.right, rect.bottom));
+}
+
+/// <summary>
+/// Fills an anti-aliased ellipse.
+/// </summary>
+void Direct2DCompositor::FillEllipse(const PointF & center, FLOAT radiusX, FLOAT radiusY, const Color & color) noexcept
+{
+    const D2D1_ELLIPSE Ellipse = D2D1::Ellipse(D2D1::Point2F(center.x, center.y), radiusX, radiusY);
+
+    _SolidBrush->SetColor(D2D1::ColorF(color.r, color.g, color.b, color.a));
+    _DC->FillEllipse(Ellipse, _SolidBrush);
+}
+
+/// <summary>
+/// Draws text with a cached DirectWrite text layout. Frames that draw the same text in the same box skip the layout entirely.
+/// </summary>
+void Direct2DCompositor::DrawString(const WCHAR * text, UINT length, const TextFormat * textFormat, const RectF & rect, const Color & color) noexcept
+{
+    if (textFormat == nullptr)
+        return;
+
+    _SolidBrush->SetColor(D2D1::ColorF(color.r, color.g, color.b, color.a));
+
+    CComPtr<IDWriteTextLayout> TextLayout;
+
+    if (SUCCEEDED(GetTextLayout(text, length, static_cast<const Direct2DTextFormat *>(textFormat)->Get(), rect.Width(), rect.Height(), &TextLayout)))
+        _DC->DrawTextLayout(D2D1::Point2F(rect.left, rect.top), TextLayout, _SolidBrush);
+    else
+        _DC->DrawText(text, length, static_cast<const Direct2DTextFormat *>(textFormat)->Get(), D2D1::RectF(rect.left, rect.top, rect.right, rect.bottom), _SolidBrush);
+}
+
+/// <summary>
+/// Gets the counters of the text layout cache.
+/// </summary>
+TextLayoutStatistics Direct2DCompositor::GetTextLayoutStatistics() const noexcept
+{
+    TextLayoutStatistics Statistics = _TextLayoutStatistics;
+
+    Statistics.Layouts = (UINT) _TextLayouts.size();
+
+    return Statistics;
+}
+
+/// <summary>
+/// Gets the text layout of a string in a box, keyed by the hash of the string, the text format and the size of the box.
+/// A layout of the same string and format in a different box is reused: DirectWrite keeps the shaped glyphs and only breaks the lines again.
+/// </summary>
+HRESULT Direct2DCompositor::GetTextLayout(const WCHAR * text, UINT length, IDWriteTextFormat * textFormat, FLOAT width, FLOAT height, IDWriteTextLayout ** textLayout) noexcept
+{
+    const uint64_t Hash = TextLayoutCache::GetHash(text, length);
+
+    for (auto Entry = _TextLayouts.begin(); Entry != _TextLayouts.end(); ++Entry)
+    {
+        if ((Entry->Hash != Hash) || (Entry->Format != textFormat) || (Entry->Text.size() != length) || (::memcmp(Entry->Text.data(), text, length * sizeof(WCHAR)) != 0))
+            continue;
+
+        _TextLayouts.splice(_TextLayouts.begin(), _TextLayouts, Entry);
+
+        if ((Entry->Width == width) && (Entry->Height == height))
+            ++_TextLayoutStatistics.Hits;
+        else
+        {
+            // The line breaks can only change if a line was wrapped or the widest line no longer fits.
+            const bool IsBreakChanged = Entry->IsWrapped || (width < Entry->LineWidth);
+
+            Entry->Layout->SetMaxWidth(width);
+            Entry->Layout->SetMaxHeight(height);
+
+            Entry->Width = width;
+            Entry->Height = height;
+
+            if (IsBreakChanged)
+            {
+                DWRITE_TEXT_METRICS Metrics;
+
+                if (SUCCEEDED(Entry->Layout->GetMetrics(&Metrics)))
+                {
+                    Entry->LineWidth = Metrics.widthIncludingTrailingWhitespace;
+                    Entry->IsWrapped = (Metrics.lineCount > (UINT32) std::count(Entry->Text.begin(), Entry->Text.end(), L'\n') + 1);
+                }
+
+                ++_TextLayoutStatistics.Relayouts;
+            }
+            else
+                ++_TextLayoutStatistics.Resizes;
+        }
+
+        *textLayout = Entry->Layout;
+        (*textLayout)->AddRef();
+
+        return S_OK;
+    }
+
+    ++_TextLayoutStatistics.Misses;
+
+    CComPtr<IDWriteTextLayout> Layout;
+
+    HRESULT hr = _DirectWrite.Factory->CreateTextLayout(text, length, textFormat, width, height, &Layout);
+
+    if (!SUCCEEDED(hr))
+        return hr;
+
+    DWRITE_TEXT_METRICS Metrics = { };
+
+    hr = Layout->GetMetrics(&Metrics);
+
+    if (!SUCCEEDED(hr))
+        return hr;
+
+    try
+    {
+        const std::wstring Text(text, length);
+
+        const bool IsWrapped = (Metrics.lineCount > (UINT32) std::count(Text.begin(), Text.end(), L'\n') + 1);
+
+        _TextLayouts.push_front({ Hash, Text, textFormat, width, height, Metrics.widthIncludingTrailingWhitespace, IsWrapped, Layout });
+    }
+    catch (const std::bad_alloc &)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    if (_TextLayouts.size() > MaxTextLayouts)
+        _TextLayouts.pop_back();
+
+    *textLayout = Layout.Detach();
+
+    return S_OK;
+}
+
+/// <summary>
+/// Presents the swap chain to the composition engine.
+/// </summary>
+HRESULT Direct2DCompositor::Present() noexcept
+{
+    return _SwapChain->Present(1, 0);
+}
+
+/// <summary>
+/// Presents the dirty region of the swap chain to the composition engine. DXGI copies the rest of the back buffer from the previous frame.
+/// </summary>
+HRESULT Direct2DCompositor::Present(const Region & dirtyRegion) noexcept
+{
+    std::vector<RECT> DirtyRects;
+
+    try
+    {
+        DirtyRects.reserve(dirtyRegion.GetRects().size());
+
+        for (const RectI & Rect : dirtyRegion.GetRects())
+            DirtyRects.push_back({ Rect.left, Rect.top, Rect.right, Rect.bottom });
+    }
+    catch (const std::bad_alloc &)
+    {
+        return Present();
+    }
+
+    DXGI_PRESENT_PARAMETERS Parameters = { (UINT) DirtyRects.size(), DirtyRects.data(), nullptr, nullptr };
+
+    return _SwapChain->Present1(1, 0, &Parameters);
+}
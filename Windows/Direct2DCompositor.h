@@ -0,0 +1,118 @@
+
+/** $VER: Direct2DCompositor.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "framework.h"
+
+#include "Compositor.h"
+#include "TextLayout.h"
+
+#include <list>
+#include <string>
+
+/// <summary>
+/// Represents a Direct2D bitmap.
+/// </summary>
+class Direct2DBitmap : public Bitmap
+{
+public:
+    Direct2DBitmap(ID2D1Bitmap * bitmap) : _Bitmap(bitmap) { }
+
+    SizeF GetSize() const noexcept override
+    {
+        const D2D1_SIZE_F Size = _Bitmap->GetSize();
+
+        return { Size.width, Size.height };
+    }
+
+    ID2D1Bitmap * Get() const noexcept { return _Bitmap; }
+
+    HRESULT GetBrush(ID2D1RenderTarget * renderTarget, ID2D1BitmapBrush ** bitmapBrush) const noexcept;
+
+private:
+    CComPtr<ID2D1Bitmap> _Bitmap;
+    mutable CComPtr<ID2D1BitmapBrush> _Brush;
+};
+
+/// <summary>
+/// Represents a DirectWrite text format.
+/// </summary>
+class Direct2DTextFormat : public TextFormat
+{
+public:
+    Direct2DTextFormat(IDWriteTextFormat * textFormat) : _TextFormat(textFormat) { }
+
+    IDWriteTextFormat * Get() const noexcept { return _TextFormat; }
+
+private:
+    CComPtr<IDWriteTextFormat> _TextFormat;
+};
+
+/// <summary>
+/// Implements a compositor that draws with a Direct2D device context on the back buffer of a swap chain.
+/// </summary>
+class Direct2DCompositor : public Compositor
+{
+public:
+    Direct2DCompositor() : _TextLayoutStatistics() { }
+
+    HRESULT Attach(ID2D1DeviceContext * dc, IDXGISwapChain1 * swapChain) noexcept;
+    void Detach() noexcept;
+
+    TextLayoutStatistics GetTextLayoutStatistics() const noexcept;
+
+    // Compositor
+    SizeF GetSize() const noexcept override
+    {
+        const D2D1_SIZE_F Size = _DC->GetSize();
+
+        return { Size.width, Size.height };
+    }
+
+    HRESULT CreateBitmap(const Raster & raster, std::unique_ptr<Bitmap> & bitmap) noexcept override;
+    HRESULT CreateTextFormat(const WCHAR * fontName, FLOAT fontSize, TextAlignment textAlignment, ParagraphAlignment paragraphAlignment, std::unique_ptr<TextFormat> & textFormat) noexcept override;
+
+    void BeginDraw() noexcept override;
+    HRESULT EndDraw() noexcept override;
+
+    void PushClip(const RectI & rect) noexcept override;
+    void PopClip() noexcept override;
+
+    void Clear(const Color & color) noexcept override;
+    void FillRectangle(const RectF & rect, const Bitmap * pattern) noexcept override;
+    void DrawBitmap(const Bitmap * bitmap, const RectF & rect) noexcept override;
+    void FillEllipse(const PointF & center, FLOAT radiusX, FLOAT radiusY, const Color & color) noexcept override;
+    void DrawString(const WCHAR * text, UINT length, const TextFormat * textFormat, const RectF & rect, const Color & color) noexcept override;
+
+    HRESULT Present() noexcept override;
+    HRESULT Present(const Region & dirtyRegion) noexcept override;
+
+private:
+    HRESULT GetTextLayout(const WCHAR * text, UINT length, IDWriteTextFormat * textFormat, FLOAT width, FLOAT height, IDWriteTextLayout ** textLayout) noexcept;
+
+    /// <summary>
+    /// Represents a DirectWrite text layout that is kept across frames. The glyphs are shaped once; a new box only breaks the lines again.
+    /// </summary>
+    struct CachedTextLayout
+    {
+        uint64_t Hash;
+        std::wstring Text;
+        CComPtr<IDWriteTextFormat> Format;
+        FLOAT Width;                            // Size of the layout box
+        FLOAT Height;
+        FLOAT LineWidth;                        // Width of the widest line, including trailing white space
+        bool IsWrapped;                         // True if a line had to be wrapped to fit the box.
+        CComPtr<IDWriteTextLayout> Layout;
+    };
+
+    static const UINT MaxTextLayouts = 16;
+
+private:
+    CComPtr<ID2D1DeviceContext> _DC;
+    CComPtr<IDXGISwapChain1> _SwapChain;
+    CComPtr<ID2D1SolidColorBrush> _SolidBrush;
+
+    std::list<CachedTextLayout> _TextLayouts;  // Most recently used first. Text layouts do not depend on the device and survive Detach.
+    TextLayoutStatistics _TextLayoutStatistics;
+};
@@ -0,0 +1,283 @@
+
+/** $VER: MappedStream.cpp (2026.10.17) P. Stuer **/
+
+#include <CppCoreCheck/Warnings.h>
+
+#pragma warning(disable: 4100 4625 4626 4710 4711 5045 ALL_CPPCORECHECK_WARNINGS)
+
+#include "framework.h"
+
+#include "MappedStream.h"
+
+#pragma hdrstop
+
+/// <summary>
+/// Maps a file and creates a stream on top of it.
+/// </summary>
+HRESULT MappedStream::Create(const WCHAR * filePath, IStream ** stream) noexcept
+{
+    if (stream == nullptr)
+        return E_POINTER;
+
+    *stream = nullptr;
+
+    try
+    {
+        auto File = std::make_shared<MappedFile>();
+
+        HRESULT hr = File->Open(filePath, FileAccess::Sequential);
+
+        if (FAILED(hr))
+            return hr;
+
+        *stream = new MappedStream(File);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    return S_OK;
+}
+
+/// <summary>
+/// Gets a supported interface.
+/// </summary>
+STDMETHODIMP MappedStream::QueryInterface(REFIID riid, void ** object) noexcept
+{
+    if (object == nullptr)
+        return E_POINTER;
+
+    if ((riid == __uuidof(IUnknown)) || (riid == __uuidof(ISequentialStream)) || (riid == __uuidof(IStream)))
+    {
+        *object = (IStream *) this;
+
+        AddRef();
+
+        return S_OK;
+    }
+
+    *object = nullptr;
+
+    return E_NOINTERFACE;
+}
+
+/// <summary>
+/// Increments the reference count.
+/// </summary>
+STDMETHODIMP_(ULONG) MappedStream::AddRef() noexcept
+{
+    return (ULONG) ::InterlockedIncrement(&_RefCount);
+}
+
+/// <summary>
+/// Decrements the reference count and deletes the stream when it reaches zero.
+/// </summary>
+STDMETHODIMP_(ULONG) MappedStream::Release() noexcept
+{
+    const LONG RefCount = ::InterlockedDecrement(&_RefCount);
+
+    if (RefCount == 0)
+        delete this;
+
+    return (ULONG) RefCount;
+}
+
+/// <summary>
+/// Copies bytes from the current position. Returns S_FALSE if the end of the file was reached before all bytes were read, and
+/// HRESULT_FROM_WIN32(ERROR_READ_FAULT) if the mapped pages could not be read from the file.
+/// </summary>
+STDMETHODIMP MappedStream::Read(void * data, ULONG size, ULONG * read) noexcept
+{
+    if ((data == nullptr) && (size != 0))
+        return STG_E_INVALIDPOINTER;
+
+    const uint64_t Size = _File->Size();
+    const ULONG Count = (_Position < Size) ? (ULONG) (std::min)((uint64_t) size, Size - _Position) : 0;
+
+    if (Count != 0)
+    {
+        // A mapped file that gets truncated, or whose volume goes away, faults on the lost pages instead of failing the read.
+        __try
+        {
+            ::memcpy(data, _File->Data() + _Position, Count);
+        }
+        __except ((GetExceptionCode() == EXCEPTION_IN_PAGE_ERROR) ? EXCEPTION_EXECUTE_HANDLER : EXCEPTION_CONTINUE_SEARCH)
+        {
+            if (read != nullptr)
+                *read = 0;
+
+            return HRESULT_FROM_WIN32(ERROR_READ_FAULT);
+        }
+    }
+
+    _Position += Count;
+
+    if (read != nullptr)
+        *read = Count;
+
+    return (Count == size) ? S_OK : S_FALSE;
+}
+
+/// <summary>
+/// Not supported; the stream is read-only.
+/// </summary>
+STDMETHODIMP MappedStream::Write(const void *, ULONG, ULONG * written) noexcept
+{
+    if (written != nullptr)
+        *written = 0;
+
+    return STG_E_ACCESSDENIED;
+}
+
+/// <summary>
+/// Moves the current position. The position may be beyond the end of the file.
+/// </summary>
+STDMETHODIMP MappedStream::Seek(LARGE_INTEGER offset, DWORD origin, ULARGE_INTEGER * position) noexcept
+{
+    int64_t Base;
+
+    switch (origin)
+    {
+        case STREAM_SEEK_SET: Base = 0; break;
+        case STREAM_SEEK_CUR: Base = (int64_t) _Position; break;
+        case STREAM_SEEK_END: Base = (int64_t) _File->Size(); break;
+
+        default:
+            return STG_E_INVALIDFUNCTION;
+    }
+
+    const int64_t Position = Base + offset.QuadPart;
+
+    if (Position < 0)
+        return STG_E_INVALIDFUNCTION;
+
+    _Position = (uint64_t) Position;
+
+    if (position != nullptr)
+        position->QuadPart = _Position;
+
+    return S_OK;
+}
+
+/// <summary>
+/// Not supported; the stream is read-only.
+/// </summary>
+STDMETHODIMP MappedStream::SetSize(ULARGE_INTEGER) noexcept
+{
+    return STG_E_ACCESSDENIED;
+}
+
+/// <summary>
+/// Writes bytes from the current position to another stream.
+/// </summary>
+STDMETHODIMP MappedStream::CopyTo(IStream * stream, ULARGE_INTEGER size, ULARGE_INTEGER * read, ULARGE_INTEGER * written) noexcept
+{
+    if (stream == nullptr)
+        return STG_E_INVALIDPOINTER;
+
+    const uint64_t Size = _File->Size();
+    const uint64_t Count = (_Position < Size) ? (std::min)(size.QuadPart, Size - _Position) : 0;
+
+    uint64_t Written = 0;
+
+    HRESULT hr = S_OK;
+
+    // IStream::Write takes a 32-bit size.
+    while (SUCCEEDED(hr) && (Written < Count))
+    {
+        const ULONG Chunk = (ULONG) (std::min)(Count - Written, (uint64_t) 0x40000000);
+
+        ULONG ChunkWritten = 0;
+
+        hr = stream->Write(_File->Data() + _Position + Written, Chunk, &ChunkWritten);
+
+        Written += ChunkWritten;
+
+        if (ChunkWritten != Chunk)
+            break;
+    }
+
+    _Position += Written;
+
+    if (read != nullptr)
+        read->QuadPart = Written;
+
+    if (written != nullptr)
+        written->QuadPart = Written;
+
+    return hr;
+}
+
+/// <summary>
+/// Does nothing; the stream is read-only.
+/// </summary>
+STDMETHODIMP MappedStream::Commit(DWORD) noexcept
+{
+    return S_OK;
+}
+
+/// <summary>
+/// Does nothing; the stream is read-only.
+/// </summary>
+STDMETHODIMP MappedStream::Revert() noexcept
+{
+    return S_OK;
+}
+
+/// <summary>
+/// Not supported.
+/// </summary>
+STDMETHODIMP MappedStream::LockRegion(ULARGE_INTEGER, ULARGE_INTEGER, DWORD) noexcept
+{
+    return STG_E_INVALIDFUNCTION;
+}
+
+/// <summary>
+/// Not supported.
+/// </summary>
+STDMETHODIMP MappedStream::UnlockRegion(ULARGE_INTEGER, ULARGE_INTEGER, DWORD) noexcept
+{
+    return STG_E_INVALIDFUNCTION;
+}
+
+/// <summary>
+/// Gets the size of the stream. The stream has no name.
+/// </summary>
+STDMETHODIMP MappedStream::Stat(STATSTG * stat, DWORD) noexcept
+{
+    if (stat == nullptr)
+        return STG_E_INVALIDPOINTER;
+
+    *stat = { };
+
+    stat->type            = STGTY_STREAM;
+    stat->cbSize.QuadPart = _File->Size();
+    stat->grfMode         = STGM_READ | STGM_SHARE_DENY_WRITE;
+
+    return S_OK;
+}
+
+/// <summary>
+/// Creates a stream with its own position on the same mapping.
+/// </summary>
+STDMETHODIMP MappedStream::Clone(IStream ** stream) noexcept
+{
+    if (stream == nullptr)
+        return STG_E_INVALIDPOINTER;
+
+    MappedStream * Copy = new (std::nothrow) MappedStream(_File);
+
+    if (Copy == nullptr)
+    {
+        *stream = nullptr;
+
+        return E_OUTOFMEMORY;
+    }
+
+    Copy->_Position = _Position;
+
+    *stream = Copy;
+
+    return S_OK;
+}
@@ -0,0 +1,47 @@
+
+/** $VER: MappedStream.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "framework.h"
+
+#include "MappedFile.h"
+
+/// <summary>
+/// Implements a read-only IStream on top of a memory-mapped file. A decoder that reads from the stream copies straight from the mapped pages;
+/// there is no intermediate read buffer. The stream owns the mapping so the file stays mapped for as long as a decoder or a frame holds a reference.
+/// </summary>
+class MappedStream : public IStream
+{
+public:
+    static HRESULT Create(const WCHAR * filePath, IStream ** stream) noexcept;
+
+    // IUnknown
+    STDMETHODIMP QueryInterface(REFIID riid, void ** object) noexcept override;
+    STDMETHODIMP_(ULONG) AddRef() noexcept override;
+    STDMETHODIMP_(ULONG) Release() noexcept override;
+
+    // ISequentialStream
+    STDMETHODIMP Read(void * data, ULONG size, ULONG * read) noexcept override;
+    STDMETHODIMP Write(const void * data, ULONG size, ULONG * written) noexcept override;
+
+    // IStream
+    STDMETHODIMP Seek(LARGE_INTEGER offset, DWORD origin, ULARGE_INTEGER * position) noexcept override;
+    STDMETHODIMP SetSize(ULARGE_INTEGER size) noexcept override;
+    STDMETHODIMP CopyTo(IStream * stream, ULARGE_INTEGER size, ULARGE_INTEGER * read, ULARGE_INTEGER * written) noexcept override;
+    STDMETHODIMP Commit(DWORD flags) noexcept override;
+    STDMETHODIMP Revert() noexcept override;
+    STDMETHODIMP LockRegion(ULARGE_INTEGER offset, ULARGE_INTEGER size, DWORD lockType) noexcept override;
+    STDMETHODIMP UnlockRegion(ULARGE_INTEGER offset, ULARGE_INTEGER size, DWORD lockType) noexcept override;
+    STDMETHODIMP Stat(STATSTG * stat, DWORD flags) noexcept override;
+    STDMETHODIMP Clone(IStream ** stream) noexcept override;
+
+private:
+    MappedStream(const std::shared_ptr<const MappedFile> & file) noexcept : _RefCount(1), _File(file), _Position() { }
+    virtual ~MappedStream() noexcept { }
+
+private:
+    LONG _RefCount;
+    std::shared_ptr<const MappedFile> _File; // Shared with the clones of the stream
+    uint64_t _Position;
+};
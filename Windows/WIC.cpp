@@ -1,10 +1,16 @@
 
-/** $VER: WIC.cpp (2024.04.04) P. Stuer **/
+/** $VER: WIC.cpp (2026.10.17) P. Stuer **/
 
 #include "framework.h"
 
 #include "WIC.h"
 
+#include "Raster.h"
+#include "PixelConverter.h"
+#include "Scaler.h"
+
+#include <limits>
+
 /// <summary>
 /// Initializes a new instance.
 /// </summary>
@@ -45,37 +51,276 @@ HRESULT WIC::Load(const uint8_t * data, size_t size, IWICBitmapFrameDecode ** fr
 }
 
 /// <summary>
-/// Gets the number of bits per pixel for the specified pixel format.
+/// Loads the first frame of an image from raw image data, reduced by the decoder as far as it can while still covering the size that fits the specified size.
+/// </summary>
+HRESULT WIC::Load(const uint8_t * data, size_t size, UINT maxWidth, UINT maxHeight, IWICBitmapSource ** source) const noexcept
+{
+    CComPtr<IWICBitmapFrameDecode> Frame;
+
+    HRESULT hr = Load(data, size, &Frame);
+
+    if (SUCCEEDED(hr))
+        hr = GetReducedSource(Frame, maxWidth, maxHeight, source);
+
+    return hr;
+}
+
+/// <summary>
+/// Decodes a bitmap source at 1/2, 1/4 or 1/8 of its size if the decoder supports scaling (IWICBitmapSourceTransform, e.g. JPEG) and the result still covers
+/// the size that fits the specified size. Otherwise returns the source itself; its pixels are only decoded when they are copied.
 /// </summary>
-HRESULT WIC::GetBitsPerPixel(const WICPixelFormatGUID & pixelFormat, UINT & bitsPerPixel) const noexcept
+HRESULT WIC::GetReducedSource(IWICBitmapSource * source, UINT maxWidth, UINT maxHeight, IWICBitmapSource ** reducedSource) const noexcept
 {
-    CComPtr<IWICComponentInfo> ComponentInfo;
+    UINT Width = 0, Height = 0;
+
+    HRESULT hr = source->GetSize(&Width, &Height);
+
+    if (!SUCCEEDED(hr))
+        return hr;
+
+    const UINT Scale = Scaler::GetDecodeScale(Width, Height, maxWidth, maxHeight);
+
+    CComPtr<IWICBitmapSourceTransform> Transform;
+
+    if ((Scale == 1) || FAILED(source->QueryInterface(IID_PPV_ARGS(&Transform))))
+        return source->QueryInterface(IID_PPV_ARGS(reducedSource));
 
-    HRESULT hr = Factory->CreateComponentInfo(pixelFormat, &ComponentInfo);
+    UINT ScaledWidth  = Width  / Scale;
+    UINT ScaledHeight = Height / Scale;
 
-    CComPtr<IWICPixelFormatInfo> PixelFormatInfo;
+    hr = Transform->GetClosestSize(&ScaledWidth, &ScaledHeight);
+
+    WICPixelFormatGUID Format;
+
+    if (SUCCEEDED(hr))
+        hr = source->GetPixelFormat(&Format);
 
     if (SUCCEEDED(hr))
-        hr = ComponentInfo->QueryInterface(__uuidof(IWICPixelFormatInfo), (void **) &PixelFormatInfo);
+        hr = Transform->GetClosestPixelFormat(&Format);
+
+    // Decoders that cannot scale return the full size as the closest size.
+    if (FAILED(hr) || (ScaledWidth >= Width) || (ScaledHeight >= Height))
+        return source->QueryInterface(IID_PPV_ARGS(reducedSource));
+
+    CComPtr<IWICBitmap> Bitmap;
+
+    hr = Factory->CreateBitmap(ScaledWidth, ScaledHeight, Format, WICBitmapCacheOnLoad, &Bitmap);
+
+    {
+        CComPtr<IWICBitmapLock> Lock;
+
+        const WICRect Rect = { 0, 0, (INT) ScaledWidth, (INT) ScaledHeight };
+
+        if (SUCCEEDED(hr))
+            hr = Bitmap->Lock(&Rect, WICBitmapLockWrite, &Lock);
+
+        UINT Stride = 0, Size = 0;
+        BYTE * Data = nullptr;
+
+        if (SUCCEEDED(hr))
+            hr = Lock->GetStride(&Stride);
+
+        if (SUCCEEDED(hr))
+            hr = Lock->GetDataPointer(&Size, &Data);
+
+        if (SUCCEEDED(hr))
+            hr = Transform->CopyPixels(nullptr, ScaledWidth, ScaledHeight, &Format, WICBitmapTransformRotate0, Stride, Size, Data);
+    }
 
     if (SUCCEEDED(hr))
-        hr = PixelFormatInfo->GetBitsPerPixel(&bitsPerPixel);
+        *reducedSource = Bitmap.Detach();
 
     return hr;
 }
 
 /// <summary>
-/// Creates a format converter to convert a WIC frame to the specfied format.
+/// Creates a format converter to convert a WIC bitmap source to 32bppPBGRA.
 /// </summary>
-HRESULT WIC::GetFormatConverter(IWICBitmapFrameDecode * frame, IWICFormatConverter ** formatConverter) const noexcept
+HRESULT WIC::GetFormatConverter(IWICBitmapSource * source, IWICFormatConverter ** formatConverter) const noexcept
 {
     // Convert the format of the frame to 32bppPBGRA.
     HRESULT hr = Factory->CreateFormatConverter(formatConverter);
 
     if (SUCCEEDED(hr))
-        hr = (*formatConverter)->Initialize(frame, GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone, nullptr, 0.f, WICBitmapPaletteTypeCustom);
+        hr = (*formatConverter)->Initialize(source, GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone, nullptr, 0.f, WICBitmapPaletteTypeCustom);
+
+    return hr;
+}
+
+/// <summary>
+/// Maps a WIC pixel format to a pixel format supported by the pixel converter.
+/// </summary>
+PixelFormat WIC::GetPixelFormat(const WICPixelFormatGUID & pixelFormat) noexcept
+{
+    if (pixelFormat == GUID_WICPixelFormat32bppPBGRA)
+        return PixelFormat::PBGRA32;
+
+    if (pixelFormat == GUID_WICPixelFormat32bppBGRA)
+        return PixelFormat::BGRA32;
+
+    if (pixelFormat == GUID_WICPixelFormat32bppRGBA)
+        return PixelFormat::RGBA32;
+
+    if (pixelFormat == GUID_WICPixelFormat24bppBGR)
+        return PixelFormat::BGR24;
+
+    if (pixelFormat == GUID_WICPixelFormat24bppRGB)
+        return PixelFormat::RGB24;
+
+    return PixelFormat::Unknown;
+}
+
+/// <summary>
+/// Copies the pixels of a bitmap source into a raster of the same size. The buffer size of CopyPixels is 32-bit, so rasters of 4 GB and more are copied in strips.
+/// </summary>
+static HRESULT CopyPixels(IWICBitmapSource * bitmapSource, Raster & raster) noexcept
+{
+    const UINT StripRows = (UINT) (std::min)((size_t) raster.Height(), (size_t) std::numeric_limits<UINT>::max() / raster.Stride());
+
+    HRESULT hr = S_OK;
+
+    for (UINT y = 0; (y < raster.Height()) && SUCCEEDED(hr); y += StripRows)
+    {
+        const UINT Rows = (std::min)(StripRows, raster.Height() - y);
+
+        const WICRect Rect = { 0, (INT) y, (INT) raster.Width(), (INT) Rows };
+
+        hr = bitmapSource->CopyPixels(&Rect, raster.Stride(), raster.Stride() * Rows, raster.Row(y));
+    }
 
     return hr;
 }
 
+/// <summary>
+/// Creates a raster in system memory from a bitmap source, converted to 32bppPBGRA.
+/// </summary>
+HRESULT WIC::CreateRaster(IWICBitmapSource * bitmapSource, Raster & raster) const noexcept
+{
+    WICPixelFormatGUID SourceFormat;
+
+    HRESULT hr = bitmapSource->GetPixelFormat(&SourceFormat);
+
+    UINT Width = 0, Height = 0;
+
+    if (SUCCEEDED(hr))
+        hr = bitmapSource->GetSize(&Width, &Height);
+
+    if (!SUCCEEDED(hr))
+        return hr;
+
+    const PixelFormat Format = GetPixelFormat(SourceFormat);
+
+    // Copy the pixels in their native format and convert them with the SIMD converter.
+    if (PixelConverter::IsSupported(Format, PixelFormat::PBGRA32))
+    {
+        hr = raster.Initialize(Width, Height, Format);
+
+        if (SUCCEEDED(hr))
+            hr = CopyPixels(bitmapSource, raster);
+
+        if (SUCCEEDED(hr))
+            hr = PixelConverter::Convert(raster, PixelFormat::PBGRA32);
+
+        return hr;
+    }
+
+    // Let WIC handle all other formats.
+    CComPtr<IWICFormatConverter> Converter;
+
+    hr = GetFormatConverter(bitmapSource, &Converter);
+
+    if (SUCCEEDED(hr))
+        hr = raster.Initialize(Width, Height, PixelFormat::PBGRA32);
+
+    if (SUCCEEDED(hr))
+        hr = CopyPixels(Converter, raster);
+
+    return hr;
+}
+
+/// <summary>
+/// Creates a raster in system memory from a bitmap source, converted to 32bppPBGRA and scaled down to fit the specified size. The source is read
+/// in strips that are scaled as they arrive, so the decoded image is never held in memory as a whole.
+/// </summary>
+HRESULT WIC::CreateFitRaster(IWICBitmapSource * bitmapSource, UINT maxWidth, UINT maxHeight, Raster & raster) const noexcept
+{
+    WICPixelFormatGUID SourceFormat;
+
+    HRESULT hr = bitmapSource->GetPixelFormat(&SourceFormat);
+
+    UINT Width = 0, Height = 0;
+
+    if (SUCCEEDED(hr))
+        hr = bitmapSource->GetSize(&Width, &Height);
+
+    if (!SUCCEEDED(hr))
+        return hr;
+
+    const PixelFormat Format = GetPixelFormat(SourceFormat);
+
+    // Copy the strips in their native format and convert them with the SIMD converter.
+    if (PixelConverter::IsSupported(Format, PixelFormat::PBGRA32))
+    {
+        Raster Strip;
+
+        hr = Strip.Initialize(Width, StreamingScaler::StripRows, Format);
+
+        if (!SUCCEEDED(hr))
+            return hr;
+
+        return StreamingScaler::Fit(Width, Height, [bitmapSource, Format, Width, &Strip](UINT y, UINT count, BYTE * data, UINT stride) -> HRESULT
+        {
+            const WICRect Rect = { 0, (INT) y, (INT) Width, (INT) count };
+
+            HRESULT hc = bitmapSource->CopyPixels(&Rect, Strip.Stride(), Strip.Stride() * count, Strip.Data());
+
+            if (SUCCEEDED(hc))
+                hc = PixelConverter::Convert(Strip.Data(), Strip.Stride(), Format, data, stride, PixelFormat::PBGRA32, Width, count);
+
+            return hc;
+        }, raster, maxWidth, maxHeight);
+    }
+
+    // Let WIC convert all other formats.
+    CComPtr<IWICFormatConverter> Converter;
+
+    hr = GetFormatConverter(bitmapSource, &Converter);
+
+    if (!SUCCEEDED(hr))
+        return hr;
+
+    IWICFormatConverter * Source = Converter;
+
+    return StreamingScaler::Fit(Width, Height, [Source, Width](UINT y, UINT count, BYTE * data, UINT stride) -> HRESULT
+    {
+        const WICRect Rect = { 0, (INT) y, (INT) Width, (INT) count };
+
+        return Source->CopyPixels(&Rect, stride, stride * count, data);
+    }, raster, maxWidth, maxHeight);
+}
+
+/// <summary>
+/// Enters the multithreaded COM apartment the first time it is called on a thread, e.g. a worker of the thread pool. The WIC factory is free-threaded
+/// but every thread that uses it needs an apartment. The thread leaves the apartment when it ends.
+/// </summary>
+HRESULT WIC::InitializeThread() noexcept
+{
+    struct Apartment
+    {
+        Apartment() noexcept : Result(::CoInitializeEx(nullptr, COINIT_MULTITHREADED)) { }
+
+        ~Apartment() noexcept
+        {
+            if (SUCCEEDED(Result))
+                ::CoUninitialize();
+        }
+
+        HRESULT Result;
+    };
+
+    thread_local Apartment Current;
+
+    return Current.Result;
+}
+
 WIC _WIC;
@@ -1,25 +1,37 @@
 
-/** $VER: WIC.h (2024.04.04) P. Stuer **/
+/** $VER: WIC.h (2026.10.17) P. Stuer **/
 
 #pragma once
 
 #include "framework.h"
 
+#include "PixelFormat.h"
+
+class Raster;
+
 class WIC
 {
 public:
     WIC();
 
     HRESULT Load(const uint8_t * data, size_t size, IWICBitmapFrameDecode ** frame) const noexcept;
+    HRESULT Load(const uint8_t * data, size_t size, UINT maxWidth, UINT maxHeight, IWICBitmapSource ** source) const noexcept;
+
+    HRESULT GetReducedSource(IWICBitmapSource * source, UINT maxWidth, UINT maxHeight, IWICBitmapSource ** reducedSource) const noexcept;
 
-    HRESULT GetFormatConverter(IWICBitmapFrameDecode * frame, IWICFormatConverter ** formatConverter) const noexcept;
+    HRESULT GetFormatConverter(IWICBitmapSource * source, IWICFormatConverter ** formatConverter) const noexcept;
 
     HRESULT CreateBitmapFromSource(IWICBitmapSource * bitmapSource, WICBitmapCreateCacheOption option, IWICBitmap ** bitmap) const
     {
         return Factory->CreateBitmapFromSource(bitmapSource, option, bitmap);
     }
 
-    HRESULT GetBitsPerPixel(const WICPixelFormatGUID & pixelFormat, UINT & BitsPerPixel) const noexcept;
+    HRESULT CreateRaster(IWICBitmapSource * bitmapSource, Raster & raster) const noexcept;
+    HRESULT CreateFitRaster(IWICBitmapSource * bitmapSource, UINT maxWidth, UINT maxHeight, Raster & raster) const noexcept;
+
+    static PixelFormat GetPixelFormat(const WICPixelFormatGUID & pixelFormat) noexcept;
+
+    static HRESULT InitializeThread() noexcept;
 
 public:
     CComPtr<IWICImagingFactory> Factory;
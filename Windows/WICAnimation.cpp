@@ -0,0 +1,179 @@
+
+/** $VER: WICAnimation.cpp (2026.10.17) P. Stuer **/
+
+#include <CppCoreCheck/Warnings.h>
+
+#pragma warning(disable: 4100 4625 4626 4710 4711 5045 ALL_CPPCORECHECK_WARNINGS)
+
+#include "framework.h"
+
+#include "WICAnimation.h"
+#include "WIC.h"
+
+#pragma hdrstop
+
+/// <summary>
+/// Creates an animation source for the decoder of a GIF. The source takes a reference to the decoder, which can still be used to decode the first frame
+/// as a still image before the animation is played, but not at the same time. The size of the canvas comes from the logical screen descriptor, or from the first frame.
+/// </summary>
+HRESULT WICAnimation::Create(IWICBitmapDecoder * decoder, std::unique_ptr<AnimationSource> & source) noexcept
+{
+    GUID ContainerFormat = { };
+
+    HRESULT hr = decoder->GetContainerFormat(&ContainerFormat);
+
+    if (SUCCEEDED(hr) && (ContainerFormat != GUID_ContainerFormatGif))
+        hr = WINCODEC_ERR_UNSUPPORTEDOPERATION;
+
+    UINT FrameCount = 0;
+
+    if (SUCCEEDED(hr))
+        hr = decoder->GetFrameCount(&FrameCount);
+
+    if (SUCCEEDED(hr) && (FrameCount == 0))
+        hr = WINCODEC_ERR_FRAMEMISSING;
+
+    CComPtr<IWICBitmapFrameDecode> Frame;
+
+    if (SUCCEEDED(hr))
+        hr = decoder->GetFrame(0, &Frame);
+
+    UINT Width = 0, Height = 0;
+
+    if (SUCCEEDED(hr))
+        hr = Frame->GetSize(&Width, &Height);
+
+    if (FAILED(hr))
+        return hr;
+
+    UINT LoopCount = 1;
+
+    CComPtr<IWICMetadataQueryReader> Reader;
+
+    if (SUCCEEDED(decoder->GetMetadataQueryReader(&Reader)))
+    {
+        UINT ScreenWidth = 0, ScreenHeight = 0;
+
+        if (GetMetadata(Reader, L"/logscrdesc/Width", ScreenWidth) && GetMetadata(Reader, L"/logscrdesc/Height", ScreenHeight) && (ScreenWidth != 0) && (ScreenHeight != 0))
+        {
+            Width = ScreenWidth;
+            Height = ScreenHeight;
+        }
+
+        LoopCount = GetLoopCount(Reader);
+    }
+
+    try
+    {
+        source.reset(new WICAnimation(decoder, Width, Height, FrameCount, LoopCount));
+    }
+    catch (const std::bad_alloc &)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    return S_OK;
+}
+
+/// <summary>
+/// Reads a frame into a premultiplied BGRA raster. Runs on a worker thread of the animation player.
+/// </summary>
+HRESULT WICAnimation::ReadFrame(UINT index, AnimationFrame & frame, Raster & raster) noexcept
+{
+    HRESULT hr = WIC::InitializeThread();
+
+    CComPtr<IWICBitmapFrameDecode> Frame;
+
+    if (SUCCEEDED(hr))
+        hr = _Decoder->GetFrame(index, &Frame);
+
+    UINT Width = 0, Height = 0;
+
+    if (SUCCEEDED(hr))
+        hr = Frame->GetSize(&Width, &Height);
+
+    if (FAILED(hr))
+        return hr;
+
+    UINT Left = 0, Top = 0, Delay = 0, Disposal = 0;
+
+    CComPtr<IWICMetadataQueryReader> Reader;
+
+    if (SUCCEEDED(Frame->GetMetadataQueryReader(&Reader)))
+    {
+        GetMetadata(Reader, L"/imgdesc/Left", Left);
+        GetMetadata(Reader, L"/imgdesc/Top", Top);
+
+        if (GetMetadata(Reader, L"/grctlext/Delay", Delay))
+            Delay *= 10; // Hundredths of a second
+
+        GetMetadata(Reader, L"/grctlext/Disposal", Disposal);
+    }
+
+    frame.Rect = { (int) Left, (int) Top, (int) (Left + Width), (int) (Top + Height) };
+    frame.Delay = Delay;
+    frame.Disposal = (Disposal == 2) ? FrameDisposal::Background : ((Disposal == 3) ? FrameDisposal::Previous : FrameDisposal::None);
+    frame.Blend = FrameBlend::Over; // Transparent pixels of a GIF frame leave the canvas as it is.
+
+    return _WIC.CreateRaster(Frame, raster);
+}
+
+/// <summary>
+/// Gets an unsigned integer from the metadata. Returns false if the metadata does not exist or is not an unsigned integer.
+/// </summary>
+bool WICAnimation::GetMetadata(IWICMetadataQueryReader * reader, const WCHAR * name, UINT & value) noexcept
+{
+    PROPVARIANT Value;
+
+    ::PropVariantInit(&Value);
+
+    if (FAILED(reader->GetMetadataByName(name, &Value)))
+        return false;
+
+    bool Result = true;
+
+    switch (Value.vt)
+    {
+        case VT_UI1: value = Value.bVal; break;
+        case VT_UI2: value = Value.uiVal; break;
+        case VT_UI4: value = Value.ulVal; break;
+
+        default:
+            Result = false;
+    }
+
+    ::PropVariantClear(&Value);
+
+    return Result;
+}
+
+/// <summary>
+/// Gets the number of times a GIF plays from its NETSCAPE2.0 application extension: a repeat count of 0 plays it forever, n repeats it n times after the first time.
+/// Without the extension the animation plays once.
+/// </summary>
+UINT WICAnimation::GetLoopCount(IWICMetadataQueryReader * reader) noexcept
+{
+    UINT LoopCount = 1;
+
+    PROPVARIANT Value;
+
+    ::PropVariantInit(&Value);
+
+    if (SUCCEEDED(reader->GetMetadataByName(L"/appext/Application", &Value)) && (Value.vt == (VT_UI1 | VT_VECTOR)) && (Value.caub.cElems == 11) &&
+        ((::memcmp(Value.caub.pElems, "NETSCAPE2.0", 11) == 0) || (::memcmp(Value.caub.pElems, "ANIMEXTS1.0", 11) == 0)))
+    {
+        ::PropVariantClear(&Value);
+
+        // The data sub-block: size (3), sub-block id (1), repeat count (little-endian).
+        if (SUCCEEDED(reader->GetMetadataByName(L"/appext/Data", &Value)) && (Value.vt == (VT_UI1 | VT_VECTOR)) && (Value.caub.cElems >= 4) && (Value.caub.pElems[0] >= 3) && (Value.caub.pElems[1] == 1))
+        {
+            const UINT RepeatCount = (UINT) Value.caub.pElems[2] | ((UINT) Value.caub.pElems[3] << 8);
+
+            LoopCount = (RepeatCount != 0) ? RepeatCount + 1 : 0;
+        }
+    }
+
+    ::PropVariantClear(&Value);
+
+    return LoopCount;
+}
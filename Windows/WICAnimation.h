@@ -0,0 +1,40 @@
+
+/** $VER: WICAnimation.h (2026.10.17) P. Stuer **/
+
+#pragma once
+
+#include "framework.h"
+
+#include "Animation.h"
+
+/// <summary>
+/// Reads the frames of an animated GIF with WIC, with the position, delay and disposal of every frame and the loop count. WIC does not expose the
+/// frames of APNG nor the frame metadata of other multi-frame containers, so only GIF is played.
+/// </summary>
+class WICAnimation : public AnimationSource
+{
+public:
+    static HRESULT Create(IWICBitmapDecoder * decoder, std::unique_ptr<AnimationSource> & source) noexcept;
+
+    UINT GetWidth() const noexcept override { return _Width; }
+    UINT GetHeight() const noexcept override { return _Height; }
+
+    UINT GetFrameCount() const noexcept override { return _FrameCount; }
+    UINT GetLoopCount() const noexcept override { return _LoopCount; }
+
+    HRESULT ReadFrame(UINT index, AnimationFrame & frame, Raster & raster) noexcept override;
+
+private:
+    WICAnimation(IWICBitmapDecoder * decoder, UINT width, UINT height, UINT frameCount, UINT loopCount) noexcept : _Decoder(decoder), _Width(width), _Height(height), _FrameCount(frameCount), _LoopCount(loopCount) { }
+
+    static bool GetMetadata(IWICMetadataQueryReader * reader, const WCHAR * name, UINT & value) noexcept;
+    static UINT GetLoopCount(IWICMetadataQueryReader * reader) noexcept;
+
+private:
+    CComPtr<IWICBitmapDecoder> _Decoder;
+
+    UINT _Width;
+    UINT _Height;
+    UINT _FrameCount;
+    UINT _LoopCount;
+};